@@ -0,0 +1,78 @@
+#include <Engine.hpp>
+#include <MeshResource.hpp>
+#include <CookedMesh.hpp>
+#include <TextureResource.hpp>
+#include <CookedTexture.hpp>
+
+namespace
+{
+	bool ParseTextureFormat(const std::string& name, Poly::eTextureDataFormat& format)
+	{
+		const std::pair<const char*, Poly::eTextureDataFormat> formats[] = {
+			{ "rgba", Poly::eTextureDataFormat::RGBA },
+			{ "bc1", Poly::eTextureDataFormat::BC1 },
+			{ "bc3", Poly::eTextureDataFormat::BC3 },
+			{ "bc7", Poly::eTextureDataFormat::BC7 },
+		};
+		for (const auto& entry : formats)
+		{
+			if (name == entry.first)
+			{
+				format = entry.second;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void PrintUsage(const char* program)
+	{
+		std::cout << "Usage: " << program << " mesh <source> <output>" << std::endl;
+		std::cout << "       " << program << " texture <source> <output> [rgba|bc1|bc3|bc7]" << std::endl;
+	}
+}
+
+// Converts source assets into binary formats loaded by the engine without parsing.
+// Resources are decoded without a rendering device, so the cooker runs headless.
+int main(int argc, char* args[])
+{
+	const std::string command = argc > 1 ? args[1] : "";
+	Poly::eTextureDataFormat textureFormat = Poly::eTextureDataFormat::BC7;
+	const bool validMesh = command == "mesh" && argc == 4;
+	const bool validTexture = command == "texture" && (argc == 4 || (argc == 5 && ParseTextureFormat(args[4], textureFormat)));
+	if (!validMesh && !validTexture)
+	{
+		PrintUsage(args[0]);
+		return 1;
+	}
+
+	const Poly::String sourcePath(args[2]);
+	const Poly::String outputPath(args[3]);
+	try
+	{
+		if (validMesh)
+		{
+			Poly::MeshResource mesh(sourcePath);
+			Poly::CookedMesh::Write(mesh, outputPath);
+		}
+		else
+		{
+			// decoded image is already flipped for the rendering device
+			Poly::TextureResource texture(sourcePath);
+			if (!texture.GetImage())
+			{
+				std::cout << args[2] << " is already cooked!" << std::endl;
+				return 1;
+			}
+			Poly::CookedTexture::Write(texture.GetImage(), texture.GetWidth(), texture.GetHeight(), textureFormat, outputPath);
+		}
+	}
+	catch (const std::exception&)
+	{
+		std::cout << "Cooking " << args[2] << " failed!" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Cooked " << args[2] << " into " << args[3] << std::endl;
+	return 0;
+}
@@ -41,6 +41,20 @@ AABox AABox::GetIntersectionVolume(const AABox& rhs) const
 		return AABox(Vector::ZERO, Vector::ZERO);
 }
 
+//------------------------------------------------------------------------------
+AABox AABox::GetTransformed(const Matrix& transform) const
+{
+	// center is transformed as a point, extents are projected onto the world axes
+	const Matrix& m = transform;
+	const Vector halfSize = Size * 0.5f;
+	const Vector center = m * GetCenter();
+	const Vector worldHalfSize(
+		std::abs(m.m00) * halfSize.X + std::abs(m.m01) * halfSize.Y + std::abs(m.m02) * halfSize.Z,
+		std::abs(m.m10) * halfSize.X + std::abs(m.m11) * halfSize.Y + std::abs(m.m12) * halfSize.Z,
+		std::abs(m.m20) * halfSize.X + std::abs(m.m21) * halfSize.Y + std::abs(m.m22) * halfSize.Z);
+	return AABox(Vector(center.X - worldHalfSize.X, center.Y - worldHalfSize.Y, center.Z - worldHalfSize.Z), worldHalfSize * 2.0f);
+}
+
 //------------------------------------------------------------------------------
 namespace Poly {
 	std::ostream & operator<<(std::ostream& stream, const AABox& rect)
@@ -3,6 +3,7 @@
 #include "Defines.hpp"
 #include "BasicMath.hpp"
 #include "Vector.hpp"
+#include "Matrix.hpp"
 
 namespace Poly {
 
@@ -17,8 +18,8 @@ namespace Poly {
 		AABox(const Vector& position, const Vector& size);
 
 		/// <summary>Calculates center of the box.</summary>
-		/// <returns>Center of the box.</returns>
-		Vector GetCenter() const { return Pos + (Size * 0.5f); }
+		/// <returns>Center of the box, as a point (W equal to 1) that can be transformed by a matrix.</returns>
+		Vector GetCenter() const { return Vector(Pos.X + Size.X * 0.5f, Pos.Y + Size.Y * 0.5f, Pos.Z + Size.Z * 0.5f); }
 		
 		/// <summary>Returns the min point of the box. (posiiton)</summary>
 		/// <returns>Min point of the box.</returns>
@@ -66,6 +67,11 @@ namespace Poly {
 		/// <see cref="AABox.Intersects()"/>
 		AABox GetIntersectionVolume(const AABox& rhs) const;
 
+		/// <summary>Calculates the smallest AABox containing this box transformed by a given matrix.</summary>
+		/// <param name="transform">Affine transformation to apply.</param>
+		/// <returns>Transformed box.</returns>
+		AABox GetTransformed(const Matrix& transform) const;
+
 		CORE_DLLEXPORT friend std::ostream& operator<< (std::ostream& stream, const AABox& color);
 	private:
 		Vector Pos;
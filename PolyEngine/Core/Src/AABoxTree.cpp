@@ -0,0 +1,260 @@
+#include "CorePCH.hpp"
+
+#include "AABoxTree.hpp"
+
+using namespace Poly;
+
+constexpr size_t AABoxTree::INVALID_PROXY;
+
+namespace
+{
+	AABox Union(const AABox& a, const AABox& b)
+	{
+		const Vector aMin = a.GetMin(), aMax = a.GetMax(), bMin = b.GetMin(), bMax = b.GetMax();
+		const Vector min(std::min(aMin.X, bMin.X), std::min(aMin.Y, bMin.Y), std::min(aMin.Z, bMin.Z));
+		const Vector max(std::max(aMax.X, bMax.X), std::max(aMax.Y, bMax.Y), std::max(aMax.Z, bMax.Z));
+		return AABox(min, max - min);
+	}
+
+	// surface area heuristic uses half of the area, constant factor does not change the result
+	float HalfArea(const AABox& box)
+	{
+		const Vector& size = box.GetSize();
+		return size.X * size.Y + size.Y * size.Z + size.Z * size.X;
+	}
+
+	bool Contains(const AABox& outer, const AABox& inner)
+	{
+		const Vector outerMin = outer.GetMin(), outerMax = outer.GetMax(), innerMin = inner.GetMin(), innerMax = inner.GetMax();
+		return outerMin.X <= innerMin.X && outerMin.Y <= innerMin.Y && outerMin.Z <= innerMin.Z
+			&& innerMax.X <= outerMax.X && innerMax.Y <= outerMax.Y && innerMax.Z <= outerMax.Z;
+	}
+}
+
+//------------------------------------------------------------------------------
+size_t AABoxTree::CreateProxy(const AABox& box, size_t userData)
+{
+	const size_t proxy = AllocateNode();
+	const Vector margin(Margin, Margin, Margin);
+	Nodes[proxy].Box = AABox(box.GetMin() - margin, box.GetSize() + margin * 2.0f);
+	Nodes[proxy].UserData = userData;
+	Nodes[proxy].Height = 0;
+	InsertLeaf(proxy);
+	++ProxyCount;
+	return proxy;
+}
+
+//------------------------------------------------------------------------------
+void AABoxTree::DestroyProxy(size_t proxy)
+{
+	HEAVY_ASSERTE(IsLeaf(proxy), "Invalid proxy");
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	--ProxyCount;
+}
+
+//------------------------------------------------------------------------------
+bool AABoxTree::MoveProxy(size_t proxy, const AABox& box)
+{
+	HEAVY_ASSERTE(IsLeaf(proxy), "Invalid proxy");
+	if (Contains(Nodes[proxy].Box, box))
+		return false;
+
+	RemoveLeaf(proxy);
+	const Vector margin(Margin, Margin, Margin);
+	Nodes[proxy].Box = AABox(box.GetMin() - margin, box.GetSize() + margin * 2.0f);
+	InsertLeaf(proxy);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+size_t AABoxTree::AllocateNode()
+{
+	if (FreeList == INVALID_PROXY)
+	{
+		Nodes.PushBack(Node());
+		return Nodes.GetSize() - 1;
+	}
+
+	const size_t node = FreeList;
+	FreeList = Nodes[node].Parent;
+	Nodes[node] = Node();
+	return node;
+}
+
+//------------------------------------------------------------------------------
+void AABoxTree::FreeNode(size_t node)
+{
+	Nodes[node].Parent = FreeList;
+	Nodes[node].Height = -1;
+	FreeList = node;
+}
+
+//------------------------------------------------------------------------------
+void AABoxTree::InsertLeaf(size_t leaf)
+{
+	if (Root == INVALID_PROXY)
+	{
+		Root = leaf;
+		Nodes[leaf].Parent = INVALID_PROXY;
+		return;
+	}
+
+	// find the best sibling with surface area heuristic, descending while it is cheaper than pairing with the current node
+	const AABox leafBox = Nodes[leaf].Box;
+	size_t index = Root;
+	while (Nodes[index].Child1 != INVALID_PROXY)
+	{
+		const Node& node = Nodes[index];
+		const float area = HalfArea(node.Box);
+		const float combinedArea = HalfArea(Union(node.Box, leafBox));
+
+		// cost of creating a new parent for this node and the leaf
+		const float cost = 2.0f * combinedArea;
+		// minimum cost of pushing the leaf further down the tree
+		const float inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto descendCost = [this, &leafBox, inheritanceCost](size_t child)
+		{
+			const Node& childNode = Nodes[child];
+			const float unionArea = HalfArea(Union(childNode.Box, leafBox));
+			return (childNode.Child1 == INVALID_PROXY ? unionArea : unionArea - HalfArea(childNode.Box)) + inheritanceCost;
+		};
+		const float cost1 = descendCost(node.Child1);
+		const float cost2 = descendCost(node.Child2);
+
+		if (cost < cost1 && cost < cost2)
+			break;
+		index = cost1 < cost2 ? node.Child1 : node.Child2;
+	}
+
+	const size_t sibling = index;
+	const size_t oldParent = Nodes[sibling].Parent;
+	const size_t newParent = AllocateNode();
+	Nodes[newParent].Parent = oldParent;
+	Nodes[newParent].Box = Union(leafBox, Nodes[sibling].Box);
+	Nodes[newParent].Height = Nodes[sibling].Height + 1;
+	Nodes[newParent].Child1 = sibling;
+	Nodes[newParent].Child2 = leaf;
+	Nodes[sibling].Parent = newParent;
+	Nodes[leaf].Parent = newParent;
+
+	if (oldParent == INVALID_PROXY)
+		Root = newParent;
+	else if (Nodes[oldParent].Child1 == sibling)
+		Nodes[oldParent].Child1 = newParent;
+	else
+		Nodes[oldParent].Child2 = newParent;
+
+	Refit(Nodes[leaf].Parent);
+}
+
+//------------------------------------------------------------------------------
+void AABoxTree::RemoveLeaf(size_t leaf)
+{
+	if (leaf == Root)
+	{
+		Root = INVALID_PROXY;
+		return;
+	}
+
+	const size_t parent = Nodes[leaf].Parent;
+	const size_t grandParent = Nodes[parent].Parent;
+	const size_t sibling = Nodes[parent].Child1 == leaf ? Nodes[parent].Child2 : Nodes[parent].Child1;
+
+	// sibling takes place of the parent
+	Nodes[sibling].Parent = grandParent;
+	FreeNode(parent);
+	if (grandParent == INVALID_PROXY)
+	{
+		Root = sibling;
+		return;
+	}
+
+	if (Nodes[grandParent].Child1 == parent)
+		Nodes[grandParent].Child1 = sibling;
+	else
+		Nodes[grandParent].Child2 = sibling;
+	Refit(grandParent);
+}
+
+//------------------------------------------------------------------------------
+void AABoxTree::Refit(size_t node)
+{
+	while (node != INVALID_PROXY)
+	{
+		node = Balance(node);
+
+		Node& current = Nodes[node];
+		const Node& child1 = Nodes[current.Child1];
+		const Node& child2 = Nodes[current.Child2];
+		current.Height = 1 + std::max(child1.Height, child2.Height);
+		current.Box = Union(child1.Box, child2.Box);
+
+		node = current.Parent;
+	}
+}
+
+//------------------------------------------------------------------------------
+size_t AABoxTree::Balance(size_t iA)
+{
+	Node& a = Nodes[iA];
+	if (a.Child1 == INVALID_PROXY || a.Height < 2)
+		return iA;
+
+	const size_t iB = a.Child1;
+	const size_t iC = a.Child2;
+	Node& b = Nodes[iB];
+	Node& c = Nodes[iC];
+	const int balance = c.Height - b.Height;
+
+	// rotates child up, so it becomes parent of A, A keeps the lower of the grandchildren
+	auto rotateUp = [this, iA, &a](size_t iUp, Node& up, const Node& other, bool upIsChild1)
+	{
+		const size_t iF = up.Child1;
+		const size_t iG = up.Child2;
+		Node& f = Nodes[iF];
+		Node& g = Nodes[iG];
+
+		up.Child1 = iA;
+		up.Parent = a.Parent;
+		a.Parent = iUp;
+
+		if (up.Parent == INVALID_PROXY)
+			Root = iUp;
+		else if (Nodes[up.Parent].Child1 == iA)
+			Nodes[up.Parent].Child1 = iUp;
+		else
+			Nodes[up.Parent].Child2 = iUp;
+
+		const bool keepF = f.Height > g.Height;
+		const size_t iKept = keepF ? iF : iG;
+		const size_t iMoved = keepF ? iG : iF;
+		Node& kept = Nodes[iKept];
+		Node& moved = Nodes[iMoved];
+
+		up.Child2 = iKept;
+		if (upIsChild1)
+			a.Child1 = iMoved;
+		else
+			a.Child2 = iMoved;
+		moved.Parent = iA;
+
+		a.Box = Union(other.Box, moved.Box);
+		up.Box = Union(a.Box, kept.Box);
+		a.Height = 1 + std::max(other.Height, moved.Height);
+		up.Height = 1 + std::max(a.Height, kept.Height);
+	};
+
+	if (balance > 1)
+	{
+		rotateUp(iC, c, b, false);
+		return iC;
+	}
+	if (balance < -1)
+	{
+		rotateUp(iB, b, c, true);
+		return iB;
+	}
+	return iA;
+}
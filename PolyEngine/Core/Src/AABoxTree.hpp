@@ -0,0 +1,170 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "Vector.hpp"
+#include "AABox.hpp"
+#include "Frustum.hpp"
+#include "Dynarray.hpp"
+
+namespace Poly {
+
+	/// <summary>Dynamic bounding volume hierarchy of axis aligned boxes.
+	/// Every proxy is stored as a leaf with a box enlarged by a margin, so small movements do not change the tree.
+	/// Tree is kept balanced with rotations on insertion and removal.</summary>
+	class CORE_DLLEXPORT AABoxTree : public BaseObject<>
+	{
+	public:
+		static constexpr size_t INVALID_PROXY = static_cast<size_t>(-1);
+
+		/// <summary>Creates empty tree.</summary>
+		/// <param name="margin">Distance by which boxes of proxies are enlarged in each direction.</param>
+		explicit AABoxTree(float margin = 0.1f) : Margin(margin) {}
+
+		/// <summary>Adds box to the tree.</summary>
+		/// <param name="box">Box of the proxy.</param>
+		/// <param name="userData">Value passed to query callbacks.</param>
+		/// <returns>Proxy identifier, valid until DestroyProxy is called with it.</returns>
+		size_t CreateProxy(const AABox& box, size_t userData);
+
+		/// <summary>Removes proxy from the tree.</summary>
+		/// <param name="proxy">Proxy returned by CreateProxy.</param>
+		void DestroyProxy(size_t proxy);
+
+		/// <summary>Updates box of the proxy. Tree is modified only when the box leaves the enlarged box of the proxy.</summary>
+		/// <param name="proxy">Proxy returned by CreateProxy.</param>
+		/// <param name="box">New box of the proxy.</param>
+		/// <returns>True if the proxy was reinserted, false otherwise.</returns>
+		bool MoveProxy(size_t proxy, const AABox& box);
+
+		/// <summary>Returns value passed to CreateProxy.</summary>
+		size_t GetUserData(size_t proxy) const { HEAVY_ASSERTE(IsLeaf(proxy), "Invalid proxy"); return Nodes[proxy].UserData; }
+
+		/// <summary>Returns box of the proxy enlarged by the margin.</summary>
+		const AABox& GetFatBox(size_t proxy) const { HEAVY_ASSERTE(IsLeaf(proxy), "Invalid proxy"); return Nodes[proxy].Box; }
+
+		size_t GetProxyCount() const { return ProxyCount; }
+
+		/// <summary>Returns height of the tree, 0 for a tree with a single proxy.</summary>
+		size_t GetHeight() const { return Root == INVALID_PROXY ? 0 : static_cast<size_t>(Nodes[Root].Height); }
+
+		/// <summary>Calls callback with user data of every proxy whose enlarged box overlaps the box.</summary>
+		template<typename Callback>
+		void QueryBox(const AABox& box, Callback callback) const
+		{
+			const Vector min = box.GetMin(), max = box.GetMax();
+			Query([&min, &max](const AABox& nodeBox) { return Overlaps(nodeBox, min, max); }, callback);
+		}
+
+		/// <summary>Calls callback with user data of every proxy whose enlarged box overlaps the sphere.</summary>
+		template<typename Callback>
+		void QuerySphere(const Vector& center, float radius, Callback callback) const
+		{
+			const float radiusSquared = radius * radius;
+			Query([&center, radiusSquared](const AABox& nodeBox) { return DistanceSquared(nodeBox, center) <= radiusSquared; }, callback);
+		}
+
+		/// <summary>Calls callback with user data of every proxy whose enlarged box is at least partially inside the frustum.</summary>
+		template<typename Callback>
+		void QueryFrustum(const Frustum& frustum, Callback callback) const
+		{
+			Query([&frustum](const AABox& nodeBox) { return frustum.IsBoxVisible(nodeBox); }, callback);
+		}
+
+		/// <summary>Calls callback with user data of every proxy whose enlarged box is hit by the ray segment.
+		/// Proxies are not sorted by distance.</summary>
+		/// <param name="origin">Origin of the ray.</param>
+		/// <param name="direction">Direction of the ray, does not have to be normalized.</param>
+		/// <param name="maxDistance">Length of the segment in units of direction length.</param>
+		template<typename Callback>
+		void QueryRay(const Vector& origin, const Vector& direction, float maxDistance, Callback callback) const
+		{
+			const Vector invDirection(1.0f / direction.X, 1.0f / direction.Y, 1.0f / direction.Z);
+			Query([&origin, &invDirection, maxDistance](const AABox& nodeBox) { return IsHitByRay(nodeBox, origin, invDirection, maxDistance); }, callback);
+		}
+
+	private:
+		struct Node
+		{
+			AABox Box = AABox(Vector::ZERO, Vector::ZERO);
+			size_t UserData = 0;
+			// next free node when the node is not used
+			size_t Parent = INVALID_PROXY;
+			size_t Child1 = INVALID_PROXY;
+			size_t Child2 = INVALID_PROXY;
+			// leafs have height 0, free nodes -1
+			int Height = -1;
+		};
+
+		template<typename Test, typename Callback>
+		void Query(Test test, Callback callback) const
+		{
+			if (Root == INVALID_PROXY)
+				return;
+
+			Dynarray<size_t> stack;
+			stack.Reserve(2 * GetHeight() + 2);
+			stack.PushBack(Root);
+			while (!stack.IsEmpty())
+			{
+				const Node& node = Nodes[stack[stack.GetSize() - 1]];
+				stack.PopBack();
+				if (!test(node.Box))
+					continue;
+
+				if (node.Child1 == INVALID_PROXY)
+				{
+					callback(node.UserData);
+				}
+				else
+				{
+					stack.PushBack(node.Child1);
+					stack.PushBack(node.Child2);
+				}
+			}
+		}
+
+		static bool Overlaps(const AABox& box, const Vector& min, const Vector& max)
+		{
+			const Vector boxMin = box.GetMin(), boxMax = box.GetMax();
+			return boxMin.X <= max.X && boxMax.X >= min.X
+				&& boxMin.Y <= max.Y && boxMax.Y >= min.Y
+				&& boxMin.Z <= max.Z && boxMax.Z >= min.Z;
+		}
+
+		static float DistanceSquared(const AABox& box, const Vector& point)
+		{
+			const Vector min = box.GetMin(), max = box.GetMax();
+			const float dx = std::max({ min.X - point.X, 0.0f, point.X - max.X });
+			const float dy = std::max({ min.Y - point.Y, 0.0f, point.Y - max.Y });
+			const float dz = std::max({ min.Z - point.Z, 0.0f, point.Z - max.Z });
+			return dx * dx + dy * dy + dz * dz;
+		}
+
+		static bool IsHitByRay(const AABox& box, const Vector& origin, const Vector& invDirection, float maxDistance)
+		{
+			// slab test, infinite inverse components make parallel slabs either always or never hit
+			const Vector min = box.GetMin(), max = box.GetMax();
+			const float tx1 = (min.X - origin.X) * invDirection.X, tx2 = (max.X - origin.X) * invDirection.X;
+			const float ty1 = (min.Y - origin.Y) * invDirection.Y, ty2 = (max.Y - origin.Y) * invDirection.Y;
+			const float tz1 = (min.Z - origin.Z) * invDirection.Z, tz2 = (max.Z - origin.Z) * invDirection.Z;
+			const float tEnter = std::max({ std::min(tx1, tx2), std::min(ty1, ty2), std::min(tz1, tz2), 0.0f });
+			const float tExit = std::min({ std::max(tx1, tx2), std::max(ty1, ty2), std::max(tz1, tz2), maxDistance });
+			return tEnter <= tExit;
+		}
+
+		bool IsLeaf(size_t node) const { return node < Nodes.GetSize() && Nodes[node].Height == 0; }
+
+		size_t AllocateNode();
+		void FreeNode(size_t node);
+		void InsertLeaf(size_t leaf);
+		void RemoveLeaf(size_t leaf);
+		void Refit(size_t node);
+		size_t Balance(size_t node);
+
+		Dynarray<Node> Nodes;
+		size_t Root = INVALID_PROXY;
+		size_t FreeList = INVALID_PROXY;
+		size_t ProxyCount = 0;
+		float Margin;
+	};
+}
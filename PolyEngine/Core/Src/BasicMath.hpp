@@ -100,4 +100,72 @@ namespace Poly {
 		T t = Clamp((x - edge1) / (edge2 - edge1), 0.0f, 1.0f);
 		return t * t * (3.0f - 2.0f * t);
 	}
+
+	/// <summary>Converts float to IEEE 754 half precision float, rounding to the nearest even value.
+	/// Values too large for half precision become infinities.</summary>
+	inline u16 FloatToHalf(float val) {
+		u32 bits;
+		std::memcpy(&bits, &val, sizeof(bits));
+		const u32 sign = (bits >> 16) & 0x8000;
+		const u32 exponent = (bits >> 23) & 0xFF;
+		u32 mantissa = bits & 0x7FFFFF;
+
+		if (exponent == 0xFF) // infinity or NaN
+			return static_cast<u16>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+
+		const int halfExponent = static_cast<int>(exponent) - 127 + 15;
+		if (halfExponent >= 0x1F)
+			return static_cast<u16>(sign | 0x7C00);
+
+		if (halfExponent <= 0) {
+			// subnormal half, mantissa with implicit bit is shifted into place
+			if (halfExponent < -10)
+				return static_cast<u16>(sign);
+			mantissa |= 0x800000;
+			const u32 shift = static_cast<u32>(14 - halfExponent);
+			u32 half = mantissa >> shift;
+			const u32 remainder = mantissa & ((1u << shift) - 1);
+			const u32 halfway = 1u << (shift - 1);
+			if (remainder > halfway || (remainder == halfway && (half & 1)))
+				++half;
+			return static_cast<u16>(sign | half);
+		}
+
+		// carry of rounding may increase exponent, up to infinity, which is correct
+		u32 half = (static_cast<u32>(halfExponent) << 10) | (mantissa >> 13);
+		const u32 remainder = mantissa & 0x1FFF;
+		if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+			++half;
+		return static_cast<u16>(sign | half);
+	}
+
+	/// <summary>Converts IEEE 754 half precision float to float. Conversion is exact.</summary>
+	inline float HalfToFloat(u16 val) {
+		const u32 sign = static_cast<u32>(val & 0x8000) << 16;
+		const u32 exponent = (val >> 10) & 0x1F;
+		u32 mantissa = val & 0x3FF;
+
+		u32 bits;
+		if (exponent == 0x1F) {
+			bits = sign | 0x7F800000 | (mantissa << 13);
+		} else if (exponent == 0) {
+			if (mantissa == 0) {
+				bits = sign;
+			} else {
+				// normalize subnormal half
+				u32 shift = 0;
+				while (!(mantissa & 0x400)) {
+					mantissa <<= 1;
+					++shift;
+				}
+				bits = sign | ((113 - shift) << 23) | ((mantissa & 0x3FF) << 13);
+			}
+		} else {
+			bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+		}
+
+		float result;
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
 }
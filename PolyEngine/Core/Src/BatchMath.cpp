@@ -0,0 +1,207 @@
+#include "CorePCH.hpp"
+
+#include "BatchMath.hpp"
+
+using namespace Poly;
+
+static_assert(sizeof(Vector3f) == 3 * sizeof(float), "Vector3f arrays have to be tightly packed");
+
+namespace
+{
+	//------------------------------------------------------------------------------
+	void TransformScalar(const Matrix& m, const Vector3f* in, Vector3f* out, size_t count, float w)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Vector3f v = in[i];
+			out[i].X = m.m00 * v.X + m.m01 * v.Y + m.m02 * v.Z + m.m03 * w;
+			out[i].Y = m.m10 * v.X + m.m11 * v.Y + m.m12 * v.Z + m.m13 * w;
+			out[i].Z = m.m20 * v.X + m.m21 * v.Y + m.m22 * v.Z + m.m23 * w;
+		}
+	}
+
+	//------------------------------------------------------------------------------
+	void QuaternionToMatrixScalar(const Quaternion& q, Matrix& out)
+	{
+		out = q.ToRotationMatrix();
+	}
+
+#if !DISABLE_SIMD
+	#define SIMD_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+
+	//------------------------------------------------------------------------------
+	void TransformSSE(const Matrix& m, const Vector3f* in, Vector3f* out, size_t count, float w)
+	{
+		const __m128 m00 = _mm_set1_ps(m.m00), m01 = _mm_set1_ps(m.m01), m02 = _mm_set1_ps(m.m02), m03 = _mm_set1_ps(m.m03 * w);
+		const __m128 m10 = _mm_set1_ps(m.m10), m11 = _mm_set1_ps(m.m11), m12 = _mm_set1_ps(m.m12), m13 = _mm_set1_ps(m.m13 * w);
+		const __m128 m20 = _mm_set1_ps(m.m20), m21 = _mm_set1_ps(m.m21), m22 = _mm_set1_ps(m.m22), m23 = _mm_set1_ps(m.m23 * w);
+
+		const size_t simdCount = count & ~size_t(3);
+		for (size_t i = 0; i < simdCount; i += 4)
+		{
+			// 4 packed vectors: (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3)
+			const float* src = &in[i].X;
+			const __m128 a = _mm_loadu_ps(src);
+			const __m128 b = _mm_loadu_ps(src + 4);
+			const __m128 c = _mm_loadu_ps(src + 8);
+
+			// to structure of arrays
+			const __m128 x = SIMD_SHUFFLE(a, SIMD_SHUFFLE(b, c, 2, 2, 1, 1), 0, 3, 0, 2);
+			const __m128 y = SIMD_SHUFFLE(SIMD_SHUFFLE(a, b, 1, 1, 0, 0), SIMD_SHUFFLE(b, c, 3, 3, 2, 2), 0, 2, 0, 2);
+			const __m128 z = SIMD_SHUFFLE(SIMD_SHUFFLE(a, b, 2, 2, 1, 1), c, 0, 2, 0, 3);
+
+			const __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m01, y)), _mm_add_ps(_mm_mul_ps(m02, z), m03));
+			const __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, x), _mm_mul_ps(m11, y)), _mm_add_ps(_mm_mul_ps(m12, z), m13));
+			const __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, x), _mm_mul_ps(m21, y)), _mm_add_ps(_mm_mul_ps(m22, z), m23));
+
+			// back to packed vectors
+			float* dst = &out[i].X;
+			_mm_storeu_ps(dst, SIMD_SHUFFLE(SIMD_SHUFFLE(rx, ry, 0, 0, 0, 0), SIMD_SHUFFLE(rz, rx, 0, 0, 1, 1), 0, 2, 0, 2));
+			_mm_storeu_ps(dst + 4, SIMD_SHUFFLE(SIMD_SHUFFLE(ry, rz, 1, 1, 1, 1), SIMD_SHUFFLE(rx, ry, 2, 2, 2, 2), 0, 2, 0, 2));
+			_mm_storeu_ps(dst + 8, SIMD_SHUFFLE(SIMD_SHUFFLE(rz, rx, 2, 2, 3, 3), SIMD_SHUFFLE(ry, rz, 3, 3, 3, 3), 0, 2, 0, 2));
+		}
+		TransformScalar(m, in + simdCount, out + simdCount, count - simdCount, w);
+	}
+
+	//------------------------------------------------------------------------------
+	void QuaternionsToMatricesSSE(const Quaternion* in, Matrix* out, size_t count)
+	{
+		const __m128 one = _mm_set1_ps(1.f);
+		const __m128 two = _mm_set1_ps(2.f);
+		const __m128 lastRow = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+
+		const size_t simdCount = count & ~size_t(3);
+		for (size_t i = 0; i < simdCount; i += 4)
+		{
+			__m128 x = in[i].SimdData, y = in[i + 1].SimdData, z = in[i + 2].SimdData, w = in[i + 3].SimdData;
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+
+			const __m128 x2 = _mm_mul_ps(two, x), y2 = _mm_mul_ps(two, y), z2 = _mm_mul_ps(two, z);
+			const __m128 xx = _mm_mul_ps(x2, x), yy = _mm_mul_ps(y2, y), zz = _mm_mul_ps(z2, z);
+			const __m128 xy = _mm_mul_ps(x2, y), xz = _mm_mul_ps(x2, z), yz = _mm_mul_ps(y2, z);
+			const __m128 wx = _mm_mul_ps(x2, w), wy = _mm_mul_ps(y2, w), wz = _mm_mul_ps(z2, w);
+
+			__m128 r00 = _mm_sub_ps(_mm_sub_ps(one, yy), zz), r01 = _mm_sub_ps(xy, wz), r02 = _mm_add_ps(xz, wy), r03 = _mm_setzero_ps();
+			__m128 r10 = _mm_add_ps(xy, wz), r11 = _mm_sub_ps(_mm_sub_ps(one, xx), zz), r12 = _mm_sub_ps(yz, wx), r13 = _mm_setzero_ps();
+			__m128 r20 = _mm_sub_ps(xz, wy), r21 = _mm_add_ps(yz, wx), r22 = _mm_sub_ps(_mm_sub_ps(one, yy), xx), r23 = _mm_setzero_ps();
+
+			// lane k of every element belongs to matrix k
+			_MM_TRANSPOSE4_PS(r00, r01, r02, r03);
+			_MM_TRANSPOSE4_PS(r10, r11, r12, r13);
+			_MM_TRANSPOSE4_PS(r20, r21, r22, r23);
+			const __m128 rows[4][3] = { { r00, r10, r20 }, { r01, r11, r21 }, { r02, r12, r22 }, { r03, r13, r23 } };
+			for (size_t k = 0; k < 4; ++k)
+			{
+				out[i + k].SimdRow[0] = rows[k][0];
+				out[i + k].SimdRow[1] = rows[k][1];
+				out[i + k].SimdRow[2] = rows[k][2];
+				out[i + k].SimdRow[3] = lastRow;
+			}
+		}
+		for (size_t i = simdCount; i < count; ++i)
+			QuaternionToMatrixScalar(in[i], out[i]);
+	}
+
+	#undef SIMD_SHUFFLE
+#endif
+}
+
+//------------------------------------------------------------------------------
+void Poly::TransformPoints(const Matrix& transform, const Vector3f* in, Vector3f* out, size_t count)
+{
+#if !DISABLE_SIMD
+	if (GetSimdInstructionSet() != eSimdInstructionSet::NONE)
+		return TransformSSE(transform, in, out, count, 1.f);
+#endif
+	TransformScalar(transform, in, out, count, 1.f);
+}
+
+//------------------------------------------------------------------------------
+void Poly::TransformDirections(const Matrix& transform, const Vector3f* in, Vector3f* out, size_t count)
+{
+#if !DISABLE_SIMD
+	if (GetSimdInstructionSet() != eSimdInstructionSet::NONE)
+		return TransformSSE(transform, in, out, count, 0.f);
+#endif
+	TransformScalar(transform, in, out, count, 0.f);
+}
+
+//------------------------------------------------------------------------------
+void Poly::MultiplyMatrices(const Matrix* lhs, const Matrix* rhs, Matrix* out, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		Matrix::Multiply(lhs[i], rhs[i], out[i]);
+}
+
+//------------------------------------------------------------------------------
+void Poly::MultiplyMatrices(const Matrix& lhs, const Matrix* rhs, Matrix* out, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		Matrix::Multiply(lhs, rhs[i], out[i]);
+}
+
+//------------------------------------------------------------------------------
+void Poly::QuaternionsToMatrices(const Quaternion* in, Matrix* out, size_t count)
+{
+#if !DISABLE_SIMD
+	if (GetSimdInstructionSet() != eSimdInstructionSet::NONE)
+		return QuaternionsToMatricesSSE(in, out, count);
+#endif
+	for (size_t i = 0; i < count; ++i)
+		QuaternionToMatrixScalar(in[i], out[i]);
+}
+
+//------------------------------------------------------------------------------
+void Poly::CalculateBounds(const Vector3f* in, size_t count, Vector3f& min, Vector3f& max)
+{
+	ASSERTE(count > 0, "Bounds of empty set are undefined");
+	size_t i = 0;
+#if !DISABLE_SIMD
+	if (GetSimdInstructionSet() != eSimdInstructionSet::NONE && count >= 4)
+	{
+		// 3 registers hold 4 packed vectors, per lane min/max keeps axes apart
+		const float* src = &in[0].X;
+		__m128 minA = _mm_loadu_ps(src), minB = _mm_loadu_ps(src + 4), minC = _mm_loadu_ps(src + 8);
+		__m128 maxA = minA, maxB = minB, maxC = minC;
+		const size_t simdCount = count & ~size_t(3);
+		for (i = 4; i < simdCount; i += 4)
+		{
+			src = &in[i].X;
+			const __m128 a = _mm_loadu_ps(src), b = _mm_loadu_ps(src + 4), c = _mm_loadu_ps(src + 8);
+			minA = _mm_min_ps(minA, a); minB = _mm_min_ps(minB, b); minC = _mm_min_ps(minC, c);
+			maxA = _mm_max_ps(maxA, a); maxB = _mm_max_ps(maxB, b); maxC = _mm_max_ps(maxC, c);
+		}
+
+		alignas(16) float lanes[12];
+		_mm_store_ps(lanes, minA); _mm_store_ps(lanes + 4, minB); _mm_store_ps(lanes + 8, minC);
+		min.X = lanes[0]; min.Y = lanes[1]; min.Z = lanes[2];
+		for (size_t k = 1; k < 4; ++k)
+		{
+			min.X = std::min(min.X, lanes[3 * k]);
+			min.Y = std::min(min.Y, lanes[3 * k + 1]);
+			min.Z = std::min(min.Z, lanes[3 * k + 2]);
+		}
+		_mm_store_ps(lanes, maxA); _mm_store_ps(lanes + 4, maxB); _mm_store_ps(lanes + 8, maxC);
+		max.X = lanes[0]; max.Y = lanes[1]; max.Z = lanes[2];
+		for (size_t k = 1; k < 4; ++k)
+		{
+			max.X = std::max(max.X, lanes[3 * k]);
+			max.Y = std::max(max.Y, lanes[3 * k + 1]);
+			max.Z = std::max(max.Z, lanes[3 * k + 2]);
+		}
+	}
+	else
+#endif
+	{
+		min.X = max.X = in[0].X;
+		min.Y = max.Y = in[0].Y;
+		min.Z = max.Z = in[0].Z;
+		i = 1;
+	}
+
+	for (; i < count; ++i)
+	{
+		min.X = std::min(min.X, in[i].X); min.Y = std::min(min.Y, in[i].Y); min.Z = std::min(min.Z, in[i].Z);
+		max.X = std::max(max.X, in[i].X); max.Y = std::max(max.Y, in[i].Y); max.Z = std::max(max.Z, in[i].Z);
+	}
+}
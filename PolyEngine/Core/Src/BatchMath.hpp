@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "Vector3f.hpp"
+#include "Matrix.hpp"
+#include "Quaternion.hpp"
+
+namespace Poly
+{
+	// Batch versions of single value math operations. They process arrays in groups of 4 elements (structure of arrays in SIMD registers),
+	// the remainder is processed one by one. Input and output arrays may be the same but must not partially overlap.
+	// Kernels are chosen at runtime, see GetSimdInstructionSet().
+
+	/// <summary>Transforms positions (w = 1) by given matrix, perspective division is not performed.</summary>
+	/// <param name="transform">Affine transformation.</param>
+	/// <param name="in">Array of count positions.</param>
+	/// <param name="out">Array of count transformed positions.</param>
+	/// <param name="count">Number of positions.</param>
+	CORE_DLLEXPORT void TransformPoints(const Matrix& transform, const Vector3f* in, Vector3f* out, size_t count);
+
+	/// <summary>Transforms directions (w = 0) by given matrix, translation is ignored.</summary>
+	/// <param name="transform">Affine transformation.</param>
+	/// <param name="in">Array of count directions.</param>
+	/// <param name="out">Array of count transformed directions.</param>
+	/// <param name="count">Number of directions.</param>
+	CORE_DLLEXPORT void TransformDirections(const Matrix& transform, const Vector3f* in, Vector3f* out, size_t count);
+
+	/// <summary>Multiplies matrices pairwise, out[i] = lhs[i] * rhs[i]. Out must not overlap lhs or rhs.</summary>
+	CORE_DLLEXPORT void MultiplyMatrices(const Matrix* lhs, const Matrix* rhs, Matrix* out, size_t count);
+
+	/// <summary>Multiplies every matrix by common lhs matrix, out[i] = lhs * rhs[i] (f.ex. view-projection by model matrices).
+	/// Out must not overlap lhs or rhs.</summary>
+	CORE_DLLEXPORT void MultiplyMatrices(const Matrix& lhs, const Matrix* rhs, Matrix* out, size_t count);
+
+	/// <summary>Converts unit quaternions to rotation matrices, out[i] = in[i].ToRotationMatrix().</summary>
+	CORE_DLLEXPORT void QuaternionsToMatrices(const Quaternion* in, Matrix* out, size_t count);
+
+	/// <summary>Calculates per axis minimum and maximum of given positions (bounds of axis aligned box containing them).</summary>
+	/// <param name="in">Array of count positions, count has to be greater than 0.</param>
+	/// <param name="count">Number of positions.</param>
+	/// <param name="min">Set to per axis minimum.</param>
+	/// <param name="max">Set to per axis maximum.</param>
+	CORE_DLLEXPORT void CalculateBounds(const Vector3f* in, size_t count, Vector3f& min, Vector3f& max);
+}
@@ -13,10 +13,13 @@
 #include "Matrix.hpp"
 #include "Quaternion.hpp"
 #include "SimdMath.hpp"
+#include "BatchMath.hpp"
 
 // Geometry
 #include "AABox.hpp"
 #include "AARect.hpp"
+#include "Frustum.hpp"
+#include "AABoxTree.hpp"
 
 // Memory
 #include "BaseObject.hpp"
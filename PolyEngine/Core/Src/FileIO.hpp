@@ -107,4 +107,20 @@ namespace Poly {
 		else
 			throw FileIOException(path);
 	}
+
+	//------------------------------------------------------------------------------
+	inline void SaveBinaryFile(const String& path, const void* data, size_t size)
+	{
+		FILE* f;
+		fopen_s(&f, path.GetCStr(), "wb");
+		if (f)
+		{
+			const size_t written = fwrite(data, 1, size, f);
+			fclose(f);
+			if (written != size)
+				throw FileIOException("File save failed");
+		}
+		else
+			throw FileIOException("File save failed");
+	}
 }
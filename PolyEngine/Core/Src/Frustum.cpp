@@ -0,0 +1,51 @@
+#include "CorePCH.hpp"
+
+#include "Frustum.hpp"
+
+using namespace Poly;
+
+//------------------------------------------------------------------------------
+Frustum::Frustum(const Matrix& viewProjection)
+{
+	// Gribb-Hartmann: every clip space plane is a sum or difference of the last row and one of the others
+	const Matrix& m = viewProjection;
+	Planes[static_cast<int>(ePlane::LEFT)] = Vector(m.m30 + m.m00, m.m31 + m.m01, m.m32 + m.m02, m.m33 + m.m03);
+	Planes[static_cast<int>(ePlane::RIGHT)] = Vector(m.m30 - m.m00, m.m31 - m.m01, m.m32 - m.m02, m.m33 - m.m03);
+	Planes[static_cast<int>(ePlane::BOTTOM)] = Vector(m.m30 + m.m10, m.m31 + m.m11, m.m32 + m.m12, m.m33 + m.m13);
+	Planes[static_cast<int>(ePlane::TOP)] = Vector(m.m30 - m.m10, m.m31 - m.m11, m.m32 - m.m12, m.m33 - m.m13);
+	Planes[static_cast<int>(ePlane::ZNEAR)] = Vector(m.m30 + m.m20, m.m31 + m.m21, m.m32 + m.m22, m.m33 + m.m23);
+	Planes[static_cast<int>(ePlane::ZFAR)] = Vector(m.m30 - m.m20, m.m31 - m.m21, m.m32 - m.m22, m.m33 - m.m23);
+
+	// normalized planes give real distances, needed by sphere test
+	for (Vector& plane : Planes)
+	{
+		const float length = std::sqrt(plane.X * plane.X + plane.Y * plane.Y + plane.Z * plane.Z);
+		HEAVY_ASSERTE(length > 0, "Degenerated frustum plane");
+		const float invLength = 1.0f / length;
+		plane = Vector(plane.X * invLength, plane.Y * invLength, plane.Z * invLength, plane.W * invLength);
+	}
+}
+
+//------------------------------------------------------------------------------
+bool Frustum::IsSphereVisible(const Vector& center, float radius) const
+{
+	for (const Vector& plane : Planes)
+	{
+		if (plane.X * center.X + plane.Y * center.Y + plane.Z * center.Z + plane.W < -radius)
+			return false;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool Frustum::IsBoxVisible(const Vector& center, const Vector& halfSize) const
+{
+	for (const Vector& plane : Planes)
+	{
+		// projected extent of the box on the plane normal
+		const float radius = std::abs(plane.X) * halfSize.X + std::abs(plane.Y) * halfSize.Y + std::abs(plane.Z) * halfSize.Z;
+		if (plane.X * center.X + plane.Y * center.Y + plane.Z * center.Z + plane.W < -radius)
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "Vector.hpp"
+#include "Matrix.hpp"
+#include "AABox.hpp"
+
+namespace Poly {
+
+	/// <summary>Class representing view frustum as 6 planes, used for visibility tests.</summary>
+	class CORE_DLLEXPORT Frustum : public BaseObject<>
+	{
+	public:
+		// near and far are not used as names, windows headers define them as macros
+		enum class ePlane { LEFT, RIGHT, BOTTOM, TOP, ZNEAR, ZFAR, _COUNT };
+
+		/// <summary>Extracts frustum planes from a view-projection matrix (f.ex. CameraComponent::GetMVP()).
+		/// Volumes passed to visibility tests are in the space transformed by the matrix (world space for view-projection).</summary>
+		/// <param name="viewProjection">Matrix transforming to OpenGL clip space.</param>
+		explicit Frustum(const Matrix& viewProjection);
+
+		/// <summary>Returns plane with normal pointing inside the frustum, W component stores plane distance.</summary>
+		/// <param name="plane">Plane to return.</param>
+		const Vector& GetPlane(ePlane plane) const { return Planes[static_cast<int>(plane)]; }
+
+		/// <summary>Checks whether sphere is at least partially inside the frustum.</summary>
+		/// <param name="center">Center of the sphere.</param>
+		/// <param name="radius">Radius of the sphere.</param>
+		bool IsSphereVisible(const Vector& center, float radius) const;
+
+		/// <summary>Checks whether axis aligned box is at least partially inside the frustum.
+		/// Test is conservative, boxes near frustum corners may be reported visible.</summary>
+		/// <param name="center">Center of the box.</param>
+		/// <param name="halfSize">Half of the size of the box in each of the dimensions.</param>
+		bool IsBoxVisible(const Vector& center, const Vector& halfSize) const;
+
+		/// <summary>Checks whether axis aligned box is at least partially inside the frustum.</summary>
+		/// <param name="box">Box to be checked.</param>
+		/// <see cref="Frustum.IsBoxVisible()"/>
+		bool IsBoxVisible(const AABox& box) const { return IsBoxVisible(box.GetCenter(), box.GetSize() * 0.5f); }
+
+	private:
+		static constexpr int PLANE_COUNT = static_cast<int>(ePlane::_COUNT);
+		Vector Planes[PLANE_COUNT];
+	};
+}
@@ -3,47 +3,80 @@
 #include "Defines.hpp"
 #include "Allocator.hpp"
 
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
 namespace Poly {
 
+	namespace Impl
+	{
+		constexpr size_t OCCUPANCY_WORD_BITS = 64;
+
+		/// <summary>Returns index of the lowest set bit. Word cannot be 0.</summary>
+		inline size_t LowestSetBit(u64 word)
+		{
+			HEAVY_ASSERTE(word != 0, "Bit scan on empty word");
+#if defined(_MSC_VER)
+			unsigned long idx;
+			_BitScanForward64(&idx, word);
+			return idx;
+#else
+			return static_cast<size_t>(__builtin_ctzll(word));
+#endif
+		}
+
+		/// <summary>Returns index of the highest set bit. Word cannot be 0.</summary>
+		inline size_t HighestSetBit(u64 word)
+		{
+			HEAVY_ASSERTE(word != 0, "Bit scan on empty word");
+#if defined(_MSC_VER)
+			unsigned long idx;
+			_BitScanReverse64(&idx, word);
+			return idx;
+#else
+			return OCCUPANCY_WORD_BITS - 1 - static_cast<size_t>(__builtin_clzll(word));
+#endif
+		}
+	}
+
 	class IterablePoolAllocatorBase : public BaseObject<>
 	{
 	public:
 		virtual void Free(void* ptr) = 0;
 	};
 
-	/// <summary>Fast pool allocator, that enables iteration.</summary>
+	/// <summary>Fast pool allocator, that enables iteration.
+	/// Allocation and freeing are O(1): free cells form an intrusive singly linked list (like in PoolAllocator)
+	/// and live cells are tracked in an occupancy bitmap, which is scanned word by word during iteration.
+	/// Iteration always visits objects in ascending address order.</summary>
 	template<typename T>
 	class IterablePoolAllocator : public IterablePoolAllocatorBase
 	{
-		struct Cell
-		{
-			char Data[sizeof(T)];
-			Cell* Prev = nullptr;
-			Cell* Next = nullptr;
-		};
-
 		STATIC_ASSERTE(sizeof(T) >= sizeof(size_t), "Type size is too small for allocator");
-		STATIC_ASSERTE(offsetof(Cell, Data) == 0, "Data has to be the first member of Cell struct. It must have no offset.");
 	public:
 		//------------------------------------------------------------------------------
 		class Iterator : public BaseObject<>, public std::iterator<std::bidirectional_iterator_tag, T>
 		{
 		public:
-			bool operator==(const Iterator& rhs) const { return CurrentCell == rhs.CurrentCell; }
+			Iterator() = default;
+
+			bool operator==(const Iterator& rhs) const { return Index == rhs.Index && Allocator == rhs.Allocator; }
 			bool operator!=(const Iterator& rhs) const { return !(*this == rhs); }
 
-			T& operator*() const { return *reinterpret_cast<T*>(CurrentCell->Data); }
-			T* operator->() const { return reinterpret_cast<T*>(CurrentCell->Data); }
+			T& operator*() const { return *Allocator->AddrFromIndex(Index); }
+			T* operator->() const { return Allocator->AddrFromIndex(Index); }
 
-			Iterator& operator++() { CurrentCell = CurrentCell->Next; return *this; }
-			Iterator operator++(int) { Iterator ret(CurrentCell); CurrentCell = CurrentCell->Next; return ret; }
-			Iterator& operator--() { CurrentCell = CurrentCell->Prev; return *this; }
-			Iterator operator--(int) { Iterator ret(CurrentCell); CurrentCell = CurrentCell->Prev; return ret; }
+			Iterator& operator++() { Index = Allocator->NextOccupied(Index + 1); return *this; }
+			Iterator operator++(int) { Iterator ret(Allocator, Index); ++(*this); return ret; }
+			Iterator& operator--() { Index = Allocator->PrevOccupied(Index); return *this; }
+			Iterator operator--(int) { Iterator ret(Allocator, Index); --(*this); return ret; }
 
 		private:
-			explicit Iterator(Cell* cell) : CurrentCell(cell) {}
+			Iterator(const IterablePoolAllocator* allocator, size_t index) : Allocator(allocator), Index(index) {}
 
-			Cell* CurrentCell = nullptr;
+			const IterablePoolAllocator* Allocator = nullptr;
+			size_t Index = 0;
 			friend class IterablePoolAllocator;
 		};
 
@@ -51,43 +84,43 @@ namespace Poly {
 		class ConstIterator : public BaseObject<>, public std::iterator<std::bidirectional_iterator_tag, T>
 		{
 		public:
-			bool operator==(const ConstIterator& rhs) const { return CurrentCell == rhs.CurrentCell; }
+			ConstIterator() = default;
+
+			bool operator==(const ConstIterator& rhs) const { return Index == rhs.Index && Allocator == rhs.Allocator; }
 			bool operator!=(const ConstIterator& rhs) const { return !(*this == rhs); }
 
-			const T& operator*() const { return *reinterpret_cast<T*>(CurrentCell->Data); }
-			const T* operator->() const { return reinterpret_cast<T*>(CurrentCell->Data); }
+			const T& operator*() const { return *Allocator->AddrFromIndex(Index); }
+			const T* operator->() const { return Allocator->AddrFromIndex(Index); }
 
-			ConstIterator& operator++() { CurrentCell = CurrentCell->Next; return *this; }
-			ConstIterator operator++(int) { ConstIterator ret(CurrentCell); CurrentCell = CurrentCell->Next; return ret; }
-			ConstIterator& operator--() { CurrentCell = CurrentCell->Prev; return *this; }
-			ConstIterator operator--(int) { ConstIterator ret(CurrentCell); CurrentCell = CurrentCell->Prev; return ret; }
+			ConstIterator& operator++() { Index = Allocator->NextOccupied(Index + 1); return *this; }
+			ConstIterator operator++(int) { ConstIterator ret(Allocator, Index); ++(*this); return ret; }
+			ConstIterator& operator--() { Index = Allocator->PrevOccupied(Index); return *this; }
+			ConstIterator operator--(int) { ConstIterator ret(Allocator, Index); --(*this); return ret; }
 
 		private:
-			explicit ConstIterator(Cell* cell) : CurrentCell(cell) {}
+			ConstIterator(const IterablePoolAllocator* allocator, size_t index) : Allocator(allocator), Index(index) {}
 
-			Cell* CurrentCell = nullptr;
+			const IterablePoolAllocator* Allocator = nullptr;
+			size_t Index = 0;
 			friend class IterablePoolAllocator;
 		};
 
 		//------------------------------------------------------------------------------
-		Iterator Begin() { return Iterator(Head); }
-		Iterator End() { return Iterator(Tail); }
-		ConstIterator Begin() const { return ConstIterator(Head); }
-		ConstIterator End() const { return ConstIterator(Tail); }
+		Iterator Begin() { return Iterator(this, NextOccupied(0)); }
+		Iterator End() { return Iterator(this, Capacity); }
+		ConstIterator Begin() const { return ConstIterator(this, NextOccupied(0)); }
+		ConstIterator End() const { return ConstIterator(this, Capacity); }
 
 		/// <summary>Constuctor that allocates memory for provided amount of objects. </summary>
 		/// <param name="count"></param>
 		explicit IterablePoolAllocator(size_t count)
-			: Capacity(count), FreeBlockCount(count)
+			: Capacity(count), FreeBlockCount(count), OccupancyWordCount((count + Impl::OCCUPANCY_WORD_BITS - 1) / Impl::OCCUPANCY_WORD_BITS)
 		{
 			ASSERTE(count > 0, "Cell count cannot be lower than 1.");
-			Data = Allocate<Cell>(Capacity + 1);
+			Data = Allocate<T>(Capacity);
+			Occupancy = Allocate<u64>(OccupancyWordCount);
+			memset(Occupancy, 0, sizeof(u64) * OccupancyWordCount);
 			NextFree = Data;
-			Head = Tail = Data + Capacity; // Head and tail point to the last element from pool which is reserved for linked list.
-			Head->Next = nullptr; // Reset next and prev pointers
-			Tail->Prev = nullptr;
-			NextFree->Next = nullptr;
-			NextFree->Prev = nullptr;
 		}
 
 		//------------------------------------------------------------------------------
@@ -95,7 +128,9 @@ namespace Poly {
 		{
 			ASSERTE(Data, "Allocator is invalid");
 			Deallocate(Data);
+			Deallocate(Occupancy);
 			Data = nullptr;
+			Occupancy = nullptr;
 		}
 
 		/// <summary>Allocation method</summary>
@@ -109,57 +144,21 @@ namespace Poly {
 				*p = ++InitializedBlockCount;
 			}
 
-			// find first suitable place for data
 			if (FreeBlockCount > 0)
 			{
-				Cell* ret = NextFree;
-
-				// setup linked list
-				if (Tail->Prev != nullptr) { // list is not empty
-					if (ret > Head) {
-
-						Cell* prev = Head;
-						while (prev->Next && prev->Next < ret)
-							prev = prev->Next;
-
-						//Cell* prev = ret - 1;
-						HEAVY_ASSERTE(prev->Next != nullptr, "prev is null");
-
-						ret->Prev = prev;
-						ret->Next = prev->Next;
-						prev->Next->Prev = ret;
-						prev->Next = ret;
-					}
-					else // Corner case when we're placing new element at first position
-					{
-						ret->Prev = nullptr;
-						ret->Next = Head;
-						Head->Prev = ret;
-						Head = ret;
-					}
-				}
-				else // list is empty
-				{
-					ret->Prev = nullptr;
-					ret->Next = Tail;
-					Tail->Prev = ret;
-					Head = ret;
-				}
+				T* ret = NextFree;
+				const size_t idx = IndexFromAddr(ret);
+				HEAVY_ASSERTE(!IsOccupied(idx), "Free list points to an occupied cell");
+				Occupancy[idx / Impl::OCCUPANCY_WORD_BITS] |= (u64(1) << (idx % Impl::OCCUPANCY_WORD_BITS));
 
 				// Update the Next node value.
 				--FreeBlockCount;
 				if (FreeBlockCount != 0)
-				{
 					NextFree = AddrFromIndex(*reinterpret_cast<size_t*>(NextFree));
-					NextFree->Next = nullptr;
-					NextFree->Prev = nullptr;
-				}
 				else
-				{
 					NextFree = nullptr;
-				}
 
-				return reinterpret_cast<T*>(ret->Data);
+				return ret;
 			}
 			return nullptr;
 		}
@@ -171,40 +170,13 @@ namespace Poly {
 		/// <param name="p">Pointer to memory to free.</param>
 		void Free(T* p)
 		{
-			// get cell addr
-			Cell* cell = reinterpret_cast<Cell*>(p);
-
-			// keep the linked list valid
-			if (Head == cell)
-			{
-				Head = cell->Next;
-				Head->Prev = nullptr;
-			}
-			else
-			{
-				Cell* prev = cell->Prev;
-				prev->Next = cell->Next;
-				cell->Next->Prev = prev;
-			}
-
-			cell->Next = nullptr;
-			cell->Prev = nullptr;
+			const size_t idx = IndexFromAddr(p);
+			HEAVY_ASSERTE(idx < Capacity && IsOccupied(idx), "Freeing memory that was not allocated by this allocator");
+			Occupancy[idx / Impl::OCCUPANCY_WORD_BITS] &= ~(u64(1) << (idx % Impl::OCCUPANCY_WORD_BITS));
 
 			// Calculate the value of Next
-			if (NextFree != nullptr)
-			{
-				*reinterpret_cast<size_t*>(p) = IndexFromAddr(NextFree);
-				NextFree = cell;
-				NextFree->Next = nullptr;
-				NextFree->Prev = nullptr;
-			}
-			else
-			{
-				*reinterpret_cast<size_t*>(p) = Capacity;
-				NextFree = cell;
-				NextFree->Next = nullptr;
-				NextFree->Prev = nullptr;
-			}
+			*reinterpret_cast<size_t*>(p) = NextFree != nullptr ? IndexFromAddr(NextFree) : Capacity;
+			NextFree = p;
 			++FreeBlockCount;
 		}
 
@@ -213,16 +185,53 @@ namespace Poly {
 		size_t GetSize() const { return Capacity - FreeBlockCount; }
 
 	private:
-		Cell* AddrFromIndex(size_t i) const { return Data + i; }
-		size_t IndexFromAddr(const Cell* p) const { return p - Data; }
+		T* AddrFromIndex(size_t i) const { return Data + i; }
+		size_t IndexFromAddr(const T* p) const { return p - Data; }
+
+		bool IsOccupied(size_t i) const { return (Occupancy[i / Impl::OCCUPANCY_WORD_BITS] >> (i % Impl::OCCUPANCY_WORD_BITS)) & 1; }
+
+		/// <summary>Finds first occupied cell with index greater or equal to i.</summary>
+		/// <returns>Index of the cell or Capacity if there is none.</returns>
+		size_t NextOccupied(size_t i) const
+		{
+			if (i >= Capacity)
+				return Capacity;
+
+			size_t wordIdx = i / Impl::OCCUPANCY_WORD_BITS;
+			u64 word = Occupancy[wordIdx] & (~u64(0) << (i % Impl::OCCUPANCY_WORD_BITS));
+			while (word == 0)
+			{
+				if (++wordIdx == OccupancyWordCount)
+					return Capacity;
+				word = Occupancy[wordIdx];
+			}
+			return wordIdx * Impl::OCCUPANCY_WORD_BITS + Impl::LowestSetBit(word);
+		}
+
+		/// <summary>Finds last occupied cell with index lower than i.</summary>
+		/// <returns>Index of the cell. Cell has to exist.</returns>
+		size_t PrevOccupied(size_t i) const
+		{
+			HEAVY_ASSERTE(i > 0, "Decrementing begin iterator");
+			--i;
+			size_t wordIdx = i / Impl::OCCUPANCY_WORD_BITS;
+			const size_t bit = i % Impl::OCCUPANCY_WORD_BITS;
+			u64 word = Occupancy[wordIdx] & (bit == Impl::OCCUPANCY_WORD_BITS - 1 ? ~u64(0) : ((u64(1) << (bit + 1)) - 1));
+			while (word == 0)
+			{
+				HEAVY_ASSERTE(wordIdx > 0, "Decrementing begin iterator");
+				word = Occupancy[--wordIdx];
+			}
+			return wordIdx * Impl::OCCUPANCY_WORD_BITS + Impl::HighestSetBit(word);
+		}
 
 		const size_t Capacity = 0;
 		size_t FreeBlockCount = 0;
 		size_t InitializedBlockCount = 0;
-		Cell* Data = nullptr;
-		Cell* NextFree = nullptr;
-		Cell* Head = nullptr;
-		Cell* Tail = nullptr;
+		const size_t OccupancyWordCount = 0;
+		T* Data = nullptr;
+		T* NextFree = nullptr;
+		u64* Occupancy = nullptr;
 	};
 
 	// std library for each enablers
@@ -3,6 +3,7 @@
 #include "Defines.hpp"
 #include "EnumUtils.hpp"
 #include "OutputStream.hpp"
+#include <mutex>
 #include <streambuf>
 
 namespace Poly 
@@ -53,6 +54,10 @@ namespace Poly
 			stream << std::endl;
 	}
 
+	/**
+	*  Logging console, safe to use from multiple threads, f.ex. by resources decoded on loader threads.
+	*  Each message is written as a whole, messages of different threads are not interleaved.
+	*/
 	class CORE_DLLEXPORT Console : public BaseObject<> 
 	{
 	public:
@@ -63,6 +68,7 @@ namespace Poly
 		{
 			constexpr bool isStream = std::is_base_of<OutputStream, S>::value; // Strange workaround to STATIC_ASSERTE macro on MSVC
 			STATIC_ASSERTE(isStream, "Provided value is not stream!");
+			std::lock_guard<std::mutex> lock(Mutex);
 			if (CurrentStream)
 				CurrentStream->OnUnregister();
 			CurrentStream = std::make_unique<S>(std::forward<Args>(args)...);
@@ -71,6 +77,7 @@ namespace Poly
 		
 		void RegisterDefaultStream()
 		{
+			std::lock_guard<std::mutex> lock(Mutex);
 			if (CurrentStream)
 				CurrentStream->OnUnregister();
 			CurrentStream = nullptr;
@@ -118,9 +125,14 @@ namespace Poly
 		void LogImpl(eLogLevel level, const std::string& levelStr, const std::string& fmt,
 			Args&&... args) {
 			if (level >= LOG_LEVEL_FILTER)
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
 				sprint(*Ostream, level, "[" + levelStr + "] " + fmt, args...);
+			}
 		}
 
+		// guards the streams, output of a message and stream registration
+		std::mutex Mutex;
 		std::unique_ptr<OutputStream> CurrentStream;
 		std::unique_ptr<std::ostream> Ostream;
 	};
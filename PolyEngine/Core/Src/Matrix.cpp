@@ -2,8 +2,324 @@
 
 #include "Matrix.hpp"
 
+#if !DISABLE_SIMD
+	#include <immintrin.h>
+#endif
+
 using namespace Poly;
 
+namespace
+{
+//------------------------------------------------------------------------------
+void MultiplyScalar(const Matrix& a, const Matrix& b, Matrix& out) {
+  for(int row=0; row<4; ++row) {
+    for(int col=0; col<4; ++col) {
+      out.Data[4*row + col] = a.Data[4*row]*b.Data[col] + a.Data[4*row + 1]*b.Data[4 + col] + a.Data[4*row +2]*b.Data[8 + col] + a.Data[4*row + 3]*b.Data[12 + col] ;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void InverseScalar(const Matrix& m, Matrix& out) {
+  out.Data[0] = m.Data[5]  * m.Data[10] * m.Data[15] -
+  m.Data[5]  * m.Data[11] * m.Data[14] -
+  m.Data[9]  * m.Data[6]  * m.Data[15] +
+  m.Data[9]  * m.Data[7]  * m.Data[14] +
+  m.Data[13] * m.Data[6]  * m.Data[11] -
+  m.Data[13] * m.Data[7]  * m.Data[10];
+
+  out.Data[4] = -m.Data[4]  * m.Data[10] * m.Data[15] +
+  m.Data[4]  * m.Data[11] * m.Data[14] +
+  m.Data[8]  * m.Data[6]  * m.Data[15] -
+  m.Data[8]  * m.Data[7]  * m.Data[14] -
+  m.Data[12] * m.Data[6]  * m.Data[11] +
+  m.Data[12] * m.Data[7]  * m.Data[10];
+
+  out.Data[8] = m.Data[4]  * m.Data[9] * m.Data[15] -
+  m.Data[4]  * m.Data[11] * m.Data[13] -
+  m.Data[8]  * m.Data[5] * m.Data[15] +
+  m.Data[8]  * m.Data[7] * m.Data[13] +
+  m.Data[12] * m.Data[5] * m.Data[11] -
+  m.Data[12] * m.Data[7] * m.Data[9];
+
+  out.Data[12] = -m.Data[4]  * m.Data[9] * m.Data[14] +
+  m.Data[4]  * m.Data[10] * m.Data[13] +
+  m.Data[8]  * m.Data[5] * m.Data[14] -
+  m.Data[8]  * m.Data[6] * m.Data[13] -
+  m.Data[12] * m.Data[5] * m.Data[10] +
+  m.Data[12] * m.Data[6] * m.Data[9];
+
+  out.Data[1] = -m.Data[1]  * m.Data[10] * m.Data[15] +
+  m.Data[1]  * m.Data[11] * m.Data[14] +
+  m.Data[9]  * m.Data[2] * m.Data[15] -
+  m.Data[9]  * m.Data[3] * m.Data[14] -
+  m.Data[13] * m.Data[2] * m.Data[11] +
+  m.Data[13] * m.Data[3] * m.Data[10];
+
+  out.Data[5] = m.Data[0]  * m.Data[10] * m.Data[15] -
+  m.Data[0]  * m.Data[11] * m.Data[14] -
+  m.Data[8]  * m.Data[2] * m.Data[15] +
+  m.Data[8]  * m.Data[3] * m.Data[14] +
+  m.Data[12] * m.Data[2] * m.Data[11] -
+  m.Data[12] * m.Data[3] * m.Data[10];
+
+  out.Data[9] = -m.Data[0]  * m.Data[9] * m.Data[15] +
+  m.Data[0]  * m.Data[11] * m.Data[13] +
+  m.Data[8]  * m.Data[1] * m.Data[15] -
+  m.Data[8]  * m.Data[3] * m.Data[13] -
+  m.Data[12] * m.Data[1] * m.Data[11] +
+  m.Data[12] * m.Data[3] * m.Data[9];
+
+  out.Data[13] = m.Data[0]  * m.Data[9] * m.Data[14] -
+  m.Data[0]  * m.Data[10] * m.Data[13] -
+  m.Data[8]  * m.Data[1] * m.Data[14] +
+  m.Data[8]  * m.Data[2] * m.Data[13] +
+  m.Data[12] * m.Data[1] * m.Data[10] -
+  m.Data[12] * m.Data[2] * m.Data[9];
+
+  out.Data[2] = m.Data[1]  * m.Data[6] * m.Data[15] -
+  m.Data[1]  * m.Data[7] * m.Data[14] -
+  m.Data[5]  * m.Data[2] * m.Data[15] +
+  m.Data[5]  * m.Data[3] * m.Data[14] +
+  m.Data[13] * m.Data[2] * m.Data[7] -
+  m.Data[13] * m.Data[3] * m.Data[6];
+
+  out.Data[6] = -m.Data[0]  * m.Data[6] * m.Data[15] +
+  m.Data[0]  * m.Data[7] * m.Data[14] +
+  m.Data[4]  * m.Data[2] * m.Data[15] -
+  m.Data[4]  * m.Data[3] * m.Data[14] -
+  m.Data[12] * m.Data[2] * m.Data[7] +
+  m.Data[12] * m.Data[3] * m.Data[6];
+
+  out.Data[10] = m.Data[0]  * m.Data[5] * m.Data[15] -
+  m.Data[0]  * m.Data[7] * m.Data[13] -
+  m.Data[4]  * m.Data[1] * m.Data[15] +
+  m.Data[4]  * m.Data[3] * m.Data[13] +
+  m.Data[12] * m.Data[1] * m.Data[7] -
+  m.Data[12] * m.Data[3] * m.Data[5];
+
+  out.Data[14] = -m.Data[0]  * m.Data[5] * m.Data[14] +
+  m.Data[0]  * m.Data[6] * m.Data[13] +
+  m.Data[4]  * m.Data[1] * m.Data[14] -
+  m.Data[4]  * m.Data[2] * m.Data[13] -
+  m.Data[12] * m.Data[1] * m.Data[6] +
+  m.Data[12] * m.Data[2] * m.Data[5];
+
+  out.Data[3] = -m.Data[1] * m.Data[6] * m.Data[11] +
+  m.Data[1] * m.Data[7] * m.Data[10] +
+  m.Data[5] * m.Data[2] * m.Data[11] -
+  m.Data[5] * m.Data[3] * m.Data[10] -
+  m.Data[9] * m.Data[2] * m.Data[7] +
+  m.Data[9] * m.Data[3] * m.Data[6];
+
+  out.Data[7] = m.Data[0] * m.Data[6] * m.Data[11] -
+  m.Data[0] * m.Data[7] * m.Data[10] -
+  m.Data[4] * m.Data[2] * m.Data[11] +
+  m.Data[4] * m.Data[3] * m.Data[10] +
+  m.Data[8] * m.Data[2] * m.Data[7] -
+  m.Data[8] * m.Data[3] * m.Data[6];
+
+  out.Data[11] = -m.Data[0] * m.Data[5] * m.Data[11] +
+  m.Data[0] * m.Data[7] * m.Data[9] +
+  m.Data[4] * m.Data[1] * m.Data[11] -
+  m.Data[4] * m.Data[3] * m.Data[9] -
+  m.Data[8] * m.Data[1] * m.Data[7] +
+  m.Data[8] * m.Data[3] * m.Data[5];
+
+  out.Data[15] = m.Data[0] * m.Data[5] * m.Data[10] -
+  m.Data[0] * m.Data[6] * m.Data[9] -
+  m.Data[4] * m.Data[1] * m.Data[10] +
+  m.Data[4] * m.Data[2] * m.Data[9] +
+  m.Data[8] * m.Data[1] * m.Data[6] -
+  m.Data[8] * m.Data[2] * m.Data[5];
+
+  float det = m.Data[0] * out.Data[0] + m.Data[1] * out.Data[4] + m.Data[2] * out.Data[8] + m.Data[3] * out.Data[12];
+
+  HEAVY_ASSERTE(det != 0, "Determinant is equal to 0!");
+
+  float idet = 1.0f/det;
+  for(int i=0; i<16; ++i)
+    out.Data[i] *= idet;
+}
+
+//------------------------------------------------------------------------------
+void AffineInverseScalar(const Matrix& m, Matrix& out) {
+  // inverse of the upper 3x3 block is its adjugate divided by determinant
+  out.Data[0] = m.Data[5] * m.Data[10] - m.Data[6] * m.Data[9];
+  out.Data[1] = m.Data[2] * m.Data[9] - m.Data[1] * m.Data[10];
+  out.Data[2] = m.Data[1] * m.Data[6] - m.Data[2] * m.Data[5];
+  out.Data[4] = m.Data[6] * m.Data[8] - m.Data[4] * m.Data[10];
+  out.Data[5] = m.Data[0] * m.Data[10] - m.Data[2] * m.Data[8];
+  out.Data[6] = m.Data[2] * m.Data[4] - m.Data[0] * m.Data[6];
+  out.Data[8] = m.Data[4] * m.Data[9] - m.Data[5] * m.Data[8];
+  out.Data[9] = m.Data[1] * m.Data[8] - m.Data[0] * m.Data[9];
+  out.Data[10] = m.Data[0] * m.Data[5] - m.Data[1] * m.Data[4];
+
+  float det = m.Data[0] * out.Data[0] + m.Data[1] * out.Data[4] + m.Data[2] * out.Data[8];
+
+  HEAVY_ASSERTE(det != 0, "Determinant is equal to 0!");
+
+  float idet = 1.0f/det;
+  for(int row=0; row<3; ++row)
+    for(int col=0; col<3; ++col)
+      out.Data[4*row + col] *= idet;
+
+  // translation is transformed by the inverted 3x3 block
+  for(int row=0; row<3; ++row)
+    out.Data[4*row + 3] = -(out.Data[4*row]*m.Data[3] + out.Data[4*row + 1]*m.Data[7] + out.Data[4*row + 2]*m.Data[11]);
+
+  out.Data[12] = 0;
+  out.Data[13] = 0;
+  out.Data[14] = 0;
+  out.Data[15] = 1;
+}
+
+#if !DISABLE_SIMD
+#define SIMD_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+#define SIMD_SWIZZLE(a, x, y, z, w) _mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(a), _MM_SHUFFLE(w, z, y, x)))
+
+//------------------------------------------------------------------------------
+void MultiplySSE(const Matrix& a, const Matrix& b, Matrix& out) {
+  // every row of the result is a linear combination of rhs rows
+  for (int i = 0; i < 4; ++i) {
+    const __m128 row = a.SimdRow[i];
+    __m128 c = _mm_mul_ps(SIMD_SWIZZLE(row, 0, 0, 0, 0), b.SimdRow[0]);
+    c = _mm_add_ps(c, _mm_mul_ps(SIMD_SWIZZLE(row, 1, 1, 1, 1), b.SimdRow[1]));
+    c = _mm_add_ps(c, _mm_mul_ps(SIMD_SWIZZLE(row, 2, 2, 2, 2), b.SimdRow[2]));
+    c = _mm_add_ps(c, _mm_mul_ps(SIMD_SWIZZLE(row, 3, 3, 3, 3), b.SimdRow[3]));
+    out.SimdRow[i] = c;
+  }
+}
+
+//------------------------------------------------------------------------------
+SIMD_TARGET_AVX2 void MultiplyAVX2(const Matrix& a, const Matrix& b, Matrix& out) {
+  // two rows of the result at once, rhs rows are duplicated in both lanes
+  const __m256 b0 = _mm256_broadcast_ps(&b.SimdRow[0]);
+  const __m256 b1 = _mm256_broadcast_ps(&b.SimdRow[1]);
+  const __m256 b2 = _mm256_broadcast_ps(&b.SimdRow[2]);
+  const __m256 b3 = _mm256_broadcast_ps(&b.SimdRow[3]);
+  for (int i = 0; i < 4; i += 2) {
+    const __m256 rows = _mm256_loadu_ps(&a.Data[4*i]);
+    __m256 c = _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0x00), b0);
+    c = _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, 0x55), b1, c);
+    c = _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, 0xAA), b2, c);
+    c = _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, 0xFF), b3, c);
+    _mm256_storeu_ps(&out.Data[4*i], c);
+  }
+}
+
+// 2x2 matrices below are stored in a single register in row-major order
+//------------------------------------------------------------------------------
+inline __m128 Mat2Mul(__m128 a, __m128 b) {
+  return _mm_add_ps(_mm_mul_ps(a, SIMD_SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(SIMD_SWIZZLE(a, 1, 0, 3, 2), SIMD_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+//------------------------------------------------------------------------------
+inline __m128 Mat2AdjMul(__m128 a, __m128 b) {
+  return _mm_sub_ps(_mm_mul_ps(SIMD_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(SIMD_SWIZZLE(a, 1, 1, 2, 2), SIMD_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+//------------------------------------------------------------------------------
+inline __m128 Mat2MulAdj(__m128 a, __m128 b) {
+  return _mm_sub_ps(_mm_mul_ps(a, SIMD_SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(SIMD_SWIZZLE(a, 1, 0, 3, 2), SIMD_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+//------------------------------------------------------------------------------
+void InverseSSE(const Matrix& m, Matrix& out) {
+  // blockwise inversion, every block is a 2x2 matrix: | A B |
+  //                                                   | C D |
+  const __m128 A = _mm_movelh_ps(m.SimdRow[0], m.SimdRow[1]);
+  const __m128 B = _mm_movehl_ps(m.SimdRow[1], m.SimdRow[0]);
+  const __m128 C = _mm_movelh_ps(m.SimdRow[2], m.SimdRow[3]);
+  const __m128 D = _mm_movehl_ps(m.SimdRow[3], m.SimdRow[2]);
+
+  // determinants of blocks (|A| |B| |C| |D|)
+  const __m128 detSub = _mm_sub_ps(
+    _mm_mul_ps(SIMD_SHUFFLE(m.SimdRow[0], m.SimdRow[2], 0, 2, 0, 2), SIMD_SHUFFLE(m.SimdRow[1], m.SimdRow[3], 1, 3, 1, 3)),
+    _mm_mul_ps(SIMD_SHUFFLE(m.SimdRow[0], m.SimdRow[2], 1, 3, 1, 3), SIMD_SHUFFLE(m.SimdRow[1], m.SimdRow[3], 0, 2, 0, 2)));
+  const __m128 detA = SIMD_SWIZZLE(detSub, 0, 0, 0, 0);
+  const __m128 detB = SIMD_SWIZZLE(detSub, 1, 1, 1, 1);
+  const __m128 detC = SIMD_SWIZZLE(detSub, 2, 2, 2, 2);
+  const __m128 detD = SIMD_SWIZZLE(detSub, 3, 3, 3, 3);
+
+  // adj(D)C and adj(A)B
+  const __m128 DC = Mat2AdjMul(D, C);
+  const __m128 AB = Mat2AdjMul(A, B);
+
+  // adjugates of blocks of the inverse
+  __m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), Mat2Mul(B, DC));
+  __m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), Mat2Mul(C, AB));
+  __m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), Mat2MulAdj(D, AB));
+  __m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), Mat2MulAdj(A, DC));
+
+  // |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+  __m128 tr = _mm_mul_ps(AB, SIMD_SWIZZLE(DC, 0, 2, 1, 3));
+  tr = _mm_hadd_ps(tr, tr);
+  tr = _mm_hadd_ps(tr, tr);
+  const __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+  HEAVY_ASSERTE(_mm_cvtss_f32(det) != 0, "Determinant is equal to 0!");
+
+  // adjugate signs are folded into the reciprocal
+  const __m128 idet = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), det);
+  X = _mm_mul_ps(X, idet);
+  Y = _mm_mul_ps(Y, idet);
+  Z = _mm_mul_ps(Z, idet);
+  W = _mm_mul_ps(W, idet);
+
+  // adjugate shuffle combined with reassembling rows from blocks
+  out.SimdRow[0] = SIMD_SHUFFLE(X, Y, 3, 1, 3, 1);
+  out.SimdRow[1] = SIMD_SHUFFLE(X, Y, 2, 0, 2, 0);
+  out.SimdRow[2] = SIMD_SHUFFLE(Z, W, 3, 1, 3, 1);
+  out.SimdRow[3] = SIMD_SHUFFLE(Z, W, 2, 0, 2, 0);
+}
+
+// 3D cross product, w of the result is 0
+//------------------------------------------------------------------------------
+inline __m128 Cross(__m128 a, __m128 b) {
+  const __m128 c = _mm_sub_ps(_mm_mul_ps(a, SIMD_SWIZZLE(b, 1, 2, 0, 3)), _mm_mul_ps(SIMD_SWIZZLE(a, 1, 2, 0, 3), b));
+  return SIMD_SWIZZLE(c, 1, 2, 0, 3);
+}
+
+//------------------------------------------------------------------------------
+void AffineInverseSSE(const Matrix& m, Matrix& out) {
+  // columns of the upper 3x3 block and translation
+  __m128 c0 = m.SimdRow[0], c1 = m.SimdRow[1], c2 = m.SimdRow[2], t = m.SimdRow[3];
+  _MM_TRANSPOSE4_PS(c0, c1, c2, t);
+
+  // rows of the inverted 3x3 block are cross products of its columns divided by determinant
+  __m128 r0 = Cross(c1, c2);
+  __m128 r1 = Cross(c2, c0);
+  __m128 r2 = Cross(c0, c1);
+  const __m128 det = _mm_dot_ps(c0, r0);
+
+  HEAVY_ASSERTE(_mm_cvtss_f32(det) != 0, "Determinant is equal to 0!");
+
+  const __m128 idet = _mm_div_ps(_mm_set1_ps(1.f), det);
+  r0 = _mm_mul_ps(r0, idet);
+  r1 = _mm_mul_ps(r1, idet);
+  r2 = _mm_mul_ps(r2, idet);
+
+  // translation is transformed by the inverted 3x3 block (as columns)
+  __m128 r3 = _mm_setzero_ps();
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+  __m128 it = _mm_mul_ps(r0, SIMD_SWIZZLE(t, 0, 0, 0, 0));
+  it = _mm_add_ps(it, _mm_mul_ps(r1, SIMD_SWIZZLE(t, 1, 1, 1, 1)));
+  it = _mm_add_ps(it, _mm_mul_ps(r2, SIMD_SWIZZLE(t, 2, 2, 2, 2)));
+  it = _mm_sub_ps(_mm_setzero_ps(), it);
+  _MM_TRANSPOSE4_PS(r0, r1, r2, it);
+
+  out.SimdRow[0] = r0;
+  out.SimdRow[1] = r1;
+  out.SimdRow[2] = r2;
+  out.SimdRow[3] = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+}
+
+#undef SIMD_SWIZZLE
+#undef SIMD_SHUFFLE
+#endif
+}
+
 //------------------------------------------------------------------------------
 Matrix::Matrix() { SetIdentity(); }
 
@@ -54,26 +370,22 @@ bool Matrix::operator==(const Matrix& rhs) const {
 //------------------------------------------------------------------------------
 Matrix Matrix::operator*(const Matrix& rhs) const {
   Matrix ret;
-#if DISABLE_SIMD
-  for(int row=0; row<4; ++row) {
-    for(int col=0; col<4; ++col) {
-      ret.Data[4*row + col] = Data[4*row]*rhs.Data[col] + Data[4*row + 1]*rhs.Data[4 + col] + Data[4*row +2]*rhs.Data[8 + col] + Data[4*row + 3]*rhs.Data[12 + col] ;
-    }
-  }
-#else
-  Matrix t_rhs = rhs.GetTransposed();
-  for (int i = 0; i < 4; ++i) {
-    for (int j = 0; j < 4; ++j) {
-      __m128 c = _mm_mul_ps(SimdRow[i], t_rhs.SimdRow[j]);
-      c = _mm_hadd_ps(c, c);
-      c = _mm_hadd_ps(c, c);
-      _mm_store_ss(&ret.Data[4*i + j], c);
-    }
-  }
-#endif
+  Multiply(*this, rhs, ret);
   return ret;
 }
 
+//------------------------------------------------------------------------------
+void Matrix::Multiply(const Matrix& lhs, const Matrix& rhs, Matrix& out) {
+  HEAVY_ASSERTE(&out != &lhs && &out != &rhs, "Multiplication result overlaps its operand!");
+  switch (GetSimdInstructionSet()) {
+#if !DISABLE_SIMD
+    case eSimdInstructionSet::AVX2: MultiplyAVX2(lhs, rhs, out); break;
+    case eSimdInstructionSet::SSE: MultiplySSE(lhs, rhs, out); break;
+#endif
+    default: MultiplyScalar(lhs, rhs, out); break;
+  }
+}
+
 //------------------------------------------------------------------------------
 Matrix& Matrix::operator*=(const Matrix& rhs) { return *this = *this * rhs; }
 
@@ -269,129 +581,13 @@ Matrix& Poly::Matrix::SetOrthographic(float bottom, float top,  float left, floa
 
 //------------------------------------------------------------------------------
 Matrix& Matrix::Inverse() {
-  //TODO vectorize
-  Matrix cpy = *this;
-
-  Data[0] = cpy.Data[5]  * cpy.Data[10] * cpy.Data[15] -
-  cpy.Data[5]  * cpy.Data[11] * cpy.Data[14] -
-  cpy.Data[9]  * cpy.Data[6]  * cpy.Data[15] +
-  cpy.Data[9]  * cpy.Data[7]  * cpy.Data[14] +
-  cpy.Data[13] * cpy.Data[6]  * cpy.Data[11] -
-  cpy.Data[13] * cpy.Data[7]  * cpy.Data[10];
-
-  Data[4] = -cpy.Data[4]  * cpy.Data[10] * cpy.Data[15] +
-  cpy.Data[4]  * cpy.Data[11] * cpy.Data[14] +
-  cpy.Data[8]  * cpy.Data[6]  * cpy.Data[15] -
-  cpy.Data[8]  * cpy.Data[7]  * cpy.Data[14] -
-  cpy.Data[12] * cpy.Data[6]  * cpy.Data[11] +
-  cpy.Data[12] * cpy.Data[7]  * cpy.Data[10];
-
-  Data[8] = cpy.Data[4]  * cpy.Data[9] * cpy.Data[15] -
-  cpy.Data[4]  * cpy.Data[11] * cpy.Data[13] -
-  cpy.Data[8]  * cpy.Data[5] * cpy.Data[15] +
-  cpy.Data[8]  * cpy.Data[7] * cpy.Data[13] +
-  cpy.Data[12] * cpy.Data[5] * cpy.Data[11] -
-  cpy.Data[12] * cpy.Data[7] * cpy.Data[9];
-
-  Data[12] = -cpy.Data[4]  * cpy.Data[9] * cpy.Data[14] +
-  cpy.Data[4]  * cpy.Data[10] * cpy.Data[13] +
-  cpy.Data[8]  * cpy.Data[5] * cpy.Data[14] -
-  cpy.Data[8]  * cpy.Data[6] * cpy.Data[13] -
-  cpy.Data[12] * cpy.Data[5] * cpy.Data[10] +
-  cpy.Data[12] * cpy.Data[6] * cpy.Data[9];
-
-  Data[1] = -cpy.Data[1]  * cpy.Data[10] * cpy.Data[15] +
-  cpy.Data[1]  * cpy.Data[11] * cpy.Data[14] +
-  cpy.Data[9]  * cpy.Data[2] * cpy.Data[15] -
-  cpy.Data[9]  * cpy.Data[3] * cpy.Data[14] -
-  cpy.Data[13] * cpy.Data[2] * cpy.Data[11] +
-  cpy.Data[13] * cpy.Data[3] * cpy.Data[10];
-
-  Data[5] = cpy.Data[0]  * cpy.Data[10] * cpy.Data[15] -
-  cpy.Data[0]  * cpy.Data[11] * cpy.Data[14] -
-  cpy.Data[8]  * cpy.Data[2] * cpy.Data[15] +
-  cpy.Data[8]  * cpy.Data[3] * cpy.Data[14] +
-  cpy.Data[12] * cpy.Data[2] * cpy.Data[11] -
-  cpy.Data[12] * cpy.Data[3] * cpy.Data[10];
-
-  Data[9] = -cpy.Data[0]  * cpy.Data[9] * cpy.Data[15] +
-  cpy.Data[0]  * cpy.Data[11] * cpy.Data[13] +
-  cpy.Data[8]  * cpy.Data[1] * cpy.Data[15] -
-  cpy.Data[8]  * cpy.Data[3] * cpy.Data[13] -
-  cpy.Data[12] * cpy.Data[1] * cpy.Data[11] +
-  cpy.Data[12] * cpy.Data[3] * cpy.Data[9];
-
-  Data[13] = cpy.Data[0]  * cpy.Data[9] * cpy.Data[14] -
-  cpy.Data[0]  * cpy.Data[10] * cpy.Data[13] -
-  cpy.Data[8]  * cpy.Data[1] * cpy.Data[14] +
-  cpy.Data[8]  * cpy.Data[2] * cpy.Data[13] +
-  cpy.Data[12] * cpy.Data[1] * cpy.Data[10] -
-  cpy.Data[12] * cpy.Data[2] * cpy.Data[9];
-
-  Data[2] = cpy.Data[1]  * cpy.Data[6] * cpy.Data[15] -
-  cpy.Data[1]  * cpy.Data[7] * cpy.Data[14] -
-  cpy.Data[5]  * cpy.Data[2] * cpy.Data[15] +
-  cpy.Data[5]  * cpy.Data[3] * cpy.Data[14] +
-  cpy.Data[13] * cpy.Data[2] * cpy.Data[7] -
-  cpy.Data[13] * cpy.Data[3] * cpy.Data[6];
-
-  Data[6] = -cpy.Data[0]  * cpy.Data[6] * cpy.Data[15] +
-  cpy.Data[0]  * cpy.Data[7] * cpy.Data[14] +
-  cpy.Data[4]  * cpy.Data[2] * cpy.Data[15] -
-  cpy.Data[4]  * cpy.Data[3] * cpy.Data[14] -
-  cpy.Data[12] * cpy.Data[2] * cpy.Data[7] +
-  cpy.Data[12] * cpy.Data[3] * cpy.Data[6];
-
-  Data[10] = cpy.Data[0]  * cpy.Data[5] * cpy.Data[15] -
-  cpy.Data[0]  * cpy.Data[7] * cpy.Data[13] -
-  cpy.Data[4]  * cpy.Data[1] * cpy.Data[15] +
-  cpy.Data[4]  * cpy.Data[3] * cpy.Data[13] +
-  cpy.Data[12] * cpy.Data[1] * cpy.Data[7] -
-  cpy.Data[12] * cpy.Data[3] * cpy.Data[5];
-
-  Data[14] = -cpy.Data[0]  * cpy.Data[5] * cpy.Data[14] +
-  cpy.Data[0]  * cpy.Data[6] * cpy.Data[13] +
-  cpy.Data[4]  * cpy.Data[1] * cpy.Data[14] -
-  cpy.Data[4]  * cpy.Data[2] * cpy.Data[13] -
-  cpy.Data[12] * cpy.Data[1] * cpy.Data[6] +
-  cpy.Data[12] * cpy.Data[2] * cpy.Data[5];
-
-  Data[3] = -cpy.Data[1] * cpy.Data[6] * cpy.Data[11] +
-  cpy.Data[1] * cpy.Data[7] * cpy.Data[10] +
-  cpy.Data[5] * cpy.Data[2] * cpy.Data[11] -
-  cpy.Data[5] * cpy.Data[3] * cpy.Data[10] -
-  cpy.Data[9] * cpy.Data[2] * cpy.Data[7] +
-  cpy.Data[9] * cpy.Data[3] * cpy.Data[6];
-
-  Data[7] = cpy.Data[0] * cpy.Data[6] * cpy.Data[11] -
-  cpy.Data[0] * cpy.Data[7] * cpy.Data[10] -
-  cpy.Data[4] * cpy.Data[2] * cpy.Data[11] +
-  cpy.Data[4] * cpy.Data[3] * cpy.Data[10] +
-  cpy.Data[8] * cpy.Data[2] * cpy.Data[7] -
-  cpy.Data[8] * cpy.Data[3] * cpy.Data[6];
-
-  Data[11] = -cpy.Data[0] * cpy.Data[5] * cpy.Data[11] +
-  cpy.Data[0] * cpy.Data[7] * cpy.Data[9] +
-  cpy.Data[4] * cpy.Data[1] * cpy.Data[11] -
-  cpy.Data[4] * cpy.Data[3] * cpy.Data[9] -
-  cpy.Data[8] * cpy.Data[1] * cpy.Data[7] +
-  cpy.Data[8] * cpy.Data[3] * cpy.Data[5];
-
-  Data[15] = cpy.Data[0] * cpy.Data[5] * cpy.Data[10] -
-  cpy.Data[0] * cpy.Data[6] * cpy.Data[9] -
-  cpy.Data[4] * cpy.Data[1] * cpy.Data[10] +
-  cpy.Data[4] * cpy.Data[2] * cpy.Data[9] +
-  cpy.Data[8] * cpy.Data[1] * cpy.Data[6] -
-  cpy.Data[8] * cpy.Data[2] * cpy.Data[5];
-
-  float det = cpy.Data[0] * Data[0] + cpy.Data[1] * Data[4] + cpy.Data[2] * Data[8] + cpy.Data[3] * Data[12];
-
-  HEAVY_ASSERTE(det != 0, "Determinant is equal to 0!");
-
-  float idet = 1.0f/det;
-  for(int i=0; i<16; ++i)
-    Data[i] *= idet;
-
+  const Matrix cpy = *this;
+#if !DISABLE_SIMD
+  if (GetSimdInstructionSet() != eSimdInstructionSet::NONE)
+    InverseSSE(cpy, *this);
+  else
+#endif
+    InverseScalar(cpy, *this);
   return *this;
 }
 
@@ -401,6 +597,25 @@ Matrix Matrix::GetInversed() const {
   return ret.Inverse();
 }
 
+//------------------------------------------------------------------------------
+Matrix& Matrix::AffineInverse() {
+  HEAVY_ASSERTE(m30 == 0 && m31 == 0 && m32 == 0 && m33 == 1, "Matrix is not affine!");
+  const Matrix cpy = *this;
+#if !DISABLE_SIMD
+  if (GetSimdInstructionSet() != eSimdInstructionSet::NONE)
+    AffineInverseSSE(cpy, *this);
+  else
+#endif
+    AffineInverseScalar(cpy, *this);
+  return *this;
+}
+
+//------------------------------------------------------------------------------
+Matrix Matrix::GetAffineInversed() const {
+  Matrix ret = *this;
+  return ret.AffineInverse();
+}
+
 //------------------------------------------------------------------------------
 Matrix& Matrix::Transpose() {
   for (int row = 0; row < 4; ++row) {
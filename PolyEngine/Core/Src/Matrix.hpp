@@ -32,6 +32,10 @@ namespace Poly
 		/// <summary>Matrix-Matrix multiplication operator.</summary>
 		Matrix operator*(const Matrix& rhs) const;
 
+		/// <summary>Writes lhs * rhs to out without a temporary, using the selected SIMD instruction set.
+		/// Out must not be lhs or rhs.</summary>
+		static void Multiply(const Matrix& lhs, const Matrix& rhs, Matrix& out);
+
 		/// <summary>Matrix-Matrix multiplication (with store) operator.</summary>
 		Matrix& operator*=(const Matrix& rhs);
 
@@ -103,6 +107,15 @@ namespace Poly
 		/// <returns>New, inversed matrix object.</returns>
 		Matrix GetInversed() const;
 
+		/// <summary>Inverses the matrix, faster than Inverse() for matrices with last row equal to (0, 0, 0, 1)
+		/// (any combination of translation, rotation, scale and skew).</summary>
+		/// <returns>Reference to itself after the inversion.</returns>
+		Matrix& AffineInverse();
+
+		/// <summary>Creates inversed matrix from this one, see AffineInverse().</summary>
+		/// <returns>New, inversed matrix object.</returns>
+		Matrix GetAffineInversed() const;
+
 		/// <summary>Transposes the matrix.</summary>
 		/// <returns>Reference to itself after the transposition.</returns>
 		Matrix& Transpose();
@@ -0,0 +1,93 @@
+#include "CorePCH.hpp"
+
+#include "MemoryMappedFile.hpp"
+#include "FileIO.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#error "Unsupported platform :("
+#endif
+
+using namespace Poly;
+
+#if defined(_WIN32)
+//------------------------------------------------------------------------------
+MemoryMappedFile::MemoryMappedFile(const String& path)
+{
+	FileHandle = CreateFileA(path.GetCStr(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (FileHandle == INVALID_HANDLE_VALUE)
+	{
+		FileHandle = nullptr;
+		throw FileIOException("File open failed!");
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(FileHandle, &size))
+	{
+		CloseHandle(FileHandle);
+		throw FileIOException("File size query failed!");
+	}
+	Size = static_cast<size_t>(size.QuadPart);
+
+	// empty files cannot be mapped
+	if (Size == 0)
+		return;
+
+	MappingHandle = CreateFileMappingA(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	Data = MappingHandle ? static_cast<const u8*>(MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+	if (!Data)
+	{
+		if (MappingHandle)
+			CloseHandle(MappingHandle);
+		CloseHandle(FileHandle);
+		throw FileIOException("File mapping failed!");
+	}
+}
+
+//------------------------------------------------------------------------------
+MemoryMappedFile::~MemoryMappedFile()
+{
+	if (Data)
+		UnmapViewOfFile(Data);
+	if (MappingHandle)
+		CloseHandle(MappingHandle);
+	if (FileHandle)
+		CloseHandle(FileHandle);
+}
+#else
+//------------------------------------------------------------------------------
+MemoryMappedFile::MemoryMappedFile(const String& path)
+{
+	const int fd = open(path.GetCStr(), O_RDONLY);
+	if (fd < 0)
+		throw FileIOException("File open failed!");
+
+	struct stat info;
+	if (fstat(fd, &info) != 0)
+	{
+		close(fd);
+		throw FileIOException("File size query failed!");
+	}
+	Size = static_cast<size_t>(info.st_size);
+
+	// mapping stays valid after the descriptor is closed, empty files cannot be mapped
+	void* data = Size > 0 ? mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+	close(fd);
+	if (data == MAP_FAILED)
+		throw FileIOException("File mapping failed!");
+	Data = static_cast<const u8*>(data);
+}
+
+//------------------------------------------------------------------------------
+MemoryMappedFile::~MemoryMappedFile()
+{
+	if (Data)
+		munmap(const_cast<u8*>(Data), Size);
+}
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "String.hpp"
+
+namespace Poly
+{
+	/// <summary>Read-only view of a whole file mapped into memory.
+	/// Pages are loaded by the operating system on first access and shared with its file cache,
+	/// so reading data does not copy it into process memory.</summary>
+	class CORE_DLLEXPORT MemoryMappedFile final : public BaseObject<>
+	{
+	public:
+		/// <summary>Maps file for reading.</summary>
+		/// <exception cref="FileIOException">Thrown when the file cannot be opened or mapped.</exception>
+		explicit MemoryMappedFile(const String& path);
+		~MemoryMappedFile();
+
+		MemoryMappedFile(const MemoryMappedFile&) = delete;
+		MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+		/// <summary>Returns beginning of the file, aligned at least to the memory page size.</summary>
+		const u8* GetData() const { return Data; }
+		size_t GetSize() const { return Size; }
+
+	private:
+		const u8* Data = nullptr;
+		size_t Size = 0;
+#if defined(_WIN32)
+		void* FileHandle = nullptr;
+		void* MappingHandle = nullptr;
+#endif
+	};
+}
@@ -4,11 +4,10 @@ using namespace Poly;
 
 std::streamsize OutputStream::xsputn(const char_type* s, std::streamsize n)
 {
-	UNUSED(n);
-	std::string str(s);
-	size_t len = str.length();
-	Append(s);
-	return len;
+	// buffer is not null terminated, f.ex. when formatting numbers
+	std::string str(s, static_cast<size_t>(n));
+	Append(str.c_str());
+	return n;
 }
 
 std::streambuf::int_type OutputStream::overflow(int_type c)
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "Queue.hpp"
+
+namespace Poly {
+	/// <summary>Allocation arithmetic of a ring buffer whose memory is released in batches, f.ex. frames read by the GPU.
+	/// Allocator does not own any memory, it only hands out offsets. Allocations never wrap around,
+	/// the rest of the ring is skipped instead. Positions grow monotonically, offset is position modulo capacity.</summary>
+	class RingAllocator : public BaseObject<>
+	{
+	public:
+		static constexpr size_t INVALID_OFFSET = static_cast<size_t>(-1);
+
+		explicit RingAllocator(size_t capacity)
+			: Capacity(capacity)
+		{
+			ASSERTE(capacity > 0, "Ring capacity cannot be lower than 1.");
+		}
+
+		/// <summary>Allocates range that does not overlap memory of batches that are not released yet.</summary>
+		/// <param name="alignment">Offset of the allocation is multiple of alignment.</param>
+		/// <returns>Offset of the allocation or INVALID_OFFSET when the oldest pending batch has to be released first.
+		/// When there are no pending batches memory used since the last batch has to be ended as a batch first.</returns>
+		size_t Allocate(size_t size, size_t alignment)
+		{
+			ASSERTE(size > 0 && size <= Capacity, "Invalid ring allocation size!");
+			ASSERTE(alignment > 0, "Invalid ring allocation alignment!");
+
+			const size_t start = Head % Capacity;
+			size_t offset = ((start + alignment - 1) / alignment) * alignment;
+			if (offset + size > Capacity)
+				offset = 0;
+			const size_t position = Head - start + (offset >= start ? offset : Capacity);
+
+			// skipped range is never written, so it is free as soon as everything allocated before it is released
+			if (Released == Head)
+				Released = position;
+
+			if (position + size > Released + Capacity)
+				return INVALID_OFFSET;
+
+			Head = position + size;
+			return offset;
+		}
+
+		/// <summary>Ends batch containing memory allocated since the previous batch.</summary>
+		/// <returns>True if a batch was ended, false if nothing was allocated since the previous one.</returns>
+		bool EndBatch()
+		{
+			if (Head == BatchEnd)
+				return false;
+
+			Batches.PushBack(Head);
+			BatchEnd = Head;
+			return true;
+		}
+
+		/// <summary>Releases memory of the oldest pending batch, so it can be allocated again.</summary>
+		void ReleaseOldestBatch()
+		{
+			ASSERTE(!Batches.IsEmpty(), "No pending ring batches to release!");
+			Released = Batches.Front();
+			Batches.PopFront();
+		}
+
+		size_t GetCapacity() const { return Capacity; }
+		size_t GetPendingBatchCount() const { return Batches.GetSize(); }
+
+		/// <summary>Returns amount of memory that is allocated and not released yet, including skipped ranges.</summary>
+		size_t GetUsedSize() const { return Head - Released; }
+
+	private:
+		size_t Capacity;
+		size_t Head = 0;
+		size_t Released = 0;
+		size_t BatchEnd = 0;
+		// positions following data of the pending batches
+		Queue<size_t> Batches;
+	};
+}
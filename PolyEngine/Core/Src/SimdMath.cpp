@@ -2,6 +2,10 @@
 
 #include "SimdMath.hpp"
 
+#if !DISABLE_SIMD && defined(_WIN32)
+	#include <intrin.h>
+#endif
+
 using namespace Poly;
 
 #if !DISABLE_SIMD
@@ -26,3 +30,47 @@ __m128 _mm_cmpf_ps(__m128 a, __m128 b) {
 }
 
 #endif
+
+namespace
+{
+	eSimdInstructionSet DetectSimdInstructionSet()
+	{
+	#if DISABLE_SIMD
+		return eSimdInstructionSet::NONE;
+	#elif defined(__GNUC__)
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ? eSimdInstructionSet::AVX2 : eSimdInstructionSet::SSE;
+	#elif defined(_WIN32)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return eSimdInstructionSet::SSE;
+		__cpuid(info, 1);
+		const bool fma = (info[2] & (1 << 12)) != 0;
+		// OS has to save YMM registers on context switch
+		const bool osxsave = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+		__cpuidex(info, 7, 0);
+		const bool avx2 = (info[1] & (1 << 5)) != 0;
+		return fma && osxsave && avx2 ? eSimdInstructionSet::AVX2 : eSimdInstructionSet::SSE;
+	#else
+		return eSimdInstructionSet::SSE;
+	#endif
+	}
+
+	const eSimdInstructionSet gSupportedSimdInstructionSet = DetectSimdInstructionSet();
+}
+
+eSimdInstructionSet Poly::gSimdInstructionSet = gSupportedSimdInstructionSet;
+
+//------------------------------------------------------------------------------
+bool Poly::IsSimdInstructionSetSupported(eSimdInstructionSet set)
+{
+	return set <= gSupportedSimdInstructionSet;
+}
+
+//------------------------------------------------------------------------------
+void Poly::SetSimdInstructionSet(eSimdInstructionSet set)
+{
+	ASSERTE(IsSimdInstructionSetSupported(set), "Instruction set is not supported");
+	gSimdInstructionSet = set;
+}
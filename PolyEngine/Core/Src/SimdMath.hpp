@@ -13,4 +13,30 @@ __m128 _mm_dot_ps(__m128 a, __m128 b);
 /// <summary>SIMD intristic compare two floats with given precission.</summary>
 __m128 _mm_cmpf_ps(__m128 a, __m128 b);
 
+// Functions using AVX2/FMA intrinsics have to be marked, the rest of the code is compiled for SSE only.
+// Such functions can be called only when GetSimdInstructionSet() returns eSimdInstructionSet::AVX2.
+#ifdef __GNUC__
+	#define SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+	#define SIMD_TARGET_AVX2
 #endif
+
+#endif
+
+namespace Poly
+{
+	/// <summary>Instruction sets math kernels (f.ex. Matrix multiplication) are dispatched to at runtime.</summary>
+	enum class eSimdInstructionSet { NONE, SSE, AVX2, _COUNT };
+
+	CORE_DLLEXPORT extern eSimdInstructionSet gSimdInstructionSet;
+
+	/// <summary>Returns instruction set currently used by math kernels. By default it is the best one supported by the CPU.</summary>
+	inline eSimdInstructionSet GetSimdInstructionSet() { return gSimdInstructionSet; }
+
+	/// <summary>Checks whether given instruction set is supported by both the CPU and the build (see SIMD CMake option).</summary>
+	CORE_DLLEXPORT bool IsSimdInstructionSetSupported(eSimdInstructionSet set);
+
+	/// <summary>Forces math kernels to use given instruction set (f.ex. to compare results or performance of the kernels).</summary>
+	/// <param name="set">Instruction set, has to be supported.</param>
+	CORE_DLLEXPORT void SetSimdInstructionSet(eSimdInstructionSet set);
+}
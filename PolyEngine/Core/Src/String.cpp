@@ -287,6 +287,18 @@ size_t String::GetLength() const
 	return Data.GetSize() - 1;
 }
 
+size_t String::GetHash() const
+{
+	// 64-bit FNV-1a, truncated on 32-bit platforms
+	u64 hash = 14695981039346656037ull;
+	for (size_t i = 0; i < GetLength(); ++i)
+	{
+		hash ^= static_cast<u8>(Data[i]);
+		hash *= 1099511628211ull;
+	}
+	return static_cast<size_t>(hash);
+}
+
 size_t String::FindSubstrFromPoint(size_t startPoint, const String& str) const
 {
 	for (size_t idx = startPoint; idx < GetLength(); ++idx)
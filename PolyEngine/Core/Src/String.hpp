@@ -190,6 +190,9 @@ namespace Poly {
 		size_t GetLength() const;
 		const char* GetCStr() const { return Data.GetData(); }
 
+		/// <summary>Returns FNV-1a hash of the characters, which can be computed once and stored with the string.</summary>
+		size_t GetHash() const;
+
 		/*CORE_DLLEXPORT*/ friend std::ostream& operator<< (std::ostream& stream, const String& rhs) { return stream << rhs.GetCStr(); }
 
 	private:
@@ -198,3 +201,8 @@ namespace Poly {
 		size_t FindSubstrFromPoint(size_t startPoint, const String& str) const;
 	};
 }
+
+// hasher for String
+namespace std {
+	template <> struct hash<Poly::String> { std::size_t operator()(const Poly::String& k) const { return k.GetHash(); } };
+}
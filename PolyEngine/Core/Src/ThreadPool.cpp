@@ -0,0 +1,184 @@
+#include "CorePCH.hpp"
+
+#include "ThreadPool.hpp"
+
+using namespace Poly;
+
+namespace
+{
+	// Pool and queue owned by the current thread, used to route submissions and pops of worker threads.
+	thread_local const ThreadPool* tCurrentPool = nullptr;
+	thread_local size_t tWorkerIdx = 0;
+}
+
+//------------------------------------------------------------------------------
+ThreadPool::ThreadPool(size_t workerCount)
+{
+	// there is always at least one queue, so jobs can be submitted even when there are no workers
+	const size_t queueCount = std::max(workerCount, size_t(1));
+	Queues.Reserve(queueCount);
+	for (size_t i = 0; i < queueCount; ++i)
+		Queues.PushBack(new WorkerQueue());
+
+	Workers.Reserve(workerCount);
+	for (size_t i = 0; i < workerCount; ++i)
+		Workers.PushBack(new std::thread(&ThreadPool::WorkerLoop, this, i));
+}
+
+//------------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(SleepMutex);
+		Quit = true;
+	}
+	WakeUp.notify_all();
+
+	for (std::thread* worker : Workers)
+	{
+		worker->join();
+		delete worker;
+	}
+
+	// without workers leftover jobs have to be finished here
+	WorkItem item;
+	while (TrySteal(Queues.GetSize(), item))
+		Execute(item);
+
+	for (WorkerQueue* queue : Queues)
+		delete queue;
+}
+
+//------------------------------------------------------------------------------
+size_t ThreadPool::GetDefaultWorkerCount()
+{
+	const size_t hardwareThreads = std::thread::hardware_concurrency();
+	return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+//------------------------------------------------------------------------------
+void ThreadPool::Submit(const Job& job, JobCounter* counter)
+{
+	if (counter)
+		counter->Pending.fetch_add(1, std::memory_order_relaxed);
+
+	// workers push to their own queue, other threads spread jobs evenly
+	const size_t queueIdx = tCurrentPool == this ? tWorkerIdx : NextQueue.fetch_add(1, std::memory_order_relaxed) % Queues.GetSize();
+	WorkerQueue* queue = Queues[queueIdx];
+	{
+		std::lock_guard<std::mutex> lock(queue->Mutex);
+		queue->Items.PushBack(WorkItem{ job, counter });
+		QueuedCount.fetch_add(1, std::memory_order_release);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(SleepMutex);
+	}
+	WakeUp.notify_one();
+}
+
+//------------------------------------------------------------------------------
+void ThreadPool::Wait(JobCounter& counter)
+{
+	while (!counter.IsDone())
+	{
+		if (TryExecuteOne())
+			continue;
+
+		std::unique_lock<std::mutex> lock(SleepMutex);
+		WakeUp.wait(lock, [this, &counter]() { return counter.IsDone() || QueuedCount.load(std::memory_order_acquire) > 0; });
+	}
+}
+
+//------------------------------------------------------------------------------
+bool ThreadPool::TryExecuteOne()
+{
+	const size_t ownIdx = tCurrentPool == this ? tWorkerIdx : Queues.GetSize();
+	WorkItem item;
+	if ((ownIdx < Queues.GetSize() && TryPop(ownIdx, item)) || TrySteal(ownIdx, item))
+	{
+		Execute(item);
+		return true;
+	}
+	return false;
+}
+
+//------------------------------------------------------------------------------
+void ThreadPool::WorkerLoop(size_t workerIdx)
+{
+	tCurrentPool = this;
+	tWorkerIdx = workerIdx;
+
+	WorkItem item;
+	while (true)
+	{
+		if (TryPop(workerIdx, item) || TrySteal(workerIdx, item))
+		{
+			Execute(item);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(SleepMutex);
+		WakeUp.wait(lock, [this]() { return Quit || QueuedCount.load(std::memory_order_acquire) > 0; });
+		if (Quit && QueuedCount.load(std::memory_order_acquire) == 0)
+			break;
+	}
+
+	tCurrentPool = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool ThreadPool::TryPop(size_t queueIdx, WorkItem& item)
+{
+	WorkerQueue* queue = Queues[queueIdx];
+	std::lock_guard<std::mutex> lock(queue->Mutex);
+	if (queue->Items.IsEmpty())
+		return false;
+
+	// owner takes the most recently pushed job, its data is most likely still in cache
+	item = queue->Items.Back();
+	queue->Items.PopBack();
+	QueuedCount.fetch_sub(1, std::memory_order_relaxed);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ThreadPool::TrySteal(size_t thiefIdx, WorkItem& item)
+{
+	const size_t queueCount = Queues.GetSize();
+	for (size_t i = 1; i <= queueCount; ++i)
+	{
+		const size_t victimIdx = (thiefIdx + i) % queueCount;
+		if (victimIdx == thiefIdx)
+			continue;
+
+		WorkerQueue* queue = Queues[victimIdx];
+		std::lock_guard<std::mutex> lock(queue->Mutex);
+		if (queue->Items.IsEmpty())
+			continue;
+
+		// thieves take the oldest job
+		item = queue->Items.Front();
+		queue->Items.PopFront();
+		QueuedCount.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+	return false;
+}
+
+//------------------------------------------------------------------------------
+void ThreadPool::Execute(WorkItem& item)
+{
+	item.Function();
+	item.Function = nullptr;
+
+	JobCounter* counter = item.Counter;
+	item.Counter = nullptr;
+	if (counter && counter->Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		{
+			std::lock_guard<std::mutex> lock(SleepMutex);
+		}
+		WakeUp.notify_all();
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "Defines.hpp"
+#include "Dynarray.hpp"
+#include "Queue.hpp"
+
+namespace Poly
+{
+	/// <summary>Counter of unfinished jobs, used to wait for a group of jobs submitted to the ThreadPool.</summary>
+	class CORE_DLLEXPORT JobCounter : public BaseObject<>
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		/// <summary>Checks whether all jobs associated with this counter have finished.</summary>
+		bool IsDone() const { return Pending.load(std::memory_order_acquire) == 0; }
+
+	private:
+		std::atomic<size_t> Pending{ 0 };
+
+		friend class ThreadPool;
+	};
+
+	/// <summary>Work-stealing thread pool.
+	/// Every worker owns a job queue. Jobs submitted from a worker go to its own queue (and are popped LIFO),
+	/// jobs submitted from other threads are distributed round-robin. Idle workers steal from the front of other queues.
+	/// Threads that wait for a JobCounter help executing jobs instead of blocking.</summary>
+	class CORE_DLLEXPORT ThreadPool : public BaseObject<>
+	{
+	public:
+		using Job = std::function<void()>;
+
+		/// <summary>Creates pool and starts worker threads.</summary>
+		/// <param name="workerCount">Amount of worker threads. With 0 workers jobs are executed by waiting threads only.</param>
+		explicit ThreadPool(size_t workerCount = GetDefaultWorkerCount());
+
+		/// <summary>Finishes all queued jobs and joins worker threads.</summary>
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/// <summary>Returns amount of worker threads.</summary>
+		size_t GetWorkerCount() const { return Workers.GetSize(); }
+
+		/// <summary>Queues job for execution.</summary>
+		/// <param name="job">Job to execute.</param>
+		/// <param name="counter">Optional counter that will be incremented now and decremented once the job finishes.</param>
+		void Submit(const Job& job, JobCounter* counter = nullptr);
+
+		/// <summary>Blocks until all jobs associated with counter are finished. Calling thread executes queued jobs in the meantime.</summary>
+		void Wait(JobCounter& counter);
+
+		/// <summary>Executes single queued job on the calling thread.</summary>
+		/// <returns>True if a job was executed, false if there was nothing to do.</returns>
+		bool TryExecuteOne();
+
+		/// <summary>Returns default amount of workers: hardware concurrency minus the calling (main) thread.</summary>
+		static size_t GetDefaultWorkerCount();
+
+	private:
+		struct WorkItem
+		{
+			Job Function;
+			JobCounter* Counter = nullptr;
+		};
+
+		struct WorkerQueue : public BaseObject<>
+		{
+			std::mutex Mutex;
+			Queue<WorkItem> Items;
+		};
+
+		void WorkerLoop(size_t workerIdx);
+		bool TryPop(size_t queueIdx, WorkItem& item);
+		bool TrySteal(size_t thiefIdx, WorkItem& item);
+		void Execute(WorkItem& item);
+
+		Dynarray<std::thread*> Workers;
+		Dynarray<WorkerQueue*> Queues;
+
+		std::mutex SleepMutex;
+		std::condition_variable WakeUp;
+		std::atomic<size_t> QueuedCount{ 0 };
+		std::atomic<size_t> NextQueue{ 0 };
+		std::atomic<bool> Quit{ false };
+	};
+}
@@ -11,6 +11,12 @@ namespace Poly {
 		UniqueID();
 		static UniqueID Generate();
 
+		/// <summary>Creates identifier with given raw value, f.ex. deserialized one or encoded by a handle.</summary>
+		static UniqueID FromValue(size_t value) { return UniqueID(value); }
+
+		/// <summary>Returns raw value of the identifier, which can be serialized.</summary>
+		size_t GetValue() const { return ID; }
+
 		bool operator==(const UniqueID& rhs) const;
 		bool operator!=(const UniqueID& rhs) const;
 
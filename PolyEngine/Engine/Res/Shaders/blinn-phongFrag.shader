@@ -1,44 +1,25 @@
 #version 330 core
 
-#ifndef MAX_DIRLIGHT_COUNT
-#define MAX_DIRLIGHT_COUNT 8
-#endif
-
-#ifndef MAX_SPOTLIGHT_COUNT
-#define MAX_SPOTLIGHT_COUNT 8
-#endif
-
-#ifndef MAX_POINTLIGHT_COUNT
-#define MAX_POINTLIGHT_COUNT 8
-#endif
-
-struct DiffuseLight
-{
-	vec4 Color;
-	float Intensity;
-};
+// has to match limit in BlinnPhongRenderingPass
+#define MAX_DIRLIGHT_COUNT 64
 
+// blocks use std140 layout and are filled from mirroring structures in BlinnPhongRenderingPass
 struct DirectionalLight
 {
-	DiffuseLight Base;
+	vec4 Color;
 	vec4 Direction;
+	float Intensity;
 };
 
-struct PointLight
-{
-	DiffuseLight Base;
-	vec4 Position;
-	float Range;
-};
-
-struct SpotLight
+// point and spot light fetched from uLights, color is premultiplied by intensity
+struct LocalLight
 {
-	DiffuseLight Base;
-	vec4 Position;
-	vec4 Direction;
+	vec3 Position;
 	float Range;
-	float CutOff;
+	vec3 Color;
 	float OuterCutOff;
+	vec3 Direction;
+	float CutOff;
 };
 
 struct Lighting
@@ -47,29 +28,41 @@ struct Lighting
 	vec3 Specular;
 };
 
-struct Material
+layout(std140) uniform FrameData
 {
-    vec4 Ambient;
-    vec4 Diffuse;
-    vec4 Specular;
-    float Shininess;
-};
+	vec4 CameraPosition;
+	vec4 CameraForward;
+	vec4 AmbientColor;
+	vec4 Viewport;
+	float AmbientIntensity;
+	int DirectionalLightCount;
+	int PointLightCount;
+	int TilesX;
+	int TilesY;
+	int Slices;
+	float SliceScale;
+	float SliceBias;
+	DirectionalLight DirectionalLights[MAX_DIRLIGHT_COUNT];
+} uFrame;
+
+layout(std140) uniform MaterialData
+{
+	vec4 Ambient;
+	vec4 Diffuse;
+	vec4 Specular;
+	float Shininess;
+} uMaterial;
 
 uniform sampler2D uTexture;
-uniform vec4 uCameraForward;
-uniform vec4 uCameraPosition;
-
-uniform Material uMaterial;
 
-uniform DiffuseLight uAmbientLight;
-uniform DirectionalLight uDirectionalLight[MAX_DIRLIGHT_COUNT];
-uniform int uDirectionalLightCount;
-uniform PointLight uPointLight[MAX_POINTLIGHT_COUNT];
-uniform int uPointLightCount;
-uniform SpotLight uSpotLight[MAX_SPOTLIGHT_COUNT];
-uniform int uSpotLightCount;
+// clustered light culling data built by LightGrid:
+// three texels per light, offset and count of light indices per cluster, light indices of all clusters
+uniform samplerBuffer uLights;
+uniform usamplerBuffer uClusters;
+uniform usamplerBuffer uLightIndices;
 
 in vec3 vVertexPos;
+in float vViewDepth;
 in vec2 vTexCoord;
 in vec3 vNormal;
 
@@ -77,7 +70,7 @@ layout(location = 0) out vec4 color;
 
 vec3 ambientLighting()
 {
-	return uMaterial.Ambient.rgb * uAmbientLight.Color.rgb * uAmbientLight.Intensity;
+	return uMaterial.Ambient.rgb * uFrame.AmbientColor.rgb * uFrame.AmbientIntensity;
 }
 
 vec3 diffuseLighting(in vec3 N, in vec3 L, in vec3 LightColor)
@@ -101,7 +94,7 @@ Lighting directionalLighting(in DirectionalLight dirLight, in vec3 positionWS, i
 	vec3 V = normalize(toCamera);
 	vec3 N = normalize(normalWS);
 
-	vec3 lightColor = dirLight.Base.Color.rgb * dirLight.Base.Intensity;
+	vec3 lightColor = dirLight.Color.rgb * dirLight.Intensity;
 
 	OUT.Diffuse = diffuseLighting(N, L, lightColor);
 	OUT.Specular = specularLighting(N, L, V, lightColor);
@@ -110,40 +103,42 @@ Lighting directionalLighting(in DirectionalLight dirLight, in vec3 positionWS, i
 }
 
 
-Lighting pointLighting(in PointLight pointLight, in vec3 positionWS, in vec3 normalWS, in vec3 toCamera)
+LocalLight fetchLight(in int index)
 {
-	Lighting OUT;
+	vec4 t0 = texelFetch(uLights, 3 * index);
+	vec4 t1 = texelFetch(uLights, 3 * index + 1);
+	vec4 t2 = texelFetch(uLights, 3 * index + 2);
+	return LocalLight(t0.xyz, t0.w, t1.rgb, t1.w, t2.xyz, t2.w);
+}
 
-	vec3 o_toLight = normalize(pointLight.Position.xyz - positionWS);
+Lighting pointLighting(in LocalLight pointLight, in vec3 positionWS, in vec3 normalWS, in vec3 toCamera)
+{
+	Lighting OUT;
 
-	vec3 L = normalize(o_toLight);
+	vec3 L = normalize(pointLight.Position - positionWS);
 	vec3 V = normalize(toCamera);
 	vec3 N = normalize(normalWS);
 
-	float dist = distance(pointLight.Position.xyz, positionWS);
+	float dist = distance(pointLight.Position, positionWS);
 	float att = clamp(1.0 - dist*dist / (pointLight.Range*pointLight.Range), 0.0, 1.0);
 	att *= att;
 
-	vec3 lightColor = pointLight.Base.Color.rgb * pointLight.Base.Intensity;
-	
-	OUT.Diffuse = diffuseLighting(N, L, lightColor) * att;
-	OUT.Specular = specularLighting(N, L, V, lightColor) * att;
+	OUT.Diffuse = diffuseLighting(N, L, pointLight.Color) * att;
+	OUT.Specular = specularLighting(N, L, V, pointLight.Color) * att;
 
 	return OUT;
 }
 
-Lighting spotLighting(in SpotLight spotLight, in vec3 positionWS, in vec3 normalWS, in vec3 toCamera)
+Lighting spotLighting(in LocalLight spotLight, in vec3 positionWS, in vec3 normalWS, in vec3 toCamera)
 {
 	Lighting OUT;
-	OUT.Diffuse = vec3(0.0);
-	OUT.Specular = vec3(0.0);
 
-	vec3 S = normalize(-spotLight.Direction.xyz);
-	vec3 L = normalize(spotLight.Position.xyz - positionWS);
+	vec3 S = normalize(-spotLight.Direction);
+	vec3 L = normalize(spotLight.Position - positionWS);
 	vec3 V = normalize(toCamera);
 	vec3 N = normalize(normalWS);
 	
-	float dist = distance(spotLight.Position.xyz, positionWS);
+	float dist = distance(spotLight.Position, positionWS);
 	float att = clamp(1.0 - dist*dist / (spotLight.Range*spotLight.Range), 0.0, 1.0);
 	att *= att;
 	
@@ -151,7 +146,7 @@ Lighting spotLighting(in SpotLight spotLight, in vec3 positionWS, in vec3 normal
 	float epsilon = spotLight.CutOff - spotLight.OuterCutOff;
 	float intensity = smoothstep(0.0, 1.0, clamp((theta - spotLight.OuterCutOff) / epsilon, 0.0, 1.0));
 
-	vec3 lightColor = spotLight.Base.Color.rgb * spotLight.Base.Intensity *intensity;
+	vec3 lightColor = spotLight.Color * intensity;
 	
 	OUT.Diffuse = diffuseLighting(N, L, lightColor) * att;
 	OUT.Specular = specularLighting(N, L, V, lightColor) * att;
@@ -159,6 +154,15 @@ Lighting spotLighting(in SpotLight spotLight, in vec3 positionWS, in vec3 normal
 	return OUT;
 }
 
+// index of the cluster containing the fragment, matches LightGrid::GetClusterIndex
+int clusterIndex()
+{
+	ivec2 tiles = ivec2(uFrame.TilesX, uFrame.TilesY);
+	ivec2 tile = clamp(ivec2((gl_FragCoord.xy - uFrame.Viewport.xy) / uFrame.Viewport.zw * vec2(tiles)), ivec2(0), tiles - 1);
+	int slice = clamp(int(floor(log(max(vViewDepth, 1e-3)) * uFrame.SliceScale + uFrame.SliceBias)), 0, uFrame.Slices - 1);
+	return (slice * uFrame.TilesY + tile.y) * uFrame.TilesX + tile.x;
+}
+
 void main() {
 
 	vec4 texDiffuse = texture(uTexture, vTexCoord);
@@ -173,25 +177,23 @@ void main() {
 	vec3 Idif =	vec3(0.0);
 	vec3 Ispe =	vec3(0.0);
 
-	vec3 toCamera = normalize(uCameraPosition.xyz - positionWS);
+	vec3 toCamera = normalize(uFrame.CameraPosition.xyz - positionWS);
 
-	for (int i = 0; i < uDirectionalLightCount; ++i)
+	for (int i = 0; i < uFrame.DirectionalLightCount; ++i)
 	{
-		Lighting lighting = directionalLighting(uDirectionalLight[i], positionWS, normalWS, toCamera);
+		Lighting lighting = directionalLighting(uFrame.DirectionalLights[i], positionWS, normalWS, toCamera);
 		Idif += lighting.Diffuse;
 		Ispe += lighting.Specular;
 	}
 	
-	for (int i = 0; i < uPointLightCount; ++i)
-	{
-		Lighting lighting = pointLighting(uPointLight[i], positionWS, normalWS, toCamera);
-		Idif += lighting.Diffuse;
-		Ispe += lighting.Specular;
-	}
-
-	for (int i = 0; i < uSpotLightCount; ++i)
+	uvec2 cluster = texelFetch(uClusters, clusterIndex()).xy;
+	for (uint i = cluster.x; i < cluster.x + cluster.y; ++i)
 	{
-		Lighting lighting = spotLighting(uSpotLight[i], positionWS, normalWS, toCamera);
+		int lightIndex = int(texelFetch(uLightIndices, int(i)).x);
+		LocalLight light = fetchLight(lightIndex);
+		Lighting lighting = lightIndex < uFrame.PointLightCount
+			? pointLighting(light, positionWS, normalWS, toCamera)
+			: spotLighting(light, positionWS, normalWS, toCamera);
 		Idif += lighting.Diffuse;
 		Ispe += lighting.Specular;
 	}
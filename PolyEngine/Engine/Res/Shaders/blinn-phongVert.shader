@@ -2,17 +2,23 @@
 layout(location = 0) in vec4 aPos;
 layout(location = 1) in vec2 aTexCoord;
 layout(location = 2) in vec3 aNormal;
+// per instance transformation, see GLMeshDeviceProxy::INSTANCE_TRANSFORM_ATTRIBUTE
+layout(location = 4) in mat4 aInstanceTransform;
 
-uniform mat4 uMVPTransform;
-uniform mat4 uTransform;
+uniform mat4 uViewProjection;
+uniform mat4 uView;
 
 out vec3 vVertexPos;
+out float vViewDepth;
 out vec2 vTexCoord;
 out vec3 vNormal;
 
 void main() {
-	gl_Position = uMVPTransform * aPos;
+	vec4 positionWS = aInstanceTransform * aPos;
+	gl_Position = uViewProjection * positionWS;
 	vTexCoord = aTexCoord;
-	vNormal = normalize(transpose(inverse(mat3(uTransform))) * aNormal);
-	vVertexPos = aPos.xyz;
+	vNormal = normalize(transpose(inverse(mat3(aInstanceTransform))) * aNormal);
+	vVertexPos = positionWS.xyz;
+	// distance along view direction selects the light cluster slice, view looks along -Z
+	vViewDepth = -(uView * positionWS).z;
 }
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "EnginePCH.hpp"
+
+#include "ArchetypeStorage.hpp"
+
+using namespace Poly;
+
+//------------------------------------------------------------------------------
+Archetype::Chunk::Chunk(size_t columnCount)
+{
+	if (columnCount > 0)
+		Columns = Allocate<ComponentBase*>(columnCount * ARCHETYPE_CHUNK_CAPACITY);
+}
+
+//------------------------------------------------------------------------------
+Archetype::Chunk::~Chunk()
+{
+	if (Columns)
+		Deallocate(Columns);
+}
+
+//------------------------------------------------------------------------------
+Archetype::Archetype(const std::bitset<MAX_COMPONENTS_COUNT>& mask)
+	: Mask(mask)
+{
+	memset(ColumnIndices, INVALID_COLUMN, sizeof(ColumnIndices));
+	for (size_t i = 0; i < MAX_COMPONENTS_COUNT; ++i)
+	{
+		if (!Mask[i])
+			continue;
+		ColumnIndices[i] = static_cast<u8>(ComponentIDs.GetSize());
+		ComponentIDs.PushBack(i);
+	}
+}
+
+//------------------------------------------------------------------------------
+Archetype::~Archetype()
+{
+	for (Chunk* chunk : Chunks)
+		delete chunk;
+}
+
+//------------------------------------------------------------------------------
+void Archetype::Add(Entity* ent)
+{
+	HEAVY_ASSERTE(ent->ComponentPosessionFlags == Mask, "Entity does not match archetype");
+	if (Chunks.IsEmpty() || Chunks[Chunks.GetSize() - 1]->Count == ARCHETYPE_CHUNK_CAPACITY)
+		Chunks.PushBack(new Chunk(ComponentIDs.GetSize()));
+
+	Chunk* chunk = Chunks[Chunks.GetSize() - 1];
+	const size_t row = chunk->Count++;
+	chunk->Entities[row] = ent;
+	for (size_t col = 0; col < ComponentIDs.GetSize(); ++col)
+		chunk->Columns[col * ARCHETYPE_CHUNK_CAPACITY + row] = ent->Components[ComponentIDs[col]];
+
+	ent->EntityArchetype = this;
+	ent->ArchetypeRow = EntityCount++;
+}
+
+//------------------------------------------------------------------------------
+void Archetype::Remove(Entity* ent)
+{
+	HEAVY_ASSERTE(ent->EntityArchetype == this, "Entity does not belong to this archetype");
+	const size_t chunkIdx = ent->ArchetypeRow / ARCHETYPE_CHUNK_CAPACITY;
+	const size_t row = ent->ArchetypeRow % ARCHETYPE_CHUNK_CAPACITY;
+	Chunk* chunk = Chunks[chunkIdx];
+	Chunk* last = Chunks[Chunks.GetSize() - 1];
+	const size_t lastRow = last->Count - 1;
+
+	// swap-remove: move last row into the hole to keep chunks tightly packed
+	if (chunk != last || row != lastRow)
+	{
+		Entity* moved = last->Entities[lastRow];
+		chunk->Entities[row] = moved;
+		for (size_t col = 0; col < ComponentIDs.GetSize(); ++col)
+			chunk->Columns[col * ARCHETYPE_CHUNK_CAPACITY + row] = last->Columns[col * ARCHETYPE_CHUNK_CAPACITY + lastRow];
+		moved->ArchetypeRow = ent->ArchetypeRow;
+	}
+
+	if (--last->Count == 0)
+	{
+		delete last;
+		Chunks.PopBack();
+	}
+	--EntityCount;
+
+	ent->EntityArchetype = nullptr;
+	ent->ArchetypeRow = 0;
+}
+
+//------------------------------------------------------------------------------
+ArchetypeStorage::~ArchetypeStorage()
+{
+	for (Archetype* archetype : Archetypes)
+		delete archetype;
+}
+
+//------------------------------------------------------------------------------
+void ArchetypeStorage::UpdateEntity(Entity* ent)
+{
+	if (ent->EntityArchetype)
+		ent->EntityArchetype->Remove(ent);
+
+	// entities without components are not part of any query
+	if (ent->ComponentPosessionFlags.none())
+		return;
+
+	STATIC_ASSERTE(MAX_COMPONENTS_COUNT <= 64, "Archetype mask key has to fit into unsigned long long.");
+	const unsigned long long key = ent->ComponentPosessionFlags.to_ullong();
+	auto it = MaskToArchetypeIdx.find(key);
+	size_t idx;
+	if (it == MaskToArchetypeIdx.end())
+	{
+		idx = Archetypes.GetSize();
+		Archetypes.PushBack(new Archetype(ent->ComponentPosessionFlags));
+		MaskToArchetypeIdx.emplace(key, idx);
+	}
+	else
+		idx = it->second;
+
+	Archetypes[idx]->Add(ent);
+}
+
+//------------------------------------------------------------------------------
+void ArchetypeStorage::RemoveEntity(Entity* ent)
+{
+	if (ent->EntityArchetype)
+		ent->EntityArchetype->Remove(ent);
+}
+
+//------------------------------------------------------------------------------
+ArchetypeStorage::Cursor ArchetypeStorage::FirstRowFrom(size_t archetypeIdx, size_t componentID) const
+{
+	for (; archetypeIdx < Archetypes.GetSize(); ++archetypeIdx)
+	{
+		const Archetype* archetype = Archetypes[archetypeIdx];
+		if (archetype->HasComponent(componentID) && archetype->GetEntityCount() > 0)
+			return Cursor{ archetypeIdx, 0, 0 };
+	}
+	return End();
+}
+
+//------------------------------------------------------------------------------
+ArchetypeStorage::Cursor ArchetypeStorage::Begin(size_t componentID) const
+{
+	return FirstRowFrom(0, componentID);
+}
+
+//------------------------------------------------------------------------------
+ArchetypeStorage::Cursor ArchetypeStorage::End() const
+{
+	return Cursor{ Archetypes.GetSize(), 0, 0 };
+}
+
+//------------------------------------------------------------------------------
+void ArchetypeStorage::Next(Cursor& cursor, size_t componentID) const
+{
+	const Archetype* archetype = Archetypes[cursor.ArchetypeIdx];
+	if (++cursor.Row < archetype->GetChunkSize(cursor.ChunkIdx))
+		return;
+
+	cursor.Row = 0;
+	if (++cursor.ChunkIdx < archetype->GetChunkCount())
+		return;
+
+	cursor = FirstRowFrom(cursor.ArchetypeIdx + 1, componentID);
+}
+
+//------------------------------------------------------------------------------
+void ArchetypeStorage::Prev(Cursor& cursor, size_t componentID) const
+{
+	if (cursor.Row > 0)
+	{
+		--cursor.Row;
+		return;
+	}
+
+	if (cursor.ChunkIdx > 0 && cursor.ArchetypeIdx < Archetypes.GetSize())
+	{
+		--cursor.ChunkIdx;
+		cursor.Row = Archetypes[cursor.ArchetypeIdx]->GetChunkSize(cursor.ChunkIdx) - 1;
+		return;
+	}
+
+	size_t archetypeIdx = cursor.ArchetypeIdx;
+	while (archetypeIdx > 0)
+	{
+		const Archetype* archetype = Archetypes[--archetypeIdx];
+		if (archetype->HasComponent(componentID) && archetype->GetEntityCount() > 0)
+		{
+			const size_t lastChunk = archetype->GetChunkCount() - 1;
+			cursor = Cursor{ archetypeIdx, lastChunk, archetype->GetChunkSize(lastChunk) - 1 };
+			return;
+		}
+	}
+	HEAVY_ASSERTE(false, "Decrementing begin iterator");
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <unordered_map>
+#include <Core.hpp>
+
+#include "Entity.hpp"
+
+namespace Poly
+{
+	/// <summary>Amount of entities stored in a single archetype chunk.</summary>
+	constexpr size_t ARCHETYPE_CHUNK_CAPACITY = 256;
+
+	/// <summary>Group of entities that share the same component set (the same Entity::ComponentPosessionFlags).
+	/// Entities of an archetype are stored in fixed size chunks, every chunk keeps a contiguous column
+	/// of component pointers per component type (SoA), so multi-component queries are linear scans.</summary>
+	class ENGINE_DLLEXPORT Archetype : public BaseObject<>
+	{
+	public:
+		explicit Archetype(const std::bitset<MAX_COMPONENTS_COUNT>& mask);
+		~Archetype();
+
+		const std::bitset<MAX_COMPONENTS_COUNT>& GetMask() const { return Mask; }
+		bool HasComponent(size_t componentID) const { return Mask[componentID]; }
+
+		size_t GetEntityCount() const { return EntityCount; }
+		size_t GetChunkCount() const { return Chunks.GetSize(); }
+		size_t GetChunkSize(size_t chunk) const { return Chunks[chunk]->Count; }
+
+		/// <summary>Returns contiguous column of components of given type stored in given chunk.</summary>
+		/// <returns>Column of GetChunkSize(chunk) component pointers or nullptr when archetype lacks that component type.</returns>
+		ComponentBase* const* GetColumn(size_t chunk, size_t componentID) const
+		{
+			HEAVY_ASSERTE(componentID < MAX_COMPONENTS_COUNT, "Invalid component ID");
+			const size_t column = ColumnIndices[componentID];
+			return column == INVALID_COLUMN ? nullptr : Chunks[chunk]->Columns + column * ARCHETYPE_CHUNK_CAPACITY;
+		}
+
+		/// <summary>Returns contiguous array of entities stored in given chunk.</summary>
+		Entity* const* GetEntities(size_t chunk) const { return Chunks[chunk]->Entities; }
+
+	private:
+		static constexpr u8 INVALID_COLUMN = 0xFF;
+
+		struct Chunk : public BaseObject<>
+		{
+			explicit Chunk(size_t columnCount);
+			~Chunk();
+
+			size_t Count = 0;
+			Entity* Entities[ARCHETYPE_CHUNK_CAPACITY];
+			ComponentBase** Columns = nullptr;
+		};
+
+		void Add(Entity* ent);
+		void Remove(Entity* ent);
+
+		std::bitset<MAX_COMPONENTS_COUNT> Mask;
+		Dynarray<size_t> ComponentIDs;
+		u8 ColumnIndices[MAX_COMPONENTS_COUNT];
+		Dynarray<Chunk*> Chunks;
+		size_t EntityCount = 0;
+
+		friend class ArchetypeStorage;
+	};
+
+	/// <summary>Optional World storage backend that groups entities into archetypes.
+	/// Components themselves stay in their pool allocators (they are referenced by pointers from other systems),
+	/// archetypes keep tightly packed tables of component pointers that World::IterateComponents can scan.</summary>
+	class ENGINE_DLLEXPORT ArchetypeStorage : public BaseObject<>
+	{
+	public:
+		/// <summary>Position of the entity row inside the storage.</summary>
+		struct Cursor
+		{
+			bool operator==(const Cursor& rhs) const { return ArchetypeIdx == rhs.ArchetypeIdx && ChunkIdx == rhs.ChunkIdx && Row == rhs.Row; }
+			bool operator!=(const Cursor& rhs) const { return !(*this == rhs); }
+
+			size_t ArchetypeIdx = 0;
+			size_t ChunkIdx = 0;
+			size_t Row = 0;
+		};
+
+		ArchetypeStorage() = default;
+		~ArchetypeStorage();
+
+		/// <summary>Moves entity to the archetype that matches its current component set.
+		/// Has to be called every time a component is added to or removed from an entity.</summary>
+		void UpdateEntity(Entity* ent);
+
+		/// <summary>Removes entity from its archetype.</summary>
+		void RemoveEntity(Entity* ent);
+
+		size_t GetArchetypeCount() const { return Archetypes.GetSize(); }
+		const Archetype* GetArchetype(size_t idx) const { return Archetypes[idx]; }
+
+		/// <summary>Returns cursor pointing at the first row of an archetype containing given component type.</summary>
+		Cursor Begin(size_t componentID) const;
+		/// <summary>Returns past-the-end cursor.</summary>
+		Cursor End() const;
+		/// <summary>Advances cursor to the next row of an archetype containing given component type.</summary>
+		void Next(Cursor& cursor, size_t componentID) const;
+		/// <summary>Moves cursor to the previous row of an archetype containing given component type.</summary>
+		void Prev(Cursor& cursor, size_t componentID) const;
+
+	private:
+		Cursor FirstRowFrom(size_t archetypeIdx, size_t componentID) const;
+
+		Dynarray<Archetype*> Archetypes;
+		std::unordered_map<unsigned long long, size_t> MaskToArchetypeIdx;
+	};
+}
@@ -2,6 +2,7 @@
 
 #include "ComponentBase.hpp"
 #include "CameraSystem.hpp"
+#include "CullingSystem.hpp"
 
 namespace Poly {
 
@@ -19,6 +20,7 @@ namespace Poly {
 	class ENGINE_DLLEXPORT CameraComponent : public ComponentBase
 	{
 		friend void CameraSystem::CameraUpdatePhase(World*);
+		friend void CullingSystem::CullingUpdatePhase(World*);
 	public:
 		CameraComponent(Angle fov, float zNear, float zFar);
 		CameraComponent(float top, float bottom, float left, float right, float zNear, float zFar);
@@ -32,9 +34,19 @@ namespace Poly {
 		void SetTargetFOV(const Angle& Value) { TargetFov = Value; }
 		void SetFOV(const Angle& Value) { Fov = Value; }
 		float GetAspect() const { return Aspect; }
+		bool IsPerspectiveProjection() const { return IsPerspective; }
+		float GetClippingPlaneNear() const { return Near; }
+		float GetClippingPlaneFar() const { return Far; }
+		float GetOrthographicTop() const { return Top; }
+		float GetOrthographicBottom() const { return Bottom; }
+		float GetOrthographicLeft() const { return Left; }
+		float GetOrthographicRight() const { return Right; }
 		eRenderingModeType GetRenderingMode() const { return RenderingMode; }
 		void SetRenderingMode(eRenderingModeType value) { RenderingMode = value; }
 
+		/// <summary>Returns submeshes that passed frustum culling in the last CullingSystem::CullingUpdatePhase.</summary>
+		const Dynarray<VisibleSubMesh>& GetVisibleSubMeshes() const { return VisibleSubMeshes; }
+
 	private:
 		Matrix Projection;
 		Matrix ModelView;
@@ -58,6 +70,8 @@ namespace Poly {
 
 		// RenderingMode
 		eRenderingModeType RenderingMode;
+
+		Dynarray<VisibleSubMesh> VisibleSubMeshes;
 	};
 
 	REGISTER_COMPONENT(ComponentsIDGroup, CameraComponent)
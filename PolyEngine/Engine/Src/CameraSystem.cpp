@@ -27,7 +27,7 @@ void Poly::CameraSystem::CameraUpdatePhase(World* world)
 					cameraCmp->Projection.SetOrthographic(cameraCmp->Top, cameraCmp->Bottom, cameraCmp->Left, cameraCmp->Right, cameraCmp->Near, cameraCmp->Far);
 			}
 
-			cameraCmp->ModelView = transformCmp->GetGlobalTransformationMatrix().GetInversed();
+			cameraCmp->ModelView = transformCmp->GetGlobalTransformationMatrix().GetAffineInversed();
 			cameraCmp->MVP = cameraCmp->Projection * cameraCmp->ModelView;
 		}
 		else
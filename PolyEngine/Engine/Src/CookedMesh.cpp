@@ -0,0 +1,178 @@
+#include "EnginePCH.hpp"
+
+#include "CookedMesh.hpp"
+#include "MeshResource.hpp"
+
+using namespace Poly;
+
+namespace
+{
+	size_t GetVertexStride(u32 flags)
+	{
+		size_t stride = 3 * sizeof(float);
+		if (flags & CookedMesh::HAS_TEXT_COORDS)
+			stride += (flags & CookedMesh::HALF_TEXT_COORDS) ? 2 * sizeof(u16) : 2 * sizeof(float);
+		if (flags & CookedMesh::HAS_NORMALS)
+			stride += (flags & CookedMesh::PACKED_NORMALS) ? sizeof(u32) : 3 * sizeof(float);
+		return stride;
+	}
+
+	bool IsBlobInFile(u64 offset, u64 size, size_t fileSize, bool aligned)
+	{
+		return offset <= fileSize && size <= fileSize - offset && (!aligned || offset % CookedMesh::BLOB_ALIGNMENT == 0);
+	}
+
+	// index data has to be an aligned blob in the file
+	template<typename Index>
+	bool AreIndicesInRange(const u8* indexData, u32 indexCount, u32 vertexCount)
+	{
+		const Index* indices = reinterpret_cast<const Index*>(indexData);
+		Index maxIndex = 0;
+		for (u32 i = 0; i < indexCount; ++i)
+			maxIndex = std::max(maxIndex, indices[i]);
+		return indexCount == 0 || maxIndex < vertexCount;
+	}
+
+	// appends data at the next aligned offset, padding is zeroed
+	u64 AppendBlob(Dynarray<u8>& file, const void* data, size_t size)
+	{
+		const size_t offset = (file.GetSize() + CookedMesh::BLOB_ALIGNMENT - 1) / CookedMesh::BLOB_ALIGNMENT * CookedMesh::BLOB_ALIGNMENT;
+		const size_t oldSize = file.GetSize();
+		if (offset + size > file.GetCapacity())
+			file.Reserve(std::max(offset + size, file.GetCapacity() * 2));
+		file.Resize(offset + size);
+		memset(file.GetData() + oldSize, 0, offset - oldSize);
+		if (size > 0)
+			memcpy(file.GetData() + offset, data, size);
+		return offset;
+	}
+}
+
+//------------------------------------------------------------------------------
+bool CookedMesh::IsCookedMesh(const u8* data, size_t size)
+{
+	return size >= sizeof(FileHeader) && reinterpret_cast<const FileHeader*>(data)->Magic == MAGIC;
+}
+
+//------------------------------------------------------------------------------
+bool CookedMesh::Validate(const u8* data, size_t size)
+{
+	if (!IsCookedMesh(data, size))
+	{
+		gConsole.LogError("Cooked mesh header is missing");
+		return false;
+	}
+
+	const FileHeader& header = *reinterpret_cast<const FileHeader*>(data);
+	if (header.Version != VERSION)
+	{
+		gConsole.LogError("Cooked mesh version {} is not supported, expected version {}. Cook the mesh again.", header.Version, VERSION);
+		return false;
+	}
+
+	if (!IsBlobInFile(sizeof(FileHeader), u64(header.SubMeshCount) * sizeof(SubMeshHeader), size, false))
+	{
+		gConsole.LogError("Cooked mesh is truncated");
+		return false;
+	}
+
+	const SubMeshHeader* subMeshes = reinterpret_cast<const SubMeshHeader*>(data + sizeof(FileHeader));
+	for (u32 i = 0; i < header.SubMeshCount; ++i)
+	{
+		const SubMeshHeader& subMesh = subMeshes[i];
+		const bool shortIndices = (subMesh.Flags & SHORT_INDICES) != 0;
+		const size_t indexSize = shortIndices ? sizeof(u16) : sizeof(u32);
+		const u8* indexData = data + subMesh.IndexDataOffset;
+		// indices are checked only once their blob is known to be in the file
+		const bool valid = subMesh.VertexStride == GetVertexStride(subMesh.Flags)
+			&& subMesh.IndexCount % 3 == 0
+			&& IsBlobInFile(subMesh.VertexDataOffset, u64(subMesh.VertexCount) * subMesh.VertexStride, size, true)
+			&& IsBlobInFile(subMesh.IndexDataOffset, u64(subMesh.IndexCount) * indexSize, size, true)
+			&& IsBlobInFile(subMesh.DiffuseTexturePathOffset, subMesh.DiffuseTexturePathLength, size, false)
+			&& (shortIndices ? AreIndicesInRange<u16>(indexData, subMesh.IndexCount, subMesh.VertexCount)
+				: AreIndicesInRange<u32>(indexData, subMesh.IndexCount, subMesh.VertexCount));
+		if (!valid)
+		{
+			gConsole.LogError("Sub mesh {} of cooked mesh is corrupted", i);
+			return false;
+		}
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+void CookedMesh::Write(const MeshResource& mesh, const String& path)
+{
+	const Dynarray<MeshResource::SubMesh*>& subMeshes = mesh.GetSubMeshes();
+
+	FileHeader header = { MAGIC, VERSION, static_cast<u32>(subMeshes.GetSize()), 0 };
+	Dynarray<SubMeshHeader> subMeshHeaders;
+	subMeshHeaders.Resize(subMeshes.GetSize());
+
+	// headers are written first and filled once offsets of all blobs are known
+	Dynarray<u8> file;
+	AppendBlob(file, &header, sizeof(header));
+	const u64 headersOffset = AppendBlob(file, subMeshHeaders.GetData(), subMeshHeaders.GetSize() * sizeof(SubMeshHeader));
+
+	for (size_t i = 0; i < subMeshes.GetSize(); ++i)
+	{
+		const MeshResource::SubMesh& subMesh = *subMeshes[i];
+		const Mesh& data = subMesh.GetMeshData();
+		const VertexFormat& format = data.GetVertexFormat();
+		ASSERTE(format.Interleaved, "Only interleaved meshes can be cooked!");
+
+		SubMeshHeader& subMeshHeader = subMeshHeaders[i];
+		memset(&subMeshHeader, 0, sizeof(SubMeshHeader));
+		if (data.HasTextCoords())
+			subMeshHeader.Flags |= HAS_TEXT_COORDS;
+		if (data.HasNormals())
+			subMeshHeader.Flags |= HAS_NORMALS;
+		if (format.HalfTextCoords)
+			subMeshHeader.Flags |= HALF_TEXT_COORDS;
+		if (format.PackedNormals)
+			subMeshHeader.Flags |= PACKED_NORMALS;
+		if (format.ShortIndices)
+			subMeshHeader.Flags |= SHORT_INDICES;
+		subMeshHeader.VertexCount = static_cast<u32>(data.GetVertexCount());
+		subMeshHeader.IndexCount = static_cast<u32>(data.GetTriangleCount() * 3);
+		subMeshHeader.VertexStride = static_cast<u32>(data.GetVertexStride());
+
+		if (data.IsPacked())
+		{
+			subMeshHeader.VertexDataOffset = AppendBlob(file, data.GetPackedContent().Vertices, subMeshHeader.VertexCount * subMeshHeader.VertexStride);
+			subMeshHeader.IndexDataOffset = AppendBlob(file, data.GetPackedContent().Indices, subMeshHeader.IndexCount * data.GetIndexSize());
+		}
+		else
+		{
+			Dynarray<u8> blob;
+			data.PackVertices(blob);
+			subMeshHeader.VertexDataOffset = AppendBlob(file, blob.GetData(), blob.GetSize());
+			data.PackIndices(blob);
+			subMeshHeader.IndexDataOffset = AppendBlob(file, blob.GetData(), blob.GetSize());
+		}
+
+		const String& texturePath = subMesh.GetDiffuseTexturePath();
+		subMeshHeader.DiffuseTexturePathLength = static_cast<u32>(texturePath.GetLength());
+		subMeshHeader.DiffuseTexturePathOffset = AppendBlob(file, texturePath.GetCStr(), texturePath.GetLength());
+
+		const AABox& box = subMesh.GetBoundingBox();
+		const Vector& center = subMesh.GetBoundingSphereCenter();
+		const float boxMin[3] = { box.GetMin().X, box.GetMin().Y, box.GetMin().Z };
+		const float boxSize[3] = { box.GetSize().X, box.GetSize().Y, box.GetSize().Z };
+		const float sphereCenter[3] = { center.X, center.Y, center.Z };
+		memcpy(subMeshHeader.BoxMin, boxMin, sizeof(boxMin));
+		memcpy(subMeshHeader.BoxSize, boxSize, sizeof(boxSize));
+		memcpy(subMeshHeader.SphereCenter, sphereCenter, sizeof(sphereCenter));
+		subMeshHeader.SphereRadius = subMesh.GetBoundingSphereRadius();
+
+		const Mesh::Material& material = data.GetMaterial();
+		subMeshHeader.SpecularIntensity = material.SpecularIntensity;
+		subMeshHeader.SpecularPower = material.SpecularPower;
+		const float specularColor[4] = { material.SpecularColor.R, material.SpecularColor.G, material.SpecularColor.B, material.SpecularColor.A };
+		memcpy(subMeshHeader.SpecularColor, specularColor, sizeof(specularColor));
+	}
+
+	if (!subMeshHeaders.IsEmpty())
+		memcpy(file.GetData() + headersOffset, subMeshHeaders.GetData(), subMeshHeaders.GetSize() * sizeof(SubMeshHeader));
+	SaveBinaryFile(path, file.GetData(), file.GetSize());
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Core.hpp>
+
+namespace Poly
+{
+	class MeshResource;
+
+	/// <summary>Binary mesh format written offline by the asset cooker and memory mapped by MeshResource.
+	/// File starts with FileHeader followed by SubMeshHeader of every sub mesh. Vertices of each sub mesh are stored
+	/// interleaved in the layout of its vertex format, so they can be uploaded to the device without per vertex work.
+	/// Data blobs are aligned to BLOB_ALIGNMENT, all values are little endian.</summary>
+	namespace CookedMesh
+	{
+		constexpr u32 MAGIC = 0x48534D50; // "PMSH"
+		constexpr u32 VERSION = 1;
+		constexpr size_t BLOB_ALIGNMENT = 16;
+
+		enum eSubMeshFlags : u32
+		{
+			HAS_TEXT_COORDS = 1 << 0,
+			HAS_NORMALS = 1 << 1,
+			HALF_TEXT_COORDS = 1 << 2,
+			PACKED_NORMALS = 1 << 3,
+			SHORT_INDICES = 1 << 4,
+		};
+
+		struct FileHeader
+		{
+			u32 Magic;
+			u32 Version;
+			u32 SubMeshCount;
+			u32 Reserved;
+		};
+
+		struct SubMeshHeader
+		{
+			u32 Flags;
+			u32 VertexCount;
+			u32 IndexCount;
+			u32 VertexStride;
+			// offsets from the beginning of the file
+			u64 VertexDataOffset;
+			u64 IndexDataOffset;
+			u64 DiffuseTexturePathOffset;
+			// path relative to the mesh file, 0 when there is no diffuse texture
+			u32 DiffuseTexturePathLength;
+			u32 Reserved;
+			float BoxMin[3];
+			float BoxSize[3];
+			float SphereCenter[3];
+			float SphereRadius;
+			float SpecularIntensity;
+			float SpecularPower;
+			float SpecularColor[4];
+		};
+
+		STATIC_ASSERTE(sizeof(FileHeader) == 16, "Cooked mesh header layout changed!");
+		STATIC_ASSERTE(sizeof(SubMeshHeader) == 112, "Cooked mesh header layout changed!");
+
+		/// <summary>Checks whether data starts with header of a cooked mesh.</summary>
+		ENGINE_DLLEXPORT bool IsCookedMesh(const u8* data, size_t size);
+
+		/// <summary>Checks headers and bounds of all blobs of a cooked mesh, logs the reason of failure.</summary>
+		ENGINE_DLLEXPORT bool Validate(const u8* data, size_t size);
+
+		/// <summary>Writes all sub meshes of a mesh imported from source asset.</summary>
+		/// <exception cref="FileIOException">Thrown when the file cannot be written.</exception>
+		ENGINE_DLLEXPORT void Write(const MeshResource& mesh, const String& path);
+	}
+}
@@ -0,0 +1,627 @@
+#include "EnginePCH.hpp"
+
+#include "CookedTexture.hpp"
+
+using namespace Poly;
+
+namespace
+{
+	typedef u8 BlockPixels[16][4];
+
+	// weights of 4-bit BC7 indices, out of 64
+	const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	size_t GetBlockSize(eTextureDataFormat format)
+	{
+		return format == eTextureDataFormat::BC1 ? 8 : 16;
+	}
+
+	size_t Align(size_t offset)
+	{
+		return (offset + CookedTexture::BLOB_ALIGNMENT - 1) / CookedTexture::BLOB_ALIGNMENT * CookedTexture::BLOB_ALIGNMENT;
+	}
+
+	// pixels outside of the image repeat its edge
+	void LoadBlock(const u8* rgba, size_t width, size_t height, size_t blockX, size_t blockY, BlockPixels pixels)
+	{
+		for (size_t y = 0; y < 4; ++y)
+		{
+			const size_t srcY = std::min(blockY * 4 + y, height - 1);
+			for (size_t x = 0; x < 4; ++x)
+			{
+				const size_t srcX = std::min(blockX * 4 + x, width - 1);
+				memcpy(pixels[y * 4 + x], rgba + (srcY * width + srcX) * 4, 4);
+			}
+		}
+	}
+
+	void StoreBlock(const BlockPixels pixels, size_t width, size_t height, size_t blockX, size_t blockY, u8* rgba)
+	{
+		for (size_t y = 0; y < 4 && blockY * 4 + y < height; ++y)
+			for (size_t x = 0; x < 4 && blockX * 4 + x < width; ++x)
+				memcpy(rgba + ((blockY * 4 + y) * width + blockX * 4 + x) * 4, pixels[y * 4 + x], 4);
+	}
+
+	// ends of the segment covering selected pixels along principal axis of their colors
+	void FindEndpoints(const BlockPixels pixels, const bool selected[16], size_t channels, float e0[4], float e1[4])
+	{
+		float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		size_t count = 0;
+		for (size_t i = 0; i < 16; ++i)
+		{
+			if (!selected[i])
+				continue;
+			for (size_t c = 0; c < channels; ++c)
+				mean[c] += pixels[i][c];
+			++count;
+		}
+
+		for (size_t c = 0; c < 4; ++c)
+			e0[c] = e1[c] = 0.0f;
+		if (count == 0)
+			return;
+
+		float covariance[4][4] = {};
+		for (size_t c = 0; c < channels; ++c)
+			mean[c] /= count;
+		for (size_t i = 0; i < 16; ++i)
+		{
+			if (!selected[i])
+				continue;
+			for (size_t a = 0; a < channels; ++a)
+				for (size_t b = 0; b < channels; ++b)
+					covariance[a][b] += (pixels[i][a] - mean[a]) * (pixels[i][b] - mean[b]);
+		}
+
+		// power iteration, uniform blocks keep the initial axis and collapse to their mean
+		float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		for (size_t iteration = 0; iteration < 8; ++iteration)
+		{
+			float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			float length = 0.0f;
+			for (size_t a = 0; a < channels; ++a)
+			{
+				for (size_t b = 0; b < channels; ++b)
+					next[a] += covariance[a][b] * axis[b];
+				length = std::max(length, std::abs(next[a]));
+			}
+			if (length < 1e-6f)
+				break;
+			for (size_t c = 0; c < channels; ++c)
+				axis[c] = next[c] / length;
+		}
+
+		float axisLengthSquared = 0.0f;
+		for (size_t c = 0; c < channels; ++c)
+			axisLengthSquared += axis[c] * axis[c];
+
+		float minT = std::numeric_limits<float>::max();
+		float maxT = std::numeric_limits<float>::lowest();
+		for (size_t i = 0; i < 16; ++i)
+		{
+			if (!selected[i])
+				continue;
+			float t = 0.0f;
+			for (size_t c = 0; c < channels; ++c)
+				t += (pixels[i][c] - mean[c]) * axis[c];
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+
+		for (size_t c = 0; c < channels; ++c)
+		{
+			e0[c] = Clamp(mean[c] + axis[c] * minT / axisLengthSquared, 0.0f, 255.0f);
+			e1[c] = Clamp(mean[c] + axis[c] * maxT / axisLengthSquared, 0.0f, 255.0f);
+		}
+	}
+
+	template <typename T, size_t N>
+	size_t FindNearest(const u8 pixel[4], const T (&palette)[N][4], size_t paletteSize, size_t channels)
+	{
+		size_t best = 0;
+		int bestDistance = std::numeric_limits<int>::max();
+		for (size_t k = 0; k < paletteSize; ++k)
+		{
+			int distance = 0;
+			for (size_t c = 0; c < channels; ++c)
+				distance += (pixel[c] - palette[k][c]) * (pixel[c] - palette[k][c]);
+			if (distance < bestDistance)
+			{
+				bestDistance = distance;
+				best = k;
+			}
+		}
+		return best;
+	}
+
+	//------------------------------------------------------------------------------
+	u16 To565(const float color[4])
+	{
+		const int r = static_cast<int>(color[0] * 31.0f / 255.0f + 0.5f);
+		const int g = static_cast<int>(color[1] * 63.0f / 255.0f + 0.5f);
+		const int b = static_cast<int>(color[2] * 31.0f / 255.0f + 0.5f);
+		return static_cast<u16>((r << 11) | (g << 5) | b);
+	}
+
+	void From565(u16 value, int color[4])
+	{
+		const int r = value >> 11, g = (value >> 5) & 63, b = value & 31;
+		color[0] = (r << 3) | (r >> 2);
+		color[1] = (g << 2) | (g >> 4);
+		color[2] = (b << 3) | (b >> 2);
+		color[3] = 255;
+	}
+
+	// BC1 blocks use 3 colors and transparent black when the first endpoint is not greater, color blocks of BC3 always use 4 colors
+	void GetColorPalette(u16 c0, u16 c1, bool fourColors, int palette[4][4])
+	{
+		From565(c0, palette[0]);
+		From565(c1, palette[1]);
+		for (size_t c = 0; c < 3; ++c)
+		{
+			if (fourColors)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+			else
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+				palette[3][c] = 0;
+			}
+		}
+		palette[2][3] = 255;
+		palette[3][3] = fourColors ? 255 : 0;
+	}
+
+	void EncodeColorBlock(const BlockPixels pixels, bool punchThroughAlpha, u8* block)
+	{
+		bool opaque[16];
+		bool hasTransparent = false;
+		for (size_t i = 0; i < 16; ++i)
+		{
+			opaque[i] = !punchThroughAlpha || pixels[i][3] >= 128;
+			hasTransparent |= !opaque[i];
+		}
+
+		float e0[4], e1[4];
+		FindEndpoints(pixels, opaque, 3, e0, e1);
+		u16 c0 = To565(e0);
+		u16 c1 = To565(e1);
+
+		// order of endpoints selects the palette of BC1 block
+		if (punchThroughAlpha && (hasTransparent ? c0 > c1 : c0 < c1))
+			std::swap(c0, c1);
+		const bool fourColors = !punchThroughAlpha || c0 > c1;
+
+		int palette[4][4];
+		GetColorPalette(c0, c1, fourColors, palette);
+		u32 indices = 0;
+		for (size_t i = 0; i < 16; ++i)
+		{
+			const size_t index = opaque[i] ? FindNearest(pixels[i], palette, fourColors ? 4 : 3, 3) : 3;
+			indices |= static_cast<u32>(index) << (2 * i);
+		}
+
+		memcpy(block, &c0, sizeof(c0));
+		memcpy(block + 2, &c1, sizeof(c1));
+		memcpy(block + 4, &indices, sizeof(indices));
+	}
+
+	void DecodeColorBlock(const u8* block, bool punchThroughAlpha, BlockPixels pixels)
+	{
+		u16 c0, c1;
+		u32 indices;
+		memcpy(&c0, block, sizeof(c0));
+		memcpy(&c1, block + 2, sizeof(c1));
+		memcpy(&indices, block + 4, sizeof(indices));
+
+		int palette[4][4];
+		GetColorPalette(c0, c1, !punchThroughAlpha || c0 > c1, palette);
+		for (size_t i = 0; i < 16; ++i)
+		{
+			const int* color = palette[(indices >> (2 * i)) & 3];
+			for (size_t c = 0; c < 4; ++c)
+				pixels[i][c] = static_cast<u8>(color[c]);
+		}
+	}
+
+	//------------------------------------------------------------------------------
+	void GetAlphaPalette(int a0, int a1, int palette[8])
+	{
+		palette[0] = a0;
+		palette[1] = a1;
+		if (a0 > a1)
+		{
+			for (int k = 1; k < 7; ++k)
+				palette[k + 1] = ((7 - k) * a0 + k * a1) / 7;
+		}
+		else
+		{
+			for (int k = 1; k < 5; ++k)
+				palette[k + 1] = ((5 - k) * a0 + k * a1) / 5;
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+	}
+
+	void EncodeAlphaBlock(const BlockPixels pixels, u8* block)
+	{
+		int a0 = 0, a1 = 255;
+		for (size_t i = 0; i < 16; ++i)
+		{
+			a0 = std::max<int>(a0, pixels[i][3]);
+			a1 = std::min<int>(a1, pixels[i][3]);
+		}
+
+		int palette[8];
+		GetAlphaPalette(a0, a1, palette);
+		u64 indices = 0;
+		for (size_t i = 0; i < 16; ++i)
+		{
+			u64 best = 0;
+			for (u64 k = 1; k < 8; ++k)
+				if (std::abs(pixels[i][3] - palette[k]) < std::abs(pixels[i][3] - palette[best]))
+					best = k;
+			indices |= best << (3 * i);
+		}
+
+		block[0] = static_cast<u8>(a0);
+		block[1] = static_cast<u8>(a1);
+		for (size_t b = 0; b < 6; ++b)
+			block[2 + b] = static_cast<u8>(indices >> (8 * b));
+	}
+
+	void DecodeAlphaBlock(const u8* block, BlockPixels pixels)
+	{
+		int palette[8];
+		GetAlphaPalette(block[0], block[1], palette);
+		u64 indices = 0;
+		for (size_t b = 0; b < 6; ++b)
+			indices |= u64(block[2 + b]) << (8 * b);
+		for (size_t i = 0; i < 16; ++i)
+			pixels[i][3] = static_cast<u8>(palette[(indices >> (3 * i)) & 7]);
+	}
+
+	//------------------------------------------------------------------------------
+	void WriteBits(u8* block, size_t& offset, u32 value, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i, ++offset)
+			if ((value >> i) & 1)
+				block[offset / 8] |= static_cast<u8>(1 << (offset % 8));
+	}
+
+	u32 ReadBits(const u8* block, size_t& offset, size_t count)
+	{
+		u32 value = 0;
+		for (size_t i = 0; i < count; ++i, ++offset)
+			value |= static_cast<u32>((block[offset / 8] >> (offset % 8)) & 1) << i;
+		return value;
+	}
+
+	void GetBC7Palette(const int endpoints[2][4], int palette[16][4])
+	{
+		for (size_t k = 0; k < 16; ++k)
+			for (size_t c = 0; c < 4; ++c)
+				palette[k][c] = ((64 - BC7_WEIGHTS[k]) * endpoints[0][c] + BC7_WEIGHTS[k] * endpoints[1][c] + 32) >> 6;
+	}
+
+	// mode 6: single subset, 7-bit RGBA endpoints with a p-bit each and 4-bit indices
+	void EncodeBC7Block(const BlockPixels pixels, u8* block)
+	{
+		const bool all[16] = { true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true };
+		float ends[2][4];
+		FindEndpoints(pixels, all, 4, ends[0], ends[1]);
+
+		int quantized[2][4];
+		int pBits[2];
+		for (size_t e = 0; e < 2; ++e)
+		{
+			float bestError = std::numeric_limits<float>::max();
+			for (int p = 0; p < 2; ++p)
+			{
+				int candidate[4];
+				float error = 0.0f;
+				for (size_t c = 0; c < 4; ++c)
+				{
+					candidate[c] = Clamp(static_cast<int>((ends[e][c] - p) / 2.0f + 0.5f), 0, 127);
+					const float difference = float(candidate[c] * 2 + p) - ends[e][c];
+					error += difference * difference;
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					pBits[e] = p;
+					memcpy(quantized[e], candidate, sizeof(candidate));
+				}
+			}
+		}
+
+		int endpoints[2][4];
+		for (size_t e = 0; e < 2; ++e)
+			for (size_t c = 0; c < 4; ++c)
+				endpoints[e][c] = (quantized[e][c] << 1) | pBits[e];
+
+		int palette[16][4];
+		GetBC7Palette(endpoints, palette);
+		u32 indices[16];
+		for (size_t i = 0; i < 16; ++i)
+			indices[i] = static_cast<u32>(FindNearest(pixels[i], palette, 16, 4));
+
+		// highest bit of the first index is implicit zero, weights are symmetric so swapping endpoints mirrors indices
+		if (indices[0] & 8)
+		{
+			std::swap(quantized[0], quantized[1]);
+			std::swap(pBits[0], pBits[1]);
+			for (size_t i = 0; i < 16; ++i)
+				indices[i] = 15 - indices[i];
+		}
+
+		memset(block, 0, 16);
+		size_t offset = 0;
+		WriteBits(block, offset, 1 << 6, 7);
+		for (size_t c = 0; c < 4; ++c)
+			for (size_t e = 0; e < 2; ++e)
+				WriteBits(block, offset, quantized[e][c], 7);
+		WriteBits(block, offset, pBits[0], 1);
+		WriteBits(block, offset, pBits[1], 1);
+		for (size_t i = 0; i < 16; ++i)
+			WriteBits(block, offset, indices[i], i == 0 ? 3 : 4);
+	}
+
+	void DecodeBC7Block(const u8* block, BlockPixels pixels)
+	{
+		if ((block[0] & 0x7F) != 0x40)
+		{
+			for (size_t i = 0; i < 16; ++i)
+			{
+				pixels[i][0] = pixels[i][2] = pixels[i][3] = 255;
+				pixels[i][1] = 0;
+			}
+			return;
+		}
+
+		size_t offset = 7;
+		int endpoints[2][4];
+		for (size_t c = 0; c < 4; ++c)
+			for (size_t e = 0; e < 2; ++e)
+				endpoints[e][c] = ReadBits(block, offset, 7) << 1;
+		for (size_t e = 0; e < 2; ++e)
+		{
+			const int p = ReadBits(block, offset, 1);
+			for (size_t c = 0; c < 4; ++c)
+				endpoints[e][c] |= p;
+		}
+
+		int palette[16][4];
+		GetBC7Palette(endpoints, palette);
+		for (size_t i = 0; i < 16; ++i)
+		{
+			const int* color = palette[ReadBits(block, offset, i == 0 ? 3 : 4)];
+			for (size_t c = 0; c < 4; ++c)
+				pixels[i][c] = static_cast<u8>(color[c]);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+size_t CookedTexture::GetMipCount(size_t width, size_t height)
+{
+	size_t count = 1;
+	for (size_t size = std::max(width, height); size > 1; size /= 2)
+		++count;
+	return count;
+}
+
+//------------------------------------------------------------------------------
+size_t CookedTexture::GetImageSize(eTextureDataFormat format, size_t width, size_t height)
+{
+	switch (format)
+	{
+	case eTextureDataFormat::RGBA:
+		return width * height * 4;
+	case eTextureDataFormat::BC1:
+	case eTextureDataFormat::BC3:
+	case eTextureDataFormat::BC7:
+		return ((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format);
+	default:
+		ASSERTE(false, "Format is not supported by cooked textures!");
+	}
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+void CookedTexture::Downsample(const u8* rgba, size_t width, size_t height, u8* result)
+{
+	const size_t mipWidth = std::max<size_t>(width / 2, 1);
+	const size_t mipHeight = std::max<size_t>(height / 2, 1);
+	for (size_t y = 0; y < mipHeight; ++y)
+	{
+		const u8* row0 = rgba + std::min(2 * y, height - 1) * width * 4;
+		const u8* row1 = rgba + std::min(2 * y + 1, height - 1) * width * 4;
+		for (size_t x = 0; x < mipWidth; ++x)
+		{
+			const size_t x0 = std::min(2 * x, width - 1) * 4;
+			const size_t x1 = std::min(2 * x + 1, width - 1) * 4;
+			for (size_t c = 0; c < 4; ++c)
+				result[(y * mipWidth + x) * 4 + c] = static_cast<u8>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+void CookedTexture::Encode(eTextureDataFormat format, const u8* rgba, size_t width, size_t height, u8* blocks)
+{
+	if (format == eTextureDataFormat::RGBA)
+	{
+		memcpy(blocks, rgba, GetImageSize(format, width, height));
+		return;
+	}
+
+	const size_t blockSize = GetBlockSize(format);
+	BlockPixels pixels;
+	for (size_t blockY = 0; blockY < (height + 3) / 4; ++blockY)
+	{
+		for (size_t blockX = 0; blockX < (width + 3) / 4; ++blockX, blocks += blockSize)
+		{
+			LoadBlock(rgba, width, height, blockX, blockY, pixels);
+			switch (format)
+			{
+			case eTextureDataFormat::BC1:
+				EncodeColorBlock(pixels, true, blocks);
+				break;
+			case eTextureDataFormat::BC3:
+				EncodeAlphaBlock(pixels, blocks);
+				EncodeColorBlock(pixels, false, blocks + 8);
+				break;
+			case eTextureDataFormat::BC7:
+				EncodeBC7Block(pixels, blocks);
+				break;
+			default:
+				ASSERTE(false, "Format is not supported by cooked textures!");
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+void CookedTexture::Decode(eTextureDataFormat format, const u8* blocks, size_t width, size_t height, u8* rgba)
+{
+	if (format == eTextureDataFormat::RGBA)
+	{
+		memcpy(rgba, blocks, GetImageSize(format, width, height));
+		return;
+	}
+
+	const size_t blockSize = GetBlockSize(format);
+	BlockPixels pixels;
+	for (size_t blockY = 0; blockY < (height + 3) / 4; ++blockY)
+	{
+		for (size_t blockX = 0; blockX < (width + 3) / 4; ++blockX, blocks += blockSize)
+		{
+			switch (format)
+			{
+			case eTextureDataFormat::BC1:
+				DecodeColorBlock(blocks, true, pixels);
+				break;
+			case eTextureDataFormat::BC3:
+				DecodeColorBlock(blocks + 8, false, pixels);
+				DecodeAlphaBlock(blocks, pixels);
+				break;
+			case eTextureDataFormat::BC7:
+				DecodeBC7Block(blocks, pixels);
+				break;
+			default:
+				ASSERTE(false, "Format is not supported by cooked textures!");
+			}
+			StoreBlock(pixels, width, height, blockX, blockY, rgba);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+bool CookedTexture::IsCookedTexture(const u8* data, size_t size)
+{
+	return size >= sizeof(FileHeader) && reinterpret_cast<const FileHeader*>(data)->Magic == MAGIC;
+}
+
+//------------------------------------------------------------------------------
+bool CookedTexture::Validate(const u8* data, size_t size)
+{
+	if (!IsCookedTexture(data, size))
+	{
+		gConsole.LogError("Cooked texture header is missing");
+		return false;
+	}
+
+	const FileHeader& header = *reinterpret_cast<const FileHeader*>(data);
+	if (header.Version != VERSION)
+	{
+		gConsole.LogError("Cooked texture version {} is not supported, expected version {}. Cook the texture again.", header.Version, VERSION);
+		return false;
+	}
+
+	const eTextureDataFormat format = static_cast<eTextureDataFormat>(header.Format);
+	if (format != eTextureDataFormat::RGBA && format != eTextureDataFormat::BC1 && format != eTextureDataFormat::BC3 && format != eTextureDataFormat::BC7)
+	{
+		gConsole.LogError("Cooked texture format {} is not supported", header.Format);
+		return false;
+	}
+
+	if (header.Width == 0 || header.Height == 0 || header.MipCount != GetMipCount(header.Width, header.Height))
+	{
+		gConsole.LogError("Cooked texture does not contain full mip chain");
+		return false;
+	}
+
+	if (size - sizeof(FileHeader) < u64(header.MipCount) * sizeof(MipHeader))
+	{
+		gConsole.LogError("Cooked texture is truncated");
+		return false;
+	}
+
+	const MipHeader* mips = reinterpret_cast<const MipHeader*>(data + sizeof(FileHeader));
+	size_t width = header.Width;
+	size_t height = header.Height;
+	for (u32 i = 0; i < header.MipCount; ++i)
+	{
+		const MipHeader& mip = mips[i];
+		const bool valid = mip.Width == width && mip.Height == height
+			&& mip.DataSize == GetImageSize(format, width, height)
+			&& mip.DataOffset % BLOB_ALIGNMENT == 0
+			&& mip.DataOffset <= size && mip.DataSize <= size - mip.DataOffset;
+		if (!valid)
+		{
+			gConsole.LogError("Mip level {} of cooked texture is corrupted", i);
+			return false;
+		}
+		width = std::max<size_t>(width / 2, 1);
+		height = std::max<size_t>(height / 2, 1);
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+void CookedTexture::Write(const u8* rgba, size_t width, size_t height, eTextureDataFormat format, const String& path)
+{
+	ASSERTE(width > 0 && height > 0, "Invalid texture size!");
+	const size_t mipCount = GetMipCount(width, height);
+
+	// sizes of all levels are known up front, so levels are encoded directly into the file
+	Dynarray<MipHeader> mips;
+	mips.Resize(mipCount);
+	size_t offset = Align(sizeof(FileHeader) + mipCount * sizeof(MipHeader));
+	for (size_t i = 0, mipWidth = width, mipHeight = height; i < mipCount; ++i)
+	{
+		mips[i].DataOffset = offset;
+		mips[i].DataSize = GetImageSize(format, mipWidth, mipHeight);
+		mips[i].Width = static_cast<u32>(mipWidth);
+		mips[i].Height = static_cast<u32>(mipHeight);
+		offset = Align(offset + mips[i].DataSize);
+		mipWidth = std::max<size_t>(mipWidth / 2, 1);
+		mipHeight = std::max<size_t>(mipHeight / 2, 1);
+	}
+
+	Dynarray<u8> file;
+	file.Resize(static_cast<size_t>(mips[mipCount - 1].DataOffset + mips[mipCount - 1].DataSize));
+	memset(file.GetData(), 0, file.GetSize());
+	const FileHeader header = { MAGIC, VERSION, static_cast<u32>(width), static_cast<u32>(height), static_cast<u32>(mipCount), static_cast<u32>(format), { 0, 0 } };
+	memcpy(file.GetData(), &header, sizeof(header));
+	memcpy(file.GetData() + sizeof(header), mips.GetData(), mipCount * sizeof(MipHeader));
+
+	Dynarray<u8> level;
+	Dynarray<u8> nextLevel;
+	level.Resize(width * height * 4);
+	memcpy(level.GetData(), rgba, level.GetSize());
+	for (size_t i = 0; i < mipCount; ++i)
+	{
+		Encode(format, level.GetData(), mips[i].Width, mips[i].Height, file.GetData() + mips[i].DataOffset);
+		if (i + 1 == mipCount)
+			break;
+		nextLevel.Resize(mips[i + 1].Width * mips[i + 1].Height * 4);
+		Downsample(level.GetData(), mips[i].Width, mips[i].Height, nextLevel.GetData());
+		std::swap(level, nextLevel);
+	}
+
+	SaveBinaryFile(path, file.GetData(), file.GetSize());
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Core.hpp>
+
+#include "IRenderingDevice.hpp"
+
+namespace Poly
+{
+	/// <summary>Binary texture format written offline by the asset cooker and memory mapped by TextureResource.
+	/// File starts with FileHeader followed by MipHeader of every level of the full mip chain, base level first.
+	/// Images are stored already flipped for the rendering device, as RGBA8 or one of block compressed formats.
+	/// Data blobs are aligned to BLOB_ALIGNMENT, all values are little endian.</summary>
+	namespace CookedTexture
+	{
+		constexpr u32 MAGIC = 0x58455450; // "PTEX"
+		constexpr u32 VERSION = 1;
+		constexpr size_t BLOB_ALIGNMENT = 16;
+
+		struct FileHeader
+		{
+			u32 Magic;
+			u32 Version;
+			u32 Width;
+			u32 Height;
+			u32 MipCount;
+			// eTextureDataFormat value, RGBA or one of block compressed formats
+			u32 Format;
+			u32 Reserved[2];
+		};
+
+		struct MipHeader
+		{
+			// offset from the beginning of the file
+			u64 DataOffset;
+			u64 DataSize;
+			u32 Width;
+			u32 Height;
+		};
+
+		STATIC_ASSERTE(sizeof(FileHeader) == 32, "Cooked texture header layout changed!");
+		STATIC_ASSERTE(sizeof(MipHeader) == 24, "Cooked texture header layout changed!");
+
+		/// <summary>Returns number of levels of full mip chain, down to 1x1.</summary>
+		ENGINE_DLLEXPORT size_t GetMipCount(size_t width, size_t height);
+
+		/// <summary>Returns size in bytes of an image in RGBA or block compressed format.</summary>
+		ENGINE_DLLEXPORT size_t GetImageSize(eTextureDataFormat format, size_t width, size_t height);
+
+		/// <summary>Writes next level of the mip chain of RGBA image, using 2x2 box filter.
+		/// Destination has to hold image of size max(width / 2, 1) x max(height / 2, 1).</summary>
+		ENGINE_DLLEXPORT void Downsample(const u8* rgba, size_t width, size_t height, u8* result);
+
+		/// <summary>Compresses RGBA image into blocks of the format. BC1 keeps 1-bit alpha, BC7 uses mode 6 only.</summary>
+		ENGINE_DLLEXPORT void Encode(eTextureDataFormat format, const u8* rgba, size_t width, size_t height, u8* blocks);
+
+		/// <summary>Decompresses blocks into RGBA image. Used when the device does not support the format.
+		/// BC7 blocks using modes other than 6 are decoded as magenta.</summary>
+		ENGINE_DLLEXPORT void Decode(eTextureDataFormat format, const u8* blocks, size_t width, size_t height, u8* rgba);
+
+		/// <summary>Checks whether data starts with header of a cooked texture.</summary>
+		ENGINE_DLLEXPORT bool IsCookedTexture(const u8* data, size_t size);
+
+		/// <summary>Checks headers and bounds of all mip levels of a cooked texture, logs the reason of failure.</summary>
+		ENGINE_DLLEXPORT bool Validate(const u8* data, size_t size);
+
+		/// <summary>Generates full mip chain of RGBA image and writes it in the format.</summary>
+		/// <exception cref="FileIOException">Thrown when the file cannot be written.</exception>
+		ENGINE_DLLEXPORT void Write(const u8* rgba, size_t width, size_t height, eTextureDataFormat format, const String& path);
+	}
+}
@@ -0,0 +1,72 @@
+#include "EnginePCH.hpp"
+
+#include "CullingSystem.hpp"
+
+using namespace Poly;
+
+//------------------------------------------------------------------------------
+void CullingSystem::CullingUpdatePhase(World* world)
+{
+	for (auto& kv : world->GetWorldComponent<ViewportWorldComponent>()->GetViewports())
+	{
+		CameraComponent* cameraCmp = kv.second.GetCamera();
+		ASSERTE(cameraCmp, "Viewport without camera?");
+		CullSubMeshes(world, Frustum(cameraCmp->GetMVP()), cameraCmp->VisibleSubMeshes);
+	}
+}
+
+//------------------------------------------------------------------------------
+bool CullingSystem::IsSubMeshVisible(const MeshResource& mesh, size_t subMeshIdx, const Matrix& transform, const Frustum& frustum)
+{
+	const Matrix& m = transform;
+	const MeshResource::SubMesh* subMesh = mesh.GetSubMeshes()[subMeshIdx];
+	// sphere radius is scaled by the longest basis vector, so it stays conservative for non uniform scale
+	const float maxScaleSquared = std::max({ m.m00 * m.m00 + m.m10 * m.m10 + m.m20 * m.m20,
+		m.m01 * m.m01 + m.m11 * m.m11 + m.m21 * m.m21,
+		m.m02 * m.m02 + m.m12 * m.m12 + m.m22 * m.m22 });
+	if (!frustum.IsSphereVisible(m * subMesh->GetBoundingSphereCenter(), subMesh->GetBoundingSphereRadius() * std::sqrt(maxScaleSquared)))
+		return false;
+	return frustum.IsBoxVisible(subMesh->GetBoundingBox().GetTransformed(m));
+}
+
+namespace
+{
+	void CullMeshSubMeshes(const MeshRenderingComponent* meshCmp, const TransformComponent* transCmp, const Frustum& frustum, Dynarray<VisibleSubMesh>& visible)
+	{
+		const Matrix& m = transCmp->GetGlobalTransformationMatrix();
+		const MeshResource& mesh = *meshCmp->GetMesh();
+		for (size_t i = 0; i < mesh.GetSubMeshes().GetSize(); ++i)
+		{
+			if (CullingSystem::IsSubMeshVisible(mesh, i, m, frustum))
+				visible.PushBack(VisibleSubMesh{ meshCmp, transCmp, i });
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+void CullingSystem::CullSubMeshes(World* world, const Frustum& frustum, Dynarray<VisibleSubMesh>& visible)
+{
+	visible.Clear();
+
+	// with the spatial tree only entities with boxes inside the frustum are tested
+	const SpatialWorldComponent* spatial = world->GetWorldComponent<SpatialWorldComponent>();
+	if (spatial)
+	{
+		Dynarray<UniqueID> entities;
+		spatial->QueryFrustum(frustum, entities);
+		for (const UniqueID& entityID : entities)
+		{
+			const MeshRenderingComponent* meshCmp = world->GetComponent<MeshRenderingComponent>(entityID);
+			const TransformComponent* transCmp = world->GetComponent<TransformComponent>(entityID);
+			CullMeshSubMeshes(meshCmp, transCmp, frustum, visible);
+		}
+		return;
+	}
+
+	for (auto componentsTuple : world->IterateComponents<MeshRenderingComponent, TransformComponent>())
+	{
+		const MeshRenderingComponent* meshCmp = std::get<MeshRenderingComponent*>(componentsTuple);
+		if (meshCmp->GetMesh())
+			CullMeshSubMeshes(meshCmp, std::get<TransformComponent*>(componentsTuple), frustum, visible);
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Dynarray.hpp>
+
+namespace Poly
+{
+	class World;
+	class Frustum;
+	class Matrix;
+	class MeshResource;
+	class MeshRenderingComponent;
+	class TransformComponent;
+
+	/// <summary>Submesh that passed visibility test for a camera.</summary>
+	struct VisibleSubMesh
+	{
+		const MeshRenderingComponent* Mesh;
+		const TransformComponent* Transform;
+		size_t SubMeshIdx;
+	};
+
+	namespace CullingSystem
+	{
+		void CullingUpdatePhase(World* world);
+
+		/// <summary>Tests bounding volumes of all submeshes in the world against the frustum.
+		/// When the world has SpatialWorldComponent, only entities returned by its frustum query are tested.
+		/// Bounding sphere is tested first, submeshes that pass it are tested with the world space bounding box.
+		/// Submeshes of the same component are stored next to each other, in submesh order.</summary>
+		/// <param name="world">World with meshes to test.</param>
+		/// <param name="frustum">Frustum in world space.</param>
+		/// <param name="visible">Output list, cleared before the test.</param>
+		void ENGINE_DLLEXPORT CullSubMeshes(World* world, const Frustum& frustum, Dynarray<VisibleSubMesh>& visible);
+
+		/// <summary>Tests bounding sphere and then bounding box of the submesh, both transformed to world space, against the frustum.</summary>
+		/// <param name="mesh">Mesh owning the submesh.</param>
+		/// <param name="subMeshIdx">Index of the submesh in the mesh.</param>
+		/// <param name="transform">Global transformation of the entity rendering the mesh.</param>
+		/// <param name="frustum">Frustum in world space.</param>
+		bool ENGINE_DLLEXPORT IsSubMeshVisible(const MeshResource& mesh, size_t subMeshIdx, const Matrix& transform, const Frustum& frustum);
+	}
+}
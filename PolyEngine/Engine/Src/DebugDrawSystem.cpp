@@ -8,26 +8,6 @@ using namespace Poly;
 
 namespace Util
 {
-	/// <summary>Get vector with minimum/maximum/else (depends on comparison function) values
-	/// on each axis in given set of vectors.</summary>
-	Vector3f FindExtremum(const Dynarray<Vector3f>& dynarray, std::function< bool(const float, const float) > comp)
-	{
-		ASSERTE(dynarray.GetSize() > 0, "SubMesh vertex data is empty.");
-
-		Vector3f result = dynarray[0];
-		for (auto const & vec : dynarray)
-		{
-			if (comp(vec.X, result.X))
-				result.X = vec.X;
-			if (comp(vec.Y, result.Y))
-				result.Y = vec.Y;
-			if (comp(vec.Z, result.Z))
-				result.Z = vec.Z;
-		}
-
-		return result;
-	}
-
 	/// <summary>Produces two orthonormal vectors from a single normal vector.</summary>
 	/// Building an Orthonormal Basis, Revisited; http://jcgt.org/published/0006/01/01/
 	void BranchlessONB(const Vector & n, Vector & b1, Vector & b2)
@@ -75,19 +55,25 @@ void DebugDrawSystem::DebugRenderingUpdatePhase(World* world)
 			// spawn a box for every mesh, in correct size
 			for(const auto subMesh : meshCmp->GetMesh()->GetSubMeshes())
 			{
-				const auto & meshVerticesPositions = subMesh->GetMeshData().GetPositions();
-
-				// find mins and maxs of each mesh coordinates
-				// in order to create AABB
-				auto minMeshVector = Util::FindExtremum(meshVerticesPositions, std::less<float>());
-				auto maxMeshVector = Util::FindExtremum(meshVerticesPositions, std::greater<float>());
+				// packed meshes do not keep positions, bounds are computed on load
+				const AABox& meshBox = subMesh->GetBoundingBox();
+				Vector3f minMeshVector(meshBox.GetMin().X, meshBox.GetMin().Y, meshBox.GetMin().Z);
+				Vector3f maxMeshVector(meshBox.GetMax().X, meshBox.GetMax().Y, meshBox.GetMax().Z);
+
+				// transform all corners, so the box encloses rotated meshes too
+				std::array<Vector3f, 8> corners;
+				for (size_t i = 0; i < corners.size(); ++i)
+				{
+					corners[i].X = (i & 1) ? maxMeshVector.X : minMeshVector.X;
+					corners[i].Y = (i & 2) ? maxMeshVector.Y : minMeshVector.Y;
+					corners[i].Z = (i & 4) ? maxMeshVector.Z : minMeshVector.Z;
+				}
+				TransformPoints(objTransform, corners.data(), corners.data(), corners.size());
+				CalculateBounds(corners.data(), corners.size(), minMeshVector, maxMeshVector);
 
 				Vector minVector(minMeshVector.X, minMeshVector.Y, minMeshVector.Z);
 				Vector maxVector(maxMeshVector.X, maxMeshVector.Y, maxMeshVector.Z);
 
-				minVector = objTransform * minVector;
-				maxVector = objTransform * maxVector;
-
 				const auto boundingOffset = Vector(0.04f, 0.04f, 0.04f);
 				// move vector away a little bit from a mesh
 				minVector -= boundingOffset;
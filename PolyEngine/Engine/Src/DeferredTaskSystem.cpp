@@ -15,6 +15,26 @@ void DeferredTaskSystem::DestroyEntityImmediate(World* w, const UniqueID& entity
 	w->DestroyEntity(entityId);
 }
 
+//------------------------------------------------------------------------------
+Dynarray<UniqueID> DeferredTaskSystem::SpawnEntitiesBatch(World* w, size_t count, const EntityPrototype& prototype)
+{
+	DeferredTaskWorldComponent* cmp = w->GetWorldComponent<DeferredTaskWorldComponent>();
+	const size_t firstCreated = cmp->NewlyCreatedComponents.GetSize();
+
+	Dynarray<UniqueID> ids;
+	w->SpawnEntitiesBatch(count, prototype, ids, cmp->NewlyCreatedComponents);
+
+	for (size_t i = firstCreated; i < cmp->NewlyCreatedComponents.GetSize(); ++i)
+		cmp->NewlyCreatedComponents[i]->SetFlags(eComponentBaseFlags::NEWLY_CREATED);
+	return ids;
+}
+
+//------------------------------------------------------------------------------
+void DeferredTaskSystem::DestroyEntitiesBatch(World* w, const Dynarray<UniqueID>& entityIds)
+{
+	w->DestroyEntitiesBatch(entityIds);
+}
+
 //------------------------------------------------------------------------------
 void DeferredTaskSystem::DestroyEntity(World* w, const UniqueID& entityId)
 {
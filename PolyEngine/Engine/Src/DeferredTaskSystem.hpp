@@ -2,6 +2,7 @@
 
 #include "DeferredTaskImplementation.hpp"
 #include "DeferredTaskWorldComponent.hpp"
+#include "EntityPrototype.hpp"
 #include "World.hpp"
 
 namespace Poly
@@ -46,6 +47,21 @@ namespace Poly
 		/// <param name="entityId">ID of the entity.</summary>
 		void ENGINE_DLLEXPORT DestroyEntityImmediate(World* w, const UniqueID& entityId);
 
+		/// <summary>Creates many entities with the same component set immediately.
+		/// Storage is reserved once and components are constructed type by type, which is much faster than
+		/// calling SpawnEntityImmediate() and AddComponentImmediate() for every entity.</summary>
+		/// <param name="world">Pointer to world to create entities in.</summary>
+		/// <param name="count">Amount of entities to create.</summary>
+		/// <param name="prototype">Components (with constructor arguments) every entity gets.</summary>
+		/// <returns>IDs of created entities.</returns>
+		Dynarray<UniqueID> ENGINE_DLLEXPORT SpawnEntitiesBatch(World* w, size_t count, const EntityPrototype& prototype);
+
+		/// <summary>Destroys many entities immediately.
+		/// IDs of entities that were already destroyed as children of earlier entities in the batch are skipped.</summary>
+		/// <param name="world">Pointer to world entities are in.</summary>
+		/// <param name="entityIds">IDs of the entities.</summary>
+		void ENGINE_DLLEXPORT DestroyEntitiesBatch(World* w, const Dynarray<UniqueID>& entityIds);
+
 		/// <summary>Adds component to entity immediately.</summary>
 		/// <param name="world">Pointer to world entity is in.</summary>
 		/// <param name="entityId">ID of the entity.</summary>
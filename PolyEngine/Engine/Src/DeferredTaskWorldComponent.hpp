@@ -7,16 +7,20 @@
 
 namespace Poly
 {
+	class EntityPrototype;
+
 	namespace DeferredTaskSystem
 	{
 		void DeferredTaskPhase(World* w);
 		template<typename T, typename ...Args> T* AddComponentImmediate(World* w, const UniqueID & entityId, Args && ...args);
+		Dynarray<UniqueID> ENGINE_DLLEXPORT SpawnEntitiesBatch(World* w, size_t count, const EntityPrototype& prototype);
 	}
 
 	class ENGINE_DLLEXPORT DeferredTaskWorldComponent : public ComponentBase
 	{
 		friend void DeferredTaskSystem::DeferredTaskPhase(World*);
 		template<typename T, typename ...Args> friend T* DeferredTaskSystem::AddComponentImmediate(World* w, const UniqueID & entityId, Args && ...args);
+		friend Dynarray<UniqueID> DeferredTaskSystem::SpawnEntitiesBatch(World* w, size_t count, const EntityPrototype& prototype);
 	public:
 		DeferredTaskWorldComponent() = default;
 
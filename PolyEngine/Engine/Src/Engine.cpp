@@ -1,10 +1,107 @@
 #include "EnginePCH.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 using namespace Poly;
 
 Engine* Poly::gEngine = nullptr;
 
+STATIC_ASSERTE(MAX_COMPONENTS_COUNT <= 64, "Component IDs have to fit into UpdatePhaseAccess masks.");
+STATIC_ASSERTE(MAX_WORLD_COMPONENTS_COUNT <= 64, "World component IDs have to fit into UpdatePhaseAccess masks.");
+
+//------------------------------------------------------------------------------
+// State of a single execution of update phases graph.
+// Phases without unfinished dependencies are pushed to the thread pool (or to the main thread queue),
+// finishing a phase releases phases that depend on it.
+class Engine::UpdatePhasesGraphRun : public BaseObject<>
+{
+public:
+	UpdatePhasesGraphRun(const Dynarray<RegisteredUpdatePhase>& phases, ThreadPool& pool, World* world)
+		: Phases(phases), Pool(pool), CurrentWorld(world), RemainingDependencies(new std::atomic<size_t>[phases.GetSize()])
+	{
+		for (size_t i = 0; i < Phases.GetSize(); ++i)
+			RemainingDependencies[i] = Phases[i].DependencyCount;
+	}
+
+	void Run()
+	{
+		for (size_t i = 0; i < Phases.GetSize(); ++i)
+			if (Phases[i].DependencyCount == 0)
+				Schedule(i);
+
+		while (true)
+		{
+			size_t phaseIdx;
+			{
+				std::unique_lock<std::mutex> lock(Mutex);
+				if (FinishedCount == Phases.GetSize())
+					break;
+				if (MainThreadQueue.IsEmpty())
+				{
+					lock.unlock();
+					// help workers, sleep only when there is nothing queued
+					if (!Pool.TryExecuteOne())
+					{
+						lock.lock();
+						MainThreadReady.wait(lock, [this]() { return !MainThreadQueue.IsEmpty() || FinishedCount == Phases.GetSize(); });
+					}
+					continue;
+				}
+				phaseIdx = MainThreadQueue.Front();
+				MainThreadQueue.PopFront();
+			}
+			Execute(phaseIdx);
+		}
+
+		// jobs may still be returning after their last notification
+		Pool.Wait(Jobs);
+	}
+
+private:
+	void Schedule(size_t phaseIdx)
+	{
+		if (Phases[phaseIdx].Access.IsMainThreadOnly())
+		{
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				MainThreadQueue.PushBack(phaseIdx);
+			}
+			MainThreadReady.notify_one();
+		}
+		else
+			Pool.Submit([this, phaseIdx]() { Execute(phaseIdx); }, &Jobs);
+	}
+
+	void Execute(size_t phaseIdx)
+	{
+		const RegisteredUpdatePhase& phase = Phases[phaseIdx];
+		phase.Function(CurrentWorld);
+
+		for (size_t dependent : phase.Dependents)
+			if (RemainingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+				Schedule(dependent);
+
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			++FinishedCount;
+		}
+		MainThreadReady.notify_one();
+	}
+
+	const Dynarray<RegisteredUpdatePhase>& Phases;
+	ThreadPool& Pool;
+	World* CurrentWorld;
+	std::unique_ptr<std::atomic<size_t>[]> RemainingDependencies;
+	JobCounter Jobs;
+
+	std::mutex Mutex;
+	std::condition_variable MainThreadReady;
+	Queue<size_t> MainThreadQueue;
+	size_t FinishedCount = 0;
+};
+
 //------------------------------------------------------------------------------
 Engine::Engine() 
 	: Game()
@@ -24,6 +121,11 @@ void Poly::Engine::Init(std::unique_ptr<IGame> game, std::unique_ptr<IRenderingD
 	Game = std::move(game);
 	RenderingDevice = std::move(device);
 	RenderingDevice->Init();
+	// released engine resources stay resident until the budget is exceeded, games may change it in Init()
+	ResourceManager<MeshResource>::SetCacheBudget(64 * 1024 * 1024);
+	ResourceManager<TextureResource>::SetCacheBudget(128 * 1024 * 1024);
+	ResourceManager<FontResource>::SetCacheBudget(8 * 1024 * 1024);
+	ResourceManager<SoundResource>::SetCacheBudget(32 * 1024 * 1024);
 	BaseWorld = std::make_unique<World>();
 	Game->RegisterEngine(this);
 
@@ -38,20 +140,37 @@ void Poly::Engine::Init(std::unique_ptr<IGame> game, std::unique_ptr<IRenderingD
 	DeferredTaskSystem::AddWorldComponentImmediate<Physics2DWorldComponent>(BaseWorld.get(), physicsConfig);
 	DeferredTaskSystem::AddWorldComponentImmediate<AmbientLightWorldComponent>(BaseWorld.get(), Color(1,1,1,1), 0.2f);
 	DeferredTaskSystem::AddWorldComponentImmediate<DebugDrawLinesComponent>(BaseWorld.get());
+	DeferredTaskSystem::AddWorldComponentImmediate<TransformWorldComponent>(BaseWorld.get());
+	DeferredTaskSystem::AddWorldComponentImmediate<SpatialWorldComponent>(BaseWorld.get());
 
 	// Engine update phases
+	// TransformComponent caches global matrices lazily, so even reading them counts as a write.
 	RegisterUpdatePhase(TimeSystem::TimeUpdatePhase, eUpdatePhaseOrder::PREUPDATE);
 	RegisterUpdatePhase(InputSystem::InputPhase, eUpdatePhaseOrder::PREUPDATE);
 	RegisterUpdatePhase(Physics2DSystem::Physics2DUpdatePhase, eUpdatePhaseOrder::PREUPDATE);
 	RegisterUpdatePhase(MovementSystem::MovementUpdatePhase, eUpdatePhaseOrder::PREUPDATE);
+	RegisterUpdatePhase(TransformSystem::TransformUpdatePhase, eUpdatePhaseOrder::POSTUPDATE,
+		UpdatePhaseAccess().Writes<TransformComponent>().WritesWorld<TransformWorldComponent>());
 	RegisterUpdatePhase(CameraSystem::CameraUpdatePhase, eUpdatePhaseOrder::POSTUPDATE);
-	RegisterUpdatePhase(DebugDrawSystem::DebugRenderingUpdatePhase, eUpdatePhaseOrder::POSTUPDATE);
-	RegisterUpdatePhase(RenderingSystem::RenderingPhase, eUpdatePhaseOrder::POSTUPDATE);
-	RegisterUpdatePhase(SoundSystem::SoundPhase, eUpdatePhaseOrder::POSTUPDATE);
+	RegisterUpdatePhase(SpatialSystem::SpatialUpdatePhase, eUpdatePhaseOrder::POSTUPDATE,
+		UpdatePhaseAccess().Reads<MeshRenderingComponent>().Writes<TransformComponent>().WritesWorld<SpatialWorldComponent>());
+	RegisterUpdatePhase(CullingSystem::CullingUpdatePhase, eUpdatePhaseOrder::POSTUPDATE,
+		UpdatePhaseAccess().Reads<MeshRenderingComponent>().Writes<TransformComponent, CameraComponent>().ReadsWorld<ViewportWorldComponent, SpatialWorldComponent>());
+	RegisterUpdatePhase(DebugDrawSystem::DebugRenderingUpdatePhase, eUpdatePhaseOrder::POSTUPDATE,
+		UpdatePhaseAccess()
+			.Reads<CameraComponent, DebugDrawableComponent, MeshRenderingComponent, RigidBody2DComponent>()
+			.Writes<TransformComponent>()
+			.ReadsWorld<ViewportWorldComponent>()
+			.WritesWorld<DebugDrawLinesComponent>());
+	RegisterUpdatePhase(RenderingSystem::RenderingPhase, eUpdatePhaseOrder::POSTUPDATE,
+		UpdatePhaseAccess().ReadsAll().Writes<TransformComponent>().RunsOnMainThread());
+	RegisterUpdatePhase(SoundSystem::SoundPhase, eUpdatePhaseOrder::POSTUPDATE,
+		UpdatePhaseAccess().Reads<SoundEmitterComponent>());
 	RegisterUpdatePhase(DeferredTaskSystem::DeferredTaskPhase, eUpdatePhaseOrder::POSTUPDATE);
 	RegisterUpdatePhase(FPSSystem::FPSUpdatePhase, eUpdatePhaseOrder::POSTUPDATE);
 
 	SoundSystem::SetWorldCurrent(BaseWorld.get());
+	SetParallelUpdatePhasesEnabled(true);
 
 	// Init game
 	Game->Init();
@@ -61,6 +180,14 @@ void Poly::Engine::Init(std::unique_ptr<IGame> game, std::unique_ptr<IRenderingD
 Engine::~Engine()
 {
 	Game->Deinit();
+	gResourceLoader.Shutdown();
+	// cached resources hold device objects, so everything released from now on is freed immediately.
+	// Meshes release their textures, so they go first.
+	ResourceManager<MeshResource>::SetCacheBudget(0);
+	ResourceManager<FontResource>::SetCacheBudget(0);
+	ResourceManager<TextureResource>::SetCacheBudget(0);
+	ResourceManager<SoundResource>::SetCacheBudget(0);
+	UpdateThreadPool.reset();
 	BaseWorld.reset();
 	Game.reset();
 	RenderingDevice.reset();
@@ -68,16 +195,60 @@ Engine::~Engine()
 }
 
 //------------------------------------------------------------------------------
-void Engine::RegisterUpdatePhase(const PhaseUpdateFunction& phaseFunction, eUpdatePhaseOrder order)
+void Engine::RegisterUpdatePhase(const PhaseUpdateFunction& phaseFunction, eUpdatePhaseOrder order, const UpdatePhaseAccess& access)
 {
 	HEAVY_ASSERTE(order != eUpdatePhaseOrder::_COUNT, "_COUNT enum value passed to RegisterUpdatePhase(), which is an invalid value");
-	Dynarray<PhaseUpdateFunction>& UpdatePhases = GameUpdatePhases[static_cast<int>(order)];
-	UpdatePhases.PushBack(phaseFunction);
+	Dynarray<RegisteredUpdatePhase>& UpdatePhases = GameUpdatePhases[static_cast<int>(order)];
+
+	RegisteredUpdatePhase phase;
+	phase.Function = phaseFunction;
+	phase.Access = access;
+
+	// phase has to wait for every earlier phase it conflicts with
+	const size_t phaseIdx = UpdatePhases.GetSize();
+	for (size_t i = 0; i < phaseIdx; ++i)
+	{
+		if (UpdatePhases[i].Access.ConflictsWith(access))
+		{
+			UpdatePhases[i].Dependents.PushBack(phaseIdx);
+			++phase.DependencyCount;
+		}
+	}
+	UpdatePhases.PushBack(phase);
+}
+
+//------------------------------------------------------------------------------
+void Engine::UpdatePhases(eUpdatePhaseOrder order)
+{
+	HEAVY_ASSERTE(order != eUpdatePhaseOrder::_COUNT, "_COUNT enum value passed to UpdatePhases(), which is an invalid value");
+	const Dynarray<RegisteredUpdatePhase>& phases = GameUpdatePhases[static_cast<int>(order)];
+
+	// sequential fallback, registration order satisfies all dependencies
+	if (!UpdateThreadPool || phases.GetSize() < 2)
+	{
+		for (const RegisteredUpdatePhase& phase : phases)
+			phase.Function(GetWorld());
+		return;
+	}
+
+	UpdatePhasesGraphRun(phases, *UpdateThreadPool, GetWorld()).Run();
+}
+
+//------------------------------------------------------------------------------
+void Engine::SetParallelUpdatePhasesEnabled(bool enabled, size_t workerCount)
+{
+	if (enabled)
+		UpdateThreadPool = std::make_unique<ThreadPool>(workerCount);
+	else
+		UpdateThreadPool.reset();
 }
 
 //------------------------------------------------------------------------------
 void Engine::Update()
 {
+	// device objects of resources loaded in background are created before any phase can use them
+	gResourceLoader.Update();
+
 	UpdatePhases(eUpdatePhaseOrder::PREUPDATE);
 	UpdatePhases(eUpdatePhaseOrder::UPDATE);
 	UpdatePhases(eUpdatePhaseOrder::POSTUPDATE);
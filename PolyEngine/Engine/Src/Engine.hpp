@@ -7,10 +7,13 @@
 #include <memory>
 
 #include <Core.hpp>
+#include <ThreadPool.hpp>
 #include "IRenderingDevice.hpp"
+#include "RenderCommandList.hpp"
 #include "OpenALDevice.hpp"
 
 #include "InputSystem.hpp"
+#include "UpdatePhaseAccess.hpp"
 
 namespace Poly
 {
@@ -57,6 +60,30 @@ namespace Poly
 		/// <param name="phaseFunction"/>
 		void RegisterGameUpdatePhase(const PhaseUpdateFunction& phaseFunction) { RegisterUpdatePhase(phaseFunction, eUpdatePhaseOrder::UPDATE); }
 
+		/// <summary>Registers a PhaseUpdateFunction with declared data access to be executed in the update.
+		/// Phase can run on a worker thread concurrently with other phases it does not conflict with.
+		/// Conflicting phases keep their registration order.</summary>
+		/// <param name="phaseFunction"/>
+		/// <param name="access">Component and world component types accessed by the phase.</param>
+		/// <see cref="UpdatePhaseAccess"/>
+		void RegisterGameUpdatePhase(const PhaseUpdateFunction& phaseFunction, const UpdatePhaseAccess& access) { RegisterUpdatePhase(phaseFunction, eUpdatePhaseOrder::UPDATE, access); }
+
+		/// <summary>Enables or disables concurrent execution of update phases.
+		/// When disabled all phases are executed one after another on the calling thread, in registration order.</summary>
+		/// <param name="enabled">True to run non conflicting phases on the worker pool.</param>
+		/// <param name="workerCount">Amount of worker threads used when enabled.</param>
+		void SetParallelUpdatePhasesEnabled(bool enabled, size_t workerCount = ThreadPool::GetDefaultWorkerCount());
+
+		/// <summary>Checks whether update phases can be executed concurrently.</summary>
+		bool IsParallelUpdatePhasesEnabled() const { return UpdateThreadPool != nullptr; }
+
+		/// <summary>Returns worker pool used by update phases.</summary>
+		/// <returns>Pointer to the pool or nullptr when parallel update is disabled.</returns>
+		ThreadPool* GetThreadPool() const { return UpdateThreadPool.get(); }
+
+		/// <summary>Returns draw commands recorded by RenderingSystem and replayed by the rendering device.</summary>
+		RenderCommandList& GetRenderCommandList() { return RenderCommands; }
+
 		/// <summary>Executes update phases functions that were registered in RegisterUpdatePhase().
 		/// Functions are executrd with given order and with given update phase order.</summary>
 		/// <see cref="Engine.RegisterUpdatePhase()"/>
@@ -120,19 +147,26 @@ namespace Poly
 		void ResizeScreen(const ScreenSize& size);
 
 	private:
-		inline void UpdatePhases(eUpdatePhaseOrder order)
+		/// <summary>Update phase with its access declaration and dependencies on earlier, conflicting phases.</summary>
+		struct RegisteredUpdatePhase
 		{
-			HEAVY_ASSERTE(order != eUpdatePhaseOrder::_COUNT, "_COUNT enum value passed to UpdatePhases(), which is an invalid value");
-			for (auto& update : GameUpdatePhases[static_cast<int>(order)])
-				update(GetWorld());
-		}
+			PhaseUpdateFunction Function;
+			UpdatePhaseAccess Access;
+			Dynarray<size_t> Dependents;
+			size_t DependencyCount = 0;
+		};
+
+		class UpdatePhasesGraphRun;
+
+		void UpdatePhases(eUpdatePhaseOrder order);
 
 		/// Registers a PhaseUpdateFunction to be executed in the update.
 		/// part of a single frame in the same order as they were passed in.
 		/// @param phaseFunction - void function(World*)
 		/// @param order - enum eUpdatePhaseOrder value
+		/// @param access - data accessed by the phase, phases without declaration are exclusive
 		/// @see eUpdatePhaseOrder
-		void RegisterUpdatePhase(const PhaseUpdateFunction& phaseFunction, eUpdatePhaseOrder order);
+		void RegisterUpdatePhase(const PhaseUpdateFunction& phaseFunction, eUpdatePhaseOrder order, const UpdatePhaseAccess& access = UpdatePhaseAccess::Exclusive());
 
 		std::unique_ptr<World> BaseWorld;
 		std::unique_ptr<IGame> Game;
@@ -140,7 +174,9 @@ namespace Poly
 		OpenALDevice AudioDevice;
 		InputQueue InputEventsQueue;
 
-		Dynarray<PhaseUpdateFunction> GameUpdatePhases[static_cast<int>(eUpdatePhaseOrder::_COUNT)];
+		Dynarray<RegisteredUpdatePhase> GameUpdatePhases[static_cast<int>(eUpdatePhaseOrder::_COUNT)];
+		std::unique_ptr<ThreadPool> UpdateThreadPool;
+		RenderCommandList RenderCommands;
 
 		bool QuitRequested = false; //stop the game
 	};
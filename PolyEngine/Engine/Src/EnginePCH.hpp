@@ -13,6 +13,9 @@
 
 // Rendering
 #include "IRenderingDevice.hpp"
+#include "RenderQueue.hpp"
+#include "RenderCommandList.hpp"
+#include "NullRenderingDevice.hpp"
 
 // Audio
 #include "OpenALDevice.hpp"
@@ -24,6 +27,7 @@
 
 // Resources
 #include "ResourceBase.hpp"
+#include "ResourceLoader.hpp"
 #include "ResourceManager.hpp"
 #include "TextureResource.hpp"
 #include "MeshResource.hpp"
@@ -52,6 +56,8 @@
 #include "ViewportWorldComponent.hpp"
 #include "DeferredTaskWorldComponent.hpp"
 #include "Physics2DWorldComponent.hpp"
+#include "TransformWorldComponent.hpp"
+#include "SpatialWorldComponent.hpp"
 
 // Systems
 #include "DeferredTaskSystem.hpp"
@@ -59,6 +65,8 @@
 #include "DeferredTaskSystem.hpp"
 #include "Physics2DSystem.hpp"
 #include "DebugDrawSystem.hpp"
+#include "CullingSystem.hpp"
+#include "SpatialSystem.hpp"
 
 // Config
 #include "AssetsPathConfig.hpp"
@@ -4,8 +4,8 @@
 
 using namespace Poly;
 
-Entity::Entity(const World * world)
-: EntityID(UniqueID::Generate()), EntityWorld(world), ComponentPosessionFlags(0)
+Entity::Entity(const World * world, const UniqueID& id)
+: EntityID(id), EntityWorld(world), ComponentPosessionFlags(0)
 {
 	memset(Components, 0, sizeof(ComponentBase*) * MAX_COMPONENTS_COUNT);
 }
@@ -8,6 +8,7 @@
 namespace Poly
 {
 	class ComponentBase;
+	class Archetype;
 	constexpr unsigned int MAX_COMPONENTS_COUNT = 64;
 
 	/// <summary>Class that represent entity inside core engine systems. Should not be used anywhere else.</summary>
@@ -42,7 +43,7 @@ namespace Poly
 		T* GetComponent(); //defined in World.hpp due to circular inclusion problem; FIXME: circular inclusion
 
 	private:
-		Entity(const World* world);
+		Entity(const World* world, const UniqueID& id);
 
 		UniqueID EntityID;
 		const World* EntityWorld = nullptr;
@@ -50,6 +51,11 @@ namespace Poly
 		std::bitset<MAX_COMPONENTS_COUNT> ComponentPosessionFlags;
 		ComponentBase* Components[MAX_COMPONENTS_COUNT];
 
+		Archetype* EntityArchetype = nullptr;
+		size_t ArchetypeRow = 0;
+
 		friend class World;
+		friend class Archetype;
+		friend class ArchetypeStorage;
 	};
 } //namespace Poly
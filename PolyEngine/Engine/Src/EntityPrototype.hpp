@@ -0,0 +1,74 @@
+#pragma once
+
+#include <Core.hpp>
+
+#include "DeferredTaskImplementation.hpp"
+#include "World.hpp"
+
+namespace Poly
+{
+	/// <summary>Description of the component set of entities spawned with DeferredTaskSystem::SpawnEntitiesBatch().
+	/// Every component added to the prototype is constructed for each spawned entity with copies of the stored arguments.</summary>
+	/// <example><code>EntityPrototype().AddComponent<TransformComponent>().AddComponent<FreeFloatMovementComponent>(10.0f, 0.003f)</code></example>
+	class EntityPrototype : public BaseObject<>
+	{
+	public:
+		EntityPrototype() = default;
+		EntityPrototype(const EntityPrototype&) = delete;
+		EntityPrototype& operator=(const EntityPrototype&) = delete;
+
+		~EntityPrototype()
+		{
+			for (ComponentBuilderBase* builder : Builders)
+				delete builder;
+		}
+
+		/// <summary>Adds component of type T to the prototype.</summary>
+		/// <param name="args">Constructor arguments, stored by value.</param>
+		template<typename T, typename... Args>
+		EntityPrototype& AddComponent(Args&&... args)
+		{
+			Builders.PushBack(new ComponentBuilder<T, typename std::decay<Args>::type...>(std::forward<Args>(args)...));
+			return *this;
+		}
+
+		/// <summary>Returns amount of components every spawned entity gets.</summary>
+		size_t GetComponentCount() const { return Builders.GetSize(); }
+
+	private:
+		class ComponentBuilderBase : public BaseObject<>
+		{
+		public:
+			virtual void Construct(World* w, const Dynarray<Entity*>& entities, Dynarray<ComponentBase*>& created) const = 0;
+		};
+
+		template<typename T, typename... Args>
+		class ComponentBuilder : public ComponentBuilderBase
+		{
+		public:
+			template<typename... CtorArgs>
+			explicit ComponentBuilder(CtorArgs&&... args) : Arguments(std::forward<CtorArgs>(args)...) {}
+
+			void Construct(World* w, const Dynarray<Entity*>& entities, Dynarray<ComponentBase*>& created) const override { Construct(w, entities, created, gen_seq<sizeof...(Args)>{}); }
+
+		private:
+			template<std::size_t... Is>
+			void Construct(World* w, const Dynarray<Entity*>& entities, Dynarray<ComponentBase*>& created, index<Is...>) const
+			{
+				EntityPrototype::ConstructComponents<T>(w, entities, created, std::get<Is>(Arguments)...);
+			}
+
+			std::tuple<Args...> Arguments;
+		};
+
+		template<typename T, typename... Args>
+		static void ConstructComponents(World* w, const Dynarray<Entity*>& entities, Dynarray<ComponentBase*>& created, const Args&... args)
+		{
+			w->AddComponentsBatch<T>(entities, created, args...);
+		}
+
+		Dynarray<ComponentBuilderBase*> Builders;
+
+		friend class World;
+	};
+}
@@ -5,19 +5,23 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include <mutex>
+
 using namespace Poly;
 
 static FT_Library gFreeTypeLibrary = nullptr;
+static std::once_flag gFreeTypeInitFlag;
 
 static const size_t GLYPH_PADDING = 8;
 
 FontResource::FontResource(const String& path)
 {
-	if (!gFreeTypeLibrary)
+	// fonts can be constructed concurrently by resource loader threads
+	std::call_once(gFreeTypeInitFlag, []()
 	{
 		FT_Error err = FT_Init_FreeType(&gFreeTypeLibrary);
 		ASSERTE(err == FT_Err_Ok, "Freetype initialization failed!");
-	}
+	});
 	FontPath = path;
 
 	gConsole.LogDebug("Font: {} loaded sucesfully!", path);
@@ -44,6 +48,14 @@ const FontResource::FontFace& FontResource::GetFace(size_t height) const
 	return it->second;
 }
 
+size_t FontResource::GetMemorySize() const
+{
+	size_t size = 0;
+	for (const auto& kv : Faces)
+		size += kv.second.TextureSize;
+	return size;
+}
+
 void Poly::FontResource::LoadFace(size_t height) const
 {
 	if (Faces.find(height) != Faces.end())
@@ -122,6 +134,7 @@ void Poly::FontResource::LoadFace(size_t height) const
 
 	// Create texture 2D for the face
 	face.TextureProxy = gEngine->GetRenderingDevice()->CreateTexture(TEXTURE_WIDTH, estimatedTextureHeight, eTextureUsageType::FONT);
+	face.TextureSize = TEXTURE_WIDTH * estimatedTextureHeight;
 
 	// Store all glyphs in it and maintain the references in Characters map
 	currRowLen = 0;
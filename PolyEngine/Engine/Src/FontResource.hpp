@@ -29,6 +29,7 @@ namespace Poly
 			};
 			
 			std::unique_ptr<ITextureDeviceProxy> TextureProxy;
+			size_t TextureSize = 0; // single channel glyph atlas
 			FT_Face FTFace;
 			std::map<char, FontGlyph> Characters;
 		};
@@ -38,6 +39,9 @@ namespace Poly
 
 		const FontFace& GetFace(size_t height) const;
 
+		/// <summary>Returns size of glyph textures of all loaded faces.</summary>
+		size_t GetMemorySize() const override;
+
 		void LoadFace(size_t height) const;
 		void LoadFaces(std::initializer_list<size_t> list) const
 		{
@@ -7,6 +7,7 @@
 namespace Poly
 {
 	class World;
+	class RenderCommandList;
 
 	struct ScreenSize
 	{
@@ -19,9 +20,23 @@ namespace Poly
 		RED,
 		RGB,
 		RGBA,
+		// block compressed RGBA, 4x4 pixel blocks
+		BC1,
+		BC3,
+		BC7,
 		_COUNT
 	};
 
+	//------------------------------------------------------------------------------
+	/// <summary>Single level of a texture mip chain, stored in the format it is uploaded with.</summary>
+	struct ENGINE_DLLEXPORT TextureMip
+	{
+		size_t Width = 0;
+		size_t Height = 0;
+		size_t Size = 0;
+		const unsigned char* Data = nullptr;
+	};
+
 	//------------------------------------------------------------------------------
 	enum class eTextureUsageType
 	{
@@ -63,6 +78,9 @@ namespace Poly
 	public:
 		virtual void SetContent(eTextureDataFormat format, const unsigned char* data) = 0;
 		virtual void SetSubContent(size_t width, size_t height, size_t offsetX, size_t offsetY, eTextureDataFormat format, const unsigned char* data) = 0;
+		/// <summary>Uploads complete mip chain starting at the base level, mipmaps are not generated by the device.
+		/// Devices without support of block compressed format decode it.</summary>
+		virtual void SetMipContent(eTextureDataFormat format, const Dynarray<TextureMip>& mips) = 0;
 	};
 
 	class ENGINE_DLLEXPORT ICubemapDeviceProxy : public BaseObject<>
@@ -93,6 +111,18 @@ namespace Poly
 		virtual void SetContent(const Mesh& mesh) = 0;
 	};
 
+	//------------------------------------------------------------------------------
+	/// <summary>Counters of rendering API calls issued during a single frame.</summary>
+	struct ENGINE_DLLEXPORT RenderingStats
+	{
+		size_t DrawCalls = 0;
+		size_t ProgramBinds = 0;
+		size_t VertexArrayBinds = 0;
+		size_t TextureBinds = 0;
+		// times CPU waited for GPU to release memory of streaming buffers
+		size_t StreamingBufferWaits = 0;
+	};
+
 	//------------------------------------------------------------------------------
 	class ENGINE_DLLEXPORT IRenderingDevice : public BaseObject<>
 	{
@@ -100,7 +130,13 @@ namespace Poly
 		virtual void Resize(const ScreenSize& size) = 0;
 		virtual const ScreenSize& GetScreenSize() const = 0;
 
-		virtual void RenderWorld(World* world) = 0;
+		/// <summary>Renders the world, drawing meshes from the command list recorded for the frame.
+		/// Called on the thread owning the rendering context.</summary>
+		virtual void RenderWorld(World* world, const RenderCommandList& commands) = 0;
+
+		/// <summary>Returns counters of the last frame rendered with RenderWorld().</summary>
+		virtual const RenderingStats& GetLastFrameStats() const = 0;
+
 		virtual void Init() = 0;
 
 		virtual std::unique_ptr<ITextureDeviceProxy> CreateTexture(size_t width, size_t height, eTextureUsageType usage) = 0;
@@ -0,0 +1,240 @@
+#include "EnginePCH.hpp"
+
+#include "LightGrid.hpp"
+
+using namespace Poly;
+
+//------------------------------------------------------------------------------
+LightGrid::LightGrid(size_t tilesX, size_t tilesY, size_t slices)
+	: TilesX(tilesX), TilesY(tilesY), Slices(slices)
+{
+	ASSERTE(TilesX > 0 && TilesY > 0 && Slices > 0, "Light grid has to contain clusters");
+	SetPerspective(60_deg, 16.0f / 9.0f, Near, Far);
+}
+
+//------------------------------------------------------------------------------
+void LightGrid::SetPerspective(Angle fov, float aspect, float zNear, float zFar)
+{
+	const float tanHalfFov = Tan(fov / 2);
+	// exponential slicing needs positive near plane
+	zNear = std::max(zNear, 1e-3f);
+	if (IsPerspective && ScaleX == tanHalfFov * aspect && ScaleY == tanHalfFov && Near == zNear && Far == zFar)
+		return;
+
+	IsPerspective = true;
+	ScaleX = tanHalfFov * aspect;
+	ScaleY = tanHalfFov;
+	OffsetX = 0.0f;
+	OffsetY = 0.0f;
+	Near = zNear;
+	Far = zFar;
+	BoundsDirty = true;
+
+	SliceScale = static_cast<float>(Slices) / std::log(Far / Near);
+	SliceBias = -std::log(Near) * SliceScale;
+}
+
+//------------------------------------------------------------------------------
+void LightGrid::SetOrthographic(float top, float bottom, float left, float right, float zNear, float zFar)
+{
+	zNear = std::max(zNear, 1e-3f);
+	const float scaleX = (right - left) * 0.5f, scaleY = (top - bottom) * 0.5f;
+	const float offsetX = (right + left) * 0.5f, offsetY = (top + bottom) * 0.5f;
+	if (!IsPerspective && ScaleX == scaleX && ScaleY == scaleY && OffsetX == offsetX && OffsetY == offsetY && Near == zNear && Far == zFar)
+		return;
+
+	IsPerspective = false;
+	ScaleX = scaleX;
+	ScaleY = scaleY;
+	OffsetX = offsetX;
+	OffsetY = offsetY;
+	Near = zNear;
+	Far = zFar;
+	BoundsDirty = true;
+
+	SliceScale = static_cast<float>(Slices) / std::log(Far / Near);
+	SliceBias = -std::log(Near) * SliceScale;
+}
+
+//------------------------------------------------------------------------------
+size_t LightGrid::GetSlice(float depth) const
+{
+	if (depth <= Near)
+		return 0;
+	const float slice = std::floor(std::log(depth) * SliceScale + SliceBias);
+	return static_cast<size_t>(Clamp(slice, 0.0f, static_cast<float>(Slices - 1)));
+}
+
+//------------------------------------------------------------------------------
+void LightGrid::Build(const Matrix& view, const Dynarray<Vector>& positions, const Dynarray<float>& ranges, ThreadPool* pool)
+{
+	ASSERTE(positions.GetSize() == ranges.GetSize(), "Every light needs position and range");
+	if (BoundsDirty)
+		UpdateClusterBounds();
+
+	ViewLights.Resize(positions.GetSize());
+	for (size_t i = 0; i < positions.GetSize(); ++i)
+	{
+		const Vector center = view * Vector(positions[i].X, positions[i].Y, positions[i].Z);
+		ViewLights[i] = ViewLight{ { center.X, center.Y, center.Z }, ranges[i] };
+	}
+
+	Clusters.Resize(TilesX * TilesY * Slices);
+	SliceIndices.Resize(Slices);
+	SliceCandidates.Resize(Slices);
+	if (!pool)
+	{
+		for (size_t slice = 0; slice < Slices; ++slice)
+			AssignSlice(slice);
+	}
+	else
+	{
+		JobCounter counter;
+		for (size_t slice = 0; slice < Slices; ++slice)
+			pool->Submit([this, slice]() { AssignSlice(slice); }, &counter);
+		pool->Wait(counter);
+	}
+
+	// slices store offsets relative to their own index lists, which are concatenated in slice order
+	size_t totalCount = 0;
+	for (const Dynarray<u32>& indices : SliceIndices)
+		totalCount += indices.GetSize();
+	LightIndices.Resize(totalCount);
+
+	size_t base = 0;
+	const size_t clustersPerSlice = TilesX * TilesY;
+	for (size_t slice = 0; slice < Slices; ++slice)
+	{
+		for (size_t cluster = slice * clustersPerSlice; cluster < (slice + 1) * clustersPerSlice; ++cluster)
+			Clusters[cluster].Offset += static_cast<u32>(base);
+
+		const Dynarray<u32>& indices = SliceIndices[slice];
+		if (!indices.IsEmpty())
+			memcpy(LightIndices.GetData() + base, indices.GetData(), indices.GetSize() * sizeof(u32));
+		base += indices.GetSize();
+	}
+}
+
+//------------------------------------------------------------------------------
+void LightGrid::AssignSlice(size_t slice)
+{
+	const float sliceNear = SliceDepths[slice];
+	const float sliceFar = SliceDepths[slice + 1];
+
+	// lights overlapping depth range of the slice, view direction is -Z
+	Dynarray<u32>& candidates = SliceCandidates[slice];
+	candidates.Clear();
+	for (size_t i = 0; i < ViewLights.GetSize(); ++i)
+	{
+		const float depth = -ViewLights[i].Center[2];
+		if (depth + ViewLights[i].Radius >= sliceNear && depth - ViewLights[i].Radius <= sliceFar)
+			candidates.PushBack(static_cast<u32>(i));
+	}
+
+	// clusters of the slice are ordered by rows, X bounds of a cluster depend only on its column and Y bounds only on its row,
+	// so rectangle of tiles overlapped by the light is found before testing single clusters
+	const size_t firstCluster = GetClusterIndex(0, 0, slice);
+	auto forEachOverlappedCluster = [&](const ViewLight& light, auto&& callback)
+	{
+		size_t minTile[2] = { 0, 0 }, maxTile[2] = { 0, 0 };
+		const size_t tileCount[2] = { TilesX, TilesY };
+		for (size_t axis = 0; axis < 2; ++axis)
+		{
+			const size_t stride = axis == 0 ? 1 : TilesX;
+			size_t tile = 0;
+			while (tile < tileCount[axis] && ClusterBounds[firstCluster + tile * stride].Max[axis] < light.Center[axis] - light.Radius)
+				++tile;
+			minTile[axis] = tile;
+			while (tile < tileCount[axis] && ClusterBounds[firstCluster + tile * stride].Min[axis] <= light.Center[axis] + light.Radius)
+				++tile;
+			maxTile[axis] = tile;
+		}
+
+		for (size_t tileY = minTile[1]; tileY < maxTile[1]; ++tileY)
+		{
+			for (size_t tileX = minTile[0]; tileX < maxTile[0]; ++tileX)
+			{
+				const size_t clusterIdx = firstCluster + tileY * TilesX + tileX;
+				const Bounds& bounds = ClusterBounds[clusterIdx];
+				float distanceSquared = 0.0f;
+				for (size_t axis = 0; axis < 3; ++axis)
+				{
+					const float offset = std::max({ bounds.Min[axis] - light.Center[axis], 0.0f, light.Center[axis] - bounds.Max[axis] });
+					distanceSquared += offset * offset;
+				}
+				if (distanceSquared <= light.Radius * light.Radius)
+					callback(Clusters[clusterIdx]);
+			}
+		}
+	};
+
+	// count lights of every cluster, then fill the index ranges, lights stay sorted within clusters
+	const size_t clustersPerSlice = TilesX * TilesY;
+	for (size_t cluster = firstCluster; cluster < firstCluster + clustersPerSlice; ++cluster)
+		Clusters[cluster] = Cluster{ 0, 0 };
+	for (u32 lightIdx : candidates)
+		forEachOverlappedCluster(ViewLights[lightIdx], [](Cluster& cluster) { ++cluster.Count; });
+
+	u32 offset = 0;
+	for (size_t cluster = firstCluster; cluster < firstCluster + clustersPerSlice; ++cluster)
+	{
+		Clusters[cluster].Offset = offset;
+		offset += Clusters[cluster].Count;
+		Clusters[cluster].Count = 0;
+	}
+
+	Dynarray<u32>& indices = SliceIndices[slice];
+	indices.Resize(offset);
+	for (u32 lightIdx : candidates)
+		forEachOverlappedCluster(ViewLights[lightIdx], [&indices, lightIdx](Cluster& cluster) { indices[cluster.Offset + cluster.Count++] = lightIdx; });
+}
+
+//------------------------------------------------------------------------------
+void LightGrid::UpdateClusterBounds()
+{
+	SliceDepths.Resize(Slices + 1);
+	for (size_t slice = 0; slice <= Slices; ++slice)
+		SliceDepths[slice] = Near * std::pow(Far / Near, static_cast<float>(slice) / static_cast<float>(Slices));
+
+	// extent of the view volume at given depth along one of screen axes, for normalized device coordinate
+	auto viewCoord = [this](float ndc, float depth, float scale, float offset)
+	{
+		return IsPerspective ? ndc * depth * scale : offset + ndc * scale;
+	};
+
+	ClusterBounds.Resize(TilesX * TilesY * Slices);
+	for (size_t slice = 0; slice < Slices; ++slice)
+	{
+		const float depths[2] = { SliceDepths[slice], SliceDepths[slice + 1] };
+		for (size_t tileY = 0; tileY < TilesY; ++tileY)
+		{
+			const float ndcY[2] = { -1.0f + 2.0f * tileY / TilesY, -1.0f + 2.0f * (tileY + 1) / TilesY };
+			for (size_t tileX = 0; tileX < TilesX; ++tileX)
+			{
+				const float ndcX[2] = { -1.0f + 2.0f * tileX / TilesX, -1.0f + 2.0f * (tileX + 1) / TilesX };
+
+				Bounds& bounds = ClusterBounds[GetClusterIndex(tileX, tileY, slice)];
+				bounds.Min[0] = bounds.Min[1] = std::numeric_limits<float>::max();
+				bounds.Max[0] = bounds.Max[1] = std::numeric_limits<float>::lowest();
+				for (float depth : depths)
+				{
+					for (float ndc : ndcX)
+					{
+						const float x = viewCoord(ndc, depth, ScaleX, OffsetX);
+						bounds.Min[0] = std::min(bounds.Min[0], x);
+						bounds.Max[0] = std::max(bounds.Max[0], x);
+					}
+					for (float ndc : ndcY)
+					{
+						const float y = viewCoord(ndc, depth, ScaleY, OffsetY);
+						bounds.Min[1] = std::min(bounds.Min[1], y);
+						bounds.Max[1] = std::max(bounds.Max[1], y);
+					}
+				}
+				bounds.Min[2] = -depths[1];
+				bounds.Max[2] = -depths[0];
+			}
+		}
+	}
+	BoundsDirty = false;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <Core.hpp>
+
+namespace Poly
+{
+	class ThreadPool;
+
+	/// <summary>Clustered assignment of lights for forward shading.
+	/// View frustum is split into clusters: tiles on the screen times slices of exponentially growing depth.
+	/// Every light is binned into all clusters its bounding sphere overlaps, so shading of a fragment
+	/// only iterates lights of the cluster containing it.</summary>
+	class ENGINE_DLLEXPORT LightGrid : public BaseObject<>
+	{
+	public:
+		/// <summary>Range of GetLightIndices() with lights overlapping the cluster.</summary>
+		struct Cluster
+		{
+			u32 Offset;
+			u32 Count;
+		};
+
+		/// <summary>Creates grid with given amount of clusters in each dimension.</summary>
+		LightGrid(size_t tilesX = 16, size_t tilesY = 9, size_t slices = 24);
+
+		/// <summary>Sets perspective projection the grid is built for. Cluster bounds are recomputed only when parameters change.</summary>
+		/// <param name="fov">Vertical field of view.</param>
+		/// <param name="aspect">Width of the viewport divided by its height.</param>
+		void SetPerspective(Angle fov, float aspect, float zNear, float zFar);
+
+		/// <summary>Sets orthographic projection the grid is built for. Cluster bounds are recomputed only when parameters change.</summary>
+		void SetOrthographic(float top, float bottom, float left, float right, float zNear, float zFar);
+
+		/// <summary>Assigns lights to clusters they overlap. Slices are processed concurrently when pool is given.</summary>
+		/// <param name="view">World to view space transformation of the camera.</param>
+		/// <param name="positions">Centers of light bounding spheres in world space.</param>
+		/// <param name="ranges">Radii of light bounding spheres, indices in clusters refer to these arrays.</param>
+		/// <param name="pool">Pool used to process slices concurrently or nullptr to process them on the calling thread.</param>
+		void Build(const Matrix& view, const Dynarray<Vector>& positions, const Dynarray<float>& ranges, ThreadPool* pool = nullptr);
+
+		size_t GetTilesX() const { return TilesX; }
+		size_t GetTilesY() const { return TilesY; }
+		size_t GetSlices() const { return Slices; }
+
+		size_t GetClusterIndex(size_t tileX, size_t tileY, size_t slice) const { return (slice * TilesY + tileY) * TilesX + tileX; }
+
+		/// <summary>Returns slice containing points at given distance along view direction, clamped to valid slices.</summary>
+		size_t GetSlice(float depth) const;
+
+		/// <summary>Slice containing depth equals log(depth) * GetSliceScale() + GetSliceBias(), rounded down.</summary>
+		float GetSliceScale() const { return SliceScale; }
+		float GetSliceBias() const { return SliceBias; }
+
+		const Dynarray<Cluster>& GetClusters() const { return Clusters; }
+		const Dynarray<u32>& GetLightIndices() const { return LightIndices; }
+
+	private:
+		struct Bounds
+		{
+			float Min[3];
+			float Max[3];
+		};
+
+		struct ViewLight
+		{
+			float Center[3];
+			float Radius;
+		};
+
+		void UpdateClusterBounds();
+		void AssignSlice(size_t slice);
+
+		size_t TilesX;
+		size_t TilesY;
+		size_t Slices;
+
+		bool IsPerspective = true;
+		// tangents of half of field of view for perspective, half sizes and center offsets of the view volume for orthographic
+		float ScaleX = 1.0f;
+		float ScaleY = 1.0f;
+		float OffsetX = 0.0f;
+		float OffsetY = 0.0f;
+		float Near = 0.1f;
+		float Far = 100.0f;
+		float SliceScale = 0.0f;
+		float SliceBias = 0.0f;
+		bool BoundsDirty = true;
+
+		// view space bounds of clusters and depth ranges of slices
+		Dynarray<Bounds> ClusterBounds;
+		Dynarray<float> SliceDepths;
+
+		Dynarray<ViewLight> ViewLights;
+		// lights overlapping depth range of each slice and indices of lights assigned by each slice,
+		// merged after all slices are processed
+		Dynarray<Dynarray<u32>> SliceCandidates;
+		Dynarray<Dynarray<u32>> SliceIndices;
+		Dynarray<Cluster> Clusters;
+		Dynarray<u32> LightIndices;
+	};
+}
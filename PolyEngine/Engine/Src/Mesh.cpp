@@ -9,3 +9,105 @@ Poly::Mesh::~Mesh()
 	if (DiffuseTexture)
 		ResourceManager<TextureResource>::Release(DiffuseTexture);
 }
+
+//------------------------------------------------------------------------------
+Poly::VertexFormat Poly::Mesh::GetCompactVertexFormat() const
+{
+	VertexFormat format;
+	format.Interleaved = true;
+	format.PackedNormals = true;
+	format.ShortIndices = GetVertexCount() <= (size_t(1) << 16);
+	// half floats keep 11 bits of relative precision, which is not enough for wrapped coordinates far from 0
+	format.HalfTextCoords = std::all_of(TextCoords.Begin(), TextCoords.End(),
+		[](const TextCoord& uv) { return std::abs(uv.U) <= 1.0f && std::abs(uv.V) <= 1.0f; });
+	return format;
+}
+
+//------------------------------------------------------------------------------
+size_t Poly::Mesh::GetVertexStride() const
+{
+	return GetNormalOffset() + (HasNormals() ? (Format.PackedNormals ? sizeof(u32) : 3 * sizeof(float)) : 0);
+}
+
+//------------------------------------------------------------------------------
+size_t Poly::Mesh::GetNormalOffset() const
+{
+	return GetTextCoordOffset() + (HasTextCoords() ? (Format.HalfTextCoords ? 2 * sizeof(u16) : 2 * sizeof(float)) : 0);
+}
+
+//------------------------------------------------------------------------------
+void Poly::Mesh::PackVertices(Dynarray<u8>& vertices) const
+{
+	HEAVY_ASSERTE(Format.Interleaved, "Only interleaved vertices can be packed!");
+	HEAVY_ASSERTE(!IsPacked(), "Mesh is already packed!");
+	const size_t stride = GetVertexStride();
+	const size_t textCoordOffset = GetTextCoordOffset();
+	const size_t normalOffset = GetNormalOffset();
+
+	vertices.Resize(GetVertexCount() * stride);
+	for (size_t i = 0; i < GetVertexCount(); ++i)
+	{
+		u8* vertex = vertices.GetData() + i * stride;
+		const float position[3] = { Positions[i].X, Positions[i].Y, Positions[i].Z };
+		memcpy(vertex, position, sizeof(position));
+
+		if (HasTextCoords())
+		{
+			if (Format.HalfTextCoords)
+			{
+				const u16 uv[2] = { FloatToHalf(TextCoords[i].U), FloatToHalf(TextCoords[i].V) };
+				memcpy(vertex + textCoordOffset, uv, sizeof(uv));
+			}
+			else
+			{
+				const float uv[2] = { TextCoords[i].U, TextCoords[i].V };
+				memcpy(vertex + textCoordOffset, uv, sizeof(uv));
+			}
+		}
+
+		if (HasNormals())
+		{
+			if (Format.PackedNormals)
+			{
+				const u32 normal = PackNormal(Normals[i]);
+				memcpy(vertex + normalOffset, &normal, sizeof(normal));
+			}
+			else
+			{
+				const float normal[3] = { Normals[i].X, Normals[i].Y, Normals[i].Z };
+				memcpy(vertex + normalOffset, normal, sizeof(normal));
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+void Poly::Mesh::PackIndices(Dynarray<u8>& indices) const
+{
+	HEAVY_ASSERTE(!IsPacked(), "Mesh is already packed!");
+	if (!Format.ShortIndices)
+	{
+		indices.Resize(Indices.GetSize() * sizeof(u32));
+		memcpy(indices.GetData(), Indices.GetData(), indices.GetSize());
+		return;
+	}
+
+	indices.Resize(Indices.GetSize() * sizeof(u16));
+	for (size_t i = 0; i < Indices.GetSize(); ++i)
+	{
+		HEAVY_ASSERTE(Indices[i] <= 0xFFFF, "Index does not fit in 16 bits!");
+		const u16 index = static_cast<u16>(Indices[i]);
+		memcpy(indices.GetData() + i * sizeof(u16), &index, sizeof(u16));
+	}
+}
+
+//------------------------------------------------------------------------------
+u32 Poly::Mesh::PackNormal(const Vector3f& normal)
+{
+	auto packComponent = [](float val)
+	{
+		const i32 component = static_cast<i32>(std::round(Clamp(val, -1.0f, 1.0f) * 511.0f));
+		return static_cast<u32>(component) & 0x3FF;
+	};
+	return packComponent(normal.X) | (packComponent(normal.Y) << 10) | (packComponent(normal.Z) << 20);
+}
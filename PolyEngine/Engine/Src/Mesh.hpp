@@ -9,6 +9,20 @@ namespace Poly
 {
 	class TextureResource;
 
+	/// <summary>Layout and precision of vertex data uploaded to the rendering device.</summary>
+	struct ENGINE_DLLEXPORT VertexFormat
+	{
+		/// <summary>All attributes of a vertex are stored next to each other in a single buffer,
+		/// instead of a separate buffer per attribute.</summary>
+		bool Interleaved = false;
+		/// <summary>Texture coordinates are stored as half precision floats, requires interleaved layout.</summary>
+		bool HalfTextCoords = false;
+		/// <summary>Normals are stored as signed normalized 10:10:10:2 integers, requires interleaved layout.</summary>
+		bool PackedNormals = false;
+		/// <summary>Indices are stored as 16-bit integers.</summary>
+		bool ShortIndices = false;
+	};
+
 	class ENGINE_DLLEXPORT Mesh : public BaseObject<>
 	{
 	public:
@@ -22,29 +36,72 @@ namespace Poly
 			Color SpecularColor;
 		};
 
+		/// <summary>Vertices and indices already stored in the layout of the vertex format, f.ex. mapped from a cooked mesh file.
+		/// Memory is owned by the creator of the mesh, attribute arrays of packed meshes are empty.</summary>
+		struct ENGINE_DLLEXPORT PackedContent
+		{
+			const u8* Vertices = nullptr;
+			const u8* Indices = nullptr;
+			size_t VertexCount = 0;
+			size_t IndexCount = 0;
+			bool HasTextCoords = false;
+			bool HasNormals = false;
+		};
+
 		
 		const TextureResource* GetDiffTexture() const { return DiffuseTexture; }
-		const Material& GetMaterial() { return Mtl; }
-		size_t GetVertexCount() const { return Positions.GetSize(); }
-		size_t GetTriangleCount() const { return Indices.GetSize() / 3; }
+		const Material& GetMaterial() const { return Mtl; }
+		size_t GetVertexCount() const { return IsPacked() ? Packed.VertexCount : Positions.GetSize(); }
+		size_t GetTriangleCount() const { return (IsPacked() ? Packed.IndexCount : Indices.GetSize()) / 3; }
 
 		const Dynarray<Vector3f>& GetPositions() const { return Positions; }
 		const Dynarray<Vector3f>& GetNormals() const { return Normals; }
 		const Dynarray<TextCoord>& GetTextCoords() const { return TextCoords; }
 		const Dynarray<uint32_t>& GetIndicies() const { return Indices; }
 
-		bool HasVertices() const { return Positions.GetSize() != 0; }
-		bool HasNormals() const { return Normals.GetSize() != 0; }
-		bool HasTextCoords() const { return TextCoords.GetSize() != 0; }
-		bool HasIndicies() const { return Indices.GetSize() != 0; }
+		bool HasVertices() const { return GetVertexCount() != 0; }
+		bool HasNormals() const { return IsPacked() ? Packed.HasNormals : Normals.GetSize() != 0; }
+		bool HasTextCoords() const { return IsPacked() ? Packed.HasTextCoords : TextCoords.GetSize() != 0; }
+		bool HasIndicies() const { return GetTriangleCount() != 0; }
+
+		/// <summary>Checks whether the mesh holds packed content instead of attribute arrays.</summary>
+		bool IsPacked() const { return Packed.Vertices != nullptr; }
+		const PackedContent& GetPackedContent() const { return Packed; }
+
+		const VertexFormat& GetVertexFormat() const { return Format; }
+
+		/// <summary>Returns the most compact format that keeps precision of the mesh data:
+		/// interleaved, with packed normals, half precision texture coordinates when all of them are in [-1, 1] range
+		/// and 16-bit indices when there are at most 65536 vertices.</summary>
+		VertexFormat GetCompactVertexFormat() const;
+
+		/// <summary>Returns size of a single vertex in interleaved layout.</summary>
+		size_t GetVertexStride() const;
+		/// <summary>Returns offset of texture coordinates within interleaved vertex.</summary>
+		size_t GetTextCoordOffset() const { return 3 * sizeof(float); }
+		/// <summary>Returns offset of normal within interleaved vertex.</summary>
+		size_t GetNormalOffset() const;
+		/// <summary>Returns size of a single index.</summary>
+		size_t GetIndexSize() const { return Format.ShortIndices ? sizeof(u16) : sizeof(u32); }
+
+		/// <summary>Writes vertices in interleaved layout of the vertex format.</summary>
+		void PackVertices(Dynarray<u8>& vertices) const;
+
+		/// <summary>Writes indices with size of the vertex format.</summary>
+		void PackIndices(Dynarray<u8>& indices) const;
+
+		/// <summary>Encodes normal as signed normalized 10:10:10:2 integer, matching GL_INT_2_10_10_10_REV.</summary>
+		static u32 PackNormal(const Vector3f& normal);
 
 	private:
+		VertexFormat Format;
 		Material Mtl;
-		TextureResource* DiffuseTexture;
+		TextureResource* DiffuseTexture = nullptr;
 		Dynarray<Vector3f> Positions;
 		Dynarray<Vector3f> Normals;
 		Dynarray<TextCoord> TextCoords;
 		Dynarray<uint32_t> Indices;
+		PackedContent Packed;
 
 		friend class MeshResource;
 		friend class SubMesh;
@@ -9,19 +9,109 @@
 
 using namespace Poly;
 
+namespace
+{
+	String ResolvePathRelativeToFile(const String& filePath, const String& relativePath)
+	{
+		//TODO load textures, this requires Path class
+		// temporary code for extracting path
+		std::string tmpPath = std::string(filePath.GetCStr());
+		std::replace(tmpPath.begin(), tmpPath.end(), '\\', '/'); // replace all '\' to '/', fix for linux machines
+		return String((tmpPath.substr(0, tmpPath.rfind('/') + 1) + std::string(relativePath.GetCStr())).c_str());
+		// end temporary code for extracting path
+	}
+}
+
 MeshResource::MeshResource(const String& path)
+	: FilePath(path)
+{
+	try
+	{
+		CookedFile = std::make_unique<MemoryMappedFile>(path);
+	}
+	catch (const FileIOException&)
+	{
+		gConsole.LogError("Error opening mesh file: {}", path);
+		throw ResourceLoadFailedException();
+	}
+
+	if (CookedMesh::IsCookedMesh(CookedFile->GetData(), CookedFile->GetSize()))
+	{
+		LoadCooked();
+	}
+	else
+	{
+		// source assets are imported into attribute arrays, mapping is not needed
+		CookedFile.reset();
+		LoadSource();
+	}
+}
+
+void MeshResource::LoadCooked()
+{
+	const u8* data = CookedFile->GetData();
+	if (!CookedMesh::Validate(data, CookedFile->GetSize()))
+	{
+		gConsole.LogError("Error loading cooked mesh: {}", FilePath);
+		throw ResourceLoadFailedException();
+	}
+
+	const CookedMesh::FileHeader& header = *reinterpret_cast<const CookedMesh::FileHeader*>(data);
+	const CookedMesh::SubMeshHeader* subMeshHeaders = reinterpret_cast<const CookedMesh::SubMeshHeader*>(data + sizeof(CookedMesh::FileHeader));
+	for (u32 i = 0; i < header.SubMeshCount; ++i)
+		SubMeshes.PushBack(new SubMesh(subMeshHeaders[i], data));
+
+	gConsole.LogDebug("Loading cooked model {} sucessfull.", FilePath);
+}
+
+void MeshResource::LoadSource()
 {
 	Assimp::Importer importer;
-	const aiScene *scene = importer.ReadFile(path.GetCStr(), aiProcessPreset_TargetRealtime_Fast);
+	const aiScene *scene = importer.ReadFile(FilePath.GetCStr(), aiProcessPreset_TargetRealtime_Fast);
 
 	if (!scene) {
 		gConsole.LogError("Error Importing Asset: {}", importer.GetErrorString());
 		throw ResourceLoadFailedException();
 	}
 
-	gConsole.LogDebug("Loading model {} sucessfull.", path);
+	gConsole.LogDebug("Loading model {} sucessfull.", FilePath);
 	for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
-		SubMeshes.PushBack(new SubMesh(path, scene->mMeshes[i], scene->mMaterials[scene->mMeshes[i]->mMaterialIndex]));
+		SubMeshes.PushBack(new SubMesh(FilePath, scene->mMeshes[i], scene->mMaterials[scene->mMeshes[i]->mMaterialIndex]));
+	}
+}
+
+void MeshResource::CreateDeviceResources()
+{
+	for (SubMesh* subMesh : SubMeshes)
+	{
+		subMesh->CreateDeviceResources(FilePath);
+	}
+}
+
+bool MeshResource::LoadDependenciesAsync()
+{
+	bool ready = true;
+	for (SubMesh* subMesh : SubMeshes)
+	{
+		ready = subMesh->LoadDiffuseTextureAsync(FilePath) && ready;
+	}
+	return ready;
+}
+
+void MeshResource::OnCached()
+{
+	for (SubMesh* subMesh : SubMeshes)
+	{
+		subMesh->ReleaseDiffuseTexture();
+	}
+}
+
+void MeshResource::OnRevived()
+{
+	// textures evicted in the meantime are taken over from loads started by LoadDependenciesAsync() when the mesh is revived by LoadAsync()
+	for (SubMesh* subMesh : SubMeshes)
+	{
+		subMesh->LoadDiffuseTexture(FilePath);
 	}
 }
 
@@ -33,6 +123,17 @@ Poly::MeshResource::~MeshResource()
 	}
 }
 
+size_t Poly::MeshResource::GetMemorySize() const
+{
+	size_t size = 0;
+	for (const SubMesh* subMesh : SubMeshes)
+	{
+		const Mesh& data = subMesh->GetMeshData();
+		size += data.GetVertexCount() * data.GetVertexStride() + data.GetTriangleCount() * 3 * data.GetIndexSize();
+	}
+	return size;
+}
+
 Poly::MeshResource::SubMesh::SubMesh(const String& path, aiMesh* mesh, aiMaterial* material)
 {
 	if (mesh->HasPositions()) {
@@ -70,8 +171,9 @@ Poly::MeshResource::SubMesh::SubMesh(const String& path, aiMesh* mesh, aiMateria
 		}
 	}
 
-	MeshProxy = gEngine->GetRenderingDevice()->CreateMesh();
-	MeshProxy->SetContent(MeshData);
+	UpdateBoundingVolumes();
+
+	MeshData.Format = MeshData.GetCompactVertexFormat();
 
 	gConsole.LogDebug(
 		"Loaded mesh entry: {} with {} vertices, {} faces and parameters: "
@@ -85,21 +187,9 @@ Poly::MeshResource::SubMesh::SubMesh(const String& path, aiMesh* mesh, aiMateria
 	aiString texPath;
 	if (material->GetTexture(aiTextureType_DIFFUSE, 0, &texPath) == AI_SUCCESS)
 	{
-		//TODO load textures, this requires Path class
-		// temporary code for extracting path
-		std::string tmpPath = std::string(path.GetCStr());
-		std::replace(tmpPath.begin(), tmpPath.end(), '\\', '/'); // replace all '\' to '/', fix for linux machines
-		std::string fullPath = tmpPath.substr(0, tmpPath.rfind('/')+1) + std::string(texPath.C_Str());
-		std::replace(fullPath.begin(), fullPath.end(), '\\', '/'); // replace all '\' to '/', fix for linux machines
-		String textPath(fullPath.c_str());
-		// end temporary code for extracting path
-
-		MeshData.DiffuseTexture = ResourceManager<TextureResource>::Load(textPath, eResourceSource::NONE);
-		if (!MeshData.DiffuseTexture) {
-			gConsole.LogError("Failed to load diffuse texture: {}", fullPath);
-		} else {
-			gConsole.LogDebug("Succeded to load diffuse texture: {}", fullPath);
-		}
+		std::string relativePath = std::string(texPath.C_Str());
+		std::replace(relativePath.begin(), relativePath.end(), '\\', '/'); // replace all '\' to '/', fix for linux machines
+		DiffuseTexturePath = String(relativePath.c_str());
 	} else {
 		gConsole.LogError("Failed to load diffuse texture for material: {}", path);
 		MeshData.DiffuseTexture = nullptr;
@@ -124,3 +214,110 @@ Poly::MeshResource::SubMesh::SubMesh(const String& path, aiMesh* mesh, aiMateria
 
 
 }
+
+Poly::MeshResource::SubMesh::SubMesh(const CookedMesh::SubMeshHeader& header, const u8* data)
+{
+	MeshData.Format.Interleaved = true;
+	MeshData.Format.HalfTextCoords = (header.Flags & CookedMesh::HALF_TEXT_COORDS) != 0;
+	MeshData.Format.PackedNormals = (header.Flags & CookedMesh::PACKED_NORMALS) != 0;
+	MeshData.Format.ShortIndices = (header.Flags & CookedMesh::SHORT_INDICES) != 0;
+
+	MeshData.Packed.Vertices = data + header.VertexDataOffset;
+	MeshData.Packed.Indices = data + header.IndexDataOffset;
+	MeshData.Packed.VertexCount = header.VertexCount;
+	MeshData.Packed.IndexCount = header.IndexCount;
+	MeshData.Packed.HasTextCoords = (header.Flags & CookedMesh::HAS_TEXT_COORDS) != 0;
+	MeshData.Packed.HasNormals = (header.Flags & CookedMesh::HAS_NORMALS) != 0;
+
+	BoundingBox = AABox(Vector(header.BoxMin[0], header.BoxMin[1], header.BoxMin[2]), Vector(header.BoxSize[0], header.BoxSize[1], header.BoxSize[2]));
+	BoundingSphereCenter = Vector(header.SphereCenter[0], header.SphereCenter[1], header.SphereCenter[2]);
+	BoundingSphereRadius = header.SphereRadius;
+
+	MeshData.Mtl.SpecularIntensity = header.SpecularIntensity;
+	MeshData.Mtl.SpecularPower = header.SpecularPower;
+	MeshData.Mtl.SpecularColor = Color(header.SpecularColor[0], header.SpecularColor[1], header.SpecularColor[2], header.SpecularColor[3]);
+
+	if (header.DiffuseTexturePathLength > 0)
+	{
+		const char* path = reinterpret_cast<const char*>(data + header.DiffuseTexturePathOffset);
+		DiffuseTexturePath = String(std::string(path, header.DiffuseTexturePathLength).c_str());
+	}
+}
+
+Poly::MeshResource::SubMesh::~SubMesh()
+{
+	// mesh was dropped before its device objects were created, f.ex. when it was loaded synchronously in the meantime
+	if (DiffuseTextureLoad.IsReady() && DiffuseTextureLoad.Get())
+		ResourceManager<TextureResource>::Release(DiffuseTextureLoad.Get());
+}
+
+void Poly::MeshResource::SubMesh::CreateDeviceResources(const String& meshPath)
+{
+	MeshProxy = gEngine->GetRenderingDevice()->CreateMesh();
+	MeshProxy->SetContent(MeshData);
+	LoadDiffuseTexture(meshPath);
+}
+
+void Poly::MeshResource::SubMesh::LoadDiffuseTexture(const String& meshPath)
+{
+	if (DiffuseTexturePath.IsEmpty())
+		return;
+
+	const String texturePath = ResolvePathRelativeToFile(meshPath, DiffuseTexturePath);
+	if (DiffuseTextureLoad.IsValid())
+	{
+		// reference of the background load is taken over, it is waited for only when the mesh is revived by a synchronous load
+		MeshData.DiffuseTexture = DiffuseTextureLoad.Wait();
+		DiffuseTextureLoad = ResourceFuture<TextureResource>();
+	}
+	else
+	{
+		MeshData.DiffuseTexture = ResourceManager<TextureResource>::Load(texturePath, eResourceSource::NONE);
+	}
+
+	if (!MeshData.DiffuseTexture) {
+		gConsole.LogError("Failed to load diffuse texture: {}", texturePath);
+	} else {
+		gConsole.LogDebug("Succeded to load diffuse texture: {}", texturePath);
+	}
+}
+
+bool Poly::MeshResource::SubMesh::LoadDiffuseTextureAsync(const String& meshPath)
+{
+	if (DiffuseTexturePath.IsEmpty())
+		return true;
+
+	if (!DiffuseTextureLoad.IsValid())
+		DiffuseTextureLoad = ResourceManager<TextureResource>::LoadAsync(ResolvePathRelativeToFile(meshPath, DiffuseTexturePath), eResourceSource::NONE);
+	return DiffuseTextureLoad.IsReady();
+}
+
+void Poly::MeshResource::SubMesh::ReleaseDiffuseTexture()
+{
+	if (!MeshData.DiffuseTexture)
+		return;
+
+	ResourceManager<TextureResource>::Release(MeshData.DiffuseTexture);
+	MeshData.DiffuseTexture = nullptr;
+}
+
+void Poly::MeshResource::SubMesh::UpdateBoundingVolumes()
+{
+	const Dynarray<Vector3f>& positions = MeshData.GetPositions();
+	if (positions.IsEmpty())
+		return;
+
+	Vector3f min, max;
+	CalculateBounds(positions.GetData(), positions.GetSize(), min, max);
+	BoundingBox = AABox(Vector(min.X, min.Y, min.Z), Vector(max.X - min.X, max.Y - min.Y, max.Z - min.Z));
+
+	// sphere around box center, tighter than the one around the box
+	BoundingSphereCenter = BoundingBox.GetCenter();
+	float radiusSquared = 0.f;
+	for (const Vector3f& position : positions)
+	{
+		const Vector offset(position.X - BoundingSphereCenter.X, position.Y - BoundingSphereCenter.Y, position.Z - BoundingSphereCenter.Z);
+		radiusSquared = std::max(radiusSquared, offset.LengthSquared());
+	}
+	BoundingSphereRadius = std::sqrt(radiusSquared);
+}
@@ -3,10 +3,15 @@
 #include <Dynarray.hpp>
 #include <EnumUtils.hpp>
 #include <Color.hpp>
+#include <AABox.hpp>
+#include <MemoryMappedFile.hpp>
 
 #include "ResourceBase.hpp"
+#include "ResourceManager.hpp"
 #include "TextureResource.hpp"
 #include "Mesh.hpp"
+#include "IRenderingDevice.hpp"
+#include "CookedMesh.hpp"
 
 struct aiMesh;
 struct aiMaterial;
@@ -22,20 +27,66 @@ namespace Poly
 		{
 		public:
 			SubMesh(const String& path, aiMesh* mesh, aiMaterial* material);
+			/// <summary>Creates sub mesh referencing packed data of a validated cooked mesh, data has to outlive the sub mesh.</summary>
+			SubMesh(const CookedMesh::SubMeshHeader& header, const u8* data);
+			~SubMesh();
 
 			const Mesh& GetMeshData() const { return MeshData; }
 			const IMeshDeviceProxy* GetMeshProxy() const { return MeshProxy.get(); }
+
+			/// <summary>Returns axis aligned box containing all vertices, in mesh space.</summary>
+			const AABox& GetBoundingBox() const { return BoundingBox; }
+
+			/// <summary>Returns center of sphere containing all vertices, in mesh space.</summary>
+			const Vector& GetBoundingSphereCenter() const { return BoundingSphereCenter; }
+
+			/// <summary>Returns radius of sphere containing all vertices, in mesh space.</summary>
+			float GetBoundingSphereRadius() const { return BoundingSphereRadius; }
+
+			/// <summary>Returns path of diffuse texture relative to the mesh file, empty when there is no diffuse texture.</summary>
+			const String& GetDiffuseTexturePath() const { return DiffuseTexturePath; }
 		private:
+			void UpdateBoundingVolumes();
+			void CreateDeviceResources(const String& meshPath);
+			void LoadDiffuseTexture(const String& meshPath);
+			bool LoadDiffuseTextureAsync(const String& meshPath);
+			void ReleaseDiffuseTexture();
+
 			Mesh MeshData;
+			// loaded together with device objects, or in background before them when the mesh is loaded asynchronously
+			String DiffuseTexturePath;
+			ResourceFuture<TextureResource> DiffuseTextureLoad;
 			std::unique_ptr<IMeshDeviceProxy> MeshProxy;
+			AABox BoundingBox = AABox(Vector::ZERO, Vector::ZERO);
+			Vector BoundingSphereCenter;
+			float BoundingSphereRadius = 0.f;
+
+			friend class MeshResource;
 		};
 
+		/// <summary>Loads mesh from a cooked mesh file, or imports it from any other format supported by Assimp.</summary>
 		MeshResource(const String& path);
 		virtual ~MeshResource();
 
-
 		const Dynarray<SubMesh*>& GetSubMeshes() const { return SubMeshes; }
+
+		/// <summary>Returns size of vertex and index data of all sub meshes, textures are separate resources released while the mesh is cached.</summary>
+		size_t GetMemorySize() const override;
+
+	protected:
+		void CreateDeviceResources() override;
+		bool LoadDependenciesAsync() override;
+		// textures of cached meshes are released, so they are budgeted by the texture cache
+		void OnCached() override;
+		void OnRevived() override;
+
 	private:
+		void LoadCooked();
+		void LoadSource();
+
+		String FilePath;
+		// cooked meshes reference the mapped file instead of copying it
+		std::unique_ptr<MemoryMappedFile> CookedFile;
 		Dynarray<SubMesh*> SubMeshes;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "EnginePCH.hpp"
+
+#include "NullRenderingDevice.hpp"
+#include "RenderCommandList.hpp"
+
+using namespace Poly;
+
+namespace
+{
+	class NullTextureDeviceProxy : public ITextureDeviceProxy
+	{
+	public:
+		void SetContent(eTextureDataFormat, const unsigned char*) override {}
+		void SetSubContent(size_t, size_t, size_t, size_t, eTextureDataFormat, const unsigned char*) override {}
+		void SetMipContent(eTextureDataFormat, const Dynarray<TextureMip>&) override {}
+	};
+
+	class NullCubemapDeviceProxy : public ICubemapDeviceProxy
+	{
+	public:
+		void SetContent(const eCubemapSide, const unsigned char*) override {}
+	};
+
+	class NullTextFieldBufferDeviceProxy : public ITextFieldBufferDeviceProxy
+	{
+	public:
+		void SetContent(size_t, const TextFieldLetter*) override {}
+	};
+
+	class NullMeshDeviceProxy : public IMeshDeviceProxy
+	{
+	public:
+		void SetContent(const Mesh&) override {}
+	};
+}
+
+//------------------------------------------------------------------------------
+void NullRenderingDevice::RenderWorld(World* /*world*/, const RenderCommandList& commands)
+{
+	RenderingStats stats;
+	for (size_t viewIdx = 0; viewIdx < commands.GetViewCount(); ++viewIdx)
+	{
+		const RenderCommandList::View& view = commands.GetView(viewIdx);
+		if (view.Queue.IsEmpty())
+			continue;
+
+		// binds are skipped when consecutive packets share the state, the same way GL passes do
+		++stats.ProgramBinds;
+		const IMeshDeviceProxy* boundMesh = nullptr;
+		const ITextureDeviceProxy* boundTexture = nullptr;
+		for (const RenderQueue::Entry& entry : view.Queue.GetEntries())
+		{
+			const RenderCommandList::DrawPacket& packet = view.Packets[entry.Index];
+			if (packet.MeshProxy != boundMesh)
+			{
+				boundMesh = packet.MeshProxy;
+				++stats.VertexArrayBinds;
+			}
+			if (packet.Texture != boundTexture)
+			{
+				boundTexture = packet.Texture;
+				++stats.TextureBinds;
+			}
+			++stats.DrawCalls;
+		}
+	}
+	LastFrameStats = stats;
+}
+
+//------------------------------------------------------------------------------
+std::unique_ptr<ITextureDeviceProxy> NullRenderingDevice::CreateTexture(size_t /*width*/, size_t /*height*/, eTextureUsageType /*usage*/)
+{
+	return std::make_unique<NullTextureDeviceProxy>();
+}
+
+//------------------------------------------------------------------------------
+std::unique_ptr<ICubemapDeviceProxy> NullRenderingDevice::CreateCubemap(size_t /*width*/, size_t /*height*/)
+{
+	return std::make_unique<NullCubemapDeviceProxy>();
+}
+
+//------------------------------------------------------------------------------
+std::unique_ptr<ITextFieldBufferDeviceProxy> NullRenderingDevice::CreateTextFieldBuffer()
+{
+	return std::make_unique<NullTextFieldBufferDeviceProxy>();
+}
+
+//------------------------------------------------------------------------------
+std::unique_ptr<IMeshDeviceProxy> NullRenderingDevice::CreateMesh()
+{
+	return std::make_unique<NullMeshDeviceProxy>();
+}
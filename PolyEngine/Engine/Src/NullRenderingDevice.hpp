@@ -0,0 +1,31 @@
+#pragma once
+
+#include "IRenderingDevice.hpp"
+
+namespace Poly
+{
+	/// <summary>Rendering device without rendering API. Resources are not uploaded anywhere and command lists are replayed
+	/// only to count draw calls and state changes a real device would issue, so rendering can be tested and benchmarked headless.</summary>
+	class ENGINE_DLLEXPORT NullRenderingDevice : public IRenderingDevice
+	{
+	public:
+		explicit NullRenderingDevice(const ScreenSize& size = ScreenSize{ 800, 600 }) : ScreenDim(size) {}
+
+		void Resize(const ScreenSize& size) override { ScreenDim = size; }
+		const ScreenSize& GetScreenSize() const override { return ScreenDim; }
+
+		void RenderWorld(World* world, const RenderCommandList& commands) override;
+		const RenderingStats& GetLastFrameStats() const override { return LastFrameStats; }
+
+		void Init() override {}
+
+		std::unique_ptr<ITextureDeviceProxy> CreateTexture(size_t width, size_t height, eTextureUsageType usage) override;
+		std::unique_ptr<ICubemapDeviceProxy> CreateCubemap(size_t width, size_t height) override;
+		std::unique_ptr<ITextFieldBufferDeviceProxy> CreateTextFieldBuffer() override;
+		std::unique_ptr<IMeshDeviceProxy> CreateMesh() override;
+
+	private:
+		ScreenSize ScreenDim;
+		RenderingStats LastFrameStats;
+	};
+}
@@ -0,0 +1,98 @@
+#include "EnginePCH.hpp"
+
+#include "RenderCommandList.hpp"
+
+using namespace Poly;
+
+constexpr size_t RenderCommandList::PACKETS_PER_JOB;
+
+//------------------------------------------------------------------------------
+void RenderCommandList::Record(World* world, ThreadPool* pool)
+{
+	Clear();
+	for (auto& kv : world->GetWorldComponent<ViewportWorldComponent>()->GetViewports())
+	{
+		const CameraComponent* cameraCmp = kv.second.GetCamera();
+		ASSERTE(cameraCmp, "Viewport without camera?");
+		const Vector cameraPos = cameraCmp->GetSibling<TransformComponent>()->GetGlobalTranslation();
+		const Dynarray<VisibleSubMesh>& visible = cameraCmp->GetVisibleSubMeshes();
+
+		// global matrices of visible submeshes were already computed by culling, so reading them from jobs does not write the cache
+		RecordView(cameraCmp, kv.second.GetRect(), visible.GetSize(), [&visible, &cameraPos](size_t idx, DrawPacket& packet)
+		{
+			const VisibleSubMesh& item = visible[idx];
+			const MeshResource::SubMesh* subMesh = item.Mesh->GetMesh()->GetSubMeshes()[item.SubMeshIdx];
+			const TextureResource* diffuseTexture = subMesh->GetMeshData().GetDiffTexture();
+
+			packet.Transform = item.Transform->GetGlobalTransformationMatrix();
+			packet.Mesh = item.Mesh;
+			packet.SubMeshIdx = item.SubMeshIdx;
+			packet.MeshProxy = subMesh->GetMeshProxy();
+			packet.Texture = diffuseTexture ? diffuseTexture->GetTextureProxy() : nullptr;
+			packet.IndexCount = subMesh->GetMeshData().GetTriangleCount() * 3;
+
+			const float depth = (packet.Transform * subMesh->GetBoundingSphereCenter() - cameraPos).Length();
+			return RenderQueue::MakeSortKey(0, 0, GetSortId(packet.Texture), GetSortId(packet.MeshProxy), depth);
+		}, pool);
+	}
+}
+
+//------------------------------------------------------------------------------
+RenderCommandList::View& RenderCommandList::RecordView(const CameraComponent* camera, const AARect& rect, size_t packetCount, const PacketBuilder& builder, ThreadPool* pool)
+{
+	// views are reused between frames to keep memory of their packets
+	if (ViewCount == Views.GetSize())
+		Views.PushBack(std::make_unique<View>(camera, rect));
+	View& view = *Views[ViewCount++];
+	view.Camera = camera;
+	view.Rect = rect;
+
+	view.Packets.Reserve(packetCount);
+	view.Packets.Resize(packetCount);
+	SortKeys.Reserve(packetCount);
+	SortKeys.Resize(packetCount);
+
+	auto buildRange = [&view, &builder, this](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+			SortKeys[i] = builder(i, view.Packets[i]);
+	};
+
+	if (!pool || packetCount <= PACKETS_PER_JOB)
+	{
+		buildRange(0, packetCount);
+	}
+	else
+	{
+		JobCounter counter;
+		for (size_t begin = 0; begin < packetCount; begin += PACKETS_PER_JOB)
+			pool->Submit([&buildRange, begin, packetCount]() { buildRange(begin, std::min(begin + PACKETS_PER_JOB, packetCount)); }, &counter);
+		pool->Wait(counter);
+	}
+
+	view.Queue.Clear();
+	view.Queue.Reserve(packetCount);
+	for (size_t i = 0; i < packetCount; ++i)
+		view.Queue.Push(SortKeys[i], static_cast<u32>(i));
+	view.Queue.Sort();
+	return view;
+}
+
+//------------------------------------------------------------------------------
+const RenderCommandList::View* RenderCommandList::FindView(const CameraComponent* camera) const
+{
+	for (size_t i = 0; i < ViewCount; ++i)
+	{
+		if (Views[i]->Camera == camera)
+			return Views[i].get();
+	}
+	return nullptr;
+}
+
+//------------------------------------------------------------------------------
+u32 RenderCommandList::GetSortId(const void* resource)
+{
+	// lowest 3 bits of pointers are equal due to alignment, fold the address so nearby allocations get different identifiers
+	const u64 address = static_cast<u64>(reinterpret_cast<uintptr_t>(resource));
+	return static_cast<u32>((address >> 3) ^ (address >> 19) ^ (address >> 35));
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <Core.hpp>
+#include <AARect.hpp>
+#include "RenderQueue.hpp"
+
+#include <functional>
+
+namespace Poly
+{
+	class World;
+	class CameraComponent;
+	class MeshRenderingComponent;
+	class IMeshDeviceProxy;
+	class ITextureDeviceProxy;
+	class ThreadPool;
+
+	/// <summary>Device agnostic draw commands of a single frame.
+	/// Recording walks the World: it builds draw packets of submeshes visible from every viewport camera and sorts them.
+	/// Packets are built concurrently on worker threads. Rendering device replays sorted packets on the submission thread,
+	/// without touching transformations or resources of the World.</summary>
+	class ENGINE_DLLEXPORT RenderCommandList : public BaseObject<>
+	{
+	public:
+		/// <summary>State and parameters needed to draw a single submesh.</summary>
+		struct DrawPacket
+		{
+			Matrix Transform;
+			// material and rendering flags
+			const MeshRenderingComponent* Mesh;
+			size_t SubMeshIdx;
+			const IMeshDeviceProxy* MeshProxy;
+			// diffuse texture, nullptr when submesh does not have one
+			const ITextureDeviceProxy* Texture;
+			size_t IndexCount;
+		};
+
+		/// <summary>Packets recorded for a viewport, Queue holds them sorted by state and depth.</summary>
+		struct View : public BaseObject<>
+		{
+			View(const CameraComponent* camera, const AARect& rect) : Camera(camera), Rect(rect) {}
+
+			const CameraComponent* Camera;
+			AARect Rect;
+			Dynarray<DrawPacket> Packets;
+			RenderQueue Queue;
+		};
+
+		/// <summary>Fills packet with given index and returns its sort key. Called concurrently for different indices.</summary>
+		using PacketBuilder = std::function<u64(size_t idx, DrawPacket& packet)>;
+
+		/// <summary>Removes all views, memory of their packets is kept for the next frame.</summary>
+		void Clear() { ViewCount = 0; }
+
+		/// <summary>Clears the list and records views of all viewports of the world from submeshes visible from their cameras.</summary>
+		/// <param name="pool">Pool used to build packets concurrently or nullptr to build them on the calling thread.</param>
+		void Record(World* world, ThreadPool* pool = nullptr);
+
+		/// <summary>Adds view with given amount of packets filled by the builder, concurrently when pool is given, and sorts them.</summary>
+		View& RecordView(const CameraComponent* camera, const AARect& rect, size_t packetCount, const PacketBuilder& builder, ThreadPool* pool = nullptr);
+
+		size_t GetViewCount() const { return ViewCount; }
+		const View& GetView(size_t idx) const { HEAVY_ASSERTE(idx < ViewCount, "Invalid view index!"); return *Views[idx]; }
+
+		/// <summary>Returns view recorded for the camera or nullptr if there is none.</summary>
+		const View* FindView(const CameraComponent* camera) const;
+
+		/// <summary>Returns identifier of the resource for sort keys. Different resources may share identifier, which only affects ordering.</summary>
+		static u32 GetSortId(const void* resource);
+
+		/// <summary>Amount of packets built by a single job.</summary>
+		static constexpr size_t PACKETS_PER_JOB = 256;
+
+	private:
+		Dynarray<std::unique_ptr<View>> Views;
+		size_t ViewCount = 0;
+		Dynarray<u64> SortKeys;
+	};
+}
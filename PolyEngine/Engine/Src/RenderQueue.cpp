@@ -0,0 +1,70 @@
+#include "EnginePCH.hpp"
+
+#include "RenderQueue.hpp"
+
+using namespace Poly;
+
+STATIC_ASSERTE(RenderQueue::PASS_BITS + RenderQueue::SHADER_BITS + RenderQueue::TEXTURE_BITS + RenderQueue::MESH_BITS + RenderQueue::DEPTH_BITS == 64,
+	"Sort key fields have to fill 64 bits.");
+
+//------------------------------------------------------------------------------
+u64 RenderQueue::MakeSortKey(u32 pass, u32 shader, u32 texture, u32 mesh, float depth)
+{
+	auto field = [](u32 value, u32 bits) { return u64(value) & ((u64(1) << bits) - 1); };
+
+	// bit patterns of non negative floats are ordered the same way as the floats, so the top bits are a monotonic depth
+	const float clampedDepth = std::max(depth, 0.0f);
+	u32 depthBits;
+	std::memcpy(&depthBits, &clampedDepth, sizeof(depthBits));
+	depthBits >>= 31 - DEPTH_BITS;
+
+	u64 key = field(pass, PASS_BITS);
+	key = (key << SHADER_BITS) | field(shader, SHADER_BITS);
+	key = (key << TEXTURE_BITS) | field(texture, TEXTURE_BITS);
+	key = (key << MESH_BITS) | field(mesh, MESH_BITS);
+	key = (key << DEPTH_BITS) | field(depthBits, DEPTH_BITS);
+	return key;
+}
+
+//------------------------------------------------------------------------------
+void RenderQueue::Sort()
+{
+	const size_t count = Entries.GetSize();
+	if (count < 2)
+		return;
+
+	// histograms of all digits are gathered in a single pass
+	constexpr size_t DIGITS = sizeof(u64);
+	size_t histograms[DIGITS][256] = {};
+	for (const Entry& entry : Entries)
+		for (size_t digit = 0; digit < DIGITS; ++digit)
+			++histograms[digit][(entry.SortKey >> (digit * 8)) & 0xFF];
+
+	SortBuffer.Resize(count);
+	Entry* src = Entries.GetData();
+	Entry* dst = SortBuffer.GetData();
+	for (size_t digit = 0; digit < DIGITS; ++digit)
+	{
+		size_t* histogram = histograms[digit];
+		if (histogram[(src[0].SortKey >> (digit * 8)) & 0xFF] == count)
+			continue;
+
+		size_t offset = 0;
+		for (size_t i = 0; i < 256; ++i)
+		{
+			const size_t bucketSize = histogram[i];
+			histogram[i] = offset;
+			offset += bucketSize;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Entry& entry = src[i];
+			dst[histogram[(entry.SortKey >> (digit * 8)) & 0xFF]++] = entry;
+		}
+		std::swap(src, dst);
+	}
+
+	if (src != Entries.GetData())
+		std::swap(Entries, SortBuffer);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Core.hpp>
+
+namespace Poly
+{
+	/// <summary>List of draw items ordered by 64-bit sort keys, built by rendering passes every frame.
+	/// Items are identified by indices into an array owned by the pass, so the queue does not depend on rendering API.
+	/// Keys built with MakeSortKey() group items by pass, shader, texture and mesh, so submission can skip redundant binds,
+	/// items sharing the whole state are ordered front to back.</summary>
+	class ENGINE_DLLEXPORT RenderQueue : public BaseObject<>
+	{
+	public:
+		struct Entry
+		{
+			u64 SortKey;
+			u32 Index;
+		};
+
+		// bit widths of sort key fields, from the most significant one
+		static constexpr u32 PASS_BITS = 4;
+		static constexpr u32 SHADER_BITS = 10;
+		static constexpr u32 TEXTURE_BITS = 16;
+		static constexpr u32 MESH_BITS = 16;
+		static constexpr u32 DEPTH_BITS = 18;
+
+		/// <summary>Builds sort key. Identifiers wider than their fields are truncated, which only affects ordering.</summary>
+		/// <param name="pass">Pass or layer index, the most significant field.</param>
+		/// <param name="shader">Shader program identifier.</param>
+		/// <param name="texture">Texture identifier.</param>
+		/// <param name="mesh">Vertex array or mesh identifier.</param>
+		/// <param name="depth">Distance from the camera, negative values are clamped to 0.</param>
+		static u64 MakeSortKey(u32 pass, u32 shader, u32 texture, u32 mesh, float depth);
+
+		void Clear() { Entries.Clear(); }
+		void Reserve(size_t capacity) { Entries.Reserve(capacity); }
+
+		/// <summary>Adds item to the queue.</summary>
+		/// <param name="sortKey">Key, f.ex. built with MakeSortKey().</param>
+		/// <param name="index">Index of the item in an array owned by the caller.</param>
+		void Push(u64 sortKey, u32 index) { Entries.PushBack(Entry{ sortKey, index }); }
+
+		/// <summary>Sorts entries by key with a stable LSD radix sort.
+		/// Bytes equal in all keys (f.ex. pass and shader within a single pass) are skipped.</summary>
+		void Sort();
+
+		const Dynarray<Entry>& GetEntries() const { return Entries; }
+		size_t GetSize() const { return Entries.GetSize(); }
+		bool IsEmpty() const { return Entries.IsEmpty(); }
+
+	private:
+		Dynarray<Entry> Entries;
+		Dynarray<Entry> SortBuffer;
+	};
+}
@@ -3,7 +3,11 @@
 using namespace Poly;
 
 void RenderingSystem::RenderingPhase(World* world)
-{	
+{
+	// packets are recorded on workers of the update pool, submission stays on the main thread owning the rendering context
+	RenderCommandList& commands = gEngine->GetRenderCommandList();
+	commands.Record(world, gEngine->GetThreadPool());
+
 	IRenderingDevice* device = gEngine->GetRenderingDevice();
-	device->RenderWorld(world);
+	device->RenderWorld(world, commands);
 }
@@ -8,6 +8,8 @@
 
 namespace Poly
 {
+	namespace Impl { template<typename T> class ResourceRegistry; template<typename T> class AsyncResourceLoad; }
+
 	//------------------------------------------------------------------------------
 	class ENGINE_DLLEXPORT ResourceLoadFailedException : public BaseObject<>, public std::exception
 	{
@@ -21,6 +23,10 @@ namespace Poly
 	public:
 		const String& GetPath() const { return Path; }
 
+		/// <summary>Returns approximate size in bytes of host and device memory held by the resource,
+		/// charged against the cache budget of ResourceManager while the resource is unreferenced.</summary>
+		virtual size_t GetMemorySize() const { return 0; }
+
 		ResourceBase() = default;
 		ResourceBase(const ResourceBase&) = delete;
 		ResourceBase& operator=(const ResourceBase&) = delete;
@@ -28,9 +34,31 @@ namespace Poly
 	protected:
 		virtual ~ResourceBase() {}
 
+		/// <summary>Creates rendering or audio device objects from data decoded by the constructor.
+		/// Constructor may run on a loader thread, this method is always called on the main thread,
+		/// before the resource is registered.</summary>
+		virtual void CreateDeviceResources() {}
+
+		/// <summary>Starts asynchronous loads of resources referenced by this one, when it is loaded by ResourceManager::LoadAsync().
+		/// Called on the main thread after decoding and again on later loader updates, until it returns true.
+		/// CreateDeviceResources() is called only once the started loads are finished.</summary>
+		/// <returns>True when all started loads are finished.</returns>
+		virtual bool LoadDependenciesAsync() { return true; }
+
+		/// <summary>Called when the last reference is released and the resource is kept in the cache.
+		/// References of other resources should be released here, so they are cached and budgeted by their own managers.</summary>
+		virtual void OnCached() {}
+
+		/// <summary>Called when a cached resource is loaded again, reacquires references released by OnCached().</summary>
+		virtual void OnRevived() {}
+
 	private:
 		String Path;
+		// slot in the registry of the resource type, updated when the registry grows
+		size_t RegistrySlot = 0;
 
 		template<typename T> friend class ResourceManager;
+		template<typename T> friend class Impl::ResourceRegistry;
+		template<typename T> friend class Impl::AsyncResourceLoad;
 	};
 }
\ No newline at end of file
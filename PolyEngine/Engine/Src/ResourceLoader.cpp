@@ -0,0 +1,145 @@
+#include "EnginePCH.hpp"
+
+#include "ResourceLoader.hpp"
+
+#include <chrono>
+
+using namespace Poly;
+
+ResourceLoader Poly::gResourceLoader;
+
+constexpr size_t ResourceLoader::WORKER_COUNT;
+
+//------------------------------------------------------------------------------
+ResourceLoader::~ResourceLoader()
+{
+	Shutdown();
+}
+
+//------------------------------------------------------------------------------
+void ResourceLoader::Submit(const std::shared_ptr<Impl::AsyncResourceLoadBase>& load)
+{
+	const LoadKey key(load->GetType(), load->GetPath());
+	HEAVY_ASSERTE(PendingLoads.find(key) == PendingLoads.end(), "Resource is already being loaded!");
+	PendingLoads.insert(std::make_pair(key, load));
+
+	// threads are not started during static initialization of the global loader
+	if (!Pool)
+		Pool = std::make_unique<ThreadPool>(WORKER_COUNT);
+
+	Pool->Submit([this, load]()
+	{
+		load->Decode();
+		{
+			std::lock_guard<std::mutex> lock(DecodedMutex);
+			DecodedLoads.PushBack(load);
+		}
+		DecodedCondition.notify_all();
+	});
+}
+
+//------------------------------------------------------------------------------
+void ResourceLoader::SubmitWaiting(const std::shared_ptr<Impl::AsyncResourceLoadBase>& load)
+{
+	const LoadKey key(load->GetType(), load->GetPath());
+	HEAVY_ASSERTE(PendingLoads.find(key) == PendingLoads.end(), "Resource is already being loaded!");
+	PendingLoads.insert(std::make_pair(key, load));
+	WaitingLoads.PushBack(load);
+}
+
+//------------------------------------------------------------------------------
+std::shared_ptr<Impl::AsyncResourceLoadBase> ResourceLoader::FindPendingLoad(std::type_index type, const String& path) const
+{
+	auto it = PendingLoads.find(LoadKey(type, path));
+	return it != PendingLoads.end() ? it->second : nullptr;
+}
+
+//------------------------------------------------------------------------------
+size_t ResourceLoader::Update()
+{
+	const auto start = std::chrono::steady_clock::now();
+	size_t finishedCount = 0;
+	while (FinishNext(false))
+	{
+		++finishedCount;
+
+		const float elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if (elapsed >= UploadBudget)
+			break;
+	}
+	return finishedCount;
+}
+
+//------------------------------------------------------------------------------
+void ResourceLoader::Wait(const Impl::AsyncResourceLoadBase& load)
+{
+	while (!load.IsDone())
+	{
+		HEAVY_ASSERTE(PendingLoads.find(LoadKey(load.GetType(), load.GetPath())) != PendingLoads.end(), "Waiting for load that was not submitted!");
+		FinishNext(true);
+	}
+}
+
+//------------------------------------------------------------------------------
+void ResourceLoader::Flush()
+{
+	while (!PendingLoads.empty())
+		FinishNext(true);
+}
+
+//------------------------------------------------------------------------------
+void ResourceLoader::Shutdown()
+{
+	// pool finishes queued decodes before joining workers
+	Pool.reset();
+	DecodedLoads.Clear();
+	WaitingLoads.Clear();
+	PendingLoads.clear();
+}
+
+//------------------------------------------------------------------------------
+std::shared_ptr<Impl::AsyncResourceLoadBase> ResourceLoader::PopDecoded(bool wait)
+{
+	std::unique_lock<std::mutex> lock(DecodedMutex);
+	if (wait)
+		DecodedCondition.wait(lock, [this]() { return !DecodedLoads.IsEmpty(); });
+	else if (DecodedLoads.IsEmpty())
+		return nullptr;
+
+	std::shared_ptr<Impl::AsyncResourceLoadBase> load = DecodedLoads.Front();
+	DecodedLoads.PopFront();
+	return load;
+}
+
+//------------------------------------------------------------------------------
+bool ResourceLoader::FinishNext(bool wait)
+{
+	// waiting loads are retried first, loads finished since the last call may have been the ones they wait for
+	for (size_t i = 0; i < WaitingLoads.GetSize(); ++i)
+	{
+		if (Finish(WaitingLoads[i]))
+		{
+			WaitingLoads.RemoveByIdx(i);
+			return true;
+		}
+	}
+
+	while (std::shared_ptr<Impl::AsyncResourceLoadBase> load = PopDecoded(wait))
+	{
+		if (Finish(load))
+			return true;
+		WaitingLoads.PushBack(load);
+	}
+	return false;
+}
+
+//------------------------------------------------------------------------------
+bool ResourceLoader::Finish(const std::shared_ptr<Impl::AsyncResourceLoadBase>& load)
+{
+	if (!load->Finish())
+		return false;
+
+	load->Done = true;
+	PendingLoads.erase(LoadKey(load->GetType(), load->GetPath()));
+	return true;
+}
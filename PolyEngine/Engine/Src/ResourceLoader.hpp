@@ -0,0 +1,115 @@
+#pragma once
+
+#include <Core.hpp>
+#include <ThreadPool.hpp>
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+
+namespace Poly
+{
+	class ResourceLoader;
+
+	namespace Impl
+	{
+		/// <summary>State of a single asynchronous resource load, shared by all futures waiting for it.
+		/// Decode() runs on a loader worker, Finish() on the main thread.</summary>
+		class ENGINE_DLLEXPORT AsyncResourceLoadBase : public BaseObject<>
+		{
+		public:
+			AsyncResourceLoadBase(std::type_index type, const String& path) : Type(type), Path(path) {}
+			virtual ~AsyncResourceLoadBase() = default;
+
+			std::type_index GetType() const { return Type; }
+			const String& GetPath() const { return Path; }
+
+			/// <summary>Checks whether the load is finished, successfully or not. Main thread only.</summary>
+			bool IsDone() const { return Done; }
+
+		protected:
+			/// <summary>File I/O and CPU side decoding, must not access rendering or audio devices.</summary>
+			virtual void Decode() = 0;
+
+			/// <summary>Creates device objects and registers the resource.</summary>
+			/// <returns>False when the resource waits for loads of other resources, Finish() is called again later.</returns>
+			virtual bool Finish() = 0;
+
+			std::type_index Type;
+			String Path;
+			bool Done = false;
+
+			friend class Poly::ResourceLoader;
+		};
+	}
+
+	/// <summary>Background loader used by ResourceManager::LoadAsync().
+	/// Reading and decoding of resources runs on a dedicated pool, separate from the update pool,
+	/// so waiting for update jobs never picks up a long decode. Decoded resources are queued
+	/// and finished on the main thread in Update(), within a per-frame time budget.
+	/// Resources referencing other resources, f.ex. meshes and their textures, wait until loads started for those are finished.</summary>
+	class ENGINE_DLLEXPORT ResourceLoader : public BaseObject<>
+	{
+	public:
+		ResourceLoader() = default;
+		~ResourceLoader();
+
+		ResourceLoader(const ResourceLoader&) = delete;
+		ResourceLoader& operator=(const ResourceLoader&) = delete;
+
+		/// <summary>Queues load for decoding. Worker threads are started with the first load.</summary>
+		void Submit(const std::shared_ptr<Impl::AsyncResourceLoadBase>& load);
+
+		/// <summary>Queues load that needs no decoding, f.ex. revival of a cached resource.
+		/// It is finished by Update() once the loads it waits for are finished.</summary>
+		void SubmitWaiting(const std::shared_ptr<Impl::AsyncResourceLoadBase>& load);
+
+		/// <summary>Returns unfinished load of given resource type and path or nullptr.</summary>
+		std::shared_ptr<Impl::AsyncResourceLoadBase> FindPendingLoad(std::type_index type, const String& path) const;
+
+		/// <summary>Finishes decoded loads on the calling thread until the upload budget is used up.
+		/// At least one load that is ready is finished, so loading always progresses. Called by the engine every frame.</summary>
+		/// <returns>Amount of finished loads.</returns>
+		size_t Update();
+
+		/// <summary>Blocks until given load is finished. Other loads decoded in the meantime are finished as well.</summary>
+		void Wait(const Impl::AsyncResourceLoadBase& load);
+
+		/// <summary>Blocks until all submitted loads are finished.</summary>
+		void Flush();
+
+		/// <summary>Waits for running decodes and drops all unfinished loads, their futures never become ready.</summary>
+		void Shutdown();
+
+		/// <summary>Sets time Update() may spend on finishing loads, in milliseconds.</summary>
+		void SetUploadBudget(float milliseconds) { UploadBudget = milliseconds; }
+		float GetUploadBudget() const { return UploadBudget; }
+
+		/// <summary>Returns amount of submitted loads that are not finished yet.</summary>
+		size_t GetPendingCount() const { return PendingLoads.size(); }
+
+		static constexpr size_t WORKER_COUNT = 2;
+
+	private:
+		using LoadKey = std::pair<std::type_index, String>;
+
+		std::shared_ptr<Impl::AsyncResourceLoadBase> PopDecoded(bool wait);
+		bool FinishNext(bool wait);
+		bool Finish(const std::shared_ptr<Impl::AsyncResourceLoadBase>& load);
+
+		std::unique_ptr<ThreadPool> Pool;
+		// accessed only by the main thread
+		std::map<LoadKey, std::shared_ptr<Impl::AsyncResourceLoadBase>> PendingLoads;
+		// decoded loads waiting for loads of resources they reference, main thread only
+		Dynarray<std::shared_ptr<Impl::AsyncResourceLoadBase>> WaitingLoads;
+		float UploadBudget = 2.0f;
+
+		std::mutex DecodedMutex;
+		std::condition_variable DecodedCondition;
+		Queue<std::shared_ptr<Impl::AsyncResourceLoadBase>> DecodedLoads;
+	};
+
+	ENGINE_DLLEXPORT extern ResourceLoader gResourceLoader;
+}
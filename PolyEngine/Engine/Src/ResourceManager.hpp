@@ -7,8 +7,9 @@
 
 #include "AssetsPathConfig.hpp"
 #include "ResourceBase.hpp"
+#include "ResourceLoader.hpp"
 
-#include <map>
+#include <list>
 
 namespace Poly
 {
@@ -20,27 +21,228 @@ namespace Poly
 	ENGINE_DLLEXPORT String LoadTextFileRelative(eResourceSource Source, const String& path);
 	ENGINE_DLLEXPORT void SaveTextFileRelative(eResourceSource Source, const String& path, const String& text);
 
-	namespace Impl { template<typename T> std::map<String, std::unique_ptr<T>>& GetResources(); }
+	//------------------------------------------------------------------------------
+	/// <summary>Statistics of the cache of unreferenced resources of one type.
+	/// Loads of resources that are still referenced count neither as hits nor as misses.</summary>
+	struct ResourceCacheStats
+	{
+		// loads served by a cached resource
+		size_t Hits = 0;
+		// loads that had to construct the resource
+		size_t Misses = 0;
+		// cached resources freed because of the budget or ClearCache()
+		size_t Evictions = 0;
+		size_t CachedCount = 0;
+		size_t CachedBytes = 0;
+	};
+
+	namespace Impl
+	{
+		//------------------------------------------------------------------------------
+		// Resources of one type, both referenced and cached, in an open addressing table keyed by path hash.
+		// Resources know their slot, so releasing one needs no lookup.
+		template<typename T>
+		class ResourceRegistry : public BaseObject<>
+		{
+		public:
+			static constexpr size_t INVALID_SLOT = static_cast<size_t>(-1);
+
+			struct Entry
+			{
+				// nullptr for free and removed slots
+				std::unique_ptr<T> Resource;
+				size_t PathHash = 0;
+				// removed slot keeps probe sequences passing through it intact
+				bool Removed = false;
+				// valid while the resource is cached
+				typename std::list<T*>::iterator CacheIt;
+				size_t CachedSize = 0;
+				bool Cached = false;
+				// taken out of the cache by LoadAsync(), waiting for loads of its dependencies
+				bool Reviving = false;
+			};
+
+			//------------------------------------------------------------------------------
+			// Returns slot of the resource registered under the path, or INVALID_SLOT
+			size_t Find(const String& path, size_t pathHash) const
+			{
+				if (Slots.IsEmpty())
+					return INVALID_SLOT;
+
+				// load factor below 1 guarantees there is a free slot ending the probe sequence
+				const size_t mask = Slots.GetSize() - 1;
+				for (size_t slot = pathHash & mask; ; slot = (slot + 1) & mask)
+				{
+					const Entry& entry = Slots[slot];
+					if (entry.Resource && entry.PathHash == pathHash && entry.Resource->GetPath() == path)
+						return slot;
+					if (!entry.Resource && !entry.Removed)
+						return INVALID_SLOT;
+				}
+			}
+
+			//------------------------------------------------------------------------------
+			// Adds resource that is not registered yet, its path has to be set
+			size_t Insert(std::unique_ptr<T> resource, size_t pathHash)
+			{
+				if ((Count + RemovedCount + 1) * 4 > Slots.GetSize() * 3)
+					Rehash();
+
+				const size_t mask = Slots.GetSize() - 1;
+				size_t slot = pathHash & mask;
+				while (Slots[slot].Resource)
+					slot = (slot + 1) & mask;
+
+				Entry& entry = Slots[slot];
+				if (entry.Removed)
+				{
+					entry.Removed = false;
+					--RemovedCount;
+				}
+				static_cast<ResourceBase*>(resource.get())->RegistrySlot = slot;
+				entry.Resource = std::move(resource);
+				entry.PathHash = pathHash;
+				++Count;
+				return slot;
+			}
+
+			//------------------------------------------------------------------------------
+			// Takes the resource out of the table, it is freed by the caller once the registry is consistent
+			std::unique_ptr<T> Remove(size_t slot)
+			{
+				Entry& entry = Slots[slot];
+				std::unique_ptr<T> resource = std::move(entry.Resource);
+				entry.Cached = false;
+				entry.Reviving = false;
+				--Count;
+
+				// when no probe sequence continues past the slot, it and removed slots before it become free
+				const size_t mask = Slots.GetSize() - 1;
+				const Entry& next = Slots[(slot + 1) & mask];
+				if (next.Resource || next.Removed)
+				{
+					entry.Removed = true;
+					++RemovedCount;
+					return resource;
+				}
+				for (size_t prev = (slot - 1) & mask; Slots[prev].Removed; prev = (prev - 1) & mask)
+				{
+					Slots[prev].Removed = false;
+					--RemovedCount;
+				}
+				return resource;
+			}
+
+			Entry& GetEntry(size_t slot) { return Slots[slot]; }
+			static size_t GetSlot(const T* resource) { return static_cast<const ResourceBase*>(resource)->RegistrySlot; }
+			size_t GetCount() const { return Count; }
+
+			// unreferenced resources, least recently released first
+			std::list<T*> Cache;
+			// 0 disables caching, resources are freed with their last reference
+			size_t CacheBudget = 0;
+			ResourceCacheStats Stats;
+
+		private:
+			//------------------------------------------------------------------------------
+			// Grows the table to keep load factor below 1/2 and drops removed slots, updating slots of moved resources
+			void Rehash()
+			{
+				size_t capacity = MIN_CAPACITY;
+				while ((Count + 1) * 2 > capacity)
+					capacity *= 2;
+
+				Dynarray<Entry> slots;
+				slots.Resize(capacity);
+				const size_t mask = capacity - 1;
+				for (Entry& entry : Slots)
+				{
+					if (!entry.Resource)
+						continue;
+					size_t slot = entry.PathHash & mask;
+					while (slots[slot].Resource)
+						slot = (slot + 1) & mask;
+					static_cast<ResourceBase*>(entry.Resource.get())->RegistrySlot = slot;
+					slots[slot] = std::move(entry);
+				}
+				Slots = std::move(slots);
+				RemovedCount = 0;
+			}
+
+			static constexpr size_t MIN_CAPACITY = 16;
+
+			// capacity is a power of two
+			Dynarray<Entry> Slots;
+			size_t Count = 0;
+			size_t RemovedCount = 0;
+		};
+
+		template<typename T> ResourceRegistry<T>& GetResources();
+	}
 
 #define ENGINE_DECLARE_RESOURCE(type, map_name) \
 	namespace Impl { \
-		ENGINE_DLLEXPORT extern std::map<String, std::unique_ptr<type>> map_name; \
-		template<> inline std::map<String, std::unique_ptr<type>>& GetResources<type>() { return map_name; } \
+		ENGINE_DLLEXPORT extern ResourceRegistry<type> map_name; \
+		template<> inline ResourceRegistry<type>& GetResources<type>() { return map_name; } \
 	}
 
 #define DECLARE_RESOURCE(type, map_name) \
 	namespace Impl { \
-		GAME_DLLEXPORT extern std::map<String, std::unique_ptr<type>> map_name; \
-		template<> inline std::map<String, std::unique_ptr<type>>& GetResources<type>() { return map_name; } \
+		GAME_DLLEXPORT extern ResourceRegistry<type> map_name; \
+		template<> inline ResourceRegistry<type>& GetResources<type>() { return map_name; } \
 	}
 
-#define DEFINE_RESOURCE(type, map_name) namespace Poly { namespace Impl { std::map<String, std::unique_ptr<type>> map_name = {}; }}
+#define DEFINE_RESOURCE(type, map_name) namespace Poly { namespace Impl { ResourceRegistry<type> map_name = {}; }}
 
 	ENGINE_DECLARE_RESOURCE(MeshResource, gMeshResourcesMap)
 	ENGINE_DECLARE_RESOURCE(TextureResource, gTextureResourcesMap)
 	ENGINE_DECLARE_RESOURCE(FontResource, gFontResourcesMap)
 	ENGINE_DECLARE_RESOURCE(SoundResource, gALSoundResourcesMap)
 
+	template<typename T> class ResourceManager;
+	namespace Impl { template<typename T> class AsyncResourceLoad; }
+
+	//------------------------------------------------------------------------------
+	/// <summary>Handle to a resource loaded by ResourceManager::LoadAsync().
+	/// Once ready, the caller owns one reference of the resource, same as the one returned by Load(),
+	/// and frees it with ResourceManager::Release().</summary>
+	template<typename T>
+	class ResourceFuture
+	{
+	public:
+		ResourceFuture() = default;
+
+		/// <summary>Checks whether the future refers to a load.</summary>
+		bool IsValid() const { return Load != nullptr; }
+
+		/// <summary>Checks whether the load is finished, successfully or not.</summary>
+		bool IsReady() const { return Load && Load->IsDone(); }
+
+		/// <summary>Returns loaded resource or nullptr if loading failed. Load has to be ready.</summary>
+		T* Get() const
+		{
+			ASSERTE(IsReady(), "Resource is not loaded yet!");
+			return Load->GetResource();
+		}
+
+		/// <summary>Blocks until the load is finished, finishing decoded loads on the calling thread.</summary>
+		/// <returns>Loaded resource or nullptr if loading failed.</returns>
+		T* Wait() const
+		{
+			ASSERTE(IsValid(), "Waiting for invalid future!");
+			if (!Load->IsDone())
+				gResourceLoader.Wait(*Load);
+			return Get();
+		}
+
+	private:
+		explicit ResourceFuture(std::shared_ptr<Impl::AsyncResourceLoad<T>> load) : Load(std::move(load)) {}
+
+		std::shared_ptr<Impl::AsyncResourceLoad<T>> Load;
+
+		friend class ResourceManager<T>;
+	};
+
 	//------------------------------------------------------------------------------
 	template<typename T>
 	class ResourceManager
@@ -59,53 +261,303 @@ namespace Poly
 		//------------------------------------------------------------------------------
 		static T* Load(const String& path, eResourceSource source = eResourceSource::NONE)
 		{
-			auto it = Impl::GetResources<T>().find(path);
+			Impl::ResourceRegistry<T>& registry = Impl::GetResources<T>();
+			const size_t slot = registry.Find(path, path.GetHash());
 
 			// Check if it is already loaded
-			if (it != Impl::GetResources<T>().end())
-			{
-				T* resource = it->second.get();
-				resource->AddRef();
-				return resource;
-			}
+			if (slot != Impl::ResourceRegistry<T>::INVALID_SLOT)
+				return Acquire(registry, slot, 1);
 
 			// Load the resource
+			++registry.Stats.Misses;
 			gConsole.LogInfo("ResourceManager: Loading: {}", path);
-			T* resource = nullptr;
-			String absolutePath = gAssetsPathConfig.GetAssetsPath(source) + path;
+			return Register(path, Create(path, gAssetsPathConfig.GetAssetsPath(source) + path), 1);
+		}
+
+		//------------------------------------------------------------------------------
+		/// <summary>Starts loading the resource in background, file reading and decoding run on gResourceLoader threads.
+		/// Device objects are created on the main thread, when the engine updates the loader.
+		/// Requests for a resource that is already being loaded share the load.
+		/// Cached resource is revived once the dependencies it released are loaded again in background.</summary>
+		static ResourceFuture<T> LoadAsync(const String& path, eResourceSource source = eResourceSource::NONE)
+		{
+			Impl::ResourceRegistry<T>& registry = Impl::GetResources<T>();
+			const size_t slot = registry.Find(path, path.GetHash());
+			if (slot != Impl::ResourceRegistry<T>::INVALID_SLOT)
+				return LoadRegisteredAsync(registry, slot, path);
+
+			if (std::shared_ptr<Impl::AsyncResourceLoadBase> pending = gResourceLoader.FindPendingLoad(typeid(T), path))
+			{
+				std::shared_ptr<Impl::AsyncResourceLoad<T>> load = std::static_pointer_cast<Impl::AsyncResourceLoad<T>>(pending);
+				++load->RequestCount;
+				return ResourceFuture<T>(load);
+			}
+
+			++registry.Stats.Misses;
+			gConsole.LogInfo("ResourceManager: Loading asynchronously: {}", path);
+			auto load = std::make_shared<Impl::AsyncResourceLoad<T>>(path, gAssetsPathConfig.GetAssetsPath(source) + path);
+			gResourceLoader.Submit(load);
+			return ResourceFuture<T>(load);
+		}
+
+		//------------------------------------------------------------------------------
+		/// <summary>Removes a reference of the resource. Unreferenced resource stays cached while it fits in the cache budget.</summary>
+		static void Release(T* resource)
+		{
+			if (!resource->RemoveRef())
+				return;
+
+			Impl::ResourceRegistry<T>& registry = Impl::GetResources<T>();
+			const size_t slot = Impl::ResourceRegistry<T>::GetSlot(resource);
+			typename Impl::ResourceRegistry<T>::Entry& entry = registry.GetEntry(slot);
+			HEAVY_ASSERTE(entry.Resource.get() == resource, "Resource creation failed!");
+			if (registry.CacheBudget == 0)
+			{
+				registry.Remove(slot);
+				return;
+			}
+
+			static_cast<ResourceBase*>(resource)->OnCached();
+			entry.Cached = true;
+			entry.CachedSize = resource->GetMemorySize();
+			entry.CacheIt = registry.Cache.insert(registry.Cache.end(), resource);
+			++registry.Stats.CachedCount;
+			registry.Stats.CachedBytes += entry.CachedSize;
+			TrimCache(registry, registry.CacheBudget);
+		}
+
+		//------------------------------------------------------------------------------
+		/// <summary>Sets how many bytes of unreferenced resources are kept resident, evicting least recently released ones above it.
+		/// Budget of 0 disables caching and frees every cached resource.</summary>
+		static void SetCacheBudget(size_t bytes)
+		{
+			Impl::ResourceRegistry<T>& registry = Impl::GetResources<T>();
+			registry.CacheBudget = bytes;
+			if (bytes == 0)
+				ClearCache();
+			else
+				TrimCache(registry, bytes);
+		}
+
+		static size_t GetCacheBudget() { return Impl::GetResources<T>().CacheBudget; }
 
+		//------------------------------------------------------------------------------
+		/// <summary>Frees all unreferenced resources, e.g. before the device they use is destroyed.</summary>
+		static void ClearCache()
+		{
+			Impl::ResourceRegistry<T>& registry = Impl::GetResources<T>();
+			while (!registry.Cache.empty())
+				EvictLeastRecentlyUsed(registry);
+		}
+
+		static const ResourceCacheStats& GetCacheStats() { return Impl::GetResources<T>().Stats; }
+
+		/// <summary>Zeroes hit, miss and eviction counters, cached count and size are kept.</summary>
+		static void ResetCacheStats()
+		{
+			ResourceCacheStats& stats = Impl::GetResources<T>().Stats;
+			stats.Hits = 0;
+			stats.Misses = 0;
+			stats.Evictions = 0;
+		}
+
+	private:
+		//------------------------------------------------------------------------------
+		// Constructs the resource, may run on a loader thread
+		static std::unique_ptr<T> Create(const String& path, const String& absolutePath)
+		{
 			try
 			{
-				auto new_resource = new T(absolutePath);
-				resource = new_resource;
+				return std::make_unique<T>(absolutePath);
 			} catch (const ResourceLoadFailedException&) {
-				resource = nullptr;
+				gConsole.LogError("Resource loading failed! {}", path);
 			} catch (const std::exception&) {
 				HEAVY_ASSERTE(false, "Resource creation failed for unknown reason!");
-				return nullptr;
 			}
+			return nullptr;
+		}
+
+		//------------------------------------------------------------------------------
+		// Creates device objects of constructed resource and adds references to it, main thread only.
+		// Failures are reported as nullptr, so they never escape the loader update.
+		static T* Register(const String& path, std::unique_ptr<T> created, size_t refCount)
+		{
+			if (!created)
+				return nullptr;
+
+			// resource could have been loaded synchronously while it was decoded
+			Impl::ResourceRegistry<T>& registry = Impl::GetResources<T>();
+			const size_t pathHash = path.GetHash();
+			const size_t slot = registry.Find(path, pathHash);
+			if (slot != Impl::ResourceRegistry<T>::INVALID_SLOT)
+				return Acquire(registry, slot, refCount);
 
-			if (!resource)
+			T* resource = created.get();
+			try
 			{
+				static_cast<ResourceBase*>(resource)->CreateDeviceResources();
+			} catch (const ResourceLoadFailedException&) {
 				gConsole.LogError("Resource loading failed! {}", path);
 				return nullptr;
+			} catch (const std::exception&) {
+				HEAVY_ASSERTE(false, "Resource creation failed for unknown reason!");
+				return nullptr;
 			}
-
-			Impl::GetResources<T>().insert(std::make_pair(path, std::unique_ptr<T>(resource)));
 			resource->Path = path;
-			resource->AddRef();
+			return Acquire(registry, registry.Insert(std::move(created), pathHash), refCount);
+		}
+
+		//------------------------------------------------------------------------------
+		// Adds references to a registered resource, taking it out of the cache.
+		// Resource that is still reviving in background is revived right away, synchronous loads need it complete.
+		static T* Acquire(Impl::ResourceRegistry<T>& registry, size_t slot, size_t refCount)
+		{
+			typename Impl::ResourceRegistry<T>::Entry& entry = registry.GetEntry(slot);
+			T* resource = entry.Resource.get();
+			if (TakeFromCache(registry, slot) || entry.Reviving)
+			{
+				// entry may move when reviving loads resources of the same type
+				entry.Reviving = false;
+				static_cast<ResourceBase*>(resource)->OnRevived();
+			}
+
+			for (size_t i = 0; i < refCount; ++i)
+				resource->AddRef();
 			return resource;
 		}
 
 		//------------------------------------------------------------------------------
-		static void Release(T* resource)
+		// Returns future of a registered resource, cached one is revived by the loader once its dependencies are loaded
+		static ResourceFuture<T> LoadRegisteredAsync(Impl::ResourceRegistry<T>& registry, size_t slot, const String& path)
 		{
-			if (resource->RemoveRef())
+			typename Impl::ResourceRegistry<T>::Entry& entry = registry.GetEntry(slot);
+			T* resource = entry.Resource.get();
+			if (entry.Reviving)
 			{
-				auto it = Impl::GetResources<T>().find(resource->GetPath());
-				HEAVY_ASSERTE(it != Impl::GetResources<T>().end(), "Resource creation failed!");
-				Impl::GetResources<T>().erase(it);
+				// request shares the pending revival, with its own reference
+				resource->AddRef();
+				return ResourceFuture<T>(std::static_pointer_cast<Impl::AsyncResourceLoad<T>>(gResourceLoader.FindPendingLoad(typeid(T), path)));
+			}
+
+			if (!TakeFromCache(registry, slot))
+			{
+				resource->AddRef();
+				return ResourceFuture<T>(std::make_shared<Impl::AsyncResourceLoad<T>>(path, resource, false));
 			}
+
+			// referenced while reviving, so it cannot be evicted in the meantime
+			resource->AddRef();
+			entry.Reviving = true;
+			auto load = std::make_shared<Impl::AsyncResourceLoad<T>>(path, resource, true);
+			if (FinishRevival(resource))
+				load->Done = true;
+			else
+				gResourceLoader.SubmitWaiting(load);
+			return ResourceFuture<T>(load);
+		}
+
+		//------------------------------------------------------------------------------
+		// Reacquires dependencies of a resource revived by LoadAsync(), main thread only.
+		// Returns false while loads started for the dependencies are not finished.
+		static bool FinishRevival(T* resource)
+		{
+			Impl::ResourceRegistry<T>& registry = Impl::GetResources<T>();
+			typename Impl::ResourceRegistry<T>::Entry& entry = registry.GetEntry(Impl::ResourceRegistry<T>::GetSlot(resource));
+			// revived by a synchronous load in the meantime
+			if (!entry.Reviving)
+				return true;
+
+			if (!static_cast<ResourceBase*>(resource)->LoadDependenciesAsync())
+				return false;
+
+			entry.Reviving = false;
+			static_cast<ResourceBase*>(resource)->OnRevived();
+			return true;
+		}
+
+		//------------------------------------------------------------------------------
+		// Removes resource from the cache, returns false when it was not cached
+		static bool TakeFromCache(Impl::ResourceRegistry<T>& registry, size_t slot)
+		{
+			typename Impl::ResourceRegistry<T>::Entry& entry = registry.GetEntry(slot);
+			if (!entry.Cached)
+				return false;
+
+			registry.Cache.erase(entry.CacheIt);
+			entry.Cached = false;
+			++registry.Stats.Hits;
+			--registry.Stats.CachedCount;
+			registry.Stats.CachedBytes -= entry.CachedSize;
+			return true;
+		}
+
+		//------------------------------------------------------------------------------
+		static void TrimCache(Impl::ResourceRegistry<T>& registry, size_t budget)
+		{
+			while (registry.Stats.CachedBytes > budget)
+				EvictLeastRecentlyUsed(registry);
 		}
+
+		//------------------------------------------------------------------------------
+		static void EvictLeastRecentlyUsed(Impl::ResourceRegistry<T>& registry)
+		{
+			const size_t slot = Impl::ResourceRegistry<T>::GetSlot(registry.Cache.front());
+			HEAVY_ASSERTE(registry.GetEntry(slot).Cached, "Cached resource is not registered!");
+			registry.Cache.pop_front();
+			++registry.Stats.Evictions;
+			--registry.Stats.CachedCount;
+			registry.Stats.CachedBytes -= registry.GetEntry(slot).CachedSize;
+			// freeing a resource may release resources of other types, registry is consistent by then
+			registry.Remove(slot);
+		}
+
+		friend class Impl::AsyncResourceLoad<T>;
 	};
+
+	namespace Impl
+	{
+		//------------------------------------------------------------------------------
+		template<typename T>
+		class AsyncResourceLoad : public AsyncResourceLoadBase
+		{
+		public:
+			AsyncResourceLoad(const String& path, const String& absolutePath)
+				: AsyncResourceLoadBase(typeid(T), path), AbsolutePath(absolutePath) {}
+
+			// load of a resource that is already registered, cached one is done once it is revived
+			AsyncResourceLoad(const String& path, T* resource, bool reviving)
+				: AsyncResourceLoadBase(typeid(T), path), Resource(resource), Reviving(reviving)
+			{
+				Done = !reviving;
+			}
+
+			T* GetResource() const { return Resource; }
+
+			// every request sharing the load gets its own reference
+			size_t RequestCount = 1;
+
+		protected:
+			void Decode() override { Created = ResourceManager<T>::Create(GetPath(), AbsolutePath); }
+			bool Finish() override
+			{
+				if (Reviving)
+					return ResourceManager<T>::FinishRevival(Resource);
+
+				// resources referenced by the decoded one are loaded in background as well, before it is registered
+				if (Created && !static_cast<ResourceBase*>(Created.get())->LoadDependenciesAsync())
+					return false;
+
+				Resource = ResourceManager<T>::Register(GetPath(), std::move(Created), RequestCount);
+				return true;
+			}
+
+		private:
+			String AbsolutePath;
+			std::unique_ptr<T> Created;
+			T* Resource = nullptr;
+			bool Reviving = false;
+
+			friend class ResourceManager<T>;
+		};
+	}
 }
@@ -12,8 +12,6 @@ using namespace Poly;
 
 SoundResource::SoundResource(const String& path)
 {
-	alGenBuffers(1, &BufferID);
-
 	// Declarations and loading file to buffer.
 
 	BinaryBuffer* data = LoadBinaryFile(path);
@@ -246,7 +244,7 @@ SoundResource::SoundResource(const String& path)
 		else gConsole.LogDebug("Error: Corrupt header during playback initialization.");
 
 		// TODO: loading chained sounds;
-		alBufferData(BufferID, AL_FORMAT_STEREO16, rawData.GetData(), (ALsizei)rawData.GetSize(), vorbisInfo.rate);
+		SampleRate = vorbisInfo.rate;
 
 		ogg_stream_clear(&streamState);
 		vorbis_comment_clear(&vorbisComment);
@@ -258,9 +256,19 @@ SoundResource::SoundResource(const String& path)
 	ogg_sync_clear(&syncState);
 
 	delete data;
+	PCMData = std::move(rawData);
+}
+
+void SoundResource::CreateDeviceResources()
+{
+	alGenBuffers(1, &BufferID);
+	alBufferData(BufferID, AL_FORMAT_STEREO16, PCMData.GetData(), (ALsizei)PCMData.GetSize(), (ALsizei)SampleRate);
+	BufferSize = PCMData.GetSize();
+	PCMData.Clear();
 }
 
 SoundResource::~SoundResource()
 {
-	alDeleteBuffers(1, &BufferID);
+	if (BufferID != 0)
+		alDeleteBuffers(1, &BufferID);
 }
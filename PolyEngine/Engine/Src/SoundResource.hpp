@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Dynarray.hpp>
+
 #include "ResourceBase.hpp"
 
 namespace Poly 
@@ -21,8 +23,17 @@ namespace Poly
 
 		unsigned int GetBufferID() const { return BufferID; }
 
+		size_t GetMemorySize() const override { return BufferSize; }
+
+	protected:
+		void CreateDeviceResources() override;
+
 	private:
-		unsigned int BufferID;
+		unsigned int BufferID = 0;
+		// decoded 16-bit stereo samples, kept until the buffer is created
+		Dynarray<char> PCMData;
+		size_t BufferSize = 0;
+		long SampleRate = 0;
 	};
 
 } // namespace Poly
@@ -0,0 +1,92 @@
+#include "EnginePCH.hpp"
+
+#include "SpatialSystem.hpp"
+#include "SpatialWorldComponent.hpp"
+
+using namespace Poly;
+
+//------------------------------------------------------------------------------
+void SpatialSystem::SpatialUpdatePhase(World* world)
+{
+	UpdateSpatialTree(world);
+}
+
+//------------------------------------------------------------------------------
+void SpatialSystem::UpdateSpatialTree(World* world)
+{
+	SpatialWorldComponent* spatial = world->GetWorldComponent<SpatialWorldComponent>();
+	ASSERTE(spatial, "SpatialWorldComponent is missing");
+
+	const size_t update = ++spatial->UpdateCounter;
+	size_t visitedCount = 0;
+	for (auto componentsTuple : world->IterateComponents<MeshRenderingComponent, TransformComponent>())
+	{
+		const MeshRenderingComponent* meshCmp = std::get<MeshRenderingComponent*>(componentsTuple);
+		const TransformComponent* transCmp = std::get<TransformComponent*>(componentsTuple);
+		if (!meshCmp->GetMesh())
+			continue;
+
+		UpdateEntityProxy(spatial, transCmp->GetOwnerID(), meshCmp->GetMesh(), transCmp, update);
+		++visitedCount;
+	}
+
+	// entities that were not visited were destroyed or lost one of the components
+	if (visitedCount == spatial->Proxies.size())
+		return;
+
+	for (auto it = spatial->Proxies.begin(); it != spatial->Proxies.end();)
+	{
+		if (it->second.LastUpdate != update)
+		{
+			spatial->Tree.DestroyProxy(it->second.Proxy);
+			it = spatial->Proxies.erase(it);
+		}
+		else
+			++it;
+	}
+}
+
+//------------------------------------------------------------------------------
+void SpatialSystem::UpdateEntityProxy(SpatialWorldComponent* spatial, const UniqueID& entityID, const MeshResource* mesh, const TransformComponent* transCmp, size_t update)
+{
+	// makes sure the revision is up to date when called outside of the frame update
+	transCmp->GetGlobalTransformationMatrix();
+
+	auto it = spatial->Proxies.find(entityID);
+	if (it == spatial->Proxies.end())
+	{
+		const size_t proxy = spatial->Tree.CreateProxy(GetWorldBoundingBox(mesh, transCmp), entityID.GetValue());
+		spatial->Proxies.emplace(entityID, SpatialWorldComponent::EntityProxy{ proxy, mesh, transCmp->GetGlobalRevision(), update });
+		return;
+	}
+
+	// box changes with the transformation or with the mesh, f.ex. when mesh component of the entity was replaced
+	SpatialWorldComponent::EntityProxy& entityProxy = it->second;
+	if (entityProxy.Mesh != mesh || entityProxy.TransformRevision != transCmp->GetGlobalRevision())
+	{
+		spatial->Tree.MoveProxy(entityProxy.Proxy, GetWorldBoundingBox(mesh, transCmp));
+		entityProxy.Mesh = mesh;
+		entityProxy.TransformRevision = transCmp->GetGlobalRevision();
+	}
+	entityProxy.LastUpdate = update;
+}
+
+//------------------------------------------------------------------------------
+AABox SpatialSystem::GetWorldBoundingBox(const MeshResource* mesh, const TransformComponent* transCmp)
+{
+	const Matrix& transform = transCmp->GetGlobalTransformationMatrix();
+	const Dynarray<MeshResource::SubMesh*>& subMeshes = mesh->GetSubMeshes();
+	if (subMeshes.IsEmpty())
+		return AABox(transCmp->GetGlobalTranslation(), Vector::ZERO);
+
+	Vector3f min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+	Vector3f max(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
+	for (const MeshResource::SubMesh* subMesh : subMeshes)
+	{
+		const AABox box = subMesh->GetBoundingBox().GetTransformed(transform);
+		const Vector boxMin = box.GetMin(), boxMax = box.GetMax();
+		min.X = std::min(min.X, boxMin.X); min.Y = std::min(min.Y, boxMin.Y); min.Z = std::min(min.Z, boxMin.Z);
+		max.X = std::max(max.X, boxMax.X); max.Y = std::max(max.Y, boxMax.Y); max.Z = std::max(max.Z, boxMax.Z);
+	}
+	return AABox(Vector(min.X, min.Y, min.Z), Vector(max.X - min.X, max.Y - min.Y, max.Z - min.Z));
+}
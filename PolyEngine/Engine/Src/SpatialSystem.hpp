@@ -0,0 +1,29 @@
+#pragma once
+
+namespace Poly
+{
+	class World;
+	class AABox;
+	class UniqueID;
+	class MeshResource;
+	class TransformComponent;
+	class SpatialWorldComponent;
+
+	namespace SpatialSystem
+	{
+		void SpatialUpdatePhase(World* world);
+
+		/// <summary>Synchronizes the tree of SpatialWorldComponent with entities that have MeshRenderingComponent and TransformComponent.
+		/// Proxies are created for new entities and destroyed for removed ones.
+		/// Boxes are recomputed only for entities whose mesh or global transformation changed (see TransformComponent::GetGlobalRevision()).</summary>
+		/// <param name="world">World with SpatialWorldComponent.</param>
+		void ENGINE_DLLEXPORT UpdateSpatialTree(World* world);
+
+		/// <summary>Creates proxy of the entity or refits its box when the mesh or the global transformation changed.</summary>
+		/// <param name="update">Number of the tree update, proxies not updated with the current number are destroyed by UpdateSpatialTree().</param>
+		void ENGINE_DLLEXPORT UpdateEntityProxy(SpatialWorldComponent* spatial, const UniqueID& entityID, const MeshResource* mesh, const TransformComponent* transCmp, size_t update);
+
+		/// <summary>Calculates world space box containing all submeshes of the mesh.</summary>
+		AABox ENGINE_DLLEXPORT GetWorldBoundingBox(const MeshResource* mesh, const TransformComponent* transCmp);
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <unordered_map>
+#include <AABoxTree.hpp>
+#include <Frustum.hpp>
+
+#include "ComponentBase.hpp"
+#include "SpatialSystem.hpp"
+
+namespace Poly
+{
+	/// <summary>Bounding volume hierarchy of all rendered entities in the world, kept up to date by SpatialSystem.
+	/// Use it for spatial queries instead of iterating over all components.</summary>
+	class ENGINE_DLLEXPORT SpatialWorldComponent : public ComponentBase
+	{
+		friend void SpatialSystem::UpdateSpatialTree(World* world);
+		friend void SpatialSystem::UpdateEntityProxy(SpatialWorldComponent* spatial, const UniqueID& entityID, const MeshResource* mesh, const TransformComponent* transCmp, size_t update);
+	public:
+		/// <param name="margin">Distance by which boxes in the tree are enlarged, entities moving less do not modify the tree.</param>
+		explicit SpatialWorldComponent(float margin = 0.1f) : Tree(margin) {}
+
+		const AABoxTree& GetTree() const { return Tree; }
+
+		/// <summary>Finds entities whose boxes overlap the box.</summary>
+		void QueryBox(const AABox& box, Dynarray<UniqueID>& entities) const
+		{
+			entities.Clear();
+			Tree.QueryBox(box, [&entities](size_t userData) { entities.PushBack(UniqueID::FromValue(userData)); });
+		}
+
+		/// <summary>Finds entities whose boxes overlap the sphere.</summary>
+		void QuerySphere(const Vector& center, float radius, Dynarray<UniqueID>& entities) const
+		{
+			entities.Clear();
+			Tree.QuerySphere(center, radius, [&entities](size_t userData) { entities.PushBack(UniqueID::FromValue(userData)); });
+		}
+
+		/// <summary>Finds entities whose boxes are at least partially inside the frustum.</summary>
+		void QueryFrustum(const Frustum& frustum, Dynarray<UniqueID>& entities) const
+		{
+			entities.Clear();
+			Tree.QueryFrustum(frustum, [&entities](size_t userData) { entities.PushBack(UniqueID::FromValue(userData)); });
+		}
+
+		/// <summary>Finds entities whose boxes are hit by the ray segment, in no particular order.</summary>
+		/// <see cref="AABoxTree.QueryRay()"/>
+		void QueryRay(const Vector& origin, const Vector& direction, float maxDistance, Dynarray<UniqueID>& entities) const
+		{
+			entities.Clear();
+			Tree.QueryRay(origin, direction, maxDistance, [&entities](size_t userData) { entities.PushBack(UniqueID::FromValue(userData)); });
+		}
+
+	private:
+		struct EntityProxy
+		{
+			size_t Proxy;
+			const MeshResource* Mesh;
+			size_t TransformRevision;
+			size_t LastUpdate;
+		};
+
+		AABoxTree Tree;
+		std::unordered_map<UniqueID, EntityProxy> Proxies;
+		size_t UpdateCounter = 0;
+	};
+
+	REGISTER_COMPONENT(WorldComponentsIDGroup, SpatialWorldComponent)
+}
@@ -2,6 +2,7 @@
 
 #include "TextureResource.hpp"
 #include "ResourceManager.hpp"
+#include "CookedTexture.hpp"
 #include "SOIL/SOIL.h"
 
 using namespace Poly;
@@ -11,6 +12,24 @@ TextureResource::TextureResource(const String& path)
 {
 	Channels = 4;
 
+	try
+	{
+		CookedFile = std::make_unique<MemoryMappedFile>(path);
+	}
+	catch (const FileIOException&)
+	{
+		gConsole.LogError("Error opening texture file: {}", path);
+		throw ResourceLoadFailedException();
+	}
+
+	if (CookedTexture::IsCookedTexture(CookedFile->GetData(), CookedFile->GetSize()))
+	{
+		LoadCooked(path);
+		return;
+	}
+	// images are decoded into memory, mapping is not needed
+	CookedFile.reset();
+
 	int FileChannels;
 	Image = SOIL_load_image(path.GetCStr(), &Width, &Height, &FileChannels, SOIL_LOAD_RGBA);
 	if (Image == nullptr)
@@ -19,21 +38,65 @@ TextureResource::TextureResource(const String& path)
 	}
 
 	// Flip Y axis
-	int rowSize = Width*Channels;
-	static Dynarray<unsigned char> row;
-	row.Resize(rowSize);
+	const size_t rowSize = Width*Channels;
 	for (int i = 0; i < Height/2; ++i) {
-		memcpy(row.GetData(), Image + ((Height - i - 1) * Width*Channels), sizeof(unsigned char) * rowSize);
-		memcpy(Image + ((Height - i - 1) * Width*Channels), Image + (i * Width*Channels), sizeof(unsigned char) * rowSize);
-		memcpy(Image + (i * Width*Channels), row.GetData(), sizeof(unsigned char) * rowSize);
+		unsigned char* row = Image + (i * rowSize);
+		std::swap_ranges(row, row + rowSize, Image + ((Height - i - 1) * rowSize));
+	}
+}
+
+//------------------------------------------------------------------------------
+void TextureResource::LoadCooked(const String& path)
+{
+	const u8* data = CookedFile->GetData();
+	if (!CookedTexture::Validate(data, CookedFile->GetSize()))
+	{
+		gConsole.LogError("Error loading cooked texture: {}", path);
+		throw ResourceLoadFailedException();
 	}
 
+	const CookedTexture::FileHeader& header = *reinterpret_cast<const CookedTexture::FileHeader*>(data);
+	const CookedTexture::MipHeader* mipHeaders = reinterpret_cast<const CookedTexture::MipHeader*>(data + sizeof(CookedTexture::FileHeader));
+	Width = static_cast<int>(header.Width);
+	Height = static_cast<int>(header.Height);
+	Format = static_cast<eTextureDataFormat>(header.Format);
+	Mips.Resize(header.MipCount);
+	for (u32 i = 0; i < header.MipCount; ++i)
+	{
+		Mips[i].Width = mipHeaders[i].Width;
+		Mips[i].Height = mipHeaders[i].Height;
+		Mips[i].Size = static_cast<size_t>(mipHeaders[i].DataSize);
+		Mips[i].Data = data + mipHeaders[i].DataOffset;
+	}
+}
+
+//------------------------------------------------------------------------------
+void TextureResource::CreateDeviceResources()
+{
 	TextureProxy = gEngine->GetRenderingDevice()->CreateTexture(Width, Height, eTextureUsageType::DIFFUSE); //HACK, remove deffise from here
-	TextureProxy->SetContent(eTextureDataFormat::RGBA, Image);
+	if (CookedFile)
+		TextureProxy->SetMipContent(Format, Mips);
+	else
+		TextureProxy->SetContent(eTextureDataFormat::RGBA, Image);
+}
+
+//------------------------------------------------------------------------------
+size_t TextureResource::GetMemorySize() const
+{
+	if (CookedFile)
+	{
+		// mapped file pages can be dropped by the system, only the device copy is counted
+		size_t size = 0;
+		for (const TextureMip& mip : Mips)
+			size += mip.Size;
+		return size;
+	}
+	return 2 * static_cast<size_t>(Width) * static_cast<size_t>(Height) * 4;
 }
 
 //-----------------------------------------------------------------------------
 TextureResource::~TextureResource()
 {
-	SOIL_free_image_data(Image);
+	if (Image)
+		SOIL_free_image_data(Image);
 }
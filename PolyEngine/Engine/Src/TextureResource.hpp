@@ -1,28 +1,49 @@
 #pragma once
 
+#include <MemoryMappedFile.hpp>
+
 #include "ResourceBase.hpp"
+#include "IRenderingDevice.hpp"
 
 typedef unsigned int GLuint;
 
 namespace Poly 
 {
-	class ITextureDeviceProxy;
-
 	class ENGINE_DLLEXPORT TextureResource : public ResourceBase
 	{
 	public:
+		/// <summary>Loads texture from a cooked texture file, or decodes it from any other image format supported by SOIL.</summary>
 		TextureResource(const String& path);
 		~TextureResource() override;
 
+		/// <summary>Returns decoded RGBA image flipped for the rendering device, nullptr for cooked textures.</summary>
 		unsigned char* GetImage() const { return Image; }
 		int GetWidth() const { return Width; }
 		int GetHeight() const { return Height; }
 		int GetChannels() const { return Channels; }
 
+		/// <summary>Returns format of the mip chain of cooked texture, RGBA for decoded images.</summary>
+		eTextureDataFormat GetFormat() const { return Format; }
+		/// <summary>Returns all mip levels of cooked texture, empty for decoded images.</summary>
+		const Dynarray<TextureMip>& GetMips() const { return Mips; }
+
 		const ITextureDeviceProxy* GetTextureProxy() const { return TextureProxy.get(); }
+
+		/// <summary>Returns size of the mip chain of cooked texture, or of decoded image together with its device copy.</summary>
+		size_t GetMemorySize() const override;
+
+	protected:
+		void CreateDeviceResources() override;
+
 	private:
+		void LoadCooked(const String& path);
+
 		std::unique_ptr<ITextureDeviceProxy> TextureProxy;
-		unsigned char* Image;
+		// mip levels of cooked textures reference the mapped file
+		std::unique_ptr<MemoryMappedFile> CookedFile;
+		eTextureDataFormat Format = eTextureDataFormat::RGBA;
+		Dynarray<TextureMip> Mips;
+		unsigned char* Image = nullptr;
 		int Width;
 		int Height;
 		int Channels;
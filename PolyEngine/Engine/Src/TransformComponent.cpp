@@ -2,8 +2,18 @@
 
 using namespace Poly;
 
+std::atomic<size_t> TransformComponent::HierarchyRevision{ 0 };
+
+namespace
+{
+	bool IsUniformScale(const Vector& scale) { return Cmpf(scale.X, scale.Y) && Cmpf(scale.Y, scale.Z); }
+	bool IsIdentityRotation(const Quaternion& rotation) { return Cmpf(rotation.X, 0) && Cmpf(rotation.Y, 0) && Cmpf(rotation.Z, 0); }
+	Vector MulComponents(const Vector& a, const Vector& b) { return Vector(a.X * b.X, a.Y * b.Y, a.Z * b.Z); }
+}
+
 //-----------------------------------------------------------------------------
 TransformComponent::~TransformComponent() {
+	++HierarchyRevision;
 	if (Parent != nullptr)
 	{
 		Parent->Children.Remove(this);
@@ -16,6 +26,7 @@ void TransformComponent::SetParent(TransformComponent* parent)
 	if (parent != nullptr)
 	{
 		parent->UpdateGlobalTransformationCache();
+		parent->UpdateGlobalTRSCache();
 		LocalTranslation = LocalTranslation - parent->GlobalTranslation;
 		LocalRotation = LocalRotation * parent->GlobalRotation.GetConjugated();
 		Vector parentGlobalScale = parent->GlobalScale;
@@ -26,6 +37,8 @@ void TransformComponent::SetParent(TransformComponent* parent)
 
 		Parent = parent;
 		Parent->Children.PushBack(this);
+		++HierarchyRevision;
+		SetGlobalDirty();
 	}
 	else
 	{
@@ -40,6 +53,7 @@ void TransformComponent::ResetParent()
 	Matrix globalTransform = GetGlobalTransformationMatrix();
 	Parent->Children.Remove(this);
 	Parent = nullptr;
+	++HierarchyRevision;
 	SetLocalTransformationMatrix(globalTransform);
 }
 
@@ -47,6 +61,7 @@ void TransformComponent::ResetParent()
 const Vector& TransformComponent::GetGlobalTranslation() const
 {
 	UpdateGlobalTransformationCache();
+	UpdateGlobalTRSCache();
 	return GlobalTranslation;
 }
 
@@ -55,6 +70,7 @@ void TransformComponent::SetLocalTranslation(const Vector& position)
 {
 	LocalTranslation = position;
 	LocalDirty = true;
+	LocalTRSExact = true;
 	SetGlobalDirty();
 }
 
@@ -62,6 +78,7 @@ void TransformComponent::SetLocalTranslation(const Vector& position)
 const Quaternion& TransformComponent::GetGlobalRotation() const
 {
 	UpdateGlobalTransformationCache();
+	UpdateGlobalTRSCache();
 	return GlobalRotation;
 }
 
@@ -70,6 +87,7 @@ void TransformComponent::SetLocalRotation(const Quaternion& quaternion)
 {
 	LocalRotation = quaternion;
 	LocalDirty = true;
+	LocalTRSExact = true;
 	SetGlobalDirty();
 }
 
@@ -77,6 +95,7 @@ void TransformComponent::SetLocalRotation(const Quaternion& quaternion)
 const Vector& TransformComponent::GetGlobalScale() const
 {
 	UpdateGlobalTransformationCache();
+	UpdateGlobalTRSCache();
 	return GlobalScale;
 }
 
@@ -85,6 +104,7 @@ void TransformComponent::SetLocalScale(const Vector& scale)
 {
 	LocalScale = scale;
 	LocalDirty = true;
+	LocalTRSExact = true;
 	SetGlobalDirty();
 }
 
@@ -106,7 +126,10 @@ const Matrix& TransformComponent::GetGlobalTransformationMatrix() const
 void TransformComponent::SetLocalTransformationMatrix(const Matrix& localTransformation)
 {
 	LocalTransform = localTransformation;
-	localTransformation.Decompose(LocalTranslation, LocalRotation, LocalScale);
+	MatrixSkew skew;
+	Vector perspectivePoint;
+	localTransformation.Decompose(LocalTranslation, LocalRotation, LocalScale, skew, perspectivePoint);
+	LocalTRSExact = Cmpf(skew.XY, 0) && Cmpf(skew.XZ, 0) && Cmpf(skew.YZ, 0) && perspectivePoint == Vector::ZERO;
 	LocalDirty = false;
 	SetGlobalDirty();
 }
@@ -132,21 +155,65 @@ bool TransformComponent::UpdateLocalTransformationCache() const
 void TransformComponent::UpdateGlobalTransformationCache() const
 {
 	if (!GlobalDirty) return;
-	if (Parent == nullptr)
+	if (Parent)
+		Parent->UpdateGlobalTransformationCache();
+	RecomputeGlobalTransformationCache(Parent);
+}
+
+//------------------------------------------------------------------------------
+void TransformComponent::UpdateGlobalTRSCache() const
+{
+	if (!GlobalTRSDirty) return;
+	// only skewed hierarchies get here, so the overload that tolerates skew is used
+	MatrixSkew skew;
+	Vector perspectivePoint;
+	GlobalTransform.Decompose(GlobalTranslation, GlobalRotation, GlobalScale, skew, perspectivePoint);
+	GlobalTRSDirty = false;
+}
+
+//------------------------------------------------------------------------------
+void TransformComponent::RecomputeGlobalTransformationCache(const TransformComponent* parent) const
+{
+	++GlobalRevision;
+	const Matrix& localTransform = GetLocalTransformationMatrix();
+	if (parent == nullptr)
 	{
-		GlobalTransform = GetLocalTransformationMatrix();
+		GlobalTransform = localTransform;
+		GlobalTranslation = LocalTranslation;
+		GlobalRotation = LocalRotation;
+		GlobalScale = LocalScale;
+		GlobalTRSDirty = false;
+		GlobalTRSExact = LocalTRSExact;
 	}
 	else
 	{
-		GlobalTransform = Parent->GetGlobalTransformationMatrix() * GetLocalTransformationMatrix();
+		GlobalTransform = parent->GlobalTransform * localTransform;
+
+		// parent TRS * local TRS is a TRS again unless non-uniform parent scale is applied to a rotated child (that results in skew)
+		if (LocalTRSExact && parent->GlobalTRSExact && (IsUniformScale(parent->GlobalScale) || IsIdentityRotation(LocalRotation)))
+		{
+			GlobalTranslation = parent->GlobalTranslation + parent->GlobalRotation * MulComponents(parent->GlobalScale, LocalTranslation);
+			GlobalTranslation.W = 1.f;
+			GlobalRotation = parent->GlobalRotation * LocalRotation;
+			GlobalScale = MulComponents(parent->GlobalScale, LocalScale);
+			GlobalTRSDirty = false;
+			GlobalTRSExact = true;
+		}
+		else
+		{
+			GlobalTRSDirty = true;
+			GlobalTRSExact = false;
+		}
 	}
-	GlobalTransform.Decompose(GlobalTranslation, GlobalRotation, GlobalScale);
 	GlobalDirty = false;
 }
 
 //------------------------------------------------------------------------------
 void TransformComponent::SetGlobalDirty() const
 {
+	// descendants of a dirty transform are always dirty too
+	if (GlobalDirty)
+		return;
 	GlobalDirty = true;
 	for (TransformComponent* c : Children)
 	{
@@ -1,13 +1,17 @@
 #pragma once
 
+#include <atomic>
+
 #include "ComponentBase.hpp"
+#include "TransformSystem.hpp"
 
 namespace Poly 
 {
 	class ENGINE_DLLEXPORT TransformComponent : public ComponentBase
 	{
+		friend void TransformSystem::UpdateGlobalTransforms(World* world, ThreadPool* pool);
 	public:
-		TransformComponent(TransformComponent* parent = nullptr) { if(parent) SetParent(parent); };
+		TransformComponent(TransformComponent* parent = nullptr) { ++HierarchyRevision; if(parent) SetParent(parent); };
 		~TransformComponent();
 
 		const TransformComponent* GetParent() const { return Parent; }
@@ -32,7 +36,19 @@ namespace Poly
 		void SetLocalTransformationMatrix(const Matrix& localTransformation);
 		
 		const Dynarray<TransformComponent*>& GetChildren() const { return Children; }
+
+		/// <summary>Returns counter incremented every time global transformation of this component is recomputed.
+		/// Systems caching data derived from the global transformation can compare it with the stored one.</summary>
+		size_t GetGlobalRevision() const { return GlobalRevision; }
+
+		/// <summary>Returns counter incremented every time a transform is created, destroyed or reparented.
+		/// Counter is shared by all worlds, a change in one of them makes the others rebuild their hierarchy as well.</summary>
+		static size_t GetHierarchyRevision() { return HierarchyRevision; }
 	private:
+		// Written by constructor, destructor, SetParent() and ResetParent(), which may run concurrently in parallel update phases.
+		// Components do not know their world when they are constructed, so the counter cannot be kept per world.
+		static std::atomic<size_t> HierarchyRevision;
+
 		TransformComponent* Parent = nullptr;
 		Dynarray<TransformComponent*> Children;
 
@@ -47,9 +63,17 @@ namespace Poly
 		mutable Matrix GlobalTransform;
 		mutable bool LocalDirty = false;
 		mutable bool GlobalDirty = false;
+		// global matrix is up to date, but global TRS has to be decomposed from it
+		mutable bool GlobalTRSDirty = false;
+		// TRS describes the matrix exactly (no skew), so children can compose their global TRS from it
+		bool LocalTRSExact = true;
+		mutable bool GlobalTRSExact = true;
+		mutable size_t GlobalRevision = 0;
 
 		bool UpdateLocalTransformationCache() const;
 		void UpdateGlobalTransformationCache() const;
+		void UpdateGlobalTRSCache() const;
+		void RecomputeGlobalTransformationCache(const TransformComponent* parent) const;
 		void SetGlobalDirty() const;
 	};
 
@@ -0,0 +1,102 @@
+#include "EnginePCH.hpp"
+
+#include "TransformSystem.hpp"
+#include "TransformWorldComponent.hpp"
+
+using namespace Poly;
+
+namespace
+{
+	// Minimal amount of nodes processed by a single job. Jobs always consist of whole root subtrees.
+	constexpr size_t MIN_NODES_PER_JOB = 1024;
+}
+
+//------------------------------------------------------------------------------
+void TransformSystem::TransformUpdatePhase(World* world)
+{
+	UpdateGlobalTransforms(world, gEngine ? gEngine->GetThreadPool() : nullptr);
+}
+
+//------------------------------------------------------------------------------
+void TransformSystem::UpdateGlobalTransforms(World* world, ThreadPool* pool)
+{
+	TransformWorldComponent* hierarchy = world->GetWorldComponent<TransformWorldComponent>();
+	ASSERTE(hierarchy, "TransformWorldComponent is missing");
+
+	// rebuild flat hierarchy, parents always precede their children
+	// revision is read before the rebuild, so changes made during it are picked up by the next update
+	const size_t hierarchyRevision = TransformComponent::GetHierarchyRevision();
+	if (!hierarchy->Built || hierarchy->HierarchyRevision != hierarchyRevision)
+	{
+		hierarchy->Nodes.Clear();
+		hierarchy->ParentIndices.Clear();
+		hierarchy->JobStarts.Clear();
+
+		Dynarray<size_t> stack;
+		size_t jobSize = MIN_NODES_PER_JOB;
+		for (auto tuple : world->IterateComponents<TransformComponent>())
+		{
+			const TransformComponent* root = std::get<TransformComponent*>(tuple);
+			if (root->Parent)
+				continue;
+
+			if (jobSize >= MIN_NODES_PER_JOB)
+			{
+				hierarchy->JobStarts.PushBack(hierarchy->Nodes.GetSize());
+				jobSize = 0;
+			}
+
+			const size_t rootIdx = hierarchy->Nodes.GetSize();
+			hierarchy->Nodes.PushBack(root);
+			hierarchy->ParentIndices.PushBack(size_t(TransformWorldComponent::INVALID_PARENT));
+			stack.PushBack(rootIdx);
+			while (!stack.IsEmpty())
+			{
+				const size_t parentIdx = stack[stack.GetSize() - 1];
+				stack.PopBack();
+				for (const TransformComponent* child : hierarchy->Nodes[parentIdx]->Children)
+				{
+					stack.PushBack(hierarchy->Nodes.GetSize());
+					hierarchy->Nodes.PushBack(child);
+					hierarchy->ParentIndices.PushBack(parentIdx);
+				}
+			}
+			jobSize += hierarchy->Nodes.GetSize() - rootIdx;
+		}
+
+		hierarchy->HierarchyRevision = hierarchyRevision;
+		hierarchy->Built = true;
+	}
+
+	const Dynarray<const TransformComponent*>& nodes = hierarchy->Nodes;
+	const Dynarray<size_t>& parentIndices = hierarchy->ParentIndices;
+	auto updateRange = [&nodes, &parentIndices](size_t begin, size_t end)
+	{
+		constexpr size_t noParent = TransformWorldComponent::INVALID_PARENT;
+		for (size_t i = begin; i < end; ++i)
+		{
+			const TransformComponent* node = nodes[i];
+			if (!node->GlobalDirty)
+				continue;
+			const size_t parentIdx = parentIndices[i];
+			HEAVY_ASSERTE(parentIdx == noParent || parentIdx < i, "Parent has to precede its children");
+			node->RecomputeGlobalTransformationCache(parentIdx == noParent ? nullptr : nodes[parentIdx]);
+		}
+	};
+
+	const Dynarray<size_t>& jobStarts = hierarchy->JobStarts;
+	if (!pool || jobStarts.GetSize() < 2)
+	{
+		updateRange(0, nodes.GetSize());
+		return;
+	}
+
+	JobCounter counter;
+	for (size_t job = 0; job < jobStarts.GetSize(); ++job)
+	{
+		const size_t begin = jobStarts[job];
+		const size_t end = job + 1 < jobStarts.GetSize() ? jobStarts[job + 1] : nodes.GetSize();
+		pool->Submit([&updateRange, begin, end]() { updateRange(begin, end); }, &counter);
+	}
+	pool->Wait(counter);
+}
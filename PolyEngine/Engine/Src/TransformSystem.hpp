@@ -0,0 +1,19 @@
+#pragma once
+
+namespace Poly
+{
+	class World;
+	class ThreadPool;
+
+	namespace TransformSystem
+	{
+		void TransformUpdatePhase(World* world);
+
+		/// <summary>Recomputes global transformations of all dirty TransformComponents in a single pass over the hierarchy.
+		/// Hierarchy is kept in TransformWorldComponent as flat arrays, where every parent precedes its children
+		/// and every root subtree occupies a contiguous range, so root subtrees can be processed concurrently.</summary>
+		/// <param name="world">World with TransformWorldComponent.</param>
+		/// <param name="pool">Pool used to process subtrees concurrently or nullptr to process them on the calling thread.</param>
+		void ENGINE_DLLEXPORT UpdateGlobalTransforms(World* world, ThreadPool* pool);
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "ComponentBase.hpp"
+#include "TransformSystem.hpp"
+
+namespace Poly
+{
+	class TransformComponent;
+
+	/// <summary>Flat, depth-first ordered copy of the transform hierarchy used by TransformSystem.
+	/// Rebuilt only when the hierarchy changes (see TransformComponent::GetHierarchyRevision()).</summary>
+	class ENGINE_DLLEXPORT TransformWorldComponent : public ComponentBase
+	{
+		friend void TransformSystem::UpdateGlobalTransforms(World* world, ThreadPool* pool);
+	public:
+		TransformWorldComponent() = default;
+
+		size_t GetNodeCount() const { return Nodes.GetSize(); }
+
+	private:
+		static constexpr size_t INVALID_PARENT = static_cast<size_t>(-1);
+
+		// SoA, indexed by position in depth-first order
+		Dynarray<const TransformComponent*> Nodes;
+		Dynarray<size_t> ParentIndices;
+
+		// first node of every job, jobs consist of whole root subtrees
+		Dynarray<size_t> JobStarts;
+
+		size_t HierarchyRevision = 0;
+		bool Built = false;
+	};
+
+	REGISTER_COMPONENT(WorldComponentsIDGroup, TransformWorldComponent)
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <map>
+#include <Core.hpp>
+
+namespace Poly {
+	/// <summary>Uniform location resolved with UniformRegistry::GetUniform(), typed with the value type it accepts.
+	/// Default constructed handle (and handle of uniform optimized out) is invalid and setting it does nothing.</summary>
+	template<typename T>
+	struct UniformHandle
+	{
+		int Location = -1;
+
+		bool IsValid() const { return Location != -1; }
+	};
+
+	/// <summary>Uniforms of a shader program found in its source, with their GLSL types and locations.
+	/// Device independent part of the shader program, shared by name lookups and typed handles.</summary>
+	class UniformRegistry : public BaseObject<>
+	{
+	public:
+		struct UniformInfo
+		{
+			UniformInfo() {}
+			UniformInfo(const String& type, int location) : TypeName(type), Location(location) {}
+
+			String TypeName;
+			int Location = 0;
+		};
+
+		/// <summary>Registers uniform, first registration of the name wins.</summary>
+		/// <returns>False when the name was already registered.</returns>
+		bool Register(const String& type, const String& name, int location)
+		{
+			return Uniforms.insert(std::make_pair(name, UniformInfo(type, location))).second;
+		}
+
+		bool Contains(const String& name) const { return Uniforms.find(name) != Uniforms.end(); }
+
+		/// <summary>Returns registered uniform or nullptr.</summary>
+		const UniformInfo* Find(const String& name) const
+		{
+			auto it = Uniforms.find(name);
+			return it != Uniforms.end() ? &it->second : nullptr;
+		}
+
+		/// <summary>Resolves registered uniform, so it can be set without name lookup.</summary>
+		/// <param name="name">Name of the uniform.</param>
+		/// <returns>Handle of the uniform, invalid when the uniform is not registered.</returns>
+		template<typename T>
+		UniformHandle<T> GetUniform(const String& name) const
+		{
+			UniformHandle<T> handle;
+			if (const UniformInfo* info = Find(name))
+			{
+				HEAVY_ASSERTE(IsTypeCompatible<T>(info->TypeName), "Invalid uniform type!");
+				handle.Location = info->Location;
+			}
+			return handle;
+		}
+
+		/// <summary>Checks whether values of type T can be set to uniform of given GLSL type.</summary>
+		template<typename T> static bool IsTypeCompatible(const String& typeName);
+
+		const std::map<String, UniformInfo>& GetUniformsInfo() const { return Uniforms; }
+
+	private:
+		std::map<String, UniformInfo> Uniforms;
+	};
+
+	template<> inline bool UniformRegistry::IsTypeCompatible<int>(const String& typeName) { return typeName == "int" || typeName == "sampler2D" || typeName == "samplerBuffer" || typeName == "usamplerBuffer"; }
+	template<> inline bool UniformRegistry::IsTypeCompatible<float>(const String& typeName) { return typeName == "float"; }
+	template<> inline bool UniformRegistry::IsTypeCompatible<Vector>(const String& typeName) { return typeName == "vec4"; }
+	template<> inline bool UniformRegistry::IsTypeCompatible<Color>(const String& typeName) { return typeName == "vec4"; }
+	template<> inline bool UniformRegistry::IsTypeCompatible<Matrix>(const String& typeName) { return typeName == "mat4"; }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <Core.hpp>
+
+#include "ComponentIDGenerator.hpp"
+
+namespace Poly
+{
+	/// <summary>Declaration of data accessed by an update phase.
+	/// Engine uses it to find phases that can run at the same time on the worker pool.
+	/// Two phases conflict when one of them writes a component (or world component) type the other one reads or writes.
+	/// Default constructed declaration accesses nothing, use builder methods to describe the phase.</summary>
+	/// <example><code>UpdatePhaseAccess().Reads<SoundEmitterComponent>().WritesWorld<SoundWorldComponent>()</code></example>
+	class UpdatePhaseAccess : public BaseObject<>
+	{
+	public:
+		/// <summary>Returns declaration of a phase that may touch anything (spawn entities, add components, etc.).
+		/// Such phase never runs concurrently with other phases. This is the default for phases registered without declaration.</summary>
+		static UpdatePhaseAccess Exclusive() { UpdatePhaseAccess access; access.IsExclusive = true; return access; }
+
+		/// <summary>Declares read access to given component types.</summary>
+		template<typename... Ts> UpdatePhaseAccess& Reads() { ComponentReads |= Mask<ComponentsIDGroup, Ts...>(); return *this; }
+
+		/// <summary>Declares write access to given component types.</summary>
+		template<typename... Ts> UpdatePhaseAccess& Writes() { ComponentWrites |= Mask<ComponentsIDGroup, Ts...>(); return *this; }
+
+		/// <summary>Declares read access to given world component types.</summary>
+		template<typename... Ts> UpdatePhaseAccess& ReadsWorld() { WorldComponentReads |= Mask<WorldComponentsIDGroup, Ts...>(); return *this; }
+
+		/// <summary>Declares write access to given world component types.</summary>
+		template<typename... Ts> UpdatePhaseAccess& WritesWorld() { WorldComponentWrites |= Mask<WorldComponentsIDGroup, Ts...>(); return *this; }
+
+		/// <summary>Declares read access to all component and world component types.</summary>
+		UpdatePhaseAccess& ReadsAll() { ComponentReads = ~u64(0); WorldComponentReads = ~u64(0); return *this; }
+
+		/// <summary>Forces phase to be executed on the thread that calls Engine::Update (f.ex. phases that issue rendering API calls).</summary>
+		UpdatePhaseAccess& RunsOnMainThread() { MainThreadOnly = true; return *this; }
+
+		bool IsExclusiveAccess() const { return IsExclusive; }
+		bool IsMainThreadOnly() const { return MainThreadOnly; }
+
+		/// <summary>Checks whether two phases cannot be executed concurrently.</summary>
+		bool ConflictsWith(const UpdatePhaseAccess& other) const
+		{
+			if (IsExclusive || other.IsExclusive)
+				return true;
+			return (ComponentWrites & (other.ComponentReads | other.ComponentWrites)) != 0
+				|| (other.ComponentWrites & ComponentReads) != 0
+				|| (WorldComponentWrites & (other.WorldComponentReads | other.WorldComponentWrites)) != 0
+				|| (other.WorldComponentWrites & WorldComponentReads) != 0;
+		}
+
+	private:
+		// group is a template parameter, so the generator is not instantiated before its explicit instantiation in ComponentIDGeneratorImpl.hpp
+		template<typename Group, typename... Ts> static u64 Mask()
+		{
+			u64 mask = 0;
+			for (size_t id : { Group::template GetComponentTypeID<Ts>()... })
+				mask |= Bit(id);
+			return mask;
+		}
+
+		static u64 Bit(size_t id)
+		{
+			HEAVY_ASSERTE(id < 64, "Component ID does not fit into access mask");
+			return u64(1) << id;
+		}
+
+		u64 ComponentReads = 0;
+		u64 ComponentWrites = 0;
+		u64 WorldComponentReads = 0;
+		u64 WorldComponentWrites = 0;
+		bool IsExclusive = false;
+		bool MainThreadOnly = false;
+	};
+}
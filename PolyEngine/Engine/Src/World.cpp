@@ -1,5 +1,7 @@
 #include "EnginePCH.hpp"
 
+#include "EntityPrototype.hpp"
+
 using namespace Poly;
 
 //------------------------------------------------------------------------------
@@ -13,12 +15,11 @@ World::World()
 //------------------------------------------------------------------------------
 World::~World()
 {
-	// copy entities
-	auto entityMap = IDToEntityMap;
-	for (auto& kv : entityMap)
+	// destroying an entity destroys its children too, so slots have to be checked again every time
+	for (const EntitySlot& slot : EntitySlots)
 	{
-		if(IDToEntityMap.find(kv.second->EntityID) != IDToEntityMap.end())
-			DestroyEntity(kv.second->EntityID);
+		if (slot.Ent)
+			DestroyEntity(slot.Ent->EntityID);
 	}
 	
 	for (size_t i = 0; i < MAX_COMPONENTS_COUNT; ++i)
@@ -35,31 +36,103 @@ World::~World()
 //------------------------------------------------------------------------------
 UniqueID World::SpawnEntity()
 {
+	return CreateEntity()->EntityID;
+}
+
+//------------------------------------------------------------------------------
+Entity* World::CreateEntity()
+{
+	size_t index;
+	if (!FreeEntitySlots.IsEmpty())
+	{
+		index = FreeEntitySlots[FreeEntitySlots.GetSize() - 1];
+		FreeEntitySlots.PopBack();
+	}
+	else
+	{
+		index = EntitySlots.GetSize();
+		EntitySlots.PushBack(EntitySlot());
+	}
+
+	EntitySlot& slot = EntitySlots[index];
 	Entity* ent = EntitiesAllocator.Alloc();
-	::new(ent) Entity(this);
-	IDToEntityMap[ent->EntityID] = ent;
-	return ent->EntityID;
+	::new(ent) Entity(this, EntityHandle{ index, slot.Generation }.ToID());
+	slot.Ent = ent;
+	return ent;
+}
+
+//------------------------------------------------------------------------------
+void World::SpawnEntitiesBatch(size_t count, const EntityPrototype& prototype, Dynarray<UniqueID>& entityIds, Dynarray<ComponentBase*>& createdComponents)
+{
+	const size_t newSlots = count > FreeEntitySlots.GetSize() ? count - FreeEntitySlots.GetSize() : 0;
+	EntitySlots.Reserve(EntitySlots.GetSize() + newSlots);
+	entityIds.Reserve(entityIds.GetSize() + count);
+	createdComponents.Reserve(createdComponents.GetSize() + count * prototype.GetComponentCount());
+
+	Dynarray<Entity*> entities(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		Entity* ent = CreateEntity();
+		entities.PushBack(ent);
+		entityIds.PushBack(ent->EntityID);
+	}
+
+	// construct components type by type, every loop touches a single pool
+	for (const EntityPrototype::ComponentBuilderBase* builder : prototype.Builders)
+		builder->Construct(this, entities, createdComponents);
+
+	// entities get their final component set at once, so they are moved to an archetype only once
+	if (Archetypes)
+	{
+		for (Entity* ent : entities)
+			Archetypes->UpdateEntity(ent);
+	}
+}
+
+//------------------------------------------------------------------------------
+void World::DestroyEntitiesBatch(const Dynarray<UniqueID>& entityIds)
+{
+	FreeEntitySlots.Reserve(FreeEntitySlots.GetSize() + entityIds.GetSize());
+	for (const UniqueID& id : entityIds)
+	{
+		// entity could have been destroyed already as a child of an entity earlier in the batch
+		if (GetEntity(id))
+			DestroyEntity(id);
+	}
 }
 
 //------------------------------------------------------------------------------
 void World::DestroyEntity(const UniqueID& entityId)
 {
-	Entity* ent = IDToEntityMap[entityId];
+	Entity* ent = GetEntity(entityId);
 	HEAVY_ASSERTE(ent, "Invalid entity ID");
 
 	TransformComponent* transform = ent->GetComponent<TransformComponent>();
 	if (transform)
 	{
-		for (auto it : transform->GetChildren())
-			DestroyEntity(it->GetOwnerID());
+		// destroyed children remove themselves from the list
+		while (!transform->GetChildren().IsEmpty())
+			DestroyEntity(transform->GetChildren()[0]->GetOwnerID());
 	}
 
+	if (Archetypes)
+		Archetypes->RemoveEntity(ent);
+
 	for (size_t i = 0; i < MAX_COMPONENTS_COUNT; ++i)
 	{
 		if (ent->Components[i])
 			RemoveComponentById(ent, i);
 	}
-	IDToEntityMap.erase(entityId);
+
+	// bump generation to invalidate all copies of entityId
+	const size_t index = EntityHandle::FromID(entityId).Index;
+	EntitySlot& slot = EntitySlots[index];
+	slot.Ent = nullptr;
+	slot.Generation = (slot.Generation + 1) & (~size_t(0) >> ENTITY_INDEX_BITS);
+	if (slot.Generation == 0)
+		slot.Generation = 1;
+	FreeEntitySlots.PushBack(index);
+
 	ent->~Entity();
 	EntitiesAllocator.Free(ent);
 }
@@ -71,6 +144,28 @@ bool World::HasWorldComponent(size_t ID) const
 	return WorldComponents[ID] != nullptr;
 }
 
+//------------------------------------------------------------------------------
+void World::SetArchetypeStorageEnabled(bool enabled)
+{
+	if (enabled == IsArchetypeStorageEnabled())
+		return;
+
+	if (enabled)
+	{
+		Archetypes = std::make_unique<ArchetypeStorage>();
+		for (const EntitySlot& slot : EntitySlots)
+			if (slot.Ent)
+				Archetypes->UpdateEntity(slot.Ent);
+	}
+	else
+	{
+		for (const EntitySlot& slot : EntitySlots)
+			if (slot.Ent)
+				Archetypes->RemoveEntity(slot.Ent);
+		Archetypes.reset();
+	}
+}
+
 //------------------------------------------------------------------------------
 void World::RemoveComponentById(Entity* ent, size_t id)
 {
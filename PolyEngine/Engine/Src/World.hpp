@@ -1,19 +1,23 @@
 #pragma once
 
-#include <unordered_map>
 #include <Core.hpp>
 
 #include "Entity.hpp"
 #include "Engine.hpp"
+#include "ArchetypeStorage.hpp"
 
 #include "ComponentBase.hpp"
 
 namespace Poly {
 
+	class EntityPrototype;
+
 	namespace DeferredTaskSystem
 	{
 		UniqueID ENGINE_DLLEXPORT SpawnEntityImmediate(World* w);
 		void ENGINE_DLLEXPORT DestroyEntityImmediate(World* w, const UniqueID& entityId);
+		Dynarray<UniqueID> ENGINE_DLLEXPORT SpawnEntitiesBatch(World* w, size_t count, const EntityPrototype& prototype);
+		void ENGINE_DLLEXPORT DestroyEntitiesBatch(World* w, const Dynarray<UniqueID>& entityIds);
 		template<typename T, typename ...Args> T* AddComponentImmediate(World* w, const UniqueID & entityId, Args && ...args);
 		template<typename T, typename ...Args> T* AddWorldComponentImmediate(World* w, Args && ...args);
 		template<typename T> void RemoveWorldComponentImmediate(World* w);
@@ -23,6 +27,22 @@ namespace Poly {
 	/// <summary>Entities per world limit.</summary>
 	constexpr size_t MAX_ENTITY_COUNT = 65536;
 
+	/// <summary>Amount of low UniqueID bits that store entity index, the rest stores generation.</summary>
+	constexpr size_t ENTITY_INDEX_BITS = 16;
+	STATIC_ASSERTE(MAX_ENTITY_COUNT <= (size_t(1) << ENTITY_INDEX_BITS), "Entity index does not fit into its UniqueID bits.");
+
+	/// <summary>Generational handle of an entity: index into world entity table and generation of that table slot.
+	/// Slot generation changes every time an entity is destroyed, so handles of destroyed entities are detected as stale.
+	/// Entity UniqueID is an encoded handle, so both can be converted into each other without any lookup.</summary>
+	struct EntityHandle
+	{
+		static EntityHandle FromID(const UniqueID& id) { return EntityHandle{ id.GetValue() & ((size_t(1) << ENTITY_INDEX_BITS) - 1), id.GetValue() >> ENTITY_INDEX_BITS }; }
+		UniqueID ToID() const { return UniqueID::FromValue((Generation << ENTITY_INDEX_BITS) | Index); }
+
+		size_t Index;
+		size_t Generation;
+	};
+
 	/// <summary>World components in limit.</summary>
 	constexpr size_t MAX_WORLD_COMPONENTS_COUNT = 64;
 
@@ -45,16 +65,32 @@ namespace Poly {
 		T* GetComponent(const UniqueID& entityId)
 		{
 			HEAVY_ASSERTE(!!entityId, "Invalid entity ID");
-			auto iter = IDToEntityMap.find(entityId);
-			HEAVY_ASSERTE(iter != IDToEntityMap.end(), "Invalid entityId - entity with that ID does not exist!");
-			return iter->second->GetComponent<T>();
+			Entity* ent = GetEntity(entityId);
+			HEAVY_ASSERTE(ent, "Invalid entityId - entity with that ID does not exist!");
+			return ent->GetComponent<T>();
 		}
 
+		/// <summary>Checks whether entity with given UniqueID exists in this world.</summary>
+		/// <param name="entityId">UniqueID of the entity.</param>
+		/// <returns>False for IDs of destroyed entities, true otherwise.</returns>
+		bool HasEntity(const UniqueID& entityId) const { return GetEntity(entityId) != nullptr; }
+
 		/// <summary>Checks whether world has component of given ID.</summary>
 		/// <param name="ID">Registered component ID.</param>
 		/// <returns>True when world has component of given ID, false otherwise</returns>
 		bool HasWorldComponent(size_t ID) const;
 
+		/// <summary>Enables or disables archetype storage mode.
+		/// In this mode entities that share component set are grouped into archetype chunks,
+		/// which makes multi-component iteration a linear scan without per-entity component lookups.
+		/// Iteration order differs from default mode. Existing entities are moved to/from archetypes.</summary>
+		/// <param name="enabled">True to enable archetype storage, false to use only component pools.</param>
+		void SetArchetypeStorageEnabled(bool enabled);
+
+		/// <summary>Checks whether archetype storage mode is enabled.</summary>
+		/// <returns>True when archetype storage is enabled, false otherwise.</returns>
+		bool IsArchetypeStorageEnabled() const { return Archetypes != nullptr; }
+
 		/// <summary>Returns world component of given type.</summary>
 		/// <returns>Pointer to world component</returns>
 		template<typename T>
@@ -109,11 +145,16 @@ namespace Poly {
 		                          public std::iterator<std::bidirectional_iterator_tag, std::tuple<typename std::add_pointer<PrimaryComponent>::type, typename std::add_pointer<SecondaryComponents>::type...>>
 		{
 			public:
-			bool operator==(const ComponentIterator& rhs) const { return primary_iter == rhs.primary_iter; }
+			bool operator==(const ComponentIterator& rhs) const { return Archetypes ? archetype_cursor == rhs.archetype_cursor : primary_iter == rhs.primary_iter; }
 			bool operator!=(const ComponentIterator& rhs) const { return !(*this == rhs); }
 
 			std::tuple<typename std::add_pointer<PrimaryComponent>::type, typename std::add_pointer<SecondaryComponents>::type...> operator*() const
 			{
+				if (Archetypes)
+				{
+					const Archetype* archetype = Archetypes->GetArchetype(archetype_cursor.ArchetypeIdx);
+					return std::make_tuple(GetFromColumn<PrimaryComponent>(archetype), GetFromColumn<SecondaryComponents>(archetype)...);
+				}
 				PrimaryComponent* primary = &*primary_iter;
 				return std::make_tuple(primary, primary->template GetSibling<SecondaryComponents>()...);
 			}
@@ -122,16 +163,42 @@ namespace Poly {
 				return **this;
 			}
 
-			ComponentIterator& operator++() { ++primary_iter; return *this; }
-			ComponentIterator operator++(int) { ComponentIterator ret(primary_iter); ++primary_iter; return ret; }
-			ComponentIterator& operator--() { --primary_iter; return *this; }
-			ComponentIterator operator--(int) { ComponentIterator ret(primary_iter); --primary_iter; return ret; }
+			ComponentIterator& operator++() { Increment(); return *this; }
+			ComponentIterator operator++(int) { ComponentIterator ret(*this); Increment(); return ret; }
+			ComponentIterator& operator--() { Decrement(); return *this; }
+			ComponentIterator operator--(int) { ComponentIterator ret(*this); Decrement(); return ret; }
 
 			private:
 			explicit ComponentIterator(typename IterablePoolAllocator<PrimaryComponent>::Iterator parent) : primary_iter(parent) {}
+			ComponentIterator(const ArchetypeStorage* archetypes, const ArchetypeStorage::Cursor& cursor) : Archetypes(archetypes), archetype_cursor(cursor) {}
 			friend struct IteratorProxy<PrimaryComponent, SecondaryComponents...>;
 
+			template<typename T>
+			T* GetFromColumn(const Archetype* archetype) const
+			{
+				ComponentBase* const* column = archetype->GetColumn(archetype_cursor.ChunkIdx, GetComponentID<T>());
+				return column ? static_cast<T*>(column[archetype_cursor.Row]) : nullptr;
+			}
+
+			void Increment()
+			{
+				if (Archetypes)
+					Archetypes->Next(archetype_cursor, GetComponentID<PrimaryComponent>());
+				else
+					++primary_iter;
+			}
+
+			void Decrement()
+			{
+				if (Archetypes)
+					Archetypes->Prev(archetype_cursor, GetComponentID<PrimaryComponent>());
+				else
+					--primary_iter;
+			}
+
 			typename IterablePoolAllocator<PrimaryComponent>::Iterator primary_iter;
+			const ArchetypeStorage* Archetypes = nullptr;
+			ArchetypeStorage::Cursor archetype_cursor;
 		};
 
 		/// Iterator proxy
@@ -141,10 +208,14 @@ namespace Poly {
 			IteratorProxy(World* w) : W(w) {}
 			World::ComponentIterator<PrimaryComponent, SecondaryComponents...> Begin()
 			{
+				if (W->Archetypes)
+					return ComponentIterator<PrimaryComponent, SecondaryComponents...>(W->Archetypes.get(), W->Archetypes->Begin(GetComponentID<PrimaryComponent>()));
 				return ComponentIterator<PrimaryComponent, SecondaryComponents...>(W->GetComponentAllocator<PrimaryComponent>()->Begin());
 			}
 			World::ComponentIterator<PrimaryComponent, SecondaryComponents...> End()
 			{
+				if (W->Archetypes)
+					return ComponentIterator<PrimaryComponent, SecondaryComponents...>(W->Archetypes.get(), W->Archetypes->End());
 				return ComponentIterator<PrimaryComponent, SecondaryComponents...>(W->GetComponentAllocator<PrimaryComponent>()->End());
 			}
 			auto begin() { return Begin(); }
@@ -153,6 +224,7 @@ namespace Poly {
 		};
 
 	private:
+		friend class EntityPrototype;
 		friend class SpawnEntityDeferredTask;
 		friend class DestroyEntityDeferredTask;
 		template<typename T,typename... Args> friend class AddComponentDeferredTask;
@@ -160,6 +232,8 @@ namespace Poly {
 
 		friend UniqueID DeferredTaskSystem::SpawnEntityImmediate(World*);
 		friend void DeferredTaskSystem::DestroyEntityImmediate(World* w, const UniqueID& entityId);
+		friend Dynarray<UniqueID> DeferredTaskSystem::SpawnEntitiesBatch(World* w, size_t count, const EntityPrototype& prototype);
+		friend void DeferredTaskSystem::DestroyEntitiesBatch(World* w, const Dynarray<UniqueID>& entityIds);
 		template<typename T, typename ...Args> friend T* DeferredTaskSystem::AddComponentImmediate(World* w, const UniqueID & entityId, Args && ...args);
 		template<typename T, typename ...Args> friend T* DeferredTaskSystem::AddWorldComponentImmediate(World* w, Args && ...args);
 		template<typename T> friend void DeferredTaskSystem::RemoveWorldComponentImmediate(World* w);
@@ -170,6 +244,15 @@ namespace Poly {
 		//------------------------------------------------------------------------------
 		void DestroyEntity(const UniqueID& entityId);
 
+		//------------------------------------------------------------------------------
+		void SpawnEntitiesBatch(size_t count, const EntityPrototype& prototype, Dynarray<UniqueID>& entityIds, Dynarray<ComponentBase*>& createdComponents);
+
+		//------------------------------------------------------------------------------
+		void DestroyEntitiesBatch(const Dynarray<UniqueID>& entityIds);
+
+		//------------------------------------------------------------------------------
+		Entity* CreateEntity();
+
 		//------------------------------------------------------------------------------
 		template<typename T, typename... Args>
 		void AddComponent(const UniqueID& entityId, Args&&... args)
@@ -177,26 +260,49 @@ namespace Poly {
 			const auto ctypeID = GetComponentID<T>();
 			T* ptr = GetComponentAllocator<T>()->Alloc();
 			::new(ptr) T(std::forward<Args>(args)...);
-			Entity* ent = IDToEntityMap[entityId];
+			Entity* ent = GetEntity(entityId);
 			HEAVY_ASSERTE(ent, "Invalid entity ID");
 			HEAVY_ASSERTE(!ent->HasComponent(ctypeID), "Failed at AddComponent() - a component of a given UniqueID already exists!");
 			ent->ComponentPosessionFlags.set(ctypeID, true);
 			ent->Components[ctypeID] = ptr;
 			ptr->Owner = ent;
+			if (Archetypes)
+				Archetypes->UpdateEntity(ent);
 			HEAVY_ASSERTE(ent->HasComponent(ctypeID), "Failed at AddComponent() - the component was not added!");
 		}
 
+		//------------------------------------------------------------------------------
+		// Constructs component for every entity without updating archetypes, caller has to do it once all components are added.
+		template<typename T, typename... Args>
+		void AddComponentsBatch(const Dynarray<Entity*>& entities, Dynarray<ComponentBase*>& createdComponents, const Args&... args)
+		{
+			const auto ctypeID = GetComponentID<T>();
+			IterablePoolAllocator<T>* allocator = GetComponentAllocator<T>();
+			for (Entity* ent : entities)
+			{
+				HEAVY_ASSERTE(!ent->HasComponent(ctypeID), "Failed at AddComponentsBatch() - a component of a given type already exists!");
+				T* ptr = allocator->Alloc();
+				::new(ptr) T(args...);
+				ent->ComponentPosessionFlags.set(ctypeID, true);
+				ent->Components[ctypeID] = ptr;
+				ptr->Owner = ent;
+				createdComponents.PushBack(ptr);
+			}
+		}
+
 		//------------------------------------------------------------------------------
 		template<typename T>
 		void RemoveComponent(const UniqueID& entityId)
 		{
 			const auto ctypeID = GetComponentID<T>();
-			Entity* ent = IDToEntityMap[entityId];
+			Entity* ent = GetEntity(entityId);
 			HEAVY_ASSERTE(ent, "Invalid entity ID");
 			HEAVY_ASSERTE(ent->HasComponent(ctypeID), "Failed at RemoveComponent() - a component of a given UniqueID does not exist!");
 			ent->ComponentPosessionFlags.set(ctypeID, false);
 			T* component = static_cast<T*>(ent->Components[ctypeID]);
 			ent->Components[ctypeID] = nullptr;
+			if (Archetypes)
+				Archetypes->UpdateEntity(ent);
 			component->~T();
 			GetComponentAllocator<T>()->Free(component);
 			HEAVY_ASSERTE(!ent->HasComponent(ctypeID), "Failed at AddComponent() - the component was not removed!");
@@ -233,7 +339,25 @@ namespace Poly {
 			component->~T();
 		}
 
-		std::unordered_map<UniqueID, Entity*> IDToEntityMap;
+		//------------------------------------------------------------------------------
+		Entity* GetEntity(const UniqueID& entityId) const
+		{
+			const EntityHandle handle = EntityHandle::FromID(entityId);
+			if (handle.Index >= EntitySlots.GetSize() || EntitySlots[handle.Index].Generation != handle.Generation)
+				return nullptr;
+			return EntitySlots[handle.Index].Ent;
+		}
+
+		/// Entry of the dense entity table, addressed by EntityHandle::Index.
+		struct EntitySlot
+		{
+			Entity* Ent = nullptr;
+			size_t Generation = 1;
+		};
+
+		Dynarray<EntitySlot> EntitySlots;
+		Dynarray<size_t> FreeEntitySlots;
+		std::unique_ptr<ArchetypeStorage> Archetypes;
 
 		void RemoveComponentById(Entity* ent, size_t id);
 
@@ -9,180 +9,221 @@
 #include <MeshRenderingComponent.hpp>
 #include <LightSourceComponent.hpp>
 #include <MovementSystem.hpp>
+#include <AARect.hpp>
+#include <Engine.hpp>
 
 
 using namespace Poly;
 
-const size_t MAX_LIGHT_COUNT_POINT = 8;
-const size_t MAX_LIGHT_COUNT_DIRECTIONAL = 8;
-const size_t MAX_LIGHT_COUNT_SPOT = 8;
-
-BlinnPhongRenderingPass::BlinnPhongRenderingPass()
-: RenderingPassBase("Shaders/blinn-phongVert.shader", "Shaders/blinn-phongFrag.shader")
+namespace
 {
-	GetProgram().RegisterUniform("vec4", "uCameraPosition");
-	GetProgram().RegisterUniform("vec4", "uCameraForward");
+	// binding points of the uniform blocks
+	const GLuint FRAME_DATA_BINDING = 0;
+	const GLuint MATERIAL_DATA_BINDING = 1;
 
-	GetProgram().RegisterUniform("vec4", "uMaterial.Ambient");
-	GetProgram().RegisterUniform("vec4", "uMaterial.Diffuse");
-	GetProgram().RegisterUniform("vec4", "uMaterial.Specular");
-	GetProgram().RegisterUniform("float", "uMaterial.Shininess");
+	// texture units of the light culling buffers, unit 0 is used by the diffuse texture
+	const GLuint LIGHTS_TEXTURE_UNIT = 1;
+	const GLuint CLUSTERS_TEXTURE_UNIT = 2;
+	const GLuint LIGHT_INDICES_TEXTURE_UNIT = 3;
 
-	GetProgram().RegisterUniform("vec4", "uAmbientLight.Color");
-	GetProgram().RegisterUniform("float", "uAmbientLight.Intensity");
-
-	for (size_t i = 0; i < MAX_LIGHT_COUNT_DIRECTIONAL; ++i)
+	bool IsSameColor(const Color& a, const Color& b)
 	{
-		String baseName = String("uDirectionalLight[") + String::From(static_cast<int>(i)) + String("].");
-		GetProgram().RegisterUniform("vec4", baseName + "Base.Color");
-		GetProgram().RegisterUniform("float", baseName + "Base.Intensity");
-		GetProgram().RegisterUniform("vec4", baseName + "Direction");
+		return a.R == b.R && a.G == b.G && a.B == b.B && a.A == b.A;
 	}
 
-	GetProgram().RegisterUniform("int", "uDirectionalLightCount");
-
-	for (size_t i = 0; i < MAX_LIGHT_COUNT_POINT; ++i)
+	bool IsSameMaterial(const PhongMaterial& a, const PhongMaterial& b)
 	{
-		String baseName = String("uPointLight[") + String::From(static_cast<int>(i)) + String("].");
-		GetProgram().RegisterUniform("vec4", baseName + "Base.Color");
-		GetProgram().RegisterUniform("float", baseName + "Base.Intensity");
-		GetProgram().RegisterUniform("vec4", baseName + "Position");
-		GetProgram().RegisterUniform("float", baseName + "Attenuation");
-		GetProgram().RegisterUniform("float", baseName + "Range");
+		return IsSameColor(a.AmbientColor, b.AmbientColor) && IsSameColor(a.DiffuseColor, b.DiffuseColor)
+			&& IsSameColor(a.SpecularColor, b.SpecularColor) && a.Shininess == b.Shininess;
 	}
+}
 
-	for (size_t i = 0; i < MAX_LIGHT_COUNT_SPOT; ++i)
-	{
-		String baseName = String("uSpotLight[") + String::From(static_cast<int>(i)) + String("].");
-		GetProgram().RegisterUniform("vec4", baseName + "Base.Color");
-		GetProgram().RegisterUniform("float", baseName + "Base.Intensity");
-		GetProgram().RegisterUniform("vec4", baseName + "Position");
-		GetProgram().RegisterUniform("vec4", baseName + "Direction");
-		GetProgram().RegisterUniform("float", baseName + "Range");
-		GetProgram().RegisterUniform("float", baseName + "CutOff");
-		GetProgram().RegisterUniform("float", baseName + "OuterCutOff");
-	}
+constexpr size_t BlinnPhongRenderingPass::MAX_LIGHT_COUNT_DIRECTIONAL;
 
-	GetProgram().RegisterUniform("int", "uSpotLightCount");
+BlinnPhongRenderingPass::BlinnPhongRenderingPass()
+: RenderingPassBase("Shaders/blinn-phongVert.shader", "Shaders/blinn-phongFrag.shader"),
+	FrameBuffer(sizeof(FrameData)), LightBuffer(GL_RGBA32F), ClusterBuffer(GL_RG32UI), LightIndexBuffer(GL_R32UI),
+	MaterialBuffer(sizeof(MaterialData))
+{
+	// sizes of std140 blocks, arrays of structures start at offset rounded to 16 bytes
+	STATIC_ASSERTE(sizeof(DirectionalLightData) == 48, "Invalid std140 layout of DirectionalLight");
+	STATIC_ASSERTE(sizeof(MaterialData) == 64, "Invalid std140 layout of MaterialData");
+	STATIC_ASSERTE(sizeof(FrameData) == 96 + MAX_LIGHT_COUNT_DIRECTIONAL * 48, "Invalid std140 layout of FrameData");
+	STATIC_ASSERTE(sizeof(LocalLightData) == 3 * 4 * sizeof(float), "Invalid layout of LocalLightData");
+	STATIC_ASSERTE(sizeof(LightGrid::Cluster) == 2 * sizeof(u32), "Invalid layout of LightGrid::Cluster");
+
+	GetProgram().BindUniformBlock("FrameData", FRAME_DATA_BINDING);
+	GetProgram().BindUniformBlock("MaterialData", MATERIAL_DATA_BINDING);
+
+	ViewProjectionUniform = GetProgram().GetUniform<Matrix>("uViewProjection");
+	ViewUniform = GetProgram().GetUniform<Matrix>("uView");
+	LightsUniform = GetProgram().GetUniform<int>("uLights");
+	ClustersUniform = GetProgram().GetUniform<int>("uClusters");
+	LightIndicesUniform = GetProgram().GetUniform<int>("uLightIndices");
 }
 
-void BlinnPhongRenderingPass::OnRun(World* world, const CameraComponent* camera, const AARect& /*rect*/, ePassType passType = ePassType::GLOBAL)
+void BlinnPhongRenderingPass::OnRun(World* world, const CameraComponent* camera, const AARect& rect, ePassType passType = ePassType::GLOBAL)
 {
 
 	GetProgram().BindProgram();
 	const Matrix& mvp = camera->GetMVP();
 	
 	const TransformComponent* cameraTransCmp = camera->GetSibling<TransformComponent>();
-	Vector CameraPos = cameraTransCmp->GetGlobalTranslation();
-	Vector CameraDir = MovementSystem::GetGlobalForward(cameraTransCmp);
-	GetProgram().SetUniform("uCameraPosition", CameraPos);
-	GetProgram().SetUniform("uCameraForward", CameraDir);
+	Frame.CameraPosition = cameraTransCmp->GetGlobalTranslation();
+	Frame.CameraForward = MovementSystem::GetGlobalForward(cameraTransCmp);
 
 	AmbientLightWorldComponent* ambientCmp = world->GetWorldComponent<AmbientLightWorldComponent>();
-	GetProgram().SetUniform("uAmbientLight.Color", ambientCmp->GetColor());
-	GetProgram().SetUniform("uAmbientLight.Intensity", ambientCmp->GetIntensity());
+	Frame.AmbientColor = ambientCmp->GetColor();
+	Frame.AmbientIntensity = ambientCmp->GetIntensity();
 
 	int dirLightsCount = 0;
 	for (const auto& componentsTuple : world->IterateComponents<DirectionalLightComponent, TransformComponent>())
 	{
 		DirectionalLightComponent* dirLightCmp = std::get<DirectionalLightComponent*>(componentsTuple);
 		TransformComponent* transformCmp = std::get<TransformComponent*>(componentsTuple);
-		String baseName = String("uDirectionalLight[") + String::From(dirLightsCount) + String("].");
-		GetProgram().SetUniform(baseName + "Direction", MovementSystem::GetGlobalForward(transformCmp));
-		GetProgram().SetUniform(baseName + "Base.Color", dirLightCmp->GetColor());
-		GetProgram().SetUniform(baseName + "Base.Intensity", dirLightCmp->GetIntensity());
-		
+		DirectionalLightData& light = Frame.DirectionalLights[dirLightsCount];
+		light.Direction = MovementSystem::GetGlobalForward(transformCmp);
+		light.LightColor = dirLightCmp->GetColor();
+		light.Intensity = dirLightCmp->GetIntensity();
+
 		++dirLightsCount;
 		if (dirLightsCount == MAX_LIGHT_COUNT_DIRECTIONAL)
 			break;
 	}
-	GetProgram().SetUniform("uDirectionalLightCount", dirLightsCount);
-	
-	int pointLightsCount = 0;
+	Frame.DirectionalLightCount = dirLightsCount;
+
+	// point lights go first in the light buffer, followed by spot lights
+	LightPositions.Clear();
+	LightRanges.Clear();
+	LocalLights.Clear();
 	for (const auto& componentsTuple : world->IterateComponents<PointLightComponent, TransformComponent>())
 	{
 		PointLightComponent* pointLightCmp = std::get<PointLightComponent*>(componentsTuple);
 		TransformComponent* transformCmp = std::get<TransformComponent*>(componentsTuple);
-	
-		String baseName = String("uPointLight[") + String::From(pointLightsCount) + String("].");
-		GetProgram().SetUniform(baseName + "Range", pointLightCmp->GetRange());
-		GetProgram().SetUniform(baseName + "Position", transformCmp->GetGlobalTranslation());
-		GetProgram().SetUniform(baseName + "Base.Color", pointLightCmp->GetColor());
-		GetProgram().SetUniform(baseName + "Base.Intensity", pointLightCmp->GetIntensity());
-
-		++pointLightsCount;
-		if (pointLightsCount == MAX_LIGHT_COUNT_POINT)
-			break;
+		const Vector position = transformCmp->GetGlobalTranslation();
+		const Color& color = pointLightCmp->GetColor();
+		const float intensity = pointLightCmp->GetIntensity();
+
+		LightPositions.PushBack(position);
+		LightRanges.PushBack(pointLightCmp->GetRange());
+		LocalLights.PushBack(LocalLightData{ { position.X, position.Y, position.Z }, pointLightCmp->GetRange(),
+			{ color.R * intensity, color.G * intensity, color.B * intensity }, 0.0f, { 0.0f, 0.0f, 0.0f }, 0.0f });
 	}
-	GetProgram().SetUniform("uPointLightCount", pointLightsCount);
+	Frame.PointLightCount = static_cast<int>(LocalLights.GetSize());
 
-	int spotLightsCount = 0;
 	for (const auto& componentsTuple : world->IterateComponents<SpotLightComponent, TransformComponent>())
 	{
 		SpotLightComponent* spotLightCmp = std::get<SpotLightComponent*>(componentsTuple);
 		TransformComponent* transformCmp = std::get<TransformComponent*>(componentsTuple);
-
-		String baseName = String("uSpotLight[") + String::From(spotLightsCount) + String("].");
-		GetProgram().SetUniform(baseName + "Range", spotLightCmp->GetRange());
-		GetProgram().SetUniform(baseName + "CutOff", Cos(1.0_deg * spotLightCmp->GetCutOff()));
-		GetProgram().SetUniform(baseName + "OuterCutOff", Cos(1.0_deg * spotLightCmp->GetOuterCutOff()));
-		GetProgram().SetUniform(baseName + "Position", transformCmp->GetGlobalTranslation());
-		GetProgram().SetUniform(baseName + "Direction", MovementSystem::GetGlobalForward(transformCmp));
-		GetProgram().SetUniform(baseName + "Base.Color", spotLightCmp->GetColor());
-		GetProgram().SetUniform(baseName + "Base.Intensity", spotLightCmp->GetIntensity());
-
-		++spotLightsCount;
-		if (spotLightsCount == MAX_LIGHT_COUNT_SPOT)
-			break;
+		const Vector position = transformCmp->GetGlobalTranslation();
+		const Vector direction = MovementSystem::GetGlobalForward(transformCmp);
+		const Color& color = spotLightCmp->GetColor();
+		const float intensity = spotLightCmp->GetIntensity();
+
+		// spot light is culled by the sphere containing its cone
+		LightPositions.PushBack(position);
+		LightRanges.PushBack(spotLightCmp->GetRange());
+		LocalLights.PushBack(LocalLightData{ { position.X, position.Y, position.Z }, spotLightCmp->GetRange(),
+			{ color.R * intensity, color.G * intensity, color.B * intensity }, Cos(1.0_deg * spotLightCmp->GetOuterCutOff()),
+			{ direction.X, direction.Y, direction.Z }, Cos(1.0_deg * spotLightCmp->GetCutOff()) });
 	}
-	GetProgram().SetUniform("uSpotLightCount", spotLightsCount);
 
-	// Render meshes
-	for (const auto& componentsTuple : world->IterateComponents<MeshRenderingComponent, TransformComponent>())
+	if (camera->IsPerspectiveProjection())
+		Grid.SetPerspective(camera->GetFOV(), camera->GetAspect(), camera->GetClippingPlaneNear(), camera->GetClippingPlaneFar());
+	else
+		Grid.SetOrthographic(camera->GetOrthographicTop(), camera->GetOrthographicBottom(), camera->GetOrthographicLeft(),
+			camera->GetOrthographicRight(), camera->GetClippingPlaneNear(), camera->GetClippingPlaneFar());
+	Grid.Build(camera->GetModelViewMatrix(), LightPositions, LightRanges, gEngine->GetThreadPool());
+
+	LightBuffer.Update(LocalLights);
+	ClusterBuffer.Update(Grid.GetClusters());
+	LightIndexBuffer.Update(Grid.GetLightIndices());
+
+	const ScreenSize screenSize = gEngine->GetRenderingDevice()->GetScreenSize();
+	Frame.Viewport[0] = rect.GetMin().X * screenSize.Width;
+	Frame.Viewport[1] = rect.GetMin().Y * screenSize.Height;
+	Frame.Viewport[2] = rect.GetSize().X * screenSize.Width;
+	Frame.Viewport[3] = rect.GetSize().Y * screenSize.Height;
+	Frame.TilesX = static_cast<int>(Grid.GetTilesX());
+	Frame.TilesY = static_cast<int>(Grid.GetTilesY());
+	Frame.Slices = static_cast<int>(Grid.GetSlices());
+	Frame.SliceScale = Grid.GetSliceScale();
+	Frame.SliceBias = Grid.GetSliceBias();
+
+	FrameBuffer.Update(Frame);
+	FrameBuffer.Bind(FRAME_DATA_BINDING);
+	LightBuffer.Bind(LIGHTS_TEXTURE_UNIT);
+	ClusterBuffer.Bind(CLUSTERS_TEXTURE_UNIT);
+	LightIndexBuffer.Bind(LIGHT_INDICES_TEXTURE_UNIT);
+	GetProgram().SetUniform(LightsUniform, static_cast<int>(LIGHTS_TEXTURE_UNIT));
+	GetProgram().SetUniform(ClustersUniform, static_cast<int>(CLUSTERS_TEXTURE_UNIT));
+	GetProgram().SetUniform(LightIndicesUniform, static_cast<int>(LIGHT_INDICES_TEXTURE_UNIT));
+
+	// Render meshes that passed frustum culling, sorted to minimize state changes
+	QueueVisibleSubMeshes(camera, passType, true, [passType](const MeshRenderingComponent* meshCmp)
 	{
-		const MeshRenderingComponent* meshCmp = std::get<MeshRenderingComponent*>(componentsTuple);
-		TransformComponent* transCmp = std::get<TransformComponent*>(componentsTuple);
+		return passType != ePassType::BY_MATERIAL || (!meshCmp->IsTransparent() && meshCmp->GetShadingModel() == eShadingModel::LIT);
+	});
 
-		if ( passType == ePassType::BY_MATERIAL &&
-			(meshCmp->IsTransparent() || meshCmp->GetShadingModel() != eShadingModel::LIT))
+	// submeshes sharing mesh, texture, material and fill mode are drawn as instances of a single draw call
+	BuildDrawBatches([](const DrawItem& first, const DrawItem& next)
+	{
+		return first.Mesh->GetIsWireframe() == next.Mesh->GetIsWireframe()
+			&& IsSameMaterial(first.Mesh->GetMaterial(static_cast<int>(first.SubMeshIdx)), next.Mesh->GetMaterial(static_cast<int>(next.SubMeshIdx)));
+	});
+
+	// gather materials of batches into one buffer, consecutive batches with equal material share the slot
+	const size_t materialStride = ((sizeof(MaterialData) + GLUniformBuffer::GetOffsetAlignment() - 1) / GLUniformBuffer::GetOffsetAlignment()) * GLUniformBuffer::GetOffsetAlignment();
+	Materials.Clear();
+	MaterialOffsets.Clear();
+	Materials.Reserve(DrawBatches.GetSize() * materialStride);
+	MaterialOffsets.Reserve(DrawBatches.GetSize());
+	const PhongMaterial* lastMaterial = nullptr;
+	for (const DrawBatch& batch : DrawBatches)
+	{
+		const DrawItem& item = DrawItems[DrawQueue.GetEntries()[batch.FirstEntry].Index];
+		const PhongMaterial& material = item.Mesh->GetMaterial(static_cast<int>(item.SubMeshIdx));
+		if (!lastMaterial || !IsSameMaterial(material, *lastMaterial))
 		{
-			continue;
+			lastMaterial = &material;
+			MaterialData data;
+			data.Ambient = material.AmbientColor;
+			data.Diffuse = material.DiffuseColor;
+			data.Specular = material.SpecularColor;
+			data.Shininess = material.Shininess;
+			Materials.Resize(Materials.GetSize() + materialStride);
+			memcpy(Materials.GetData() + Materials.GetSize() - materialStride, &data, sizeof(MaterialData));
 		}
+		MaterialOffsets.PushBack(Materials.GetSize() - materialStride);
+	}
+	if (!Materials.IsEmpty())
+		MaterialBuffer.Update(Materials.GetData(), Materials.GetSize());
 
-		const Matrix& objTransform = transCmp->GetGlobalTransformationMatrix();
-		Matrix screenTransform = mvp * objTransform;
-		GetProgram().SetUniform("uTransform", objTransform);
-		GetProgram().SetUniform("uMVPTransform", screenTransform);
-		
-		glPolygonMode(GL_FRONT_AND_BACK, meshCmp->GetIsWireframe() ? GL_LINE : GL_FILL);
+	GetProgram().SetUniform(ViewProjectionUniform, mvp);
+	GetProgram().SetUniform(ViewUniform, camera->GetModelViewMatrix());
 
-		int i = 0;
-		for (const MeshResource::SubMesh* subMesh : meshCmp->GetMesh()->GetSubMeshes())
+	size_t lastMaterialOffset = size_t(-1);
+	bool lastWireframe = false;
+	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	for (size_t i = 0; i < DrawBatches.GetSize(); ++i)
+	{
+		const DrawBatch& batch = DrawBatches[i];
+		const DrawItem& item = DrawItems[DrawQueue.GetEntries()[batch.FirstEntry].Index];
+		if (item.Mesh->GetIsWireframe() != lastWireframe)
 		{
-			PhongMaterial material = meshCmp->GetMaterial(i);
-			GetProgram().SetUniform("uMaterial.Ambient", material.AmbientColor);
-			GetProgram().SetUniform("uMaterial.Diffuse", material.DiffuseColor);
-			GetProgram().SetUniform("uMaterial.Specular", material.SpecularColor);
-			GetProgram().SetUniform("uMaterial.Shininess", material.Shininess);
-
-			const GLMeshDeviceProxy* meshProxy = static_cast<const GLMeshDeviceProxy*>(subMesh->GetMeshProxy());
-			glBindVertexArray(meshProxy->GetVAO());
-
-			const Poly::TextureResource* DiffuseTexture = subMesh->GetMeshData().GetDiffTexture();
-			GLuint TextureID = DiffuseTexture == nullptr
-				? FallbackWhiteTexture
-				: static_cast<const GLTextureDeviceProxy*>(DiffuseTexture->GetTextureProxy())->GetTextureID();
-
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, TextureID);
-
-			glDrawElements(GL_TRIANGLES, (GLsizei)subMesh->GetMeshData().GetTriangleCount() * 3, GL_UNSIGNED_INT, NULL);
-			glBindTexture(GL_TEXTURE_2D, 0);
-			glBindVertexArray(0);
+			lastWireframe = item.Mesh->GetIsWireframe();
+			glPolygonMode(GL_FRONT_AND_BACK, lastWireframe ? GL_LINE : GL_FILL);
+		}
 
-			++i;
+		if (MaterialOffsets[i] != lastMaterialOffset)
+		{
+			lastMaterialOffset = MaterialOffsets[i];
+			MaterialBuffer.BindRange(MATERIAL_DATA_BINDING, lastMaterialOffset, sizeof(MaterialData));
 		}
 
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		DrawInstanced(batch, true);
 	}
-}
\ No newline at end of file
+	ResetBindings();
+
+	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+}
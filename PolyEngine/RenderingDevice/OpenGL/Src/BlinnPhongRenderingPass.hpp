@@ -2,6 +2,10 @@
 
 #include "RenderingPassBase.hpp"
 #include "GLShaderProgram.hpp"
+#include "GLUniformBuffer.hpp"
+#include "GLTextureBuffer.hpp"
+
+#include <LightGrid.hpp>
 
 namespace Poly
 {
@@ -16,6 +20,9 @@ namespace Poly
 	public:
 		BlinnPhongRenderingPass();
 
+		// has to match define in blinn-phongFrag.shader, point and spot lights are not limited as they are culled by LightGrid
+		static constexpr size_t MAX_LIGHT_COUNT_DIRECTIONAL = 64;
+
 	protected:
 
 		void OnRun(World* world, const CameraComponent* camera, const AARect& rect, ePassType passType) override;
@@ -23,6 +30,78 @@ namespace Poly
 		void CreateDummyTexture();
 
 	private:
+		// CPU side mirrors of the uniform blocks, laid out according to std140 rules
+		struct DirectionalLightData
+		{
+			Color LightColor;
+			Vector Direction;
+			float Intensity;
+			float Padding[3];
+		};
+
+		struct FrameData
+		{
+			Vector CameraPosition;
+			Vector CameraForward;
+			Color AmbientColor;
+			// x, y, width and height of the viewport in pixels
+			float Viewport[4];
+			float AmbientIntensity;
+			int DirectionalLightCount;
+			// lights in the light buffer before this index are point lights, the rest are spot lights
+			int PointLightCount;
+			int TilesX;
+			int TilesY;
+			int Slices;
+			float SliceScale;
+			float SliceBias;
+			DirectionalLightData DirectionalLights[MAX_LIGHT_COUNT_DIRECTIONAL];
+		};
+
+		// three RGBA32F texels of the light buffer texture
+		struct LocalLightData
+		{
+			float Position[3];
+			float Range;
+			float Color[3];
+			float OuterCutOff;
+			float Direction[3];
+			float CutOff;
+		};
+
+		struct MaterialData
+		{
+			Color Ambient;
+			Color Diffuse;
+			Color Specular;
+			float Shininess;
+			float Padding[3];
+		};
+
 		GLuint WhiteDummyTexture;
+
+		UniformHandle<Matrix> ViewProjectionUniform;
+
+		UniformHandle<Matrix> ViewUniform;
+		UniformHandle<int> LightsUniform;
+		UniformHandle<int> ClustersUniform;
+		UniformHandle<int> LightIndicesUniform;
+
+		FrameData Frame;
+		GLUniformBuffer FrameBuffer;
+
+		// point and spot lights binned into clusters of the view frustum
+		LightGrid Grid;
+		Dynarray<Vector> LightPositions;
+		Dynarray<float> LightRanges;
+		Dynarray<LocalLightData> LocalLights;
+		GLTextureBuffer LightBuffer;
+		GLTextureBuffer ClusterBuffer;
+		GLTextureBuffer LightIndexBuffer;
+
+		// materials of all draw batches, each at offset aligned for glBindBufferRange
+		Dynarray<u8> Materials;
+		Dynarray<size_t> MaterialOffsets;
+		GLUniformBuffer MaterialBuffer;
 	};
-}
\ No newline at end of file
+}
@@ -13,46 +13,46 @@ using namespace Poly;
 DebugNormalsRenderingPass::DebugNormalsRenderingPass()
 : RenderingPassBase("Shaders/normalsVert.shader", "Shaders/normalsFrag.shader")
 {
+	TransformUniform = GetProgram().GetUniform<Matrix>("uTransform");
+	MVPTransformUniform = GetProgram().GetUniform<Matrix>("uMVPTransform");
 }
 
-void DebugNormalsRenderingPass::OnRun(World* world, const CameraComponent* camera, const AARect& /*rect*/, ePassType passType = ePassType::GLOBAL)
+void DebugNormalsRenderingPass::OnRun(World* /*world*/, const CameraComponent* camera, const AARect& /*rect*/, ePassType passType = ePassType::GLOBAL)
 {
 	GetProgram().BindProgram();
 	const Matrix& mvp = camera->GetMVP();
 	
-	// Render meshes
-	for (auto componentsTuple : world->IterateComponents<MeshRenderingComponent, TransformComponent>())
+	// Render meshes that passed frustum culling, sorted to minimize state changes
+	QueueVisibleSubMeshes(camera, passType, false, [passType](const MeshRenderingComponent* meshCmp)
 	{
-		const MeshRenderingComponent* meshCmp = std::get<MeshRenderingComponent*>(componentsTuple);
-		TransformComponent* transCmp = std::get<TransformComponent*>(componentsTuple);
+		return passType != ePassType::BY_MATERIAL || (!meshCmp->IsTransparent() && meshCmp->GetShadingModel() == eShadingModel::LIT);
+	});
 
-		if (passType == ePassType::BY_MATERIAL &&
-			(meshCmp->IsTransparent() || meshCmp->GetShadingModel() != eShadingModel::LIT))
+	const Matrix* lastTransform = nullptr;
+	bool lastWireframe = false;
+	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	for (const RenderQueue::Entry& entry : DrawQueue.GetEntries())
+	{
+		const DrawItem& item = DrawItems[entry.Index];
+		// submeshes of the same object are recorded in separate packets with equal transformations
+		if (!lastTransform || !(*item.Transform == *lastTransform))
 		{
-		 	continue;
+			lastTransform = item.Transform;
+			const Matrix& objTransform = *item.Transform;
+			Matrix screenTransform = mvp * objTransform;
+			GetProgram().SetUniform(TransformUniform, objTransform);
+			GetProgram().SetUniform(MVPTransformUniform, screenTransform);
 		}
 
-		const Matrix& objTransform = transCmp->GetGlobalTransformationMatrix();
-		Matrix screenTransform = mvp * objTransform;
-		GetProgram().SetUniform("uTransform", objTransform);
-		GetProgram().SetUniform("uMVPTransform", screenTransform);
-		
-		glPolygonMode(GL_FRONT_AND_BACK, meshCmp->GetIsWireframe() ? GL_LINE : GL_FILL);
-
-		int i = 0;
-		for (const MeshResource::SubMesh* subMesh : meshCmp->GetMesh()->GetSubMeshes())
+		if (item.Mesh->GetIsWireframe() != lastWireframe)
 		{
-			const GLMeshDeviceProxy* meshProxy = static_cast<const GLMeshDeviceProxy*>(subMesh->GetMeshProxy());
-
-			glBindVertexArray(meshProxy->GetVAO());
-
-			glDrawElements(GL_TRIANGLES, (GLsizei)subMesh->GetMeshData().GetTriangleCount() * 3, GL_UNSIGNED_INT, NULL);
-			glBindTexture(GL_TEXTURE_2D, 0);
-			glBindVertexArray(0);
-
-			++i;
+			lastWireframe = item.Mesh->GetIsWireframe();
+			glPolygonMode(GL_FRONT_AND_BACK, lastWireframe ? GL_LINE : GL_FILL);
 		}
 
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		Draw(item, false);
 	}
-}
+	ResetBindings();
+
+	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+}
\ No newline at end of file
@@ -18,5 +18,9 @@ namespace Poly
 
 	protected:
 		void OnRun(World* world, const CameraComponent* camera, const AARect& rect, ePassType passType) override;
+
+	private:
+		UniformHandle<Matrix> TransformUniform;
+		UniformHandle<Matrix> MVPTransformUniform;
 	};
 }
\ No newline at end of file
@@ -13,10 +13,11 @@ using namespace Poly;
 DebugNormalsWireframeRenderingPass::DebugNormalsWireframeRenderingPass()
 : RenderingPassBase("Shaders/debugNormalsVert.shader", "Shaders/debugNormalsGeom.shader", "Shaders/debugNormalsFrag.shader")
 {
-
+	MVPUniform = GetProgram().GetUniform<Matrix>("u_MVP");
+	NormalMatrixUniform = GetProgram().GetUniform<Matrix>("u_normalMatrix4x4");
 }
 
-void DebugNormalsWireframeRenderingPass::OnRun(World* world, const CameraComponent* camera, const AARect& /*rect*/, ePassType /*passType = ePassType::BY_MATERIAL*/)
+void DebugNormalsWireframeRenderingPass::OnRun(World* /*world*/, const CameraComponent* camera, const AARect& /*rect*/, ePassType /*passType = ePassType::BY_MATERIAL*/)
 {
 	const Matrix& mModelView = camera->GetMVP();
 	const Matrix& mProjection = camera->GetProjectionMatrix();
@@ -24,22 +25,25 @@ void DebugNormalsWireframeRenderingPass::OnRun(World* world, const CameraCompone
 	GetProgram().BindProgram();
 	GetProgram().SetUniform("u_projection", mProjection);
 
-	for (auto componentsTuple : world->IterateComponents<MeshRenderingComponent, TransformComponent>())
+	// submeshes that passed frustum culling, sorted to minimize state changes
+	QueueVisibleSubMeshes(camera, ePassType::GLOBAL, false, [](const MeshRenderingComponent*) { return true; });
+
+	const Matrix* lastTransform = nullptr;
+	for (const RenderQueue::Entry& entry : DrawQueue.GetEntries())
 	{
-		const MeshRenderingComponent* meshCmp = std::get<MeshRenderingComponent*>(componentsTuple);
-		const TransformComponent* transCmp = std::get<TransformComponent*>(componentsTuple);
-
-		const Matrix& objTransform = transCmp->GetGlobalTransformationMatrix();
-		Matrix MVPTransform = mModelView * objTransform;
-		Matrix mNormalMatrix = (mModelView * objTransform).GetInversed().GetTransposed();
-		GetProgram().SetUniform("u_MVP", MVPTransform);
-		GetProgram().SetUniform("u_normalMatrix4x4", mNormalMatrix);
-		for (const MeshResource::SubMesh* subMesh : meshCmp->GetMesh()->GetSubMeshes())
+		const DrawItem& item = DrawItems[entry.Index];
+		// submeshes of the same object are recorded in separate packets with equal transformations
+		if (!lastTransform || !(*item.Transform == *lastTransform))
 		{
-			const GLMeshDeviceProxy* meshProxy = static_cast<const GLMeshDeviceProxy*>(subMesh->GetMeshProxy());
-			glBindVertexArray(meshProxy->GetVAO());
-			glDrawElements(GL_TRIANGLES, (GLsizei)subMesh->GetMeshData().GetTriangleCount() * 3, GL_UNSIGNED_INT, NULL);
-			glBindVertexArray(0);
+			lastTransform = item.Transform;
+			const Matrix& objTransform = *item.Transform;
+			Matrix MVPTransform = mModelView * objTransform;
+			Matrix mNormalMatrix = (mModelView * objTransform).GetInversed().GetTransposed();
+			GetProgram().SetUniform(MVPUniform, MVPTransform);
+			GetProgram().SetUniform(NormalMatrixUniform, mNormalMatrix);
 		}
+
+		Draw(item, false);
 	}
-}
+	ResetBindings();
+}
\ No newline at end of file
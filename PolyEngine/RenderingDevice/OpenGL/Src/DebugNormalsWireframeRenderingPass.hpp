@@ -18,5 +18,9 @@ namespace Poly
 
 	protected:
 		virtual void OnRun(World* world, const CameraComponent* camera, const AARect& rect, ePassType passType = ePassType::BY_MATERIAL) override;
+
+	private:
+		UniformHandle<Matrix> MVPUniform;
+		UniformHandle<Matrix> NormalMatrixUniform;
 	};
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "DebugRenderingPass.hpp"
 
-#include "DebugRenderingBuffers.hpp"
+#include "GLStreamingBuffer.hpp"
+#include "GLRenderingDevice.hpp"
 
 #include <World.hpp>
 #include <CameraComponent.hpp>
@@ -12,6 +13,25 @@ DebugRenderingPass::DebugRenderingPass()
 	: RenderingPassBase("Shaders/debugVert.shader", "Shaders/debugFrag.shader")
 {
 	GetProgram().RegisterUniform("mat4", "MVP");
+
+	glGenVertexArrays(1, &VAO);
+	ASSERTE(VAO > 0, "DebugRenderingPass VAO creation failed!");
+
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, gRenderingDevice->GetStreamingVertexBuffer().GetBuffer());
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (GLvoid*)offsetof(DebugVertex, Position));
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (GLvoid*)offsetof(DebugVertex, Color));
+	glEnableVertexAttribArray(1);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	CHECK_GL_ERR();
+}
+
+DebugRenderingPass::~DebugRenderingPass()
+{
+	if (VAO)
+		glDeleteVertexArrays(1, &VAO);
 }
 
 void DebugRenderingPass::OnRun(World* world, const CameraComponent* camera, const AARect& /*rect*/, ePassType /*passType*/)
@@ -24,25 +44,31 @@ void DebugRenderingPass::OnRun(World* world, const CameraComponent* camera, cons
 		auto debugLinesComponent = world->GetWorldComponent<DebugDrawLinesComponent>();
 		auto& debugLines = debugLinesComponent->DebugLines;
 		auto& debugLinesColors = debugLinesComponent->DebugLinesColors;
-
-		DebugRenderingBuffers debugLinesBuffers; // vertex and color buffer
-
-		// set up buffer
-		glBindVertexArray(debugLinesBuffers.VAO);
-		glBindBuffer(GL_ARRAY_BUFFER, debugLinesBuffers.VBO);
-		glBufferData(GL_ARRAY_BUFFER, debugLines.GetSize() * sizeof(DebugDrawLinesComponent::DebugLine)
-									+ debugLinesColors.GetSize() * sizeof(DebugDrawLinesComponent::DebugLineColor), NULL, GL_STATIC_DRAW);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, debugLines.GetSize() * sizeof(DebugDrawLinesComponent::DebugLine), (GLvoid*)debugLines.GetData());
-		glBufferSubData(GL_ARRAY_BUFFER, debugLines.GetSize() * sizeof(DebugDrawLinesComponent::DebugLine), debugLinesColors.GetSize() * sizeof(DebugDrawLinesComponent::DebugLineColor), (GLvoid*)debugLinesColors.GetData());
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vector3f), NULL);
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Color), (GLvoid*)(debugLines.GetSize() * sizeof(DebugDrawLinesComponent::DebugLine)));
-		glEnableVertexAttribArray(1);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		ASSERTE(debugLines.GetSize() == debugLinesColors.GetSize(), "Every debug line needs color");
 
 		GetProgram().SetUniform("MVP", MVP);
+		glBindVertexArray(VAO);
+
+		// lines are written interleaved with their colors straight into mapped memory,
+		// in chunks small enough to keep the rest of the ring available for frames in flight
+		GLStreamingBuffer& streamingBuffer = gRenderingDevice->GetStreamingVertexBuffer();
+		const size_t maxLinesPerDraw = streamingBuffer.GetCapacity() / 4 / (2 * sizeof(DebugVertex));
+		for (size_t first = 0; first < debugLines.GetSize(); first += maxLinesPerDraw)
+		{
+			const size_t count = std::min(maxLinesPerDraw, debugLines.GetSize() - first);
+			GLStreamingBuffer::Allocation allocation = streamingBuffer.Allocate(count * 2 * sizeof(DebugVertex), sizeof(DebugVertex));
+			DebugVertex* vertices = static_cast<DebugVertex*>(allocation.Data);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const DebugDrawLinesComponent::DebugLine& line = debugLines[first + i];
+				const DebugDrawLinesComponent::DebugLineColor& color = debugLinesColors[first + i];
+				vertices[2 * i] = DebugVertex{ { line.Begin.X, line.Begin.Y, line.Begin.Z }, { color.Begin.R, color.Begin.G, color.Begin.B, color.Begin.A } };
+				vertices[2 * i + 1] = DebugVertex{ { line.End.X, line.End.Y, line.End.Z }, { color.End.R, color.End.G, color.End.B, color.End.A } };
+			}
+			streamingBuffer.Commit();
 
-		glDrawArrays(GL_LINES, 0, (GLsizei)debugLines.GetSize() * 2);
+			glDrawArrays(GL_LINES, (GLint)(allocation.Offset / sizeof(DebugVertex)), (GLsizei)(count * 2));
+		}
 		glBindVertexArray(0);
 
 		debugLines.Clear();
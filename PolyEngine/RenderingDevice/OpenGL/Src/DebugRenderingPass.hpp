@@ -13,8 +13,19 @@ namespace Poly
 	{
 	public:
 		DebugRenderingPass();
+		~DebugRenderingPass();
 
 	protected:
 		void OnRun(World* world, const CameraComponent* camera, const AARect& rect, ePassType passType) override final;
+
+	private:
+		struct DebugVertex
+		{
+			float Position[3];
+			float Color[4];
+		};
+
+		// reads line vertices from the streaming vertex buffer
+		GLuint VAO = 0;
 	};
 }
\ No newline at end of file
@@ -1,9 +1,12 @@
 #include "GLMeshDeviceProxy.hpp"
 #include "Vector3f.hpp"
+#include "Matrix.hpp"
 #include "GLUtils.hpp"
 
 using namespace Poly;
 
+constexpr GLuint GLMeshDeviceProxy::INSTANCE_TRANSFORM_ATTRIBUTE;
+
 //---------------------------------------------------------------
 GLMeshDeviceProxy::GLMeshDeviceProxy()
 {
@@ -46,6 +49,38 @@ void GLMeshDeviceProxy::SetContent(const Mesh& mesh)
 
 	ASSERTE(mesh.HasVertices() && mesh.HasIndicies(), "Meshes that does not contain vertices and faces are not supported yet!");
 
+	if (mesh.GetVertexFormat().Interleaved)
+		SetInterleavedVertices(mesh);
+	else
+		SetSeparateVertices(mesh);
+
+	if (mesh.HasIndicies())
+	{
+		// packed meshes are uploaded directly from their memory
+		Dynarray<u8> packedIndices;
+		const u8* indices = mesh.GetPackedContent().Indices;
+		if (!mesh.IsPacked())
+		{
+			mesh.PackIndices(packedIndices);
+			indices = packedIndices.GetData();
+		}
+		IndexType = mesh.GetVertexFormat().ShortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+		// element array binding is part of the vertex array state, it does not take vertex attributes
+		EnsureVBOCreated(eBufferType::INDEX_BUFFER);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, VBO[eBufferType::INDEX_BUFFER]);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.GetTriangleCount() * 3 * mesh.GetIndexSize(), indices, GL_STATIC_DRAW);
+		CHECK_GL_ERR();
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+//---------------------------------------------------------------
+void GLMeshDeviceProxy::SetSeparateVertices(const Mesh& mesh)
+{
+	ASSERTE(!mesh.IsPacked(), "Packed meshes have to be interleaved!");
 	if (mesh.HasVertices()) {
 		EnsureVBOCreated(eBufferType::VERTEX_BUFFER);
 		glBindBuffer(GL_ARRAY_BUFFER, VBO[eBufferType::VERTEX_BUFFER]);
@@ -72,20 +107,57 @@ void GLMeshDeviceProxy::SetContent(const Mesh& mesh)
 		glEnableVertexAttribArray(2);
 		CHECK_GL_ERR();
 	}
+}
 
-	if (mesh.HasIndicies())
+//---------------------------------------------------------------
+void GLMeshDeviceProxy::SetInterleavedVertices(const Mesh& mesh)
+{
+	const VertexFormat& format = mesh.GetVertexFormat();
+	const GLsizei stride = static_cast<GLsizei>(mesh.GetVertexStride());
+
+	Dynarray<u8> packedVertices;
+	const u8* vertices = mesh.GetPackedContent().Vertices;
+	if (!mesh.IsPacked())
 	{
-		EnsureVBOCreated(eBufferType::INDEX_BUFFER);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, VBO[eBufferType::INDEX_BUFFER]);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.GetIndicies().GetSize() * sizeof(GLuint), mesh.GetIndicies().GetData(), GL_STATIC_DRAW);
+		mesh.PackVertices(packedVertices);
+		vertices = packedVertices.GetData();
+	}
 
-		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(3);
-		CHECK_GL_ERR();
+	EnsureVBOCreated(eBufferType::VERTEX_BUFFER);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO[eBufferType::VERTEX_BUFFER]);
+	glBufferData(GL_ARRAY_BUFFER, mesh.GetVertexCount() * stride, vertices, GL_STATIC_DRAW);
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, NULL);
+	glEnableVertexAttribArray(0);
+
+	if (mesh.HasTextCoords()) {
+		glVertexAttribPointer(1, 2, format.HalfTextCoords ? GL_HALF_FLOAT : GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(mesh.GetTextCoordOffset()));
+		glEnableVertexAttribArray(1);
 	}
 
+	if (mesh.HasNormals()) {
+		if (format.PackedNormals)
+			glVertexAttribPointer(2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, reinterpret_cast<const void*>(mesh.GetNormalOffset()));
+		else
+			glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(mesh.GetNormalOffset()));
+		glEnableVertexAttribArray(2);
+	}
+	CHECK_GL_ERR();
+}
+
+//---------------------------------------------------------------
+void GLMeshDeviceProxy::BindInstanceAttributes(GLuint instanceBuffer, size_t offset)
+{
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+	for (GLuint column = 0; column < 4; ++column)
+	{
+		const GLuint attribute = INSTANCE_TRANSFORM_ATTRIBUTE + column;
+		glVertexAttribPointer(attribute, 4, GL_FLOAT, GL_FALSE, sizeof(Matrix), reinterpret_cast<const void*>(offset + column * 4 * sizeof(float)));
+		glVertexAttribDivisor(attribute, 1);
+		glEnableVertexAttribArray(attribute);
+	}
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	CHECK_GL_ERR();
 }
 
 //---------------------------------------------------------------
@@ -24,10 +24,25 @@ namespace Poly
 		void SetContent(const Mesh& mesh);
 
 		GLuint GetVAO() const { return VAO; }
+
+		/// <summary>Returns type of indices passed to glDrawElements.</summary>
+		GLenum GetIndexType() const { return IndexType; }
+
+		// first of 4 consecutive attribute locations holding columns of per instance transformation matrix
+		static constexpr GLuint INSTANCE_TRANSFORM_ATTRIBUTE = 4;
+
+		/// <summary>Points per instance attributes of the currently bound vertex array at transformations stored in the buffer.
+		/// Instance N of the following instanced draw call uses matrix at index N after the offset.</summary>
+		/// <param name="instanceBuffer">Buffer with column major matrices.</param>
+		/// <param name="offset">Offset of the first matrix in bytes.</param>
+		static void BindInstanceAttributes(GLuint instanceBuffer, size_t offset);
 	private:
 		void EnsureVBOCreated(eBufferType type);
+		void SetSeparateVertices(const Mesh& mesh);
+		void SetInterleavedVertices(const Mesh& mesh);
 
 		GLuint VAO = 0;
+		GLenum IndexType = GL_UNSIGNED_INT;
 		EnumArray<GLuint, eBufferType> VBO;
 
 		friend class GLRenderingDevice;
@@ -9,6 +9,7 @@
 #include "GLCubemapDeviceProxy.hpp"
 #include "GLTextFieldBufferDeviceProxy.hpp"
 #include "GLMeshDeviceProxy.hpp"
+#include "GLStreamingBuffer.hpp"
 
 #include "UnlitRenderingPass.hpp"
 #include "BlinnPhongRenderingPass.hpp"
@@ -24,6 +25,12 @@
 
 using namespace Poly;
 
+namespace
+{
+	// vertices of immediate debug drawing and texts for a few frames in flight
+	const size_t STREAMING_VERTEX_BUFFER_SIZE = 4 * 1024 * 1024;
+}
+
 GLRenderingDevice* Poly::gRenderingDevice = nullptr;
 
 IRenderingDevice* POLY_STDCALL PolyCreateRenderingDevice(SDL_Window* window, const Poly::ScreenSize& size) { return new GLRenderingDevice(window, size); }
@@ -72,6 +79,8 @@ GLRenderingDevice::~GLRenderingDevice()
 //------------------------------------------------------------------------------
 void GLRenderingDevice::EndFrame()
 {
+	StreamingVertexBuffer->EndFrame();
+	LastFrameStats = CurrentFrameStats;
 	if(Window && Context)
 		SDL_GL_SwapWindow(Window);
 }
@@ -134,6 +143,7 @@ void GLRenderingDevice::InitPrograms()
 {
 	PostprocessRenderingQuad = std::make_unique<PostprocessQuad>();
 	PrimitiveRenderingCube = std::make_unique<PrimitiveCube>();
+	StreamingVertexBuffer = std::make_unique<GLStreamingBuffer>(GL_ARRAY_BUFFER, STREAMING_VERTEX_BUFFER_SIZE);
 	
 	// Init input textures
 	//Texture2DInputTarget* RGBANoise256 = CreateRenderingTarget<Texture2DInputTarget>("Textures/RGBANoise256x256.png");
@@ -173,6 +183,7 @@ void Poly::GLRenderingDevice::CleanUpResources()
 
 	PostprocessRenderingQuad.reset();
 	PrimitiveRenderingCube.reset();
+	StreamingVertexBuffer.reset();
 }
 
 //------------------------------------------------------------------------------
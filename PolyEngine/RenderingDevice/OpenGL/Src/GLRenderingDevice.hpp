@@ -16,6 +16,7 @@ namespace Poly
 	struct PrimitiveCube;
 	class RenderingPassBase;
 	class RenderingTargetBase;
+	class GLStreamingBuffer;
 
 	class DEVICE_DLLEXPORT GLRenderingDevice : public IRenderingDevice
 	{
@@ -60,7 +61,17 @@ namespace Poly
 		void Resize(const ScreenSize& size) override;
 		const ScreenSize& GetScreenSize() const override { return ScreenDim; }
 
-		void RenderWorld(World* world) override;
+		void RenderWorld(World* world, const RenderCommandList& commands) override;
+		const RenderingStats& GetLastFrameStats() const override { return LastFrameStats; }
+
+		/// <summary>Returns counters of the frame being rendered, updated by rendering passes.</summary>
+		RenderingStats& GetCurrentFrameStats() { return CurrentFrameStats; }
+
+		/// <summary>Returns command list passed to RenderWorld(), valid while the world is rendered.</summary>
+		const RenderCommandList& GetRenderCommands() const { ASSERTE(RenderCommands, "Not rendering a world!"); return *RenderCommands; }
+
+		/// <summary>Returns ring buffer for vertices generated every frame, valid after Init().</summary>
+		GLStreamingBuffer& GetStreamingVertexBuffer() { return *StreamingVertexBuffer; }
 		void Init() override;
 
 		std::unique_ptr<ITextureDeviceProxy> CreateTexture(size_t width, size_t height, eTextureUsageType usage) override;
@@ -102,6 +113,10 @@ namespace Poly
 		SDL_GLContext Context;
 		ScreenSize ScreenDim;
 
+		const RenderCommandList* RenderCommands = nullptr;
+		RenderingStats CurrentFrameStats;
+		RenderingStats LastFrameStats;
+
 		Dynarray<std::unique_ptr<RenderingTargetBase>> RenderingTargets;
 
 		EnumArray<std::unique_ptr<RenderingPassBase>, eGeometryRenderPassType> GeometryRenderingPasses;
@@ -109,6 +124,7 @@ namespace Poly
 
 		std::unique_ptr<PostprocessQuad> PostprocessRenderingQuad;
 		std::unique_ptr<PrimitiveCube> PrimitiveRenderingCube;
+		std::unique_ptr<GLStreamingBuffer> StreamingVertexBuffer;
 	};
 
 	extern GLRenderingDevice* gRenderingDevice;
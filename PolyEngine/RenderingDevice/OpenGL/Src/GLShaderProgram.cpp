@@ -1,5 +1,6 @@
 #include "GLShaderProgram.hpp"
 #include "GLUtils.hpp"
+#include "GLRenderingDevice.hpp"
 
 SILENCE_MSVC_WARNING(4805, "Warning originates in std::regex");
 #include <regex>
@@ -46,6 +47,7 @@ GLShaderProgram::GLShaderProgram(const String& vertex, const String& geometry, c
 void GLShaderProgram::BindProgram() const
 {
 	glUseProgram(ProgramHandle);
+	++gRenderingDevice->GetCurrentFrameStats().ProgramBinds;
 }
 
 //------------------------------------------------------------------------------
@@ -126,7 +128,7 @@ size_t GLShaderProgram::GetProgramHandle() const
 //------------------------------------------------------------------------------
 void GLShaderProgram::RegisterUniform(const String& type, const String& name)
 {
-	if (Uniforms.find(name) != Uniforms.end())
+	if (Uniforms.Contains(name))
 		return;
 
 	GLint location = 0;
@@ -136,76 +138,113 @@ void GLShaderProgram::RegisterUniform(const String& type, const String& name)
 		gConsole.LogError("Invalid uniform location for {}. Probably optimized out.", name);
 		return;
 	}
-	Uniforms[name] = UniformInfo(type, location);
+	Uniforms.Register(type, name, location);
+	CHECK_GL_ERR();
+}
+
+//------------------------------------------------------------------------------
+void GLShaderProgram::BindUniformBlock(const String& blockName, GLuint bindingPoint)
+{
+	GLuint index = glGetUniformBlockIndex(ProgramHandle, blockName.GetCStr());
+	if (index == GL_INVALID_INDEX)
+	{
+		gConsole.LogError("Invalid uniform block index for {}. Probably optimized out.", blockName);
+		return;
+	}
+	glUniformBlockBinding(ProgramHandle, index, bindingPoint);
 	CHECK_GL_ERR();
 }
 
 //------------------------------------------------------------------------------
 void GLShaderProgram::SetUniform(const String& name, int val)
 {
-	auto it = Uniforms.find(name);
-	if (it != Uniforms.end())
+	if (const UniformRegistry::UniformInfo* uniform = Uniforms.Find(name))
 	{
-		HEAVY_ASSERTE(it->second.TypeName == "int" || it->second.TypeName == "sampler2D", "Invalid uniform type!");
-		glUniform1i(it->second.Location, val);
+		HEAVY_ASSERTE(UniformRegistry::IsTypeCompatible<int>(uniform->TypeName), "Invalid uniform type!");
+		glUniform1i(uniform->Location, val);
 	}
 }
 
 //------------------------------------------------------------------------------
 void GLShaderProgram::SetUniform(const String& name, float val)
 {
-	auto it = Uniforms.find(name);
-	if (it != Uniforms.end())
+	if (const UniformRegistry::UniformInfo* uniform = Uniforms.Find(name))
 	{
-		HEAVY_ASSERTE(it->second.TypeName == "float", "Invalid uniform type!");
-		glUniform1f(it->second.Location, val);
+		HEAVY_ASSERTE(UniformRegistry::IsTypeCompatible<float>(uniform->TypeName), "Invalid uniform type!");
+		glUniform1f(uniform->Location, val);
 	}
 }
 
 //------------------------------------------------------------------------------
 void GLShaderProgram::SetUniform(const String & name, float val1, float val2)
 {
-	auto it = Uniforms.find(name);
-	if (it != Uniforms.end())
+	if (const UniformRegistry::UniformInfo* uniform = Uniforms.Find(name))
 	{
-		HEAVY_ASSERTE(it->second.TypeName == "vec2", "Invalid uniform type!");
-		glUniform2f(it->second.Location, val1, val2);
+		HEAVY_ASSERTE(uniform->TypeName == "vec2", "Invalid uniform type!");
+		glUniform2f(uniform->Location, val1, val2);
 	}
 }
 
 //------------------------------------------------------------------------------
 void GLShaderProgram::SetUniform(const String& name, const Vector& val)
 {
-	auto it = Uniforms.find(name);
-	if (it != Uniforms.end())
+	if (const UniformRegistry::UniformInfo* uniform = Uniforms.Find(name))
 	{
-		HEAVY_ASSERTE(it->second.TypeName == "vec4", "Invalid uniform type!");
-		glUniform4f(it->second.Location, val.X, val.Y, val.Z, val.W);
+		HEAVY_ASSERTE(UniformRegistry::IsTypeCompatible<Vector>(uniform->TypeName), "Invalid uniform type!");
+		glUniform4f(uniform->Location, val.X, val.Y, val.Z, val.W);
 	}
 }
 
 //------------------------------------------------------------------------------
 void GLShaderProgram::SetUniform(const String& name, const Color& val)
 {
-	auto it = Uniforms.find(name);
-	if (it != Uniforms.end())
+	if (const UniformRegistry::UniformInfo* uniform = Uniforms.Find(name))
 	{
-		HEAVY_ASSERTE(it->second.TypeName == "vec4", "Invalid uniform type!");
-		glUniform4f(it->second.Location, val.R, val.G, val.B, val.A);
+		HEAVY_ASSERTE(UniformRegistry::IsTypeCompatible<Color>(uniform->TypeName), "Invalid uniform type!");
+		glUniform4f(uniform->Location, val.R, val.G, val.B, val.A);
 	}
 }
 
 //------------------------------------------------------------------------------
 void GLShaderProgram::SetUniform(const String& name, const Matrix& val)
 {
-	auto it = Uniforms.find(name);
-	if (it != Uniforms.end())
+	if (const UniformRegistry::UniformInfo* uniform = Uniforms.Find(name))
 	{
-		HEAVY_ASSERTE(it->second.TypeName == "mat4", "Invalid uniform type!");
-		glUniformMatrix4fv(it->second.Location, 1, GL_FALSE, val.GetTransposed().GetDataPtr());
+		HEAVY_ASSERTE(UniformRegistry::IsTypeCompatible<Matrix>(uniform->TypeName), "Invalid uniform type!");
+		glUniformMatrix4fv(uniform->Location, 1, GL_FALSE, val.GetTransposed().GetDataPtr());
 	}
 }
 
+//------------------------------------------------------------------------------
+void GLShaderProgram::SetUniform(UniformHandle<int> uniform, int val)
+{
+	glUniform1i(uniform.Location, val);
+}
+
+//------------------------------------------------------------------------------
+void GLShaderProgram::SetUniform(UniformHandle<float> uniform, float val)
+{
+	glUniform1f(uniform.Location, val);
+}
+
+//------------------------------------------------------------------------------
+void GLShaderProgram::SetUniform(UniformHandle<Vector> uniform, const Vector& val)
+{
+	glUniform4f(uniform.Location, val.X, val.Y, val.Z, val.W);
+}
+
+//------------------------------------------------------------------------------
+void GLShaderProgram::SetUniform(UniformHandle<Color> uniform, const Color& val)
+{
+	glUniform4f(uniform.Location, val.R, val.G, val.B, val.A);
+}
+
+//------------------------------------------------------------------------------
+void GLShaderProgram::SetUniform(UniformHandle<Matrix> uniform, const Matrix& val)
+{
+	glUniformMatrix4fv(uniform.Location, 1, GL_FALSE, val.GetTransposed().GetDataPtr());
+}
+
 //------------------------------------------------------------------------------
 GLenum GLShaderProgram::GetEnumFromShaderUnitType(eShaderUnitType type)
 {
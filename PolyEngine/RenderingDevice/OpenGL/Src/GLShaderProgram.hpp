@@ -2,6 +2,7 @@
 
 #include <map>
 #include <Core.hpp>
+#include <UniformRegistry.hpp>
 
 typedef unsigned int GLuint;
 typedef unsigned int GLenum;
@@ -17,15 +18,6 @@ namespace Poly {
 			_COUNT
 		};
 
-		struct UniformInfo
-		{
-			UniformInfo() {}
-			UniformInfo(const String& type, int location) : TypeName(type), Location(location) {}
-
-			String TypeName;
-			int Location = 0;
-		};
-
 		struct OutputInfo
 		{
 			OutputInfo() {}
@@ -49,10 +41,27 @@ namespace Poly {
 		void SetUniform(const String& name, const Color& val);
 		void SetUniform(const String& name, const Matrix& val);
 
+		/// <summary>Resolves registered uniform, so it can be set without name lookup.</summary>
+		/// <param name="name">Name of the uniform.</param>
+		/// <returns>Handle of the uniform, invalid when the uniform is not registered.</returns>
+		template<typename T>
+		UniformHandle<T> GetUniform(const String& name) const { return Uniforms.GetUniform<T>(name); }
+
+		void SetUniform(UniformHandle<int> uniform, int val);
+		void SetUniform(UniformHandle<float> uniform, float val);
+		void SetUniform(UniformHandle<Vector> uniform, const Vector& val);
+		void SetUniform(UniformHandle<Color> uniform, const Color& val);
+		void SetUniform(UniformHandle<Matrix> uniform, const Matrix& val);
+
 		const std::map<String, OutputInfo>& GetOutputsInfo() const { return Outputs; }
-		const std::map<String, UniformInfo>& GetUniformsInfo() const { return Uniforms; }
+		const std::map<String, UniformRegistry::UniformInfo>& GetUniformsInfo() const { return Uniforms.GetUniformsInfo(); }
 
 		void RegisterUniform(const String& type, const String& name);
+
+		/// <summary>Connects uniform block of the program with the binding point, where uniform buffer is bound.</summary>
+		/// <param name="blockName">Name of the block (not of its instance).</param>
+		/// <param name="bindingPoint">Index passed to GLUniformBuffer::Bind.</param>
+		void BindUniformBlock(const String& blockName, GLuint bindingPoint);
 	private:
 		void CompileProgram();
 		void Validate();
@@ -62,7 +71,7 @@ namespace Poly {
 
 		void AnalyzeShaderCode(eShaderUnitType type);
 
-		std::map<String, UniformInfo> Uniforms;
+		UniformRegistry Uniforms;
 		std::map<String, OutputInfo> Outputs;
 		GLuint ProgramHandle;
 		EnumArray<String, eShaderUnitType> ShaderCode;
@@ -71,4 +80,4 @@ namespace Poly {
 		String GeometryProgramPath;
 		String FragmentProgramPath;
 	};
-}
+}
\ No newline at end of file
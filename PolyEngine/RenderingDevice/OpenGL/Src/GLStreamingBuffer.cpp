@@ -0,0 +1,116 @@
+#include "GLStreamingBuffer.hpp"
+#include "GLRenderingDevice.hpp"
+
+using namespace Poly;
+
+//------------------------------------------------------------------------------
+GLStreamingBuffer::GLStreamingBuffer(GLenum target, size_t capacity)
+	: Target(target), Ring(capacity)
+{
+	glGenBuffers(1, &Buffer);
+	ASSERTE(Buffer > 0, "GLStreamingBuffer buffer creation failed!");
+	glBindBuffer(Target, Buffer);
+
+	if (epoxy_gl_version() >= 44 || epoxy_has_gl_extension("GL_ARB_buffer_storage"))
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(Target, capacity, nullptr, flags);
+		PersistentData = static_cast<u8*>(glMapBufferRange(Target, 0, capacity, flags));
+		ASSERTE(PersistentData, "GLStreamingBuffer persistent mapping failed!");
+	}
+	else
+	{
+		glBufferData(Target, capacity, nullptr, GL_STREAM_DRAW);
+	}
+
+	glBindBuffer(Target, 0);
+	CHECK_GL_ERR();
+}
+
+//------------------------------------------------------------------------------
+GLStreamingBuffer::~GLStreamingBuffer()
+{
+	while (!Fences.IsEmpty())
+	{
+		glDeleteSync(Fences.Front());
+		Fences.PopFront();
+	}
+
+	if (Buffer)
+	{
+		if (PersistentData || Mapped)
+		{
+			glBindBuffer(Target, Buffer);
+			glUnmapBuffer(Target);
+			glBindBuffer(Target, 0);
+		}
+		glDeleteBuffers(1, &Buffer);
+	}
+}
+
+//------------------------------------------------------------------------------
+GLStreamingBuffer::Allocation GLStreamingBuffer::Allocate(size_t size, size_t alignment)
+{
+	Commit();
+
+	// wait until the GPU is done with data previously stored in the range
+	size_t offset;
+	while ((offset = Ring.Allocate(size, alignment)) == RingAllocator::INVALID_OFFSET)
+	{
+		if (Ring.GetPendingBatchCount() == 0)
+			EndFrame(); // whole ring is used by the current frame
+		WaitForOldestFence();
+	}
+
+	if (PersistentData)
+		return Allocation{ PersistentData + offset, offset };
+
+	glBindBuffer(Target, Buffer);
+	void* data = glMapBufferRange(Target, offset, size, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+	glBindBuffer(Target, 0);
+	ASSERTE(data, "GLStreamingBuffer mapping failed!");
+	Mapped = true;
+	return Allocation{ data, offset };
+}
+
+//------------------------------------------------------------------------------
+void GLStreamingBuffer::Commit()
+{
+	// persistent mapping is coherent, writes are visible to commands issued after them
+	if (!Mapped)
+		return;
+
+	glBindBuffer(Target, Buffer);
+	glUnmapBuffer(Target);
+	glBindBuffer(Target, 0);
+	Mapped = false;
+}
+
+//------------------------------------------------------------------------------
+void GLStreamingBuffer::EndFrame()
+{
+	Commit();
+	if (Ring.EndBatch())
+		Fences.PushBack(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+}
+
+//------------------------------------------------------------------------------
+void GLStreamingBuffer::WaitForOldestFence()
+{
+	ASSERTE(!Fences.IsEmpty(), "No streaming buffer fences to wait for!");
+	GLsync fence = Fences.Front();
+	GLenum result = glClientWaitSync(fence, 0, 0);
+	if (result == GL_TIMEOUT_EXPIRED)
+	{
+		++gRenderingDevice->GetCurrentFrameStats().StreamingBufferWaits;
+		do
+		{
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+		} while (result == GL_TIMEOUT_EXPIRED);
+	}
+	ASSERTE(result != GL_WAIT_FAILED, "Waiting for streaming buffer fence failed!");
+
+	glDeleteSync(fence);
+	Fences.PopFront();
+	Ring.ReleaseOldestBatch();
+}
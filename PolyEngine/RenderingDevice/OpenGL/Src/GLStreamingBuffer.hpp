@@ -0,0 +1,52 @@
+#pragma once
+
+#include "GLUtils.hpp"
+#include <RingAllocator.hpp>
+
+namespace Poly
+{
+	/// <summary>Ring buffer for vertex data regenerated every frame, shared by immediate debug drawing and text rendering.
+	/// Data is written directly into mapped memory at increasing offsets. Fences inserted at the end of every frame
+	/// guard regions still read by the GPU, so the buffer is never orphaned and CPU waits only when it wraps onto them.
+	/// Buffer is mapped persistently when ARB_buffer_storage is available, otherwise each allocation is mapped unsynchronized.</summary>
+	class GLStreamingBuffer : public BaseObject<>
+	{
+	public:
+		/// <summary>Write-only memory of the allocation and its offset in bytes from the start of the buffer.</summary>
+		struct Allocation
+		{
+			void* Data;
+			size_t Offset;
+		};
+
+		GLStreamingBuffer(GLenum target, size_t capacity);
+		~GLStreamingBuffer();
+
+		/// <summary>Allocates memory for data used in the current frame.</summary>
+		/// <param name="alignment">Offset of the allocation is multiple of alignment, for example vertex stride, so
+		/// first vertex of the allocation is Offset / stride.</param>
+		Allocation Allocate(size_t size, size_t alignment);
+
+		/// <summary>Makes data written to the last allocation visible to the GPU. Has to be called before draw calls using it.</summary>
+		void Commit();
+
+		/// <summary>Marks end of the frame, memory allocated so far is reused after GPU finishes reading it.</summary>
+		void EndFrame();
+
+		GLuint GetBuffer() const { return Buffer; }
+		size_t GetCapacity() const { return Ring.GetCapacity(); }
+		bool IsPersistentlyMapped() const { return PersistentData != nullptr; }
+
+	private:
+		void WaitForOldestFence();
+
+		GLenum Target;
+		GLuint Buffer = 0;
+		u8* PersistentData = nullptr;
+		bool Mapped = false;
+
+		RingAllocator Ring;
+		// one fence for every pending batch of the ring
+		Queue<GLsync> Fences;
+	};
+}
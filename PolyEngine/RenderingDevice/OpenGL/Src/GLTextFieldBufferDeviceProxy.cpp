@@ -3,39 +3,7 @@
 
 using namespace Poly;
 
-//---------------------------------------------------------------
-GLTextFieldBufferDeviceProxy::GLTextFieldBufferDeviceProxy()
-{
-	glGenVertexArrays(1, &VAO);
-	if(VAO <= 0)
-		throw RenderingDeviceProxyCreationFailedException();
-
-	glGenBuffers(1, &VBO);
-	if (VBO <= 0)
-		throw RenderingDeviceProxyCreationFailedException();
-
-	glBindVertexArray(VAO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), 0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (void*)(4 * sizeof(GLfloat)));
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-	CHECK_GL_ERR();
-}
-
-//---------------------------------------------------------------
-GLTextFieldBufferDeviceProxy::~GLTextFieldBufferDeviceProxy()
-{
-	if (VBO)
-		glDeleteBuffers(1, &VBO);
-
-	if (VAO)
-		glDeleteVertexArrays(1, &VAO);
-}
+constexpr size_t GLTextFieldBufferDeviceProxy::VERTEX_STRIDE;
 
 //---------------------------------------------------------------
 void GLTextFieldBufferDeviceProxy::SetContent(size_t count, const TextFieldLetter* letters)
@@ -44,7 +12,8 @@ void GLTextFieldBufferDeviceProxy::SetContent(size_t count, const TextFieldLette
 
 	Size = count;
 
-	Dynarray<float> vboData(count * 36);
+	Vertices.Clear();
+	Vertices.Reserve(count * 36);
 	for (size_t i = 0; i < count; ++i)
 	{
 		GLfloat xpos = letters[i].PosX;
@@ -67,11 +36,6 @@ void GLTextFieldBufferDeviceProxy::SetContent(size_t count, const TextFieldLette
 		};
 
 		for (int k = 0; k < 36; ++k)
-			vboData.PushBack(vertices[k]);
+			Vertices.PushBack(vertices[k]);
 	}
-
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * vboData.GetSize(), vboData.GetData(), GL_DYNAMIC_DRAW);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	CHECK_GL_ERR();
 }
@@ -5,19 +5,20 @@
 
 namespace Poly
 {
+	/// <summary>Keeps quads of text letters on CPU side, Text2DRenderingPass streams them to the GPU every frame
+	/// through GLRenderingDevice::GetStreamingVertexBuffer(), so changing text never reallocates GL buffers.</summary>
 	class GLTextFieldBufferDeviceProxy : public ITextFieldBufferDeviceProxy
 	{
 	public:
-		GLTextFieldBufferDeviceProxy();
-		virtual ~GLTextFieldBufferDeviceProxy();
+		/// <summary>Vertex layout: position (4 floats) followed by texture coordinates (2 floats).</summary>
+		static constexpr size_t VERTEX_STRIDE = 6 * sizeof(GLfloat);
 
 		void SetContent(size_t count, const TextFieldLetter* letters);
 
-		GLuint GetVAO() const { return VAO; }
+		const Dynarray<GLfloat>& GetVertices() const { return Vertices; }
 		size_t GetSize() const { return Size; }
 	private:
-		GLuint VAO = 0;
-		GLuint VBO = 0;
+		Dynarray<GLfloat> Vertices;
 		size_t Size = 0;
 
 		friend class GLRenderingDevice;
@@ -0,0 +1,60 @@
+#include "GLTextureBuffer.hpp"
+
+using namespace Poly;
+
+namespace
+{
+	// empty buffer textures are not allowed, so storage never goes below this size
+	const size_t MIN_BUFFER_SIZE = 16;
+}
+
+//------------------------------------------------------------------------------
+GLTextureBuffer::GLTextureBuffer(GLenum internalFormat)
+	: InternalFormat(internalFormat), Size(MIN_BUFFER_SIZE)
+{
+	glGenBuffers(1, &TBO);
+	ASSERTE(TBO > 0, "GLTextureBuffer TBO creation failed!");
+	glBindBuffer(GL_TEXTURE_BUFFER, TBO);
+	glBufferData(GL_TEXTURE_BUFFER, Size, nullptr, GL_STREAM_DRAW);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+	glGenTextures(1, &Texture);
+	ASSERTE(Texture > 0, "GLTextureBuffer texture creation failed!");
+	glBindTexture(GL_TEXTURE_BUFFER, Texture);
+	glTexBuffer(GL_TEXTURE_BUFFER, InternalFormat, TBO);
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+	CHECK_GL_ERR();
+}
+
+//------------------------------------------------------------------------------
+GLTextureBuffer::~GLTextureBuffer()
+{
+	if (Texture)
+		glDeleteTextures(1, &Texture);
+	if (TBO)
+		glDeleteBuffers(1, &TBO);
+}
+
+//------------------------------------------------------------------------------
+void GLTextureBuffer::Update(const void* data, size_t size)
+{
+	if (size == 0)
+		return;
+
+	glBindBuffer(GL_TEXTURE_BUFFER, TBO);
+	if (size > Size)
+		Size = size;
+	// orphan the storage, texture attachment stays valid as the buffer object is the same
+	glBufferData(GL_TEXTURE_BUFFER, Size, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+	CHECK_GL_ERR();
+}
+
+//------------------------------------------------------------------------------
+void GLTextureBuffer::Bind(GLuint textureUnit) const
+{
+	glActiveTexture(GL_TEXTURE0 + textureUnit);
+	glBindTexture(GL_TEXTURE_BUFFER, Texture);
+	glActiveTexture(GL_TEXTURE0);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "GLUtils.hpp"
+
+namespace Poly
+{
+	/// <summary>Buffer texture exposing array of CPU side data to shaders through texelFetch on samplerBuffer.
+	/// Used for data too large for uniform blocks, as shader storage buffers are not available in GLSL 3.30.</summary>
+	class GLTextureBuffer : public BaseObject<>
+	{
+	public:
+		/// <param name="internalFormat">Format of the texels, for example GL_RGBA32F or GL_R32UI.</param>
+		explicit GLTextureBuffer(GLenum internalFormat);
+		~GLTextureBuffer();
+
+		/// <summary>Uploads data to the buffer. Previous storage is orphaned, so update does not stall on draws still using it.</summary>
+		void Update(const void* data, size_t size);
+
+		template<typename T>
+		void Update(const Dynarray<T>& data) { Update(data.GetData(), data.GetSize() * sizeof(T)); }
+
+		/// <summary>Binds buffer texture to the texture unit.</summary>
+		void Bind(GLuint textureUnit) const;
+
+		size_t GetSize() const { return Size; }
+
+	private:
+		GLuint TBO = 0;
+		GLuint Texture = 0;
+		GLenum InternalFormat;
+		size_t Size = 0;
+	};
+}
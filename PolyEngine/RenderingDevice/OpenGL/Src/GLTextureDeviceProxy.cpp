@@ -1,6 +1,8 @@
 #include "GLTextureDeviceProxy.hpp"
 #include "GLUtils.hpp"
 
+#include <CookedTexture.hpp>
+
 using namespace Poly;
 
 //---------------------------------------------------------------
@@ -20,6 +22,37 @@ static GLenum GetGLDataFormat(eTextureDataFormat format) noexcept
 	return 0;
 }
 
+//---------------------------------------------------------------
+static GLenum GetGLCompressedFormat(eTextureDataFormat format) noexcept
+{
+	switch (format)
+	{
+	case Poly::eTextureDataFormat::BC1:
+		return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+	case Poly::eTextureDataFormat::BC3:
+		return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	case Poly::eTextureDataFormat::BC7:
+		return GL_COMPRESSED_RGBA_BPTC_UNORM;
+	default:
+		return 0;
+	}
+}
+
+//---------------------------------------------------------------
+static bool IsCompressedFormatSupported(eTextureDataFormat format)
+{
+	switch (format)
+	{
+	case Poly::eTextureDataFormat::BC1:
+	case Poly::eTextureDataFormat::BC3:
+		return epoxy_has_gl_extension("GL_EXT_texture_compression_s3tc");
+	case Poly::eTextureDataFormat::BC7:
+		return epoxy_gl_version() >= 42 || epoxy_has_gl_extension("GL_ARB_texture_compression_bptc");
+	default:
+		return false;
+	}
+}
+
 //---------------------------------------------------------------
 static GLenum GetGLInternalFormat(eTextureUsageType usage) noexcept
 {
@@ -77,6 +110,46 @@ void GLTextureDeviceProxy::SetContent(eTextureDataFormat format, const unsigned
 	CHECK_GL_ERR();
 }
 
+//---------------------------------------------------------------
+void GLTextureDeviceProxy::SetMipContent(eTextureDataFormat format, const Dynarray<TextureMip>& mips)
+{
+	ASSERTE(TextureID > 0, "Texture is invalid!");
+	ASSERTE(!mips.IsEmpty() && mips[0].Width == Width && mips[0].Height == Height, "Invalid arguments!");
+
+	const GLenum compressedFormat = GetGLCompressedFormat(format);
+	const bool uploadCompressed = compressedFormat != 0 && IsCompressedFormatSupported(format);
+	if (compressedFormat != 0 && !uploadCompressed)
+		gConsole.LogInfo("Compressed texture format is not supported by the device, decoding it on CPU.");
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, TextureID);
+
+	Dynarray<u8> decoded;
+	for (size_t level = 0; level < mips.GetSize(); ++level)
+	{
+		const TextureMip& mip = mips[level];
+		ASSERTE(mip.Data, "Data pointer is nullptr!");
+		if (uploadCompressed)
+		{
+			glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)level, compressedFormat, (GLsizei)mip.Width, (GLsizei)mip.Height, 0, (GLsizei)mip.Size, mip.Data);
+		}
+		else if (compressedFormat != 0)
+		{
+			decoded.Resize(mip.Width * mip.Height * 4);
+			CookedTexture::Decode(format, mip.Data, mip.Width, mip.Height, decoded.GetData());
+			glTexImage2D(GL_TEXTURE_2D, (GLint)level, InternalFormat, (GLsizei)mip.Width, (GLsizei)mip.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, decoded.GetData());
+		}
+		else
+		{
+			glTexImage2D(GL_TEXTURE_2D, (GLint)level, InternalFormat, (GLsizei)mip.Width, (GLsizei)mip.Height, 0, GetGLDataFormat(format), GL_UNSIGNED_BYTE, mip.Data);
+		}
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)mips.GetSize() - 1);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	CHECK_GL_ERR();
+}
+
 //---------------------------------------------------------------
 void GLTextureDeviceProxy::SetSubContent(size_t width, size_t height,
 	size_t offsetX, size_t offsetY, eTextureDataFormat format, const unsigned char* data)
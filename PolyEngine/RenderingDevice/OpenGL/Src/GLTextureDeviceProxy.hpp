@@ -24,6 +24,7 @@ namespace Poly
 		
 		void SetContent(eTextureDataFormat inputFormat, const unsigned char* data) override;
 		void SetSubContent(size_t width, size_t height, size_t offsetX, size_t offsetY, eTextureDataFormat format, const unsigned char* data) override;
+		void SetMipContent(eTextureDataFormat format, const Dynarray<TextureMip>& mips) override;
 
 		GLuint GetTextureID() const { return TextureID; }
 
@@ -0,0 +1,65 @@
+#include "GLUniformBuffer.hpp"
+
+using namespace Poly;
+
+//------------------------------------------------------------------------------
+GLUniformBuffer::GLUniformBuffer(size_t size)
+	: Size(size)
+{
+	glGenBuffers(1, &UBO);
+	ASSERTE(UBO > 0, "GLUniformBuffer UBO creation failed!");
+
+	glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+	glBufferData(GL_UNIFORM_BUFFER, Size, nullptr, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	CHECK_GL_ERR();
+}
+
+//------------------------------------------------------------------------------
+GLUniformBuffer::~GLUniformBuffer()
+{
+	if (UBO)
+		glDeleteBuffers(1, &UBO);
+}
+
+//------------------------------------------------------------------------------
+void GLUniformBuffer::Update(const void* data, size_t size)
+{
+	glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+	if (size > Size)
+	{
+		Size = size;
+		glBufferData(GL_UNIFORM_BUFFER, Size, data, GL_DYNAMIC_DRAW);
+	}
+	else
+	{
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	CHECK_GL_ERR();
+}
+
+//------------------------------------------------------------------------------
+void GLUniformBuffer::Bind(GLuint bindingPoint) const
+{
+	glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, UBO);
+}
+
+//------------------------------------------------------------------------------
+void GLUniformBuffer::BindRange(GLuint bindingPoint, size_t offset, size_t size) const
+{
+	HEAVY_ASSERTE(offset % GetOffsetAlignment() == 0 && offset + size <= Size, "Invalid uniform buffer range!");
+	glBindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, UBO, offset, size);
+}
+
+//------------------------------------------------------------------------------
+size_t GLUniformBuffer::GetOffsetAlignment()
+{
+	static const size_t alignment = []()
+	{
+		GLint value = 0;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &value);
+		return value > 0 ? static_cast<size_t>(value) : size_t(256);
+	}();
+	return alignment;
+}
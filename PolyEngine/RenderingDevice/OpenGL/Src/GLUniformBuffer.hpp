@@ -0,0 +1,38 @@
+#pragma once
+
+#include "GLUtils.hpp"
+
+namespace Poly
+{
+	/// <summary>Uniform buffer object filled from CPU side structures laid out according to std140 rules.</summary>
+	class GLUniformBuffer : public BaseObject<>
+	{
+	public:
+		/// <summary>Creates buffer with given initial size in bytes.</summary>
+		explicit GLUniformBuffer(size_t size);
+		~GLUniformBuffer();
+
+		/// <summary>Uploads data to the beginning of the buffer with single glBufferSubData call.
+		/// Buffer is reallocated when it is too small.</summary>
+		void Update(const void* data, size_t size);
+
+		template<typename T>
+		void Update(const T& data) { Update(&data, sizeof(T)); }
+
+		/// <summary>Binds whole buffer to the uniform block binding point.</summary>
+		void Bind(GLuint bindingPoint) const;
+
+		/// <summary>Binds part of the buffer to the uniform block binding point.</summary>
+		/// <param name="offset">Offset in bytes, has to be multiple of GetOffsetAlignment().</param>
+		void BindRange(GLuint bindingPoint, size_t offset, size_t size) const;
+
+		size_t GetSize() const { return Size; }
+
+		/// <summary>Returns alignment required for offsets passed to BindRange.</summary>
+		static size_t GetOffsetAlignment();
+
+	private:
+		GLuint UBO = 0;
+		size_t Size = 0;
+	};
+}
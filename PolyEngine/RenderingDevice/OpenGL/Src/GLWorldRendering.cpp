@@ -20,9 +20,11 @@
 using namespace Poly;
 
 //------------------------------------------------------------------------------
-void GLRenderingDevice::RenderWorld(World* world)
+void GLRenderingDevice::RenderWorld(World* world, const RenderCommandList& commands)
 {
+	RenderCommands = &commands;
 	const ScreenSize screenSize = gEngine->GetRenderingDevice()->GetScreenSize();
+	CurrentFrameStats = RenderingStats();
 
 	glDepthMask(GL_TRUE);
 	glEnable(GL_DEPTH_TEST);
@@ -78,6 +80,7 @@ void GLRenderingDevice::RenderWorld(World* world)
 
 	// Signal frame end
 	EndFrame();
+	RenderCommands = nullptr;
 }
 
 void GLRenderingDevice::RenderWireframe(World* world, const AARect& rect, CameraComponent* cameraCmp) const
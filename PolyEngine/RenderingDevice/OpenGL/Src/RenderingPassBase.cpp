@@ -2,8 +2,12 @@
 
 #include <ResourceManager.hpp>
 #include <TextureResource.hpp>
+#include <CameraComponent.hpp>
+#include <TransformComponent.hpp>
+#include <MeshRenderingComponent.hpp>
 
 #include "GLTextureDeviceProxy.hpp"
+#include "GLMeshDeviceProxy.hpp"
 #include "GLRenderingDevice.hpp"
 
 
@@ -106,6 +110,145 @@ Poly::RenderingPassBase::~RenderingPassBase()
 {
 	if(FBO > 0)
 		glDeleteFramebuffers(1, &FBO);
+	if (InstanceVBO > 0)
+		glDeleteBuffers(1, &InstanceVBO);
+}
+
+//------------------------------------------------------------------------------
+void RenderingPassBase::QueueVisibleSubMeshes(const CameraComponent* camera, ePassType passType, bool useTextures,
+	const std::function<bool(const MeshRenderingComponent*)>& filter)
+{
+	DrawItems.Clear();
+	DrawQueue.Clear();
+
+	const RenderCommandList::View* view = gRenderingDevice->GetRenderCommands().FindView(camera);
+	if (!view)
+		return;
+
+	// recorded packets are sorted by texture, mesh and depth, a filtered subsequence stays sorted,
+	// so only pass and shader fields, equal for all items of the pass, are added to their keys
+	const u32 shader = static_cast<u32>(GetProgram().GetProgramHandle());
+	const u64 passKey = RenderQueue::MakeSortKey(static_cast<u32>(passType), shader, 0, 0, 0.0f);
+	for (const RenderQueue::Entry& entry : view->Queue.GetEntries())
+	{
+		const RenderCommandList::DrawPacket& packet = view->Packets[entry.Index];
+		if (!filter(packet.Mesh))
+			continue;
+
+		const GLMeshDeviceProxy* meshProxy = static_cast<const GLMeshDeviceProxy*>(packet.MeshProxy);
+		GLuint texture = 0;
+		if (useTextures)
+		{
+			texture = packet.Texture == nullptr
+				? FallbackWhiteTexture
+				: static_cast<const GLTextureDeviceProxy*>(packet.Texture)->GetTextureID();
+		}
+
+		DrawQueue.Push(passKey | entry.SortKey, static_cast<u32>(DrawItems.GetSize()));
+		DrawItems.PushBack(DrawItem{ packet.Mesh, &packet.Transform, packet.SubMeshIdx, meshProxy->GetVAO(), texture,
+			static_cast<GLsizei>(packet.IndexCount), meshProxy->GetIndexType() });
+	}
+}
+
+//------------------------------------------------------------------------------
+void RenderingPassBase::BindVertexArray(GLuint vao)
+{
+	if (vao == BoundVAO)
+		return;
+	glBindVertexArray(vao);
+	BoundVAO = vao;
+	++gRenderingDevice->GetCurrentFrameStats().VertexArrayBinds;
+}
+
+//------------------------------------------------------------------------------
+void RenderingPassBase::BindTexture(GLuint texture)
+{
+	if (texture == BoundTexture)
+		return;
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	BoundTexture = texture;
+	++gRenderingDevice->GetCurrentFrameStats().TextureBinds;
+}
+
+//------------------------------------------------------------------------------
+void RenderingPassBase::Draw(const DrawItem& item, bool useTexture)
+{
+	BindVertexArray(item.VAO);
+	if (useTexture)
+		BindTexture(item.Texture);
+	glDrawElements(GL_TRIANGLES, item.IndexCount, item.IndexType, NULL);
+	++gRenderingDevice->GetCurrentFrameStats().DrawCalls;
+}
+
+//------------------------------------------------------------------------------
+void RenderingPassBase::BuildDrawBatches(const std::function<bool(const DrawItem&, const DrawItem&)>& canBatch)
+{
+	DrawBatches.Clear();
+	InstanceTransforms.Clear();
+
+	const Dynarray<RenderQueue::Entry>& entries = DrawQueue.GetEntries();
+	if (entries.IsEmpty())
+		return;
+
+	// instances are stored in queue order, so batch instances start at index of its first entry
+	InstanceTransforms.Reserve(entries.GetSize());
+	for (size_t i = 0; i < entries.GetSize(); ++i)
+	{
+		const DrawItem& item = DrawItems[entries[i].Index];
+		InstanceTransforms.PushBack(item.Transform->GetTransposed());
+
+		if (!DrawBatches.IsEmpty())
+		{
+			DrawBatch& batch = DrawBatches[DrawBatches.GetSize() - 1];
+			const DrawItem& first = DrawItems[entries[batch.FirstEntry].Index];
+			if (first.VAO == item.VAO && first.Texture == item.Texture && first.IndexCount == item.IndexCount && canBatch(first, item))
+			{
+				++batch.InstanceCount;
+				continue;
+			}
+		}
+		DrawBatches.PushBack(DrawBatch{ i, 1 });
+	}
+
+	if (!InstanceVBO)
+	{
+		glGenBuffers(1, &InstanceVBO);
+		ASSERTE(InstanceVBO > 0, "Instance buffer creation failed!");
+	}
+
+	const size_t size = InstanceTransforms.GetSize() * sizeof(Matrix);
+	glBindBuffer(GL_ARRAY_BUFFER, InstanceVBO);
+	// orphan the previous storage, so the upload does not wait for draws still using it
+	InstanceVBOSize = std::max(InstanceVBOSize, size);
+	glBufferData(GL_ARRAY_BUFFER, InstanceVBOSize, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, InstanceTransforms.GetData());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	CHECK_GL_ERR();
+}
+
+//------------------------------------------------------------------------------
+void RenderingPassBase::DrawInstanced(const DrawBatch& batch, bool useTexture)
+{
+	const DrawItem& item = DrawItems[DrawQueue.GetEntries()[batch.FirstEntry].Index];
+	BindVertexArray(item.VAO);
+	if (useTexture)
+		BindTexture(item.Texture);
+	// there is no base instance in OpenGL 3.3, so attributes are pointed at the first instance of the batch
+	GLMeshDeviceProxy::BindInstanceAttributes(InstanceVBO, batch.FirstEntry * sizeof(Matrix));
+	glDrawElementsInstanced(GL_TRIANGLES, item.IndexCount, item.IndexType, NULL, static_cast<GLsizei>(batch.InstanceCount));
+	++gRenderingDevice->GetCurrentFrameStats().DrawCalls;
+}
+
+//------------------------------------------------------------------------------
+void RenderingPassBase::ResetBindings()
+{
+	// vertex arrays and textures used for drawing are never 0, so 0 is a safe initial state for the next pass
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glBindVertexArray(0);
+	BoundTexture = 0;
+	BoundVAO = 0;
 }
 
 //------------------------------------------------------------------------------
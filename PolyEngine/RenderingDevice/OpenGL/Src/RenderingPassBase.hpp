@@ -3,6 +3,9 @@
 #include <Defines.hpp>
 #include <String.hpp>
 #include <map>
+#include <functional>
+#include <RenderQueue.hpp>
+#include <RenderCommandList.hpp>
 #include "GLUtils.hpp"
 #include "GLShaderProgram.hpp"
 
@@ -10,6 +13,8 @@ namespace Poly
 {
 	class World;
 	class CameraComponent;
+	class MeshRenderingComponent;
+	class TransformComponent;
 	class RenderingTargetBase;
 	class GLTextureDeviceProxy;
 	class AARect;
@@ -50,9 +55,61 @@ namespace Poly
 		void ClearFBO(GLenum flags = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	
 	protected:
+		/// <summary>Submesh queued for drawing, together with the state it needs.</summary>
+		struct DrawItem
+		{
+			const MeshRenderingComponent* Mesh;
+			// global transformation stored in the recorded draw packet
+			const Matrix* Transform;
+			size_t SubMeshIdx;
+			GLuint VAO;
+			GLuint Texture;
+			GLsizei IndexCount;
+			GLenum IndexType;
+		};
+
+		/// <summary>Consecutive entries of DrawQueue drawn with a single instanced draw call.</summary>
+		struct DrawBatch
+		{
+			size_t FirstEntry;
+			size_t InstanceCount;
+		};
 
 		GLuint FallbackWhiteTexture;
 
+		/// <summary>Fills DrawItems and DrawQueue with packets recorded for the camera view, in their sorted order.</summary>
+		/// <param name="camera">Camera of the view in the command list passed to GLRenderingDevice::RenderWorld().</param>
+		/// <param name="passType">Type of the pass, stored in the most significant bits of the sort key.</param>
+		/// <param name="useTextures">Whether diffuse textures are bound (and part of the sort key).</param>
+		/// <param name="filter">Predicate selecting meshes drawn by the pass.</param>
+		void QueueVisibleSubMeshes(const CameraComponent* camera, ePassType passType, bool useTextures,
+			const std::function<bool(const MeshRenderingComponent*)>& filter);
+
+		/// <summary>Binds vertex array unless it is already bound.</summary>
+		void BindVertexArray(GLuint vao);
+
+		/// <summary>Binds texture to the first texture unit unless it is already bound.</summary>
+		void BindTexture(GLuint texture);
+
+		/// <summary>Binds state of the item and issues its draw call.</summary>
+		void Draw(const DrawItem& item, bool useTexture);
+
+		/// <summary>Unbinds vertex array and texture bound with BindVertexArray() and BindTexture().</summary>
+		void ResetBindings();
+
+		/// <summary>Groups consecutive entries of sorted DrawQueue sharing vertex array, texture and index count into DrawBatches
+		/// and uploads their global transformations to the instance buffer.</summary>
+		/// <param name="canBatch">Predicate checking remaining state (f.ex. material) of the first item of the batch and the next item.</param>
+		void BuildDrawBatches(const std::function<bool(const DrawItem&, const DrawItem&)>& canBatch);
+
+		/// <summary>Binds state of the first item of the batch and draws all instances with a single draw call.
+		/// Shader takes transformation of the instance from attribute at GLMeshDeviceProxy::INSTANCE_TRANSFORM_ATTRIBUTE.</summary>
+		void DrawInstanced(const DrawBatch& batch, bool useTexture);
+
+		Dynarray<DrawItem> DrawItems;
+		RenderQueue DrawQueue;
+		Dynarray<DrawBatch> DrawBatches;
+
 		virtual void OnRun(World* world, const CameraComponent* camera, const AARect& rect, ePassType passType) = 0;
 
 		RenderingTargetBase* GetInputTarget(const String& name);
@@ -68,6 +125,13 @@ namespace Poly
 
 		GLShaderProgram Program;
 		GLuint FBO = 0;
+		GLuint BoundVAO = 0;
+		GLuint BoundTexture = 0;
+
+		// streaming buffer with transformations of all batched instances, orphaned every frame
+		Dynarray<Matrix> InstanceTransforms;
+		GLuint InstanceVBO = 0;
+		size_t InstanceVBOSize = 0;
 
 		void CreateDummyTexture();
 	};
@@ -21,6 +21,8 @@
 #include "GLTextFieldBufferDeviceProxy.hpp"
 #include "GLTextureDeviceProxy.hpp"
 #include "GLMeshDeviceProxy.hpp"
+#include "GLStreamingBuffer.hpp"
+#include "GLRenderingDevice.hpp"
 #include "GLUtils.hpp"
 
 using namespace Poly;
@@ -28,7 +30,24 @@ using namespace Poly;
 Text2DRenderingPass::Text2DRenderingPass()
 : RenderingPassBase("Shaders/text2DVert.shader", "Shaders/text2DFrag.shader")
 {
+	glGenVertexArrays(1, &VAO);
+	ASSERTE(VAO > 0, "Text2DRenderingPass VAO creation failed!");
+
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, gRenderingDevice->GetStreamingVertexBuffer().GetBuffer());
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, GLTextFieldBufferDeviceProxy::VERTEX_STRIDE, 0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, GLTextFieldBufferDeviceProxy::VERTEX_STRIDE, (void*)(4 * sizeof(GLfloat)));
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	CHECK_GL_ERR();
+}
 
+Text2DRenderingPass::~Text2DRenderingPass()
+{
+	if (VAO)
+		glDeleteVertexArrays(1, &VAO);
 }
 
 void Text2DRenderingPass::OnRun(World* world, const CameraComponent* /*camera*/, const AARect& rect, ePassType /*passType = ePassType::GLOBAL*/ )
@@ -44,6 +63,8 @@ void Text2DRenderingPass::OnRun(World* world, const CameraComponent* /*camera*/,
 	GetProgram().BindProgram();
 	GetProgram().SetUniform("u_projection", ortho);
 
+	GLStreamingBuffer& streamingBuffer = gRenderingDevice->GetStreamingVertexBuffer();
+	glBindVertexArray(VAO);
 	for (auto componentsTuple : world->IterateComponents<ScreenSpaceTextComponent>())
 	{
 		ScreenSpaceTextComponent* textCmp = std::get<ScreenSpaceTextComponent*>(componentsTuple);
@@ -53,17 +74,25 @@ void Text2DRenderingPass::OnRun(World* world, const CameraComponent* /*camera*/,
 		text.UpdateDeviceBuffers();
 
 		const GLTextFieldBufferDeviceProxy* textFieldBuffer = static_cast<const GLTextFieldBufferDeviceProxy*>(text.GetTextFieldBuffer());
+		if (!textFieldBuffer || textFieldBuffer->GetVertices().IsEmpty())
+			continue;
+
+		// allocation is aligned to vertex stride, so it starts at whole vertex of the shared VAO
+		const Dynarray<GLfloat>& vertices = textFieldBuffer->GetVertices();
+		const size_t size = vertices.GetSize() * sizeof(GLfloat);
+		GLStreamingBuffer::Allocation allocation = streamingBuffer.Allocate(size, GLTextFieldBufferDeviceProxy::VERTEX_STRIDE);
+		memcpy(allocation.Data, vertices.GetData(), size);
+		streamingBuffer.Commit();
 
-		glBindVertexArray(textFieldBuffer->GetVAO());
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, static_cast<const GLTextureDeviceProxy*>(text.GetFontTextureProxy())->GetTextureID());
 
 		// Render glyph texture over quad
-		glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(6 * textFieldBuffer->GetSize()));
+		glDrawArrays(GL_TRIANGLES, (GLint)(allocation.Offset / GLTextFieldBufferDeviceProxy::VERTEX_STRIDE), (GLsizei)(6 * textFieldBuffer->GetSize()));
 
 		glBindTexture(GL_TEXTURE_2D, 0);
-		glBindVertexArray(0);
 	}
+	glBindVertexArray(0);
 	CHECK_GL_ERR();
 
 	glDisable(GL_BLEND);
@@ -15,8 +15,13 @@ namespace Poly
 	{
 	public:
 		Text2DRenderingPass();
+		~Text2DRenderingPass();
 
 	protected:
 		void OnRun(World* world, const CameraComponent* camera, const AARect& rect, ePassType passType) override;
+
+	private:
+		// reads vertices of all texts from the streaming vertex buffer
+		GLuint VAO = 0;
 	};
 }
\ No newline at end of file
@@ -17,62 +17,57 @@ UnlitRenderingPass::UnlitRenderingPass()
 	GetProgram().RegisterUniform("mat4", "uTransform");
 	GetProgram().RegisterUniform("mat4", "uMVPTransform");
 	GetProgram().RegisterUniform("vec4", "Color");
+
+	TransformUniform = GetProgram().GetUniform<Matrix>("uTransform");
+	MVPTransformUniform = GetProgram().GetUniform<Matrix>("uMVPTransform");
+	ColorUniform = GetProgram().GetUniform<Color>("uColor");
 }
 
-void UnlitRenderingPass::OnRun(World* world, const CameraComponent* camera, const AARect& /*rect*/, ePassType passType = ePassType::GLOBAL)
+void UnlitRenderingPass::OnRun(World* /*world*/, const CameraComponent* camera, const AARect& /*rect*/, ePassType passType = ePassType::GLOBAL)
 {
 	GetProgram().BindProgram();
 	const Matrix& mvp = camera->GetMVP();
 	
-	// Render meshes
-	for (auto componentsTuple : world->IterateComponents<MeshRenderingComponent, TransformComponent>())
+	// Render meshes that passed frustum culling, sorted to minimize state changes
+	QueueVisibleSubMeshes(camera, passType, true, [passType](const MeshRenderingComponent* meshCmp)
 	{
-		const MeshRenderingComponent* meshCmp = std::get<MeshRenderingComponent*>(componentsTuple);
-		TransformComponent* transCmp = std::get<TransformComponent*>(componentsTuple);
+		return passType != ePassType::BY_MATERIAL || (!meshCmp->IsTransparent() && meshCmp->GetShadingModel() == eShadingModel::UNLIT);
+	});
 
-		if (passType == ePassType::BY_MATERIAL &&
-			(meshCmp->IsTransparent() || meshCmp->GetShadingModel() != eShadingModel::UNLIT))
+	const Matrix* lastTransform = nullptr;
+	bool lastWireframe = false;
+	if (passType == ePassType::BY_MATERIAL)
+	{
+		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	}
+	for (const RenderQueue::Entry& entry : DrawQueue.GetEntries())
+	{
+		const DrawItem& item = DrawItems[entry.Index];
+		// submeshes of the same object are recorded in separate packets with equal transformations
+		if (!lastTransform || !(*item.Transform == *lastTransform))
 		{
-			continue;
+			lastTransform = item.Transform;
+			const Matrix& objTransform = *item.Transform;
+			Matrix screenTransform = mvp * objTransform;
+			GetProgram().SetUniform(TransformUniform, objTransform);
+			GetProgram().SetUniform(MVPTransformUniform, screenTransform);
 		}
 
-		const Matrix& objTransform = transCmp->GetGlobalTransformationMatrix();
-		Matrix screenTransform = mvp * objTransform;
-		GetProgram().SetUniform("uTransform", objTransform);
-		GetProgram().SetUniform("uMVPTransform", screenTransform);
-		
-		if (passType == ePassType::BY_MATERIAL)
+		if (passType == ePassType::BY_MATERIAL && item.Mesh->GetIsWireframe() != lastWireframe)
 		{
-			glPolygonMode(GL_FRONT_AND_BACK, meshCmp->GetIsWireframe() ? GL_LINE : GL_FILL);
+			lastWireframe = item.Mesh->GetIsWireframe();
+			glPolygonMode(GL_FRONT_AND_BACK, lastWireframe ? GL_LINE : GL_FILL);
 		}
 
-		int i = 0;
-		for (const MeshResource::SubMesh* subMesh : meshCmp->GetMesh()->GetSubMeshes())
-		{
-			PhongMaterial material = meshCmp->GetMaterial(i);
-			GetProgram().SetUniform("uColor", material.DiffuseColor);
-
-			const GLMeshDeviceProxy* meshProxy = static_cast<const GLMeshDeviceProxy*>(subMesh->GetMeshProxy());
-			glBindVertexArray(meshProxy->GetVAO());
-
-			const Poly::TextureResource* DiffuseTexture = subMesh->GetMeshData().GetDiffTexture();
-			GLuint TextureID = DiffuseTexture == nullptr
-				? FallbackWhiteTexture
-				: static_cast<const GLTextureDeviceProxy*>(DiffuseTexture->GetTextureProxy())->GetTextureID();
+		const PhongMaterial& material = item.Mesh->GetMaterial(static_cast<int>(item.SubMeshIdx));
+		GetProgram().SetUniform(ColorUniform, material.DiffuseColor);
 
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, TextureID);
-
-			glDrawElements(GL_TRIANGLES, (GLsizei)subMesh->GetMeshData().GetTriangleCount() * 3, GL_UNSIGNED_INT, NULL);
-			glBindTexture(GL_TEXTURE_2D, 0);
-			glBindVertexArray(0);
+		Draw(item, true);
+	}
+	ResetBindings();
 
-			++i;
-		}
-		
-		if (passType == ePassType::BY_MATERIAL)
-		{
-			glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-		}
+	if (passType == ePassType::BY_MATERIAL)
+	{
+		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 	}
 }
\ No newline at end of file
@@ -18,5 +18,10 @@ namespace Poly
 
 	protected:
 		void OnRun(World* world, const CameraComponent* camera, const AARect& rect, ePassType passType) override;
+
+	private:
+		UniformHandle<Matrix> TransformUniform;
+		UniformHandle<Matrix> MVPTransformUniform;
+		UniformHandle<Color> ColorUniform;
 	};
 }
\ No newline at end of file
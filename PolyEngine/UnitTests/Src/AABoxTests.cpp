@@ -42,4 +42,31 @@ TEST_CASE("AABox intersection calculation", "[AABox]") {
 	const AABox ar2(pos2, size2);
 
 	REQUIRE(ar.GetIntersectionVolume(ar2).GetSize() == Vector(1.f, 1.f, 1.f));
-}
\ No newline at end of file
+}
+TEST_CASE("AABox transformation", "[AABox]") {
+	const AABox box(Vector(-1.f, -2.f, -3.f), Vector(2.f, 4.f, 6.f));
+
+	Matrix translation;
+	translation.SetTranslation(Vector(10.f, 0.f, 0.f));
+	const AABox moved = box.GetTransformed(translation);
+	REQUIRE(moved.GetMin().X == Approx(9.f));
+	REQUIRE(moved.GetMin().Y == Approx(-2.f));
+	REQUIRE(moved.GetSize().Z == Approx(6.f));
+	// center is a point, so it is moved by the translation exactly once
+	REQUIRE(box.GetCenter().W == Approx(1.f));
+	REQUIRE((translation * box.GetCenter()).X == Approx(10.f));
+
+	// rotation by 90 degrees around Z swaps X and Y extents
+	Matrix rotation;
+	rotation.SetRotationZ(90_deg);
+	const AABox rotated = box.GetTransformed(rotation);
+	REQUIRE(rotated.GetSize().X == Approx(4.f));
+	REQUIRE(rotated.GetSize().Y == Approx(2.f));
+	REQUIRE(rotated.GetSize().Z == Approx(6.f));
+	REQUIRE(rotated.GetCenter().X == Approx(0.f).margin(1e-5));
+
+	// rotation by 45 degrees encloses rotated corners
+	rotation.SetRotationZ(45_deg);
+	const AABox rotated45 = box.GetTransformed(rotation);
+	REQUIRE(rotated45.GetSize().X == Approx(6.f / std::sqrt(2.f)));
+}
@@ -0,0 +1,178 @@
+#include <catch.hpp>
+
+#include <AABoxTree.hpp>
+#include <Logger.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+using namespace Poly;
+
+namespace
+{
+	bool Overlaps(const AABox& a, const AABox& b)
+	{
+		const Vector aMin = a.GetMin(), aMax = a.GetMax(), bMin = b.GetMin(), bMax = b.GetMax();
+		return aMin.X <= bMax.X && aMax.X >= bMin.X && aMin.Y <= bMax.Y && aMax.Y >= bMin.Y && aMin.Z <= bMax.Z && aMax.Z >= bMin.Z;
+	}
+
+	AABox RandomBox(std::mt19937& rng, float range)
+	{
+		std::uniform_real_distribution<float> position(-range, range);
+		std::uniform_real_distribution<float> size(0.1f, 2.0f);
+		return AABox(Vector(position(rng), position(rng), position(rng)), Vector(size(rng), size(rng), size(rng)));
+	}
+
+	Dynarray<size_t> Sorted(Dynarray<size_t> values)
+	{
+		std::sort(values.Begin(), values.End());
+		return values;
+	}
+}
+
+TEST_CASE("AABoxTree queries match brute force", "[AABoxTree]")
+{
+	std::mt19937 rng(std::rand());
+	AABoxTree tree(0.0f);
+	Dynarray<AABox> boxes;
+	Dynarray<size_t> proxies;
+	Dynarray<bool> alive;
+
+	auto check = [&]()
+	{
+		for (int q = 0; q < 20; ++q)
+		{
+			const AABox queryBox = RandomBox(rng, 50.0f);
+			Dynarray<size_t> expected, found;
+			for (size_t i = 0; i < boxes.GetSize(); ++i)
+				if (alive[i] && Overlaps(boxes[i], queryBox))
+					expected.PushBack(i);
+			tree.QueryBox(queryBox, [&found](size_t userData) { found.PushBack(userData); });
+			REQUIRE(Sorted(found) == Sorted(expected));
+		}
+	};
+
+	for (size_t i = 0; i < 500; ++i)
+	{
+		boxes.PushBack(RandomBox(rng, 50.0f));
+		proxies.PushBack(tree.CreateProxy(boxes[i], i));
+		alive.PushBack(true);
+	}
+	REQUIRE(tree.GetProxyCount() == 500);
+	REQUIRE(tree.GetHeight() < 25);
+	check();
+
+	// move and destroy some proxies
+	for (size_t i = 0; i < boxes.GetSize(); i += 3)
+	{
+		boxes[i] = RandomBox(rng, 50.0f);
+		REQUIRE(tree.MoveProxy(proxies[i], boxes[i]) == true);
+	}
+	for (size_t i = 1; i < boxes.GetSize(); i += 4)
+	{
+		tree.DestroyProxy(proxies[i]);
+		alive[i] = false;
+	}
+	REQUIRE(tree.GetProxyCount() == 500 - 125);
+	check();
+
+	// freed nodes are reused
+	for (size_t i = 1; i < boxes.GetSize(); i += 4)
+	{
+		proxies[i] = tree.CreateProxy(boxes[i], i);
+		alive[i] = true;
+	}
+	REQUIRE(tree.GetUserData(proxies[5]) == 5);
+	check();
+}
+
+TEST_CASE("AABoxTree margin", "[AABoxTree]")
+{
+	AABoxTree tree(0.5f);
+	const size_t proxy = tree.CreateProxy(AABox(Vector(0.0f, 0.0f, 0.0f), Vector(1.0f, 1.0f, 1.0f)), 7);
+	REQUIRE(tree.GetFatBox(proxy).GetMin().X == Approx(-0.5f));
+	REQUIRE(tree.GetFatBox(proxy).GetSize().X == Approx(2.0f));
+
+	// small movement stays inside the enlarged box
+	REQUIRE(tree.MoveProxy(proxy, AABox(Vector(0.25f, 0.0f, 0.0f), Vector(1.0f, 1.0f, 1.0f))) == false);
+	REQUIRE(tree.MoveProxy(proxy, AABox(Vector(2.0f, 0.0f, 0.0f), Vector(1.0f, 1.0f, 1.0f))) == true);
+	REQUIRE(tree.GetFatBox(proxy).GetMin().X == Approx(1.5f));
+
+	tree.DestroyProxy(proxy);
+	REQUIRE(tree.GetProxyCount() == 0);
+	REQUIRE(tree.GetHeight() == 0);
+	size_t calls = 0;
+	tree.QueryBox(AABox(Vector(-100.0f, -100.0f, -100.0f), Vector(200.0f, 200.0f, 200.0f)), [&calls](size_t) { ++calls; });
+	REQUIRE(calls == 0);
+}
+
+TEST_CASE("AABoxTree sphere, ray and frustum queries", "[AABoxTree]")
+{
+	AABoxTree tree(0.0f);
+	// row of unit boxes along X at 0, 10, 20, ...
+	for (size_t i = 0; i < 10; ++i)
+		tree.CreateProxy(AABox(Vector(10.0f * i, 0.0f, 0.0f), Vector(1.0f, 1.0f, 1.0f)), i);
+
+	Dynarray<size_t> found;
+	auto collect = [&found](size_t userData) { found.PushBack(userData); };
+
+	tree.QuerySphere(Vector(10.5f, 0.5f, 0.5f), 1.0f, collect);
+	REQUIRE(Sorted(found) == Dynarray<size_t>{ 1 });
+	found.Clear();
+	tree.QuerySphere(Vector(15.0f, 0.5f, 0.5f), 5.5f, collect);
+	REQUIRE(Sorted(found) == Dynarray<size_t>{ 1, 2 });
+	found.Clear();
+
+	// ray along the row, limited by distance
+	tree.QueryRay(Vector(-5.0f, 0.5f, 0.5f), Vector(1.0f, 0.0f, 0.0f), 30.0f, collect);
+	REQUIRE(Sorted(found) == Dynarray<size_t>{ 0, 1, 2 });
+	found.Clear();
+	tree.QueryRay(Vector(-5.0f, 0.5f, 0.5f), Vector(-1.0f, 0.0f, 0.0f), 100.0f, collect);
+	REQUIRE(found.IsEmpty());
+	tree.QueryRay(Vector(40.5f, 10.0f, 0.5f), Vector(0.0f, -1.0f, 0.0f), 100.0f, collect);
+	REQUIRE(Sorted(found) == Dynarray<size_t>{ 4 });
+	found.Clear();
+
+	// camera at (45, 0.5, 10) looking down -Z sees only boxes near X = 45
+	Matrix projection, view;
+	projection.SetPerspective(90_deg, 1.0f, 1.0f, 100.0f);
+	view.SetTranslation(Vector(-45.0f, -0.5f, -10.0f));
+	tree.QueryFrustum(Frustum(projection * view), collect);
+	REQUIRE(Sorted(found) == Dynarray<size_t>{ 4, 5 });
+}
+
+TEST_CASE("AABoxTree frustum query benchmark", "[.][Benchmark][AABoxTree]")
+{
+	std::mt19937 rng(1234);
+	const size_t count = 100000;
+	AABoxTree tree;
+	Dynarray<AABox> boxes;
+	for (size_t i = 0; i < count; ++i)
+	{
+		boxes.PushBack(RandomBox(rng, 1000.0f));
+		tree.CreateProxy(boxes[i], i);
+	}
+
+	Matrix projection, view;
+	projection.SetPerspective(60_deg, 1.0f, 1.0f, 300.0f);
+	view.SetTranslation(Vector(0.0f, 0.0f, 0.0f));
+	const Frustum frustum(projection * view);
+	const int iterations = 20;
+
+	size_t bruteVisible = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int it = 0; it < iterations; ++it)
+		for (const AABox& box : boxes)
+			bruteVisible += frustum.IsBoxVisible(box) ? 1 : 0;
+	const double bruteMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+	size_t treeVisible = 0;
+	start = std::chrono::steady_clock::now();
+	for (int it = 0; it < iterations; ++it)
+		tree.QueryFrustum(frustum, [&treeVisible](size_t) { ++treeVisible; });
+	const double treeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+	gConsole.LogInfo("AABoxTree frustum query of {} boxes (tree height {}): brute force {} ms ({} visible), tree {} ms ({} visible)",
+		count, tree.GetHeight(), bruteMs, bruteVisible / iterations, treeMs, treeVisible / iterations);
+}
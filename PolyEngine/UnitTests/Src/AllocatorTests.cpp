@@ -2,6 +2,8 @@
 
 #include <PoolAllocator.hpp>
 #include <IterablePoolAllocator.hpp>
+#include <Logger.hpp>
+#include <chrono>
 
 using namespace Poly;
 
@@ -98,4 +100,80 @@ TEST_CASE("Iterable pool allocator corner case test", "[Allocator]") {
 	size_t* e = allocator.Alloc();
 	REQUIRE(e != nullptr);
 	REQUIRE(allocator.GetSize() == 3);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Iterable pool allocator iteration over sparse pool", "[Allocator]") {
+	IterablePoolAllocator<size_t> allocator(200);
+	size_t* ptrs[200];
+	for (size_t i = 0; i < 200; ++i)
+	{
+		ptrs[i] = allocator.Alloc();
+		*ptrs[i] = i;
+	}
+	REQUIRE(allocator.Alloc() == nullptr);
+
+	// leave only every 7th element, spanning several bitmap words
+	for (size_t i = 0; i < 200; ++i)
+		if (i % 7 != 0)
+			allocator.Free(ptrs[i]);
+	REQUIRE(allocator.GetSize() == 29);
+
+	size_t expected = 0;
+	for (size_t val : allocator)
+	{
+		REQUIRE(val == expected);
+		expected += 7;
+	}
+	REQUIRE(expected == 203);
+
+	// backward iteration
+	auto it = allocator.End();
+	do
+	{
+		--it;
+		expected -= 7;
+		REQUIRE(*it == expected);
+	} while (it != allocator.Begin());
+	REQUIRE(expected == 0);
+
+	// freed cells are reused first, iteration stays in address order
+	size_t* reused = allocator.Alloc();
+	REQUIRE(reused == ptrs[199]);
+	*reused = 199;
+	size_t prev = 0;
+	size_t count = 0;
+	for (size_t val : allocator)
+	{
+		REQUIRE((count == 0 || val > prev));
+		prev = val;
+		++count;
+	}
+	REQUIRE(count == 30);
+	REQUIRE(prev == 199);
+}
+
+TEST_CASE("Iterable pool allocator spawn/destroy benchmark", "[.][Benchmark][Allocator]") {
+	struct DummyComponent { size_t Payload[8]; };
+	constexpr size_t COUNT = 65536;
+	IterablePoolAllocator<DummyComponent> allocator(COUNT);
+	DummyComponent** ptrs = new DummyComponent*[COUNT];
+
+	auto start = std::chrono::steady_clock::now();
+	for (size_t pass = 0; pass < 4; ++pass)
+	{
+		for (size_t i = 0; i < COUNT; ++i)
+			ptrs[i] = allocator.Alloc();
+		REQUIRE(allocator.GetSize() == COUNT);
+
+		// destroy every other object first to fragment the pool, then the rest
+		for (size_t i = 0; i < COUNT; i += 2)
+			allocator.Free(ptrs[i]);
+		for (size_t i = 1; i < COUNT; i += 2)
+			allocator.Free(ptrs[i]);
+		REQUIRE(allocator.GetSize() == 0);
+	}
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	delete[] ptrs;
+
+	gConsole.LogInfo("IterablePoolAllocator: 4 x spawn/destroy of {} components took {} ms", COUNT, elapsed.count());
+}
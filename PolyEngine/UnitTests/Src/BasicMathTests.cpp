@@ -141,3 +141,39 @@ TEST_CASE("Floating-point equality comparisons", "[FloatCmp]") {
 		CHECK_FALSE(Cmpft(-LOW_FLOAT, 0.000000001f));
 	}
 }
+
+TEST_CASE("Half precision float conversions", "[BasicMath]") {
+	SECTION("Exactly representable values") {
+		CHECK(FloatToHalf(0.0f) == 0x0000);
+		CHECK(FloatToHalf(-0.0f) == 0x8000);
+		CHECK(FloatToHalf(1.0f) == 0x3C00);
+		CHECK(FloatToHalf(-2.0f) == 0xC000);
+		CHECK(FloatToHalf(0.5f) == 0x3800);
+		CHECK(FloatToHalf(65504.0f) == 0x7BFF);
+		CHECK(FloatToHalf(std::ldexp(1.0f, -24)) == 0x0001); // smallest subnormal
+
+		for (float val : { 0.0f, 1.0f, -2.0f, 0.5f, 0.25f, 1024.0f, 65504.0f, std::ldexp(1.0f, -24), std::ldexp(3.0f, -20) })
+			CHECK(HalfToFloat(FloatToHalf(val)) == val);
+	}
+
+	SECTION("Rounding") {
+		// 1 + 2^-11 is halfway between 1 and the next half, ties to even
+		CHECK(FloatToHalf(1.0f + std::ldexp(1.0f, -11)) == 0x3C00);
+		CHECK(FloatToHalf(1.0f + 3.0f * std::ldexp(1.0f, -11)) == 0x3C02);
+		CHECK(FloatToHalf(std::ldexp(1.0f, -26)) == 0x0000);
+		CHECK(FloatToHalf(100000.0f) == 0x7C00);
+		CHECK(FloatToHalf(-100000.0f) == 0xFC00);
+
+		// texture coordinates in [0, 1] keep relative precision of 11 bits
+		for (int i = 0; i <= 1000; ++i)
+		{
+			const float val = i / 1000.0f;
+			CHECK(Abs(HalfToFloat(FloatToHalf(val)) - val) <= std::ldexp(1.0f, -12));
+		}
+	}
+
+	SECTION("Special values") {
+		CHECK(std::isinf(HalfToFloat(FloatToHalf(INF_FLOAT))));
+		CHECK(std::isnan(HalfToFloat(FloatToHalf(NAN_FLOAT))));
+	}
+}
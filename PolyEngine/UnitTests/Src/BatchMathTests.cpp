@@ -0,0 +1,139 @@
+#include <catch.hpp>
+
+#include <BatchMath.hpp>
+#include <SimdMath.hpp>
+#include <Dynarray.hpp>
+#include <Logger.hpp>
+
+#include <chrono>
+
+using namespace Poly;
+
+namespace
+{
+	Matrix MakeTransform(float seed)
+	{
+		Matrix t, r, s;
+		t.SetTranslation(Vector(seed, -2.0f * seed, 3.0f));
+		r = Quaternion(Vector(1, 2, 3).GetNormalized(), Angle::FromDegrees(17.0f * seed)).ToRotationMatrix();
+		s.SetScale(Vector(1.0f, 2.0f, 0.5f));
+		return t * r * s;
+	}
+
+	bool Cmpv(const Vector3f& a, const Vector& b) { return Cmpf(a.X, b.X) && Cmpf(a.Y, b.Y) && Cmpf(a.Z, b.Z); }
+
+	template<typename Test>
+	void ForEachInstructionSet(Test test)
+	{
+		const eSimdInstructionSet defaultSet = GetSimdInstructionSet();
+		for (int set = 0; set < int(eSimdInstructionSet::_COUNT); ++set)
+		{
+			if (!IsSimdInstructionSetSupported(eSimdInstructionSet(set)))
+				continue;
+			SetSimdInstructionSet(eSimdInstructionSet(set));
+			test();
+		}
+		SetSimdInstructionSet(defaultSet);
+	}
+}
+
+TEST_CASE("Batch vector transformation", "[BatchMath]")
+{
+	const Matrix transform = MakeTransform(1.5f);
+	ForEachInstructionSet([&transform]()
+	{
+		// sizes cover both SIMD groups and the scalar remainder
+		for (size_t count : { 0, 1, 3, 4, 7, 8, 13 })
+		{
+			Dynarray<Vector3f> in, points, directions;
+			for (size_t i = 0; i < count; ++i)
+			{
+				in.PushBack(Vector3f(float(i), float(i % 3) - 1.0f, 0.5f * float(i)));
+				points.PushBack(Vector3f());
+				directions.PushBack(in[i]);
+			}
+
+			TransformPoints(transform, in.GetData(), points.GetData(), count);
+			// in place
+			TransformDirections(transform, directions.GetData(), directions.GetData(), count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				REQUIRE(Cmpv(points[i], transform * in[i].GetVector()));
+				REQUIRE(Cmpv(directions[i], transform * Vector(in[i].X, in[i].Y, in[i].Z, 0.0f)));
+			}
+
+			if (count > 0)
+			{
+				Vector3f min, max;
+				CalculateBounds(points.GetData(), count, min, max);
+				for (const Vector3f& p : points)
+				{
+					REQUIRE(p.X >= min.X); REQUIRE(p.Y >= min.Y); REQUIRE(p.Z >= min.Z);
+					REQUIRE(p.X <= max.X); REQUIRE(p.Y <= max.Y); REQUIRE(p.Z <= max.Z);
+				}
+				REQUIRE(std::any_of(points.Begin(), points.End(), [&min](const Vector3f& p) { return p.X == min.X; }));
+				REQUIRE(std::any_of(points.Begin(), points.End(), [&max](const Vector3f& p) { return p.Z == max.Z; }));
+			}
+		}
+	});
+}
+
+TEST_CASE("Batch matrix operations", "[BatchMath]")
+{
+	ForEachInstructionSet([]()
+	{
+		const size_t count = 7;
+		Dynarray<Matrix> lhs, rhs, out;
+		Dynarray<Quaternion> rotations;
+		for (size_t i = 0; i < count; ++i)
+		{
+			lhs.PushBack(MakeTransform(float(i)));
+			rhs.PushBack(MakeTransform(float(i) * 0.5f + 3.0f));
+			out.PushBack(Matrix());
+			rotations.PushBack(Quaternion(Vector(float(i), 1, -2).GetNormalized(), Angle::FromDegrees(31.0f * float(i))));
+		}
+
+		MultiplyMatrices(lhs.GetData(), rhs.GetData(), out.GetData(), count);
+		for (size_t i = 0; i < count; ++i)
+			REQUIRE(out[i] == lhs[i] * rhs[i]);
+
+		MultiplyMatrices(lhs[2], rhs.GetData(), out.GetData(), count);
+		for (size_t i = 0; i < count; ++i)
+			REQUIRE(out[i] == lhs[2] * rhs[i]);
+
+		QuaternionsToMatrices(rotations.GetData(), out.GetData(), count);
+		for (size_t i = 0; i < count; ++i)
+			REQUIRE(out[i] == rotations[i].ToRotationMatrix());
+	});
+}
+
+TEST_CASE("Batch math benchmark", "[.][Benchmark][BatchMath]")
+{
+	const size_t count = 100000;
+	const size_t passes = 20;
+	const Matrix transform = MakeTransform(2.0f);
+	Dynarray<Vector3f> in, out;
+	for (size_t i = 0; i < count; ++i)
+	{
+		in.PushBack(Vector3f(float(i % 101), float(i % 37), float(i % 11)));
+		out.PushBack(Vector3f());
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t pass = 0; pass < passes; ++pass)
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Vector v = transform * in[i].GetVector();
+			out[i].X = v.X;
+			out[i].Y = v.Y;
+			out[i].Z = v.Z;
+		}
+	const std::chrono::duration<double, std::milli> single = std::chrono::high_resolution_clock::now() - start;
+
+	start = std::chrono::high_resolution_clock::now();
+	for (size_t pass = 0; pass < passes; ++pass)
+		TransformPoints(transform, in.GetData(), out.GetData(), count);
+	const std::chrono::duration<double, std::milli> batch = std::chrono::high_resolution_clock::now() - start;
+
+	gConsole.LogInfo("Transform of {} points: Matrix * Vector {} ms, TransformPoints {} ms", count, single.count() / passes, batch.count() / passes);
+}
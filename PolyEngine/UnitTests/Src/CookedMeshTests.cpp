@@ -0,0 +1,240 @@
+#include <catch.hpp>
+
+#define _WINDLL
+#define _GAME //fake being a game for the dllexport macros
+#include <MeshResource.hpp>
+#include <CookedMesh.hpp>
+#include <FileIO.hpp>
+
+#include <chrono>
+#include <cstdio>
+
+using namespace Poly;
+
+namespace
+{
+	// cooked grid of size x size vertices in XZ plane, with full precision texture coordinates and normals
+	Dynarray<u8> CookGrid(size_t size, const char* texturePath)
+	{
+		using namespace CookedMesh;
+		const size_t vertexCount = size * size;
+		const size_t indexCount = (size - 1) * (size - 1) * 6;
+		const bool shortIndices = vertexCount <= (size_t(1) << 16);
+		const size_t indexSize = shortIndices ? sizeof(u16) : sizeof(u32);
+		const size_t pathLength = strlen(texturePath);
+
+		SubMeshHeader subMesh;
+		memset(&subMesh, 0, sizeof(subMesh));
+		subMesh.Flags = HAS_TEXT_COORDS | HAS_NORMALS;
+		if (shortIndices)
+			subMesh.Flags |= SHORT_INDICES;
+		subMesh.VertexCount = static_cast<u32>(vertexCount);
+		subMesh.IndexCount = static_cast<u32>(indexCount);
+		subMesh.VertexStride = 8 * sizeof(float);
+		subMesh.VertexDataOffset = sizeof(FileHeader) + sizeof(SubMeshHeader);
+		subMesh.IndexDataOffset = subMesh.VertexDataOffset + (vertexCount * subMesh.VertexStride + BLOB_ALIGNMENT - 1) / BLOB_ALIGNMENT * BLOB_ALIGNMENT;
+		subMesh.DiffuseTexturePathOffset = subMesh.IndexDataOffset + indexCount * indexSize;
+		subMesh.DiffuseTexturePathLength = static_cast<u32>(pathLength);
+		subMesh.BoxSize[0] = subMesh.BoxSize[2] = float(size - 1);
+		subMesh.SphereCenter[0] = subMesh.SphereCenter[2] = 0.5f * float(size - 1);
+		subMesh.SphereRadius = std::sqrt(0.5f) * float(size - 1);
+		subMesh.SpecularIntensity = 0.5f;
+		subMesh.SpecularPower = 8.0f;
+		subMesh.SpecularColor[0] = subMesh.SpecularColor[1] = subMesh.SpecularColor[2] = subMesh.SpecularColor[3] = 1.0f;
+
+		const FileHeader header = { MAGIC, VERSION, 1, 0 };
+		Dynarray<u8> file;
+		file.Resize(static_cast<size_t>(subMesh.DiffuseTexturePathOffset + pathLength));
+		memset(file.GetData(), 0, file.GetSize());
+		memcpy(file.GetData(), &header, sizeof(header));
+		memcpy(file.GetData() + sizeof(header), &subMesh, sizeof(subMesh));
+
+		float* vertex = reinterpret_cast<float*>(file.GetData() + subMesh.VertexDataOffset);
+		for (size_t z = 0; z < size; ++z)
+		{
+			for (size_t x = 0; x < size; ++x)
+			{
+				const float vertexData[8] = { float(x), 0.0f, float(z), float(x) / (size - 1), float(z) / (size - 1), 0.0f, 1.0f, 0.0f };
+				memcpy(vertex, vertexData, sizeof(vertexData));
+				vertex += 8;
+			}
+		}
+
+		u8* index = file.GetData() + subMesh.IndexDataOffset;
+		for (size_t z = 0; z + 1 < size; ++z)
+		{
+			for (size_t x = 0; x + 1 < size; ++x)
+			{
+				const u32 corner = static_cast<u32>(z * size + x);
+				const u32 quad[6] = { corner, corner + u32(size), corner + 1, corner + 1, corner + u32(size), corner + u32(size) + 1 };
+				for (u32 i : quad)
+				{
+					const u16 shortIndex = static_cast<u16>(i);
+					memcpy(index, shortIndices ? static_cast<const void*>(&shortIndex) : static_cast<const void*>(&i), indexSize);
+					index += indexSize;
+				}
+			}
+		}
+
+		memcpy(file.GetData() + subMesh.DiffuseTexturePathOffset, texturePath, pathLength);
+		return file;
+	}
+
+	CookedMesh::SubMeshHeader& GetSubMeshHeader(Dynarray<u8>& file)
+	{
+		return *reinterpret_cast<CookedMesh::SubMeshHeader*>(file.GetData() + sizeof(CookedMesh::FileHeader));
+	}
+}
+
+TEST_CASE("Cooked mesh loading", "[CookedMesh]")
+{
+	const Dynarray<u8> file = CookGrid(3, "Textures/grid.png");
+	SaveBinaryFile("cooked_mesh_test.mesh", file.GetData(), file.GetSize());
+
+	{
+		MeshResource mesh("cooked_mesh_test.mesh");
+		REQUIRE(mesh.GetSubMeshes().GetSize() == 1);
+		const MeshResource::SubMesh& subMesh = *mesh.GetSubMeshes()[0];
+		const Mesh& data = subMesh.GetMeshData();
+
+		CHECK(data.IsPacked());
+		CHECK(data.GetVertexCount() == 9);
+		CHECK(data.GetTriangleCount() == 8);
+		CHECK(data.HasTextCoords());
+		CHECK(data.HasNormals());
+		CHECK(data.GetVertexFormat().Interleaved);
+		CHECK(data.GetVertexFormat().ShortIndices);
+		CHECK(!data.GetVertexFormat().HalfTextCoords);
+		CHECK(!data.GetVertexFormat().PackedNormals);
+		CHECK(data.GetVertexStride() == 8 * sizeof(float));
+		CHECK(data.GetPositions().IsEmpty());
+
+		const CookedMesh::SubMeshHeader& header = *reinterpret_cast<const CookedMesh::SubMeshHeader*>(file.GetData() + sizeof(CookedMesh::FileHeader));
+		CHECK(memcmp(data.GetPackedContent().Vertices, file.GetData() + header.VertexDataOffset, 9 * data.GetVertexStride()) == 0);
+		CHECK(memcmp(data.GetPackedContent().Indices, file.GetData() + header.IndexDataOffset, 24 * sizeof(u16)) == 0);
+
+		CHECK(subMesh.GetBoundingBox().GetMin() == Vector(0, 0, 0));
+		CHECK(subMesh.GetBoundingBox().GetSize() == Vector(2, 0, 2));
+		CHECK(subMesh.GetBoundingSphereCenter() == Vector(1, 0, 1));
+		CHECK(subMesh.GetDiffuseTexturePath() == String("Textures/grid.png"));
+		CHECK(data.GetMaterial().SpecularPower == Approx(8.0f));
+
+		// packed meshes are cooked again without unpacking
+		CookedMesh::Write(mesh, "cooked_mesh_test_copy.mesh");
+	}
+
+	MemoryMappedFile copy("cooked_mesh_test_copy.mesh");
+	REQUIRE(copy.GetSize() == file.GetSize());
+	CHECK(memcmp(copy.GetData(), file.GetData(), file.GetSize()) == 0);
+
+	std::remove("cooked_mesh_test.mesh");
+	std::remove("cooked_mesh_test_copy.mesh");
+}
+
+TEST_CASE("Cooked mesh validation", "[CookedMesh]")
+{
+	Dynarray<u8> file = CookGrid(3, "grid.png");
+	CHECK(CookedMesh::IsCookedMesh(file.GetData(), file.GetSize()));
+	CHECK(CookedMesh::Validate(file.GetData(), file.GetSize()));
+
+	SECTION("Truncated file")
+	{
+		CHECK(!CookedMesh::Validate(file.GetData(), file.GetSize() - 1));
+		CHECK(!CookedMesh::Validate(file.GetData(), sizeof(CookedMesh::FileHeader) + 8));
+		CHECK(!CookedMesh::IsCookedMesh(file.GetData(), 4));
+	}
+
+	SECTION("Unsupported version")
+	{
+		reinterpret_cast<CookedMesh::FileHeader*>(file.GetData())->Version = CookedMesh::VERSION + 1;
+		CHECK(CookedMesh::IsCookedMesh(file.GetData(), file.GetSize()));
+		CHECK(!CookedMesh::Validate(file.GetData(), file.GetSize()));
+	}
+
+	SECTION("Stride not matching vertex format")
+	{
+		GetSubMeshHeader(file).Flags |= CookedMesh::PACKED_NORMALS;
+		CHECK(!CookedMesh::Validate(file.GetData(), file.GetSize()));
+	}
+
+	SECTION("Misaligned vertex data")
+	{
+		GetSubMeshHeader(file).VertexDataOffset += 4;
+		CHECK(!CookedMesh::Validate(file.GetData(), file.GetSize()));
+	}
+
+	SECTION("Index out of vertex range")
+	{
+		// last index of the grid refers to the last vertex
+		u16* lastIndex = reinterpret_cast<u16*>(file.GetData() + GetSubMeshHeader(file).IndexDataOffset) + GetSubMeshHeader(file).IndexCount - 1;
+		REQUIRE(*lastIndex == 8);
+		*lastIndex = 9;
+		CHECK(!CookedMesh::Validate(file.GetData(), file.GetSize()));
+		// fewer vertices than the indices refer to
+		*lastIndex = 8;
+		GetSubMeshHeader(file).VertexCount -= 1;
+		CHECK(!CookedMesh::Validate(file.GetData(), file.GetSize()));
+	}
+
+	SECTION("Index out of vertex range with 32 bit indices")
+	{
+		file = CookGrid(257, "grid.png");
+		REQUIRE((GetSubMeshHeader(file).Flags & CookedMesh::SHORT_INDICES) == 0);
+		CHECK(CookedMesh::Validate(file.GetData(), file.GetSize()));
+		u32* firstIndex = reinterpret_cast<u32*>(file.GetData() + GetSubMeshHeader(file).IndexDataOffset);
+		*firstIndex = GetSubMeshHeader(file).VertexCount;
+		CHECK(!CookedMesh::Validate(file.GetData(), file.GetSize()));
+	}
+
+	SECTION("Corrupted file is not loaded")
+	{
+		GetSubMeshHeader(file).IndexCount += 1;
+		SaveBinaryFile("cooked_mesh_corrupted.mesh", file.GetData(), file.GetSize());
+		CHECK_THROWS_AS(MeshResource("cooked_mesh_corrupted.mesh"), ResourceLoadFailedException);
+		std::remove("cooked_mesh_corrupted.mesh");
+	}
+
+	CHECK(!CookedMesh::IsCookedMesh(reinterpret_cast<const u8*>("v 0 0 0\nv 1 0 0\n"), 16));
+}
+
+TEST_CASE("Cooked mesh loading benchmark", "[.][Benchmark][CookedMesh]")
+{
+	// 512 x 512 grid, 262k vertices and 522k triangles
+	const Dynarray<u8> file = CookGrid(512, "grid.png");
+	SaveBinaryFile("cooked_mesh_benchmark.mesh", file.GetData(), file.GetSize());
+
+	const int iterations = 20;
+	// reading the whole file is the lower bound of any loader that copies vertices into attribute arrays
+	auto start = std::chrono::steady_clock::now();
+	for (int it = 0; it < iterations; ++it)
+	{
+		std::unique_ptr<BinaryBuffer> buffer(LoadBinaryFile("cooked_mesh_benchmark.mesh"));
+		REQUIRE(buffer->GetSize() == file.GetSize());
+	}
+	const double readMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+	start = std::chrono::steady_clock::now();
+	for (int it = 0; it < iterations; ++it)
+	{
+		MeshResource mesh("cooked_mesh_benchmark.mesh");
+		REQUIRE(mesh.GetSubMeshes()[0]->GetMeshData().GetVertexCount() == 512 * 512);
+	}
+	const double mapMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+	// upload reads all of the mapped data once
+	start = std::chrono::steady_clock::now();
+	u32 checksum = 0;
+	for (int it = 0; it < iterations; ++it)
+	{
+		MeshResource mesh("cooked_mesh_benchmark.mesh");
+		const Mesh& data = mesh.GetSubMeshes()[0]->GetMeshData();
+		const size_t size = data.GetVertexCount() * data.GetVertexStride();
+		for (size_t i = 0; i < size; i += 64)
+			checksum += data.GetPackedContent().Vertices[i];
+	}
+	const double touchMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+	gConsole.LogInfo("Cooked mesh of {} MB: full read {} ms, mapped load {} ms, mapped load with vertex read {} ms (checksum {})",
+		file.GetSize() / (1024 * 1024), readMs, mapMs, touchMs, checksum);
+	std::remove("cooked_mesh_benchmark.mesh");
+}
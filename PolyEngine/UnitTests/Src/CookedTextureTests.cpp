@@ -0,0 +1,258 @@
+#include <catch.hpp>
+
+#define _WINDLL
+#define _GAME //fake being a game for the dllexport macros
+#include <TextureResource.hpp>
+#include <CookedTexture.hpp>
+#include <FileIO.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using namespace Poly;
+
+namespace
+{
+	// smooth gradients with noise, alpha is a gradient as well
+	Dynarray<u8> CreateImage(size_t width, size_t height, unsigned seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> noise(-4, 4);
+		Dynarray<u8> image;
+		image.Resize(width * height * 4);
+		for (size_t y = 0; y < height; ++y)
+		{
+			for (size_t x = 0; x < width; ++x)
+			{
+				u8* pixel = image.GetData() + (y * width + x) * 4;
+				pixel[0] = static_cast<u8>(Clamp<int>(int(x * 255 / width) + noise(rng), 0, 255));
+				pixel[1] = static_cast<u8>(Clamp<int>(int(y * 255 / height) + noise(rng), 0, 255));
+				pixel[2] = static_cast<u8>(Clamp<int>(int((x + y) * 127 / (width + height)) + 64 + noise(rng), 0, 255));
+				pixel[3] = static_cast<u8>(255 - x * 255 / width);
+			}
+		}
+		return image;
+	}
+
+	int GetMaxError(const Dynarray<u8>& lhs, const Dynarray<u8>& rhs, size_t channel)
+	{
+		int maxError = 0;
+		for (size_t i = channel; i < lhs.GetSize(); i += 4)
+			maxError = std::max(maxError, std::abs(int(lhs[i]) - int(rhs[i])));
+		return maxError;
+	}
+
+	Dynarray<u8> EncodeAndDecode(eTextureDataFormat format, const Dynarray<u8>& image, size_t width, size_t height)
+	{
+		Dynarray<u8> blocks;
+		blocks.Resize(CookedTexture::GetImageSize(format, width, height));
+		CookedTexture::Encode(format, image.GetData(), width, height, blocks.GetData());
+		Dynarray<u8> decoded;
+		decoded.Resize(width * height * 4);
+		CookedTexture::Decode(format, blocks.GetData(), width, height, decoded.GetData());
+		return decoded;
+	}
+}
+
+TEST_CASE("Cooked texture sizes", "[CookedTexture]")
+{
+	CHECK(CookedTexture::GetMipCount(1, 1) == 1);
+	CHECK(CookedTexture::GetMipCount(256, 256) == 9);
+	CHECK(CookedTexture::GetMipCount(300, 20) == 9);
+	CHECK(CookedTexture::GetImageSize(eTextureDataFormat::RGBA, 5, 3) == 60);
+	CHECK(CookedTexture::GetImageSize(eTextureDataFormat::BC1, 5, 3) == 16);
+	CHECK(CookedTexture::GetImageSize(eTextureDataFormat::BC3, 5, 3) == 32);
+	CHECK(CookedTexture::GetImageSize(eTextureDataFormat::BC7, 1, 1) == 16);
+
+	const u8 image[4 * 3 * 4] = {
+		0, 0, 0, 0,  4, 4, 4, 4,  100, 0, 0, 0,  200, 0, 0, 0,
+		8, 8, 8, 8,  12, 12, 12, 12,  100, 0, 0, 0,  200, 0, 0, 0,
+		40, 0, 0, 0,  40, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0,
+	};
+	u8 mip[2 * 4];
+	CookedTexture::Downsample(image, 4, 3, mip);
+	CHECK(mip[0] == 6);
+	CHECK(mip[3] == 6);
+	CHECK(mip[4] == 150);
+}
+
+TEST_CASE("Block compression", "[CookedTexture]")
+{
+	// size that is not a multiple of block size
+	const size_t width = 37, height = 21;
+	const Dynarray<u8> image = CreateImage(width, height, 7);
+
+	SECTION("BC1")
+	{
+		const Dynarray<u8> decoded = EncodeAndDecode(eTextureDataFormat::BC1, image, width, height);
+		// 1-bit alpha, transparent pixels are black
+		int maxError = 0;
+		for (size_t i = 0; i < image.GetSize(); i += 4)
+		{
+			CHECK(decoded[i + 3] == (image[i + 3] >= 128 ? 255 : 0));
+			for (size_t c = 0; c < 3; ++c)
+				maxError = std::max(maxError, std::abs(int(image[i + c]) - int(decoded[i + c])) * (decoded[i + 3] / 255));
+		}
+		CHECK(maxError <= 24);
+	}
+
+	SECTION("BC3")
+	{
+		const Dynarray<u8> decoded = EncodeAndDecode(eTextureDataFormat::BC3, image, width, height);
+		for (size_t c = 0; c < 3; ++c)
+			CHECK(GetMaxError(image, decoded, c) <= 24);
+		CHECK(GetMaxError(image, decoded, 3) <= 4);
+	}
+
+	SECTION("BC7")
+	{
+		const Dynarray<u8> decoded = EncodeAndDecode(eTextureDataFormat::BC7, image, width, height);
+		for (size_t c = 0; c < 4; ++c)
+			CHECK(GetMaxError(image, decoded, c) <= 20);
+	}
+
+	SECTION("Uniform blocks")
+	{
+		Dynarray<u8> uniform;
+		uniform.Resize(8 * 8 * 4);
+		for (size_t i = 0; i < uniform.GetSize(); i += 4)
+		{
+			uniform[i] = 200;
+			uniform[i + 1] = 17;
+			uniform[i + 2] = 90;
+			uniform[i + 3] = 255;
+		}
+		for (eTextureDataFormat format : { eTextureDataFormat::BC1, eTextureDataFormat::BC3, eTextureDataFormat::BC7 })
+		{
+			const Dynarray<u8> decoded = EncodeAndDecode(format, uniform, 8, 8);
+			for (size_t c = 0; c < 4; ++c)
+				CHECK(GetMaxError(uniform, decoded, c) <= 4);
+		}
+	}
+}
+
+TEST_CASE("Cooked texture loading", "[CookedTexture]")
+{
+	const size_t width = 12, height = 5;
+	const Dynarray<u8> image = CreateImage(width, height, 3);
+	CookedTexture::Write(image.GetData(), width, height, eTextureDataFormat::BC3, "cooked_texture_test.tex");
+
+	{
+		TextureResource texture("cooked_texture_test.tex");
+		CHECK(texture.GetWidth() == 12);
+		CHECK(texture.GetHeight() == 5);
+		CHECK(texture.GetImage() == nullptr);
+		CHECK(texture.GetFormat() == eTextureDataFormat::BC3);
+
+		const Dynarray<TextureMip>& mips = texture.GetMips();
+		REQUIRE(mips.GetSize() == 4);
+		const size_t sizes[4][2] = { { 12, 5 }, { 6, 2 }, { 3, 1 }, { 1, 1 } };
+		for (size_t i = 0; i < 4; ++i)
+		{
+			CHECK(mips[i].Width == sizes[i][0]);
+			CHECK(mips[i].Height == sizes[i][1]);
+			CHECK(mips[i].Size == CookedTexture::GetImageSize(eTextureDataFormat::BC3, sizes[i][0], sizes[i][1]));
+			CHECK(reinterpret_cast<uintptr_t>(mips[i].Data) % CookedTexture::BLOB_ALIGNMENT == 0);
+		}
+
+		// base level is stored as passed, next levels are downsampled from previous ones
+		Dynarray<u8> blocks;
+		blocks.Resize(mips[0].Size);
+		CookedTexture::Encode(eTextureDataFormat::BC3, image.GetData(), width, height, blocks.GetData());
+		CHECK(memcmp(mips[0].Data, blocks.GetData(), mips[0].Size) == 0);
+
+		Dynarray<u8> mip;
+		mip.Resize(6 * 2 * 4);
+		CookedTexture::Downsample(image.GetData(), width, height, mip.GetData());
+		CookedTexture::Encode(eTextureDataFormat::BC3, mip.GetData(), 6, 2, blocks.GetData());
+		CHECK(memcmp(mips[1].Data, blocks.GetData(), mips[1].Size) == 0);
+	}
+
+	std::remove("cooked_texture_test.tex");
+}
+
+TEST_CASE("Cooked texture validation", "[CookedTexture]")
+{
+	const Dynarray<u8> image = CreateImage(8, 8, 1);
+	CookedTexture::Write(image.GetData(), 8, 8, eTextureDataFormat::RGBA, "cooked_texture_validation.tex");
+	Dynarray<u8> file;
+	{
+		MemoryMappedFile mapped("cooked_texture_validation.tex");
+		file.Resize(mapped.GetSize());
+		memcpy(file.GetData(), mapped.GetData(), mapped.GetSize());
+	}
+	std::remove("cooked_texture_validation.tex");
+
+	CookedTexture::FileHeader& header = *reinterpret_cast<CookedTexture::FileHeader*>(file.GetData());
+	CookedTexture::MipHeader* mips = reinterpret_cast<CookedTexture::MipHeader*>(file.GetData() + sizeof(CookedTexture::FileHeader));
+	REQUIRE(CookedTexture::Validate(file.GetData(), file.GetSize()));
+	CHECK(header.MipCount == 4);
+	CHECK(memcmp(file.GetData() + mips[0].DataOffset, image.GetData(), image.GetSize()) == 0);
+
+	SECTION("Truncated file")
+	{
+		CHECK(!CookedTexture::Validate(file.GetData(), file.GetSize() - 1));
+		CHECK(!CookedTexture::Validate(file.GetData(), sizeof(CookedTexture::FileHeader) + 4));
+	}
+
+	SECTION("Unsupported version")
+	{
+		header.Version = CookedTexture::VERSION + 1;
+		CHECK(!CookedTexture::Validate(file.GetData(), file.GetSize()));
+	}
+
+	SECTION("Unsupported format")
+	{
+		header.Format = static_cast<u32>(eTextureDataFormat::RGB);
+		CHECK(!CookedTexture::Validate(file.GetData(), file.GetSize()));
+	}
+
+	SECTION("Partial mip chain")
+	{
+		header.MipCount = 3;
+		CHECK(!CookedTexture::Validate(file.GetData(), file.GetSize()));
+	}
+
+	SECTION("Wrong mip size")
+	{
+		mips[2].Width = 4;
+		CHECK(!CookedTexture::Validate(file.GetData(), file.GetSize()));
+	}
+}
+
+TEST_CASE("Texture cooking benchmark", "[.][Benchmark][CookedTexture]")
+{
+	const size_t size = 1024;
+	const Dynarray<u8> image = CreateImage(size, size, 5);
+	for (eTextureDataFormat format : { eTextureDataFormat::RGBA, eTextureDataFormat::BC1, eTextureDataFormat::BC3, eTextureDataFormat::BC7 })
+	{
+		auto start = std::chrono::steady_clock::now();
+		CookedTexture::Write(image.GetData(), size, size, format, "cooked_texture_benchmark.tex");
+		const double cookMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		const int iterations = 20;
+		size_t fileSize = 0;
+		start = std::chrono::steady_clock::now();
+		for (int it = 0; it < iterations; ++it)
+		{
+			TextureResource texture("cooked_texture_benchmark.tex");
+			for (const TextureMip& mip : texture.GetMips())
+				fileSize += mip.Size;
+		}
+		const double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+		Dynarray<u8> blocks;
+		blocks.Resize(CookedTexture::GetImageSize(format, size, size));
+		CookedTexture::Encode(format, image.GetData(), size, size, blocks.GetData());
+		Dynarray<u8> decoded;
+		decoded.Resize(size * size * 4);
+		start = std::chrono::steady_clock::now();
+		CookedTexture::Decode(format, blocks.GetData(), size, size, decoded.GetData());
+		const double decodeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		gConsole.LogInfo("Texture {}x{} format {}: {} KB with mips, cook {} ms, mapped load {} ms, base level CPU decode {} ms",
+			size, size, static_cast<int>(format), fileSize / iterations / 1024, cookMs, loadMs, decodeMs);
+	}
+	std::remove("cooked_texture_benchmark.tex");
+}
@@ -0,0 +1,73 @@
+#include <catch.hpp>
+
+#define _WINDLL
+#define _GAME //fake being a game for the dllexport macros
+#include <MeshResource.hpp>
+#include <CookedMesh.hpp>
+#include <CullingSystem.hpp>
+#include <Frustum.hpp>
+#include <FileIO.hpp>
+
+#include <cstdio>
+
+using namespace Poly;
+
+namespace
+{
+	// cooked mesh without vertices, only bounding volumes of a unit cube at the origin are stored
+	void WriteBoundsOnlyMesh(const String& path)
+	{
+		using namespace CookedMesh;
+		SubMeshHeader subMesh;
+		memset(&subMesh, 0, sizeof(subMesh));
+		subMesh.VertexStride = 3 * sizeof(float);
+		subMesh.VertexDataOffset = sizeof(FileHeader) + sizeof(SubMeshHeader);
+		subMesh.IndexDataOffset = subMesh.VertexDataOffset;
+		subMesh.DiffuseTexturePathOffset = subMesh.VertexDataOffset;
+		subMesh.BoxMin[0] = subMesh.BoxMin[1] = subMesh.BoxMin[2] = -0.5f;
+		subMesh.BoxSize[0] = subMesh.BoxSize[1] = subMesh.BoxSize[2] = 1.0f;
+		subMesh.SphereRadius = std::sqrt(0.75f);
+
+		const FileHeader header = { MAGIC, VERSION, 1, 0 };
+		u8 file[sizeof(FileHeader) + sizeof(SubMeshHeader)];
+		memcpy(file, &header, sizeof(header));
+		memcpy(file + sizeof(header), &subMesh, sizeof(subMesh));
+		SaveBinaryFile(path, file, sizeof(file));
+	}
+
+	// camera at (x, 0, 5) looking down -Z, frustum half width at Z = 0 is ~2.89
+	Frustum MakeFrustum(float x)
+	{
+		Matrix projection, view;
+		projection.SetPerspective(60_deg, 1.0f, 1.0f, 100.0f);
+		view.SetTranslation(Vector(-x, 0.0f, -5.0f));
+		return Frustum(projection * view);
+	}
+}
+
+TEST_CASE("Culling translated meshes", "[Culling]")
+{
+	WriteBoundsOnlyMesh("culling_test.mesh");
+	{
+		MeshResource mesh("culling_test.mesh");
+		REQUIRE(mesh.GetSubMeshes().GetSize() == 1);
+
+		Matrix transform;
+		transform.SetTranslation(Vector(100.0f, 0.0f, 0.0f));
+		// translation is applied once, not scaled by W of the box center
+		CHECK(CullingSystem::IsSubMeshVisible(mesh, 0, transform, MakeFrustum(100.0f)));
+		CHECK(!CullingSystem::IsSubMeshVisible(mesh, 0, transform, MakeFrustum(150.0f)));
+		CHECK(!CullingSystem::IsSubMeshVisible(mesh, 0, transform, MakeFrustum(0.0f)));
+
+		// visible only while a part of the cube is inside the frustum
+		transform.SetTranslation(Vector(103.0f, 0.0f, 0.0f));
+		CHECK(CullingSystem::IsSubMeshVisible(mesh, 0, transform, MakeFrustum(100.0f)));
+		transform.SetTranslation(Vector(104.0f, 0.0f, 0.0f));
+		CHECK(!CullingSystem::IsSubMeshVisible(mesh, 0, transform, MakeFrustum(100.0f)));
+
+		Matrix scale;
+		scale.SetScale(Vector(4.0f, 1.0f, 1.0f));
+		CHECK(CullingSystem::IsSubMeshVisible(mesh, 0, transform * scale, MakeFrustum(100.0f)));
+	}
+	std::remove("culling_test.mesh");
+}
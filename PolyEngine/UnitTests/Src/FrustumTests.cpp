@@ -0,0 +1,78 @@
+#include <catch.hpp>
+
+#include <Frustum.hpp>
+
+using namespace Poly;
+
+namespace
+{
+	// camera at (0, 0, 5) looking down -Z, frustum half width at the origin is 5 * tan(30deg) ~ 2.89
+	Frustum MakeFrustum()
+	{
+		Matrix projection, view;
+		projection.SetPerspective(60_deg, 1.0f, 1.0f, 100.0f);
+		view.SetTranslation(Vector(0.0f, 0.0f, -5.0f));
+		return Frustum(projection * view);
+	}
+}
+
+TEST_CASE("Frustum planes", "[Frustum]")
+{
+	const Frustum frustum = MakeFrustum();
+
+	// normals point inside
+	const Vector& zNear = frustum.GetPlane(Frustum::ePlane::ZNEAR);
+	REQUIRE(zNear.Z == Approx(-1.0f));
+	REQUIRE(zNear.W == Approx(4.0f));
+	const Vector& zFar = frustum.GetPlane(Frustum::ePlane::ZFAR);
+	REQUIRE(zFar.Z == Approx(1.0f));
+	REQUIRE(zFar.W == Approx(95.0f));
+	REQUIRE(frustum.GetPlane(Frustum::ePlane::LEFT).X > 0.0f);
+	REQUIRE(frustum.GetPlane(Frustum::ePlane::RIGHT).X < 0.0f);
+	REQUIRE(frustum.GetPlane(Frustum::ePlane::BOTTOM).Y > 0.0f);
+	REQUIRE(frustum.GetPlane(Frustum::ePlane::TOP).Y < 0.0f);
+}
+
+TEST_CASE("Frustum sphere visibility", "[Frustum]")
+{
+	const Frustum frustum = MakeFrustum();
+
+	REQUIRE(frustum.IsSphereVisible(Vector(0.0f, 0.0f, 0.0f), 1.0f));
+	REQUIRE(frustum.IsSphereVisible(Vector(0.0f, 0.0f, -90.0f), 1.0f));
+
+	// behind the camera, in front of near plane and beyond far plane
+	REQUIRE(!frustum.IsSphereVisible(Vector(0.0f, 0.0f, 10.0f), 1.0f));
+	REQUIRE(!frustum.IsSphereVisible(Vector(0.0f, 0.0f, 4.5f), 0.25f));
+	REQUIRE(!frustum.IsSphereVisible(Vector(0.0f, 0.0f, -200.0f), 1.0f));
+
+	// on the sides
+	REQUIRE(!frustum.IsSphereVisible(Vector(50.0f, 0.0f, 0.0f), 1.0f));
+	REQUIRE(!frustum.IsSphereVisible(Vector(0.0f, -50.0f, 0.0f), 1.0f));
+
+	// partially inside
+	REQUIRE(frustum.IsSphereVisible(Vector(3.5f, 0.0f, 0.0f), 1.0f));
+	REQUIRE(!frustum.IsSphereVisible(Vector(3.5f, 0.0f, 0.0f), 0.25f));
+	REQUIRE(frustum.IsSphereVisible(Vector(0.0f, 0.0f, 4.5f), 1.0f));
+}
+
+TEST_CASE("Frustum box visibility", "[Frustum]")
+{
+	const Frustum frustum = MakeFrustum();
+
+	REQUIRE(frustum.IsBoxVisible(Vector(0.0f, 0.0f, 0.0f), Vector(1.0f, 1.0f, 1.0f)));
+	REQUIRE(!frustum.IsBoxVisible(Vector(0.0f, 0.0f, 10.0f), Vector(1.0f, 1.0f, 1.0f)));
+	REQUIRE(!frustum.IsBoxVisible(Vector(0.0f, 0.0f, -200.0f), Vector(1.0f, 1.0f, 1.0f)));
+	REQUIRE(!frustum.IsBoxVisible(Vector(0.0f, 50.0f, 0.0f), Vector(1.0f, 1.0f, 1.0f)));
+
+	// partially inside
+	REQUIRE(frustum.IsBoxVisible(Vector(3.5f, 0.0f, 0.0f), Vector(1.0f, 1.0f, 1.0f)));
+	REQUIRE(!frustum.IsBoxVisible(Vector(3.5f, 0.0f, 0.0f), Vector(0.25f, 0.25f, 0.25f)));
+
+	// box containing whole frustum
+	REQUIRE(frustum.IsBoxVisible(Vector(0.0f, 0.0f, 0.0f), Vector(500.0f, 500.0f, 500.0f)));
+
+	const AABox visible(Vector(2.5f, -0.5f, -0.5f), Vector(1.0f, 1.0f, 1.0f));
+	const AABox invisible(Vector(3.25f, -0.5f, -0.5f), Vector(1.0f, 1.0f, 1.0f));
+	REQUIRE(frustum.IsBoxVisible(visible));
+	REQUIRE(!frustum.IsBoxVisible(invisible));
+}
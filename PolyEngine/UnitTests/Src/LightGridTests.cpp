@@ -0,0 +1,171 @@
+#include <catch.hpp>
+
+#include <LightGrid.hpp>
+#include <ThreadPool.hpp>
+#include <Logger.hpp>
+
+#include <chrono>
+#include <random>
+
+using namespace Poly;
+
+namespace
+{
+	Dynarray<u32> GetClusterLights(const LightGrid& grid, size_t tileX, size_t tileY, size_t slice)
+	{
+		const LightGrid::Cluster& cluster = grid.GetClusters()[grid.GetClusterIndex(tileX, tileY, slice)];
+		Dynarray<u32> lights;
+		for (u32 i = cluster.Offset; i < cluster.Offset + cluster.Count; ++i)
+			lights.PushBack(grid.GetLightIndices()[i]);
+		return lights;
+	}
+
+	void RandomLights(std::mt19937& rng, size_t count, Dynarray<Vector>& positions, Dynarray<float>& ranges)
+	{
+		std::uniform_real_distribution<float> xy(-60.0f, 60.0f);
+		std::uniform_real_distribution<float> z(-100.0f, 5.0f);
+		std::uniform_real_distribution<float> range(0.5f, 8.0f);
+		positions.Clear();
+		ranges.Clear();
+		for (size_t i = 0; i < count; ++i)
+		{
+			positions.PushBack(Vector(xy(rng), xy(rng), z(rng)));
+			ranges.PushBack(range(rng));
+		}
+	}
+}
+
+TEST_CASE("LightGrid assignment", "[LightGrid]")
+{
+	// camera at origin looking along -Z, tiles split exactly at the view axis
+	LightGrid grid(4, 4, 8);
+	grid.SetPerspective(90_deg, 1.0f, 1.0f, 100.0f);
+
+	SECTION("Slices")
+	{
+		CHECK(grid.GetSlice(0.5f) == 0);
+		CHECK(grid.GetSlice(1.5f) == 0);
+		CHECK(grid.GetSlice(99.0f) == 7);
+		CHECK(grid.GetSlice(1000.0f) == 7);
+		// slices grow exponentially, 100^(4/8) = 10
+		CHECK(grid.GetSlice(9.9f) == 3);
+		CHECK(grid.GetSlice(10.1f) == 4);
+	}
+
+	SECTION("Light on the view axis")
+	{
+		grid.Build(Matrix(), { Vector(0.0f, 0.0f, -5.0f) }, { 0.5f });
+		const size_t slice = grid.GetSlice(5.0f);
+		for (size_t tileY = 0; tileY < 4; ++tileY)
+		{
+			for (size_t tileX = 0; tileX < 4; ++tileX)
+			{
+				const bool central = (tileX == 1 || tileX == 2) && (tileY == 1 || tileY == 2);
+				CHECK(GetClusterLights(grid, tileX, tileY, slice) == (central ? Dynarray<u32>{ 0 } : Dynarray<u32>{}));
+			}
+		}
+		CHECK(grid.GetLightIndices().GetSize() == 4);
+	}
+
+	SECTION("Lights outside of the frustum")
+	{
+		grid.Build(Matrix(), { Vector(0.0f, 0.0f, 5.0f), Vector(0.0f, 0.0f, -200.0f), Vector(50.0f, 0.0f, -10.0f) }, { 1.0f, 1.0f, 1.0f });
+		CHECK(grid.GetLightIndices().IsEmpty());
+	}
+
+	SECTION("View transformation")
+	{
+		// camera moved to (100, 0, 0), so the light is again on the view axis
+		Matrix cameraTransform;
+		cameraTransform.SetTranslation(Vector(100.0f, 0.0f, 0.0f));
+		grid.Build(cameraTransform.GetAffineInversed(), { Vector(100.0f, 0.0f, -5.0f) }, { 0.5f });
+		CHECK(GetClusterLights(grid, 1, 1, grid.GetSlice(5.0f)) == Dynarray<u32>{ 0 });
+		CHECK(grid.GetLightIndices().GetSize() == 4);
+	}
+}
+
+TEST_CASE("LightGrid is conservative", "[LightGrid]")
+{
+	std::mt19937 rng(42);
+	Dynarray<Vector> positions;
+	Dynarray<float> ranges;
+	RandomLights(rng, 300, positions, ranges);
+
+	const float aspect = 16.0f / 9.0f;
+	const float tanHalfFov = Tan(30_deg);
+	LightGrid grid(16, 9, 24);
+	grid.SetPerspective(60_deg, aspect, 0.5f, 120.0f);
+	grid.Build(Matrix(), positions, ranges);
+
+	// every point has to find all lights reaching it in its cluster, the same way shader looks the cluster up
+	std::uniform_real_distribution<float> ndc(-0.999f, 0.999f);
+	std::uniform_real_distribution<float> depthDist(0.6f, 119.0f);
+	for (int i = 0; i < 2000; ++i)
+	{
+		const float ndcX = ndc(rng), ndcY = ndc(rng), depth = depthDist(rng);
+		const Vector point(ndcX * depth * tanHalfFov * aspect, ndcY * depth * tanHalfFov, -depth);
+		const size_t tileX = static_cast<size_t>((ndcX + 1.0f) * 0.5f * 16);
+		const size_t tileY = static_cast<size_t>((ndcY + 1.0f) * 0.5f * 9);
+		const Dynarray<u32> clusterLights = GetClusterLights(grid, tileX, tileY, grid.GetSlice(depth));
+
+		for (size_t light = 0; light < positions.GetSize(); ++light)
+		{
+			if ((positions[light] - point).LengthSquared() < ranges[light] * ranges[light] * 0.99f)
+				CHECK(clusterLights.Contains(static_cast<u32>(light)));
+		}
+	}
+}
+
+TEST_CASE("LightGrid multithreaded build", "[LightGrid]")
+{
+	std::mt19937 rng(7);
+	Dynarray<Vector> positions;
+	Dynarray<float> ranges;
+	RandomLights(rng, 500, positions, ranges);
+
+	LightGrid single, multi;
+	single.SetPerspective(60_deg, 1.5f, 0.1f, 150.0f);
+	multi.SetPerspective(60_deg, 1.5f, 0.1f, 150.0f);
+
+	ThreadPool pool(3);
+	single.Build(Matrix(), positions, ranges);
+	multi.Build(Matrix(), positions, ranges, &pool);
+
+	REQUIRE(single.GetLightIndices() == multi.GetLightIndices());
+	REQUIRE(single.GetClusters().GetSize() == multi.GetClusters().GetSize());
+	for (size_t i = 0; i < single.GetClusters().GetSize(); ++i)
+	{
+		CHECK(single.GetClusters()[i].Offset == multi.GetClusters()[i].Offset);
+		CHECK(single.GetClusters()[i].Count == multi.GetClusters()[i].Count);
+	}
+}
+
+TEST_CASE("LightGrid build benchmark", "[.][Benchmark][LightGrid]")
+{
+	std::mt19937 rng(1234);
+	const int iterations = 50;
+
+	for (size_t lightCount : { 100, 1000, 4000 })
+	{
+		Dynarray<Vector> positions;
+		Dynarray<float> ranges;
+		RandomLights(rng, lightCount, positions, ranges);
+
+		LightGrid grid(16, 9, 24);
+		grid.SetPerspective(60_deg, 16.0f / 9.0f, 0.1f, 150.0f);
+
+		auto start = std::chrono::steady_clock::now();
+		for (int it = 0; it < iterations; ++it)
+			grid.Build(Matrix(), positions, ranges);
+		const double singleMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+		ThreadPool pool;
+		start = std::chrono::steady_clock::now();
+		for (int it = 0; it < iterations; ++it)
+			grid.Build(Matrix(), positions, ranges, &pool);
+		const double multiMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+		gConsole.LogInfo("LightGrid build of {} lights ({} assignments): single thread {} ms, {} workers {} ms",
+			lightCount, grid.GetLightIndices().GetSize(), singleMs, pool.GetWorkerCount(), multiMs);
+	}
+}
@@ -0,0 +1,61 @@
+#include <catch.hpp>
+
+#include <Logger.hpp>
+
+#include <cstdio>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace Poly;
+
+namespace
+{
+	// collects the output, checked once logging threads are joined
+	class StringOutputStream : public OutputStream
+	{
+	public:
+		StringOutputStream(std::string* output) : Output(output) {}
+		void Append(const char* data) override { Output->append(data); }
+
+	private:
+		std::string* Output;
+	};
+}
+
+TEST_CASE("Console logging from multiple threads", "[Logger]")
+{
+	std::string output;
+	gConsole.RegisterStream<StringOutputStream>(&output);
+
+	const int threadCount = 4;
+	const int messageCount = 500;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; ++t)
+		threads.emplace_back([t]() {
+			for (int i = 0; i < messageCount; ++i)
+				gConsole.LogInfo("thread {} message {} end", t, i);
+		});
+	for (std::thread& thread : threads)
+		thread.join();
+	gConsole.RegisterDefaultStream();
+
+	// messages are whole lines, in order within each thread
+	int nextMessage[threadCount] = {};
+	std::istringstream lines(output);
+	std::string line;
+	int lineCount = 0;
+	while (std::getline(lines, line))
+	{
+		int t = -1, i = -1;
+		char end[4] = {};
+		REQUIRE(sscanf(line.c_str(), "[INFO] thread %d message %d %3s", &t, &i, end) == 3);
+		REQUIRE(std::string(end) == "end");
+		REQUIRE(t >= 0);
+		REQUIRE(t < threadCount);
+		REQUIRE(i == nextMessage[t]);
+		++nextMessage[t];
+		++lineCount;
+	}
+	CHECK(lineCount == threadCount * messageCount);
+}
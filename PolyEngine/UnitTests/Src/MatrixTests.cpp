@@ -2,6 +2,10 @@
 
 #include <Matrix.hpp>
 #include <Quaternion.hpp>
+#include <SimdMath.hpp>
+#include <Logger.hpp>
+
+#include <chrono>
 
 using namespace Poly;
 
@@ -344,3 +348,85 @@ TEST_CASE("Matrix decomposition", "[Matrix]") {
 		REQUIRE(p == Vector());
 	}
 }
+
+namespace {
+  // deterministic, well conditioned test matrices
+  Matrix MakeTestMatrix(int seed) {
+    Matrix m;
+    for(int i=0; i<16; ++i)
+      m.Data[i] = float((seed * 37 + i * 11) % 19) - 9.0f + (i%5==0 ? 20.0f : 0.0f);
+    return m;
+  }
+
+  Matrix MakeAffineTestMatrix(int seed) {
+    Matrix t, r, s, skew;
+    t.SetTranslation(Vector(float(seed % 7) - 3, float(seed % 5), -2.5f));
+    r = (Matrix)Quaternion(Vector(1, float(seed % 3), 2).GetNormalized(), Angle::FromDegrees(float(seed * 13)));
+    s.SetScale(Vector(1.0f + seed % 4, 0.5f, 2.0f));
+    skew.m01 = 0.25f * (seed % 2);
+    return t * r * skew * s;
+  }
+
+  void RequireMatricesClose(const Matrix& a, const Matrix& b) {
+    // relative tolerance, SIMD kernels sum products in different order
+    for(int i=0; i<16; ++i)
+      REQUIRE(Cmpf(a.Data[i], b.Data[i], CMPF_EPS * std::max(1.0f, std::abs(b.Data[i]))));
+  }
+}
+
+TEST_CASE("Matrix SIMD kernels match scalar path", "[Matrix]") {
+  const eSimdInstructionSet defaultSet = GetSimdInstructionSet();
+  for(int set = int(eSimdInstructionSet::SSE); set < int(eSimdInstructionSet::_COUNT); ++set) {
+    if(!IsSimdInstructionSetSupported(eSimdInstructionSet(set)))
+      continue;
+
+    for(int seed=0; seed<32; ++seed) {
+      const Matrix a = MakeTestMatrix(seed), b = MakeTestMatrix(seed + 1), affine = MakeAffineTestMatrix(seed);
+
+      SetSimdInstructionSet(eSimdInstructionSet::NONE);
+      const Matrix product = a * b;
+      const Matrix inverse = a.GetInversed();
+      const Matrix affineInverse = affine.GetInversed();
+      const Matrix scalarAffineInverse = affine.GetAffineInversed();
+
+      SetSimdInstructionSet(eSimdInstructionSet(set));
+      RequireMatricesClose(a * b, product);
+      RequireMatricesClose(a.GetInversed(), inverse);
+      RequireMatricesClose(affine.GetAffineInversed(), affineInverse);
+      RequireMatricesClose(scalarAffineInverse, affineInverse);
+      RequireMatricesClose(affine * affine.GetAffineInversed(), Matrix());
+    }
+  }
+  SetSimdInstructionSet(defaultSet);
+}
+
+TEST_CASE("Matrix kernels benchmark", "[.][Benchmark][Matrix]") {
+  const size_t count = 1024;
+  const size_t passes = 1000;
+  Dynarray<Matrix> matrices, results;
+  for(size_t i=0; i<count; ++i) {
+    matrices.PushBack(MakeAffineTestMatrix(int(i)));
+    results.PushBack(Matrix());
+  }
+
+  const eSimdInstructionSet defaultSet = GetSimdInstructionSet();
+  for(int set = int(eSimdInstructionSet::NONE); set < int(eSimdInstructionSet::_COUNT); ++set) {
+    if(!IsSimdInstructionSetSupported(eSimdInstructionSet(set)))
+      continue;
+    SetSimdInstructionSet(eSimdInstructionSet(set));
+
+    auto measure = [&](auto op) {
+      const auto start = std::chrono::high_resolution_clock::now();
+      for(size_t pass=0; pass<passes; ++pass)
+        for(size_t i=0; i<count; ++i)
+          op(i);
+      const std::chrono::duration<double, std::nano> elapsed = std::chrono::high_resolution_clock::now() - start;
+      return elapsed.count() / (passes * count);
+    };
+    const double multiply = measure([&](size_t i) { results[i] = matrices[i] * matrices[(i + 1) % count]; });
+    const double inverse = measure([&](size_t i) { results[i] = matrices[i].GetInversed(); });
+    const double affineInverse = measure([&](size_t i) { results[i] = matrices[i].GetAffineInversed(); });
+    gConsole.LogInfo("Matrix kernels, instruction set {}: multiply {} ns, inverse {} ns, affine inverse {} ns", set, multiply, inverse, affineInverse);
+  }
+  SetSimdInstructionSet(defaultSet);
+}
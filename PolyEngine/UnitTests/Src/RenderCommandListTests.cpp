@@ -0,0 +1,180 @@
+#include <catch.hpp>
+
+#include <RenderCommandList.hpp>
+#include <NullRenderingDevice.hpp>
+#include <ThreadPool.hpp>
+#include <Logger.hpp>
+
+#include <chrono>
+#include <random>
+
+using namespace Poly;
+
+namespace
+{
+	// synthetic scene: packets are built from pools of fake resources, identified by their addresses only
+	struct FakeScene
+	{
+		FakeScene(size_t meshCount, size_t textureCount, size_t packetCount, unsigned seed)
+		{
+			MeshProxies.Resize(meshCount);
+			Textures.Resize(textureCount);
+			std::mt19937 rng(seed);
+			std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+			for (size_t i = 0; i < packetCount; ++i)
+			{
+				Objects.PushBack(Object{ rng() % meshCount, rng() % textureCount, Vector(position(rng), position(rng), position(rng)) });
+			}
+		}
+
+		RenderCommandList::PacketBuilder GetBuilder() const
+		{
+			return [this](size_t idx, RenderCommandList::DrawPacket& packet)
+			{
+				const Object& object = Objects[idx];
+				packet.Transform.SetTranslation(object.Position);
+				packet.Mesh = nullptr;
+				packet.SubMeshIdx = 0;
+				packet.MeshProxy = reinterpret_cast<const IMeshDeviceProxy*>(&MeshProxies[object.Mesh]);
+				packet.Texture = reinterpret_cast<const ITextureDeviceProxy*>(&Textures[object.Texture]);
+				packet.IndexCount = 36;
+				return RenderQueue::MakeSortKey(0, 0, RenderCommandList::GetSortId(packet.Texture),
+					RenderCommandList::GetSortId(packet.MeshProxy), object.Position.Length());
+			};
+		}
+
+		struct Object
+		{
+			size_t Mesh;
+			size_t Texture;
+			Vector Position;
+		};
+
+		Dynarray<u64> MeshProxies;
+		Dynarray<u64> Textures;
+		Dynarray<Object> Objects;
+	};
+
+	const AARect FULL_SCREEN(Vector2f(0.0f, 0.0f), Vector2f(1.0f, 1.0f));
+}
+
+TEST_CASE("RenderCommandList recording", "[RenderCommandList]")
+{
+	FakeScene scene(8, 3, 2000, 5);
+	RenderCommandList commands;
+
+	SECTION("Packets are sorted by state")
+	{
+		const RenderCommandList::View& view = commands.RecordView(nullptr, FULL_SCREEN, scene.Objects.GetSize(), scene.GetBuilder());
+		REQUIRE(commands.GetViewCount() == 1);
+		REQUIRE(view.Packets.GetSize() == 2000);
+		REQUIRE(view.Queue.GetSize() == 2000);
+
+		// every combination of texture and mesh forms a single run
+		Dynarray<std::pair<const void*, const void*>> runs;
+		for (const RenderQueue::Entry& entry : view.Queue.GetEntries())
+		{
+			const RenderCommandList::DrawPacket& packet = view.Packets[entry.Index];
+			const std::pair<const void*, const void*> state(packet.Texture, packet.MeshProxy);
+			if (runs.IsEmpty() || runs[runs.GetSize() - 1] != state)
+			{
+				CHECK_FALSE(runs.Contains(state));
+				runs.PushBack(state);
+			}
+		}
+		CHECK(runs.GetSize() == 8 * 3);
+	}
+
+	SECTION("Views are found by camera and reused")
+	{
+		const CameraComponent* first = reinterpret_cast<const CameraComponent*>(&scene.MeshProxies[0]);
+		const CameraComponent* second = reinterpret_cast<const CameraComponent*>(&scene.MeshProxies[1]);
+		commands.RecordView(first, FULL_SCREEN, 10, scene.GetBuilder());
+		commands.RecordView(second, FULL_SCREEN, 20, scene.GetBuilder());
+		REQUIRE(commands.GetViewCount() == 2);
+		REQUIRE(commands.FindView(first)->Packets.GetSize() == 10);
+		REQUIRE(commands.FindView(second)->Packets.GetSize() == 20);
+		REQUIRE(commands.FindView(nullptr) == nullptr);
+
+		commands.Clear();
+		REQUIRE(commands.GetViewCount() == 0);
+		REQUIRE(commands.FindView(first) == nullptr);
+		commands.RecordView(second, FULL_SCREEN, 5, scene.GetBuilder());
+		REQUIRE(commands.FindView(second)->Packets.GetSize() == 5);
+	}
+
+	SECTION("Multithreaded recording")
+	{
+		ThreadPool pool(3);
+		RenderCommandList pooledCommands;
+		const RenderCommandList::View& single = commands.RecordView(nullptr, FULL_SCREEN, scene.Objects.GetSize(), scene.GetBuilder());
+		const RenderCommandList::View& pooled = pooledCommands.RecordView(nullptr, FULL_SCREEN, scene.Objects.GetSize(), scene.GetBuilder(), &pool);
+
+		REQUIRE(single.Queue.GetSize() == pooled.Queue.GetSize());
+		for (size_t i = 0; i < single.Queue.GetSize(); ++i)
+		{
+			REQUIRE(single.Queue.GetEntries()[i].SortKey == pooled.Queue.GetEntries()[i].SortKey);
+			REQUIRE(single.Queue.GetEntries()[i].Index == pooled.Queue.GetEntries()[i].Index);
+			REQUIRE(pooled.Packets[i].Transform == single.Packets[i].Transform);
+		}
+	}
+}
+
+TEST_CASE("NullRenderingDevice replays command lists", "[RenderCommandList]")
+{
+	FakeScene scene(8, 3, 2000, 11);
+	RenderCommandList commands;
+	commands.RecordView(nullptr, FULL_SCREEN, scene.Objects.GetSize(), scene.GetBuilder());
+	commands.RecordView(nullptr, FULL_SCREEN, 0, scene.GetBuilder());
+
+	NullRenderingDevice device;
+	device.RenderWorld(nullptr, commands);
+	const RenderingStats& stats = device.GetLastFrameStats();
+	CHECK(stats.DrawCalls == 2000);
+	// empty view does not bind the program, sorted packets bind every mesh once per texture
+	CHECK(stats.ProgramBinds == 1);
+	CHECK(stats.TextureBinds == 3);
+	CHECK(stats.VertexArrayBinds == 8 * 3);
+
+	commands.Clear();
+	device.RenderWorld(nullptr, commands);
+	CHECK(device.GetLastFrameStats().DrawCalls == 0);
+}
+
+TEST_CASE("RenderCommandList recording benchmark", "[.][Benchmark][RenderCommandList]")
+{
+	const int iterations = 20;
+	for (size_t packetCount : { 1000, 10000, 100000 })
+	{
+		FakeScene scene(64, 16, packetCount, 3);
+		const RenderCommandList::PacketBuilder builder = scene.GetBuilder();
+		RenderCommandList commands;
+		NullRenderingDevice device;
+
+		auto start = std::chrono::steady_clock::now();
+		for (int it = 0; it < iterations; ++it)
+		{
+			commands.Clear();
+			commands.RecordView(nullptr, FULL_SCREEN, packetCount, builder);
+		}
+		const double singleMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+		ThreadPool pool;
+		start = std::chrono::steady_clock::now();
+		for (int it = 0; it < iterations; ++it)
+		{
+			commands.Clear();
+			commands.RecordView(nullptr, FULL_SCREEN, packetCount, builder, &pool);
+		}
+		const double pooledMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+		start = std::chrono::steady_clock::now();
+		for (int it = 0; it < iterations; ++it)
+			device.RenderWorld(nullptr, commands);
+		const double replayMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+		const RenderingStats& stats = device.GetLastFrameStats();
+		gConsole.LogInfo("Recording {} packets: single thread {} ms, {} workers {} ms, null replay {} ms ({} mesh binds, {} texture binds)",
+			packetCount, singleMs, pool.GetWorkerCount(), pooledMs, replayMs, stats.VertexArrayBinds, stats.TextureBinds);
+	}
+}
@@ -0,0 +1,116 @@
+#include <catch.hpp>
+
+#include <RenderQueue.hpp>
+#include <Logger.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+using namespace Poly;
+
+TEST_CASE("RenderQueue sort keys", "[RenderQueue]")
+{
+	// fields are ordered from the most significant one
+	REQUIRE(RenderQueue::MakeSortKey(1, 0, 0, 0, 0.0f) > RenderQueue::MakeSortKey(0, 1023, 65535, 65535, 1000.0f));
+	REQUIRE(RenderQueue::MakeSortKey(0, 2, 0, 0, 0.0f) > RenderQueue::MakeSortKey(0, 1, 65535, 65535, 1000.0f));
+	REQUIRE(RenderQueue::MakeSortKey(0, 1, 2, 0, 0.0f) > RenderQueue::MakeSortKey(0, 1, 1, 65535, 1000.0f));
+	REQUIRE(RenderQueue::MakeSortKey(0, 1, 1, 2, 0.0f) > RenderQueue::MakeSortKey(0, 1, 1, 1, 1000.0f));
+
+	// items sharing state are ordered front to back
+	REQUIRE(RenderQueue::MakeSortKey(0, 1, 1, 1, 10.0f) > RenderQueue::MakeSortKey(0, 1, 1, 1, 1.0f));
+	REQUIRE(RenderQueue::MakeSortKey(0, 1, 1, 1, 1.0f) > RenderQueue::MakeSortKey(0, 1, 1, 1, 0.5f));
+	REQUIRE(RenderQueue::MakeSortKey(0, 1, 1, 1, -5.0f) == RenderQueue::MakeSortKey(0, 1, 1, 1, 0.0f));
+
+	// too wide identifiers do not spill into other fields
+	REQUIRE(RenderQueue::MakeSortKey(0, 0, 0x10001, 0, 0.0f) == RenderQueue::MakeSortKey(0, 0, 1, 0, 0.0f));
+}
+
+TEST_CASE("RenderQueue radix sort", "[RenderQueue]")
+{
+	std::mt19937 rng(std::rand());
+
+	SECTION("Random keys")
+	{
+		RenderQueue queue;
+		Dynarray<u64> keys;
+		for (u32 i = 0; i < 5000; ++i)
+		{
+			const u64 key = (u64(rng()) << 32) | rng();
+			keys.PushBack(key);
+			queue.Push(key, i);
+		}
+		queue.Sort();
+
+		std::sort(keys.Begin(), keys.End());
+		REQUIRE(queue.GetSize() == keys.GetSize());
+		for (size_t i = 0; i < keys.GetSize(); ++i)
+		{
+			REQUIRE(queue.GetEntries()[i].SortKey == keys[i]);
+			REQUIRE(queue.GetEntries()[i].Index < keys.GetSize());
+		}
+	}
+
+	SECTION("Sort is stable and skips equal bytes")
+	{
+		RenderQueue queue;
+		// keys differ only in texture field, indices of equal keys have to stay in push order
+		for (u32 i = 0; i < 1000; ++i)
+			queue.Push(RenderQueue::MakeSortKey(3, 7, rng() % 4, 5, 1.0f), i);
+		queue.Sort();
+
+		const Dynarray<RenderQueue::Entry>& entries = queue.GetEntries();
+		for (size_t i = 1; i < entries.GetSize(); ++i)
+		{
+			REQUIRE(entries[i - 1].SortKey <= entries[i].SortKey);
+			if (entries[i - 1].SortKey == entries[i].SortKey)
+				REQUIRE(entries[i - 1].Index < entries[i].Index);
+		}
+	}
+
+	SECTION("Empty and single item queues")
+	{
+		RenderQueue queue;
+		queue.Sort();
+		REQUIRE(queue.IsEmpty());
+		queue.Push(42, 0);
+		queue.Sort();
+		REQUIRE(queue.GetEntries()[0].SortKey == 42);
+		queue.Clear();
+		REQUIRE(queue.IsEmpty());
+	}
+}
+
+TEST_CASE("RenderQueue sort benchmark", "[.][Benchmark][RenderQueue]")
+{
+	std::mt19937 rng(1234);
+	const u32 count = 50000;
+	const int iterations = 20;
+
+	// typical frame: few shaders, hundreds of textures and meshes, random depths
+	Dynarray<RenderQueue::Entry> source;
+	for (u32 i = 0; i < count; ++i)
+		source.PushBack(RenderQueue::Entry{ RenderQueue::MakeSortKey(0, rng() % 4, rng() % 300, rng() % 500, float(rng() % 10000) * 0.01f), i });
+
+	RenderQueue queue;
+	auto start = std::chrono::steady_clock::now();
+	for (int it = 0; it < iterations; ++it)
+	{
+		queue.Clear();
+		for (const RenderQueue::Entry& entry : source)
+			queue.Push(entry.SortKey, entry.Index);
+		queue.Sort();
+	}
+	const double radixMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+	Dynarray<RenderQueue::Entry> sorted;
+	start = std::chrono::steady_clock::now();
+	for (int it = 0; it < iterations; ++it)
+	{
+		sorted = source;
+		std::stable_sort(sorted.Begin(), sorted.End(), [](const RenderQueue::Entry& a, const RenderQueue::Entry& b) { return a.SortKey < b.SortKey; });
+	}
+	const double stdMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+	gConsole.LogInfo("RenderQueue sort of {} items: radix {} ms, std::stable_sort {} ms", count, radixMs, stdMs);
+}
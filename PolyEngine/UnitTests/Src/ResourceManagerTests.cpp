@@ -4,6 +4,11 @@
 #define _GAME //fake being a game for the dllexport macros
 #include <ResourceManager.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <thread>
+
 using namespace Poly;
 
 class DummyResource : public Poly::ResourceBase
@@ -12,10 +17,134 @@ class DummyResource : public Poly::ResourceBase
 	DummyResource(const String& /*path*/) {}
 };
 
+// records threads of both loading stages, paths starting with '!' fail to load, paths ending with '!' fail to create device resources
+class AsyncDummyResource : public Poly::ResourceBase
+{
+public:
+	AsyncDummyResource(const String& path) : DecodeThread(std::this_thread::get_id()), DeviceFailure(path.EndsWith('!'))
+	{
+		++ConstructedCount;
+		if (path.StartsWith('!'))
+			throw ResourceLoadFailedException();
+	}
+
+	std::thread::id DecodeThread;
+	std::thread::id UploadThread;
+	static std::atomic<int> ConstructedCount;
+
+protected:
+	void CreateDeviceResources() override
+	{
+		UploadThread = std::this_thread::get_id();
+		if (DeviceFailure)
+			throw ResourceLoadFailedException();
+	}
+
+private:
+	bool DeviceFailure;
+};
+
+std::atomic<int> AsyncDummyResource::ConstructedCount{ 0 };
+
+// references an async dummy like a mesh references its texture, path of the dependency has "dep_" prefix
+class AsyncDependentDummyResource : public Poly::ResourceBase
+{
+public:
+	AsyncDependentDummyResource(const String& path) : DependencyPath(String("dep_") + path) {}
+	~AsyncDependentDummyResource() override
+	{
+		if (Dependency)
+			ResourceManager<AsyncDummyResource>::Release(Dependency);
+		else if (DependencyLoad.IsReady() && DependencyLoad.Get())
+			ResourceManager<AsyncDummyResource>::Release(DependencyLoad.Get());
+	}
+
+	AsyncDummyResource* Dependency = nullptr;
+
+protected:
+	bool LoadDependenciesAsync() override
+	{
+		if (!DependencyLoad.IsValid())
+			DependencyLoad = ResourceManager<AsyncDummyResource>::LoadAsync(DependencyPath);
+		return DependencyLoad.IsReady();
+	}
+
+	void CreateDeviceResources() override { OnRevived(); }
+	void OnCached() override
+	{
+		if (Dependency)
+			ResourceManager<AsyncDummyResource>::Release(Dependency);
+		Dependency = nullptr;
+	}
+	void OnRevived() override
+	{
+		if (DependencyLoad.IsValid())
+		{
+			Dependency = DependencyLoad.Wait();
+			DependencyLoad = ResourceFuture<AsyncDummyResource>();
+		}
+		else
+		{
+			Dependency = ResourceManager<AsyncDummyResource>::Load(DependencyPath);
+		}
+	}
+
+private:
+	String DependencyPath;
+	ResourceFuture<AsyncDummyResource> DependencyLoad;
+};
+
+// every resource takes 100 bytes, paths of freed resources are recorded
+class CachedDummyResource : public Poly::ResourceBase
+{
+public:
+	CachedDummyResource(const String& /*path*/) {}
+	~CachedDummyResource() override { FreedPaths.PushBack(GetPath()); }
+
+	size_t GetMemorySize() const override { return 100; }
+
+	static Dynarray<String> FreedPaths;
+};
+
+Dynarray<String> CachedDummyResource::FreedPaths;
+
+// references a cached dummy like a mesh references its texture, path of the dependency has "tex_" prefix
+class DependentDummyResource : public Poly::ResourceBase
+{
+public:
+	DependentDummyResource(const String& path) : DependencyPath(String("tex_") + path) {}
+	~DependentDummyResource() override { OnCached(); }
+
+	size_t GetMemorySize() const override { return 10; }
+
+	CachedDummyResource* Dependency = nullptr;
+
+protected:
+	void CreateDeviceResources() override { OnRevived(); }
+	void OnCached() override
+	{
+		if (Dependency)
+			ResourceManager<CachedDummyResource>::Release(Dependency);
+		Dependency = nullptr;
+	}
+	void OnRevived() override { Dependency = ResourceManager<CachedDummyResource>::Load(DependencyPath); }
+
+private:
+	String DependencyPath;
+};
+
 namespace Poly {
 	DECLARE_RESOURCE(DummyResource, gDummyResourcesMap)
+	DECLARE_RESOURCE(AsyncDummyResource, gAsyncDummyResourcesMap)
+	DECLARE_RESOURCE(AsyncDependentDummyResource, gAsyncDependentDummyResourcesMap)
+	DECLARE_RESOURCE(CachedDummyResource, gCachedDummyResourcesMap)
+	DECLARE_RESOURCE(DependentDummyResource, gDependentDummyResourcesMap)
 }
 DEFINE_RESOURCE(DummyResource, gDummyResourcesMap)
+DEFINE_RESOURCE(AsyncDummyResource, gAsyncDummyResourcesMap)
+DEFINE_RESOURCE(AsyncDependentDummyResource, gAsyncDependentDummyResourcesMap)
+DEFINE_RESOURCE(CachedDummyResource, gCachedDummyResourcesMap)
+DEFINE_RESOURCE(DependentDummyResource, gDependentDummyResourcesMap)
 
 TEST_CASE("ResourceManager loading/freeing", "[ResourceManager]")
 {
@@ -46,3 +175,435 @@ TEST_CASE("ResourceManager loading/freeing", "[ResourceManager]")
 	ResourceManager<DummyResource>::Release(res3);
 	ResourceManager<DummyResource>::Release(res4);
 }
+
+TEST_CASE("ResourceManager registry growth and removal", "[ResourceManager]")
+{
+	// enough resources to grow the table several times, freed slots are reused in between
+	const size_t count = 1000;
+	Dynarray<DummyResource*> resources;
+	for (size_t i = 0; i < count; ++i)
+	{
+		resources.PushBack(ResourceManager<DummyResource>::Load(String::From(static_cast<int>(i))));
+		if (i % 3 == 0)
+			ResourceManager<DummyResource>::Release(ResourceManager<DummyResource>::Load(String("tmp") + String::From(static_cast<int>(i))));
+	}
+	CHECK(Impl::GetResources<DummyResource>().GetCount() == count);
+
+	for (size_t i = 0; i < count; i += 2)
+		ResourceManager<DummyResource>::Release(resources[i]);
+	CHECK(Impl::GetResources<DummyResource>().GetCount() == count / 2);
+
+	// resources that moved during growth are still found and released by their slots
+	for (size_t i = 1; i < count; i += 2)
+	{
+		DummyResource* res = ResourceManager<DummyResource>::Load(String::From(static_cast<int>(i)));
+		REQUIRE(res == resources[i]);
+		CHECK(res->GetRefCount() == 2);
+		ResourceManager<DummyResource>::Release(res);
+	}
+	for (size_t i = 0; i < count; i += 2)
+	{
+		resources[i] = ResourceManager<DummyResource>::Load(String::From(static_cast<int>(i)));
+		CHECK(resources[i]->GetRefCount() == 1);
+	}
+	for (DummyResource* res : resources)
+		ResourceManager<DummyResource>::Release(res);
+	CHECK(Impl::GetResources<DummyResource>().GetCount() == 0);
+}
+
+TEST_CASE("ResourceManager asynchronous loading", "[ResourceManager]")
+{
+	AsyncDummyResource::ConstructedCount = 0;
+
+	SECTION("Decoding runs in background, device resources are created on the main thread")
+	{
+		ResourceFuture<AsyncDummyResource> future = ResourceManager<AsyncDummyResource>::LoadAsync("a");
+		REQUIRE(future.IsValid());
+		// loads are finished only by the main thread
+		REQUIRE_FALSE(future.IsReady());
+
+		AsyncDummyResource* res = future.Wait();
+		REQUIRE(future.IsReady());
+		REQUIRE(res != nullptr);
+		CHECK(res->GetPath() == "a");
+		CHECK(res->GetRefCount() == 1);
+		CHECK(res->DecodeThread != std::this_thread::get_id());
+		CHECK(res->UploadThread == std::this_thread::get_id());
+		CHECK(gResourceLoader.GetPendingCount() == 0);
+
+		// already registered resource is ready immediately
+		ResourceFuture<AsyncDummyResource> loaded = ResourceManager<AsyncDummyResource>::LoadAsync("a");
+		REQUIRE(loaded.IsReady());
+		CHECK(loaded.Get() == res);
+		CHECK(res->GetRefCount() == 2);
+		CHECK(ResourceManager<AsyncDummyResource>::Load("a") == res);
+		CHECK(AsyncDummyResource::ConstructedCount == 1);
+
+		for (int i = 0; i < 3; ++i)
+			ResourceManager<AsyncDummyResource>::Release(res);
+	}
+
+	SECTION("Requests for the same path share the load")
+	{
+		ResourceFuture<AsyncDummyResource> first = ResourceManager<AsyncDummyResource>::LoadAsync("b");
+		ResourceFuture<AsyncDummyResource> second = ResourceManager<AsyncDummyResource>::LoadAsync("b");
+		CHECK(gResourceLoader.GetPendingCount() == 1);
+		gResourceLoader.Flush();
+
+		REQUIRE(first.IsReady());
+		REQUIRE(second.IsReady());
+		REQUIRE(first.Get() == second.Get());
+		CHECK(first.Get()->GetRefCount() == 2);
+		CHECK(AsyncDummyResource::ConstructedCount == 1);
+
+		ResourceManager<AsyncDummyResource>::Release(first.Get());
+		ResourceManager<AsyncDummyResource>::Release(second.Get());
+	}
+
+	SECTION("Synchronous load during decoding")
+	{
+		ResourceFuture<AsyncDummyResource> future = ResourceManager<AsyncDummyResource>::LoadAsync("c");
+		AsyncDummyResource* res = ResourceManager<AsyncDummyResource>::Load("c");
+		// decoded copy is dropped in favour of the registered one
+		CHECK(future.Wait() == res);
+		CHECK(res->GetRefCount() == 2);
+
+		ResourceManager<AsyncDummyResource>::Release(res);
+		ResourceManager<AsyncDummyResource>::Release(res);
+	}
+
+	SECTION("Failed load")
+	{
+		ResourceFuture<AsyncDummyResource> future = ResourceManager<AsyncDummyResource>::LoadAsync("!missing");
+		CHECK(future.Wait() == nullptr);
+		CHECK(future.IsReady());
+		CHECK(gResourceLoader.GetPendingCount() == 0);
+	}
+
+	SECTION("Failed device resources creation")
+	{
+		// failure is reported by the future instead of escaping the loader
+		ResourceFuture<AsyncDummyResource> future = ResourceManager<AsyncDummyResource>::LoadAsync("device!");
+		CHECK(future.Wait() == nullptr);
+		CHECK(gResourceLoader.GetPendingCount() == 0);
+		CHECK(ResourceManager<AsyncDummyResource>::Load("device!") == nullptr);
+		CHECK(Impl::GetResources<AsyncDummyResource>().GetCount() == 0);
+	}
+
+	SECTION("Upload budget")
+	{
+		const float budget = gResourceLoader.GetUploadBudget();
+		gResourceLoader.SetUploadBudget(0.0f);
+
+		Dynarray<ResourceFuture<AsyncDummyResource>> futures;
+		for (const char* path : { "d", "e", "f", "g" })
+			futures.PushBack(ResourceManager<AsyncDummyResource>::LoadAsync(path));
+
+		// exhausted budget still lets one load finish every update
+		size_t finished = 0;
+		while (gResourceLoader.GetPendingCount() > 0)
+		{
+			const size_t count = gResourceLoader.Update();
+			CHECK(count <= 1);
+			finished += count;
+		}
+		CHECK(finished == 4);
+		gResourceLoader.SetUploadBudget(budget);
+
+		for (const ResourceFuture<AsyncDummyResource>& future : futures)
+		{
+			REQUIRE(future.IsReady());
+			ResourceManager<AsyncDummyResource>::Release(future.Get());
+		}
+	}
+}
+
+TEST_CASE("ResourceManager asynchronous loading of dependencies", "[ResourceManager]")
+{
+	typedef ResourceManager<AsyncDependentDummyResource> Manager;
+
+	SECTION("Dependencies are decoded in background before the resource is registered")
+	{
+		ResourceFuture<AsyncDependentDummyResource> future = Manager::LoadAsync("a");
+		AsyncDependentDummyResource* res = future.Wait();
+		REQUIRE(res != nullptr);
+		REQUIRE(res->Dependency != nullptr);
+		CHECK(res->Dependency->GetPath() == "dep_a");
+		CHECK(res->Dependency->GetRefCount() == 1);
+		CHECK(res->Dependency->DecodeThread != std::this_thread::get_id());
+		CHECK(res->Dependency->UploadThread == std::this_thread::get_id());
+		CHECK(gResourceLoader.GetPendingCount() == 0);
+
+		Manager::Release(res);
+		CHECK(Impl::GetResources<AsyncDummyResource>().GetCount() == 0);
+	}
+
+	SECTION("Resource waiting for dependencies is finished by later updates")
+	{
+		ResourceFuture<AsyncDependentDummyResource> future = Manager::LoadAsync("b");
+		while (!future.IsReady())
+			gResourceLoader.Update();
+		REQUIRE(future.Get() != nullptr);
+		REQUIRE(future.Get()->Dependency != nullptr);
+		CHECK(gResourceLoader.GetPendingCount() == 0);
+		Manager::Release(future.Get());
+	}
+
+	SECTION("Failed dependency does not fail the resource")
+	{
+		ResourceFuture<AsyncDependentDummyResource> future = Manager::LoadAsync("c!");
+		AsyncDependentDummyResource* res = future.Wait();
+		REQUIRE(res != nullptr);
+		CHECK(res->Dependency == nullptr);
+		CHECK(gResourceLoader.GetPendingCount() == 0);
+		Manager::Release(res);
+	}
+
+	SECTION("Synchronous load while waiting for dependencies")
+	{
+		ResourceFuture<AsyncDependentDummyResource> future = Manager::LoadAsync("d");
+		AsyncDependentDummyResource* res = Manager::Load("d");
+		// decoded copy is dropped together with the dependency reference it got
+		CHECK(future.Wait() == res);
+		REQUIRE(res->Dependency != nullptr);
+		CHECK(res->Dependency->GetRefCount() == 1);
+
+		Manager::Release(res);
+		Manager::Release(res);
+		CHECK(Impl::GetResources<AsyncDummyResource>().GetCount() == 0);
+	}
+}
+
+TEST_CASE("ResourceManager asynchronous revival of cached resource", "[ResourceManager]")
+{
+	typedef ResourceManager<AsyncDependentDummyResource> Manager;
+	Manager::SetCacheBudget(1000);
+	Manager::ResetCacheStats();
+	AsyncDependentDummyResource* res = Manager::LoadAsync("a").Wait();
+	REQUIRE(res != nullptr);
+	REQUIRE(res->Dependency != nullptr);
+	// cached resource releases its dependency, dependency without cache budget is freed
+	Manager::Release(res);
+	CHECK(res->Dependency == nullptr);
+	CHECK(Impl::GetResources<AsyncDummyResource>().GetCount() == 0);
+
+	SECTION("Dependencies are loaded in background before the revived resource is ready")
+	{
+		ResourceFuture<AsyncDependentDummyResource> future = Manager::LoadAsync("a");
+		// nothing is loaded synchronously, the dependency load is pending together with the revival
+		REQUIRE_FALSE(future.IsReady());
+		CHECK(res->Dependency == nullptr);
+		CHECK(gResourceLoader.GetPendingCount() == 2);
+		CHECK(Manager::GetCacheStats().Hits == 1);
+		CHECK(Manager::GetCacheStats().CachedCount == 0);
+		while (!future.IsReady())
+			gResourceLoader.Update();
+		REQUIRE(future.Get() == res);
+		CHECK(res->GetRefCount() == 1);
+		REQUIRE(res->Dependency != nullptr);
+		CHECK(res->Dependency->GetRefCount() == 1);
+		CHECK(res->Dependency->DecodeThread != std::this_thread::get_id());
+		CHECK(gResourceLoader.GetPendingCount() == 0);
+		Manager::Release(res);
+	}
+	SECTION("Requests for a reviving resource share the revival")
+	{
+		ResourceFuture<AsyncDependentDummyResource> first = Manager::LoadAsync("a");
+		ResourceFuture<AsyncDependentDummyResource> second = Manager::LoadAsync("a");
+		CHECK(gResourceLoader.GetPendingCount() == 2);
+		gResourceLoader.Flush();
+		REQUIRE(first.IsReady());
+		REQUIRE(second.IsReady());
+		CHECK(first.Get() == res);
+		CHECK(second.Get() == res);
+		CHECK(res->GetRefCount() == 2);
+		REQUIRE(res->Dependency != nullptr);
+		CHECK(res->Dependency->GetRefCount() == 1);
+		Manager::Release(res);
+		Manager::Release(res);
+	}
+	SECTION("Synchronous load during revival")
+	{
+		ResourceFuture<AsyncDependentDummyResource> future = Manager::LoadAsync("a");
+		// revival is completed right away, taking over the dependency load that was already started
+		CHECK(Manager::Load("a") == res);
+		REQUIRE(res->Dependency != nullptr);
+		CHECK(res->Dependency->DecodeThread != std::this_thread::get_id());
+		CHECK(future.Wait() == res);
+		CHECK(res->GetRefCount() == 2);
+		CHECK(res->Dependency->GetRefCount() == 1);
+		CHECK(gResourceLoader.GetPendingCount() == 0);
+		Manager::Release(res);
+		Manager::Release(res);
+	}
+
+	Manager::SetCacheBudget(0);
+	CHECK(Impl::GetResources<AsyncDependentDummyResource>().GetCount() == 0);
+	CHECK(Impl::GetResources<AsyncDummyResource>().GetCount() == 0);
+}
+
+TEST_CASE("ResourceManager cache", "[ResourceManager]")
+{
+	typedef ResourceManager<CachedDummyResource> Manager;
+	CachedDummyResource::FreedPaths.Clear();
+	Manager::ResetCacheStats();
+
+	SECTION("Without budget resources are freed with the last reference")
+	{
+		CachedDummyResource* res = Manager::Load("a");
+		Manager::Release(res);
+		CHECK(CachedDummyResource::FreedPaths.GetSize() == 1);
+		CHECK(Manager::GetCacheStats().CachedCount == 0);
+		CHECK(Manager::GetCacheStats().Misses == 1);
+	}
+
+	SECTION("Unreferenced resources are evicted in LRU order")
+	{
+		Manager::SetCacheBudget(250);
+		CachedDummyResource* a = Manager::Load("a");
+		CachedDummyResource* b = Manager::Load("b");
+		CachedDummyResource* c = Manager::Load("c");
+		// referenced resources are not counted as hits
+		Manager::Release(Manager::Load("a"));
+		CHECK(Manager::GetCacheStats().Hits == 0);
+		CHECK(Manager::GetCacheStats().Misses == 3);
+
+		Manager::Release(a);
+		Manager::Release(b);
+		CHECK(Manager::GetCacheStats().CachedCount == 2);
+		CHECK(Manager::GetCacheStats().CachedBytes == 200);
+		Manager::Release(c);
+		REQUIRE(CachedDummyResource::FreedPaths.GetSize() == 1);
+		CHECK(CachedDummyResource::FreedPaths[0] == "a");
+		CHECK(Manager::GetCacheStats().Evictions == 1);
+
+		// revived resource becomes the most recently used one once released again
+		CHECK(Manager::Load("b") == b);
+		CHECK(b->GetRefCount() == 1);
+		CHECK(Manager::GetCacheStats().Hits == 1);
+		CHECK(Manager::GetCacheStats().CachedBytes == 100);
+		Manager::Release(b);
+		Manager::Release(Manager::Load("d"));
+		REQUIRE(CachedDummyResource::FreedPaths.GetSize() == 2);
+		CHECK(CachedDummyResource::FreedPaths[1] == "c");
+
+		// cached resource is ready immediately for asynchronous loads
+		ResourceFuture<CachedDummyResource> future = Manager::LoadAsync("d");
+		REQUIRE(future.IsReady());
+		CHECK(Manager::GetCacheStats().Hits == 2);
+		Manager::Release(future.Get());
+
+		Manager::SetCacheBudget(100);
+		CHECK(CachedDummyResource::FreedPaths.GetSize() == 3);
+		CHECK(CachedDummyResource::FreedPaths[2] == "b");
+		Manager::ClearCache();
+		CHECK(CachedDummyResource::FreedPaths.GetSize() == 4);
+		CHECK(Manager::GetCacheStats().CachedCount == 0);
+		CHECK(Manager::GetCacheStats().CachedBytes == 0);
+		CHECK(Manager::GetCacheStats().Evictions == 4);
+
+		Manager::ResetCacheStats();
+		CHECK(Manager::GetCacheStats().Hits == 0);
+		CHECK(Manager::GetCacheStats().Misses == 0);
+		CHECK(Manager::GetCacheStats().Evictions == 0);
+		Manager::SetCacheBudget(0);
+	}
+
+	SECTION("Disabling cache frees cached resources")
+	{
+		Manager::SetCacheBudget(1000);
+		Manager::Release(Manager::Load("a"));
+		Manager::Release(Manager::Load("b"));
+		CHECK(CachedDummyResource::FreedPaths.IsEmpty());
+		Manager::SetCacheBudget(0);
+		CHECK(CachedDummyResource::FreedPaths.GetSize() == 2);
+		CHECK(Manager::GetCacheStats().CachedCount == 0);
+	}
+}
+
+TEST_CASE("ResourceManager cached resource releases its dependencies", "[ResourceManager]")
+{
+	typedef ResourceManager<CachedDummyResource> Textures;
+	typedef ResourceManager<DependentDummyResource> Meshes;
+	CachedDummyResource::FreedPaths.Clear();
+	Textures::ResetCacheStats();
+	Textures::SetCacheBudget(200);
+	Meshes::SetCacheBudget(1000);
+
+	DependentDummyResource* mesh = Meshes::Load("a");
+	CachedDummyResource* texture = mesh->Dependency;
+	REQUIRE(texture != nullptr);
+	CHECK(texture->GetRefCount() == 1);
+
+	// cached mesh does not hold its texture, so the texture is cached and budgeted on its own
+	Meshes::Release(mesh);
+	CHECK(Meshes::GetCacheStats().CachedCount == 1);
+	CHECK(mesh->Dependency == nullptr);
+	CHECK(Textures::GetCacheStats().CachedCount == 1);
+	CHECK(Textures::GetCacheStats().CachedBytes == 100);
+
+	// reviving the mesh takes the cached texture back
+	CHECK(Meshes::Load("a") == mesh);
+	CHECK(mesh->Dependency == texture);
+	CHECK(texture->GetRefCount() == 1);
+	CHECK(Textures::GetCacheStats().CachedCount == 0);
+	CHECK(Textures::GetCacheStats().Hits == 1);
+	Meshes::Release(mesh);
+
+	// texture budget evicts texture of the cached mesh, it is loaded again when the mesh is revived
+	Textures::Release(Textures::Load("b"));
+	Textures::Release(Textures::Load("c"));
+	REQUIRE(CachedDummyResource::FreedPaths.GetSize() == 1);
+	CHECK(CachedDummyResource::FreedPaths[0] == "tex_a");
+	CHECK(Meshes::GetCacheStats().CachedCount == 1);
+
+	CHECK(Meshes::Load("a") == mesh);
+	REQUIRE(mesh->Dependency != nullptr);
+	CHECK(mesh->Dependency->GetPath() == "tex_a");
+	CHECK(mesh->Dependency->GetRefCount() == 1);
+	Meshes::Release(mesh);
+
+	Meshes::SetCacheBudget(0);
+	Textures::SetCacheBudget(0);
+	CHECK(Impl::GetResources<DependentDummyResource>().GetCount() == 0);
+	CHECK(Impl::GetResources<CachedDummyResource>().GetCount() == 0);
+}
+
+TEST_CASE("ResourceManager reference churn benchmark", "[.][Benchmark][ResourceManager]")
+{
+	// entities sharing a few thousand textures acquire and release them every frame
+	const int resourceCount = 4096;
+	const int iterations = 200;
+	Dynarray<String> paths;
+	Dynarray<DummyResource*> resources;
+	for (int i = 0; i < resourceCount; ++i)
+	{
+		paths.PushBack(String("Textures/Environment/Props/texture_") + String::From(i) + String(".png"));
+		resources.PushBack(ResourceManager<DummyResource>::Load(paths[i]));
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for (int it = 0; it < iterations; ++it)
+		for (const String& path : paths)
+			ResourceManager<DummyResource>::Release(ResourceManager<DummyResource>::Load(path));
+	const double registryMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+	// previous registry, ordered map looked up on both load and release
+	std::map<String, DummyResource*> map;
+	for (int i = 0; i < resourceCount; ++i)
+		map[paths[i]] = resources[i];
+	size_t found = 0;
+	start = std::chrono::steady_clock::now();
+	for (int it = 0; it < iterations; ++it)
+		for (const String& path : paths)
+		{
+			DummyResource* res = map.find(path)->second;
+			found += map.find(res->GetPath()) != map.end();
+		}
+	const double mapMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+	REQUIRE(found == size_t(resourceCount) * iterations);
+
+	for (DummyResource* res : resources)
+		ResourceManager<DummyResource>::Release(res);
+	gConsole.LogInfo("Load and release of {} shared resources: hash registry {} ms, ordered map lookups {} ms", resourceCount, registryMs, mapMs);
+}
@@ -0,0 +1,100 @@
+#include <catch.hpp>
+
+#include <RingAllocator.hpp>
+
+using namespace Poly;
+
+static const size_t INVALID_OFFSET = RingAllocator::INVALID_OFFSET;
+
+TEST_CASE("Ring allocator alignment", "[Allocator]") {
+	RingAllocator ring(100);
+	REQUIRE(ring.Allocate(10, 1) == 0);
+	REQUIRE(ring.Allocate(10, 16) == 16);
+	REQUIRE(ring.Allocate(4, 4) == 28);
+	REQUIRE(ring.GetUsedSize() == 32);
+	REQUIRE(ring.GetPendingBatchCount() == 0);
+}
+
+TEST_CASE("Ring allocator wrapping", "[Allocator]") {
+	RingAllocator ring(100);
+	REQUIRE(ring.Allocate(60, 1) == 0);
+	REQUIRE(ring.EndBatch());
+	REQUIRE(ring.Allocate(30, 1) == 60);
+	REQUIRE(ring.EndBatch());
+
+	SECTION("Allocation is not split, rest of the ring is skipped") {
+		// 10 bytes left at the end, allocation wraps onto the first batch
+		REQUIRE(ring.Allocate(20, 1) == INVALID_OFFSET);
+		ring.ReleaseOldestBatch();
+		REQUIRE(ring.Allocate(20, 1) == 0);
+		REQUIRE(ring.GetUsedSize() == 60); // 30 of the second batch, 10 skipped and 20 allocated
+		REQUIRE(ring.Allocate(40, 1) == 20);
+		REQUIRE(ring.Allocate(1, 1) == INVALID_OFFSET);
+	}
+
+	SECTION("Aligned offset past the end wraps") {
+		REQUIRE(ring.Allocate(8, 16) == INVALID_OFFSET);
+		ring.ReleaseOldestBatch();
+		REQUIRE(ring.Allocate(8, 16) == 0);
+	}
+
+	SECTION("Allocation fits exactly at the end") {
+		REQUIRE(ring.Allocate(10, 1) == 90);
+		REQUIRE(ring.Allocate(1, 1) == INVALID_OFFSET);
+	}
+}
+
+TEST_CASE("Ring allocator batch retirement", "[Allocator]") {
+	RingAllocator ring(100);
+	REQUIRE_FALSE(ring.EndBatch()); // nothing allocated
+
+	for (size_t i = 0; i < 4; ++i)
+	{
+		REQUIRE(ring.Allocate(25, 1) == i * 25);
+		REQUIRE(ring.EndBatch());
+		REQUIRE_FALSE(ring.EndBatch());
+	}
+	REQUIRE(ring.GetPendingBatchCount() == 4);
+	REQUIRE(ring.GetUsedSize() == 100);
+	REQUIRE(ring.Allocate(50, 1) == INVALID_OFFSET);
+
+	// batches are released in order, each one frees only its own memory
+	ring.ReleaseOldestBatch();
+	REQUIRE(ring.GetUsedSize() == 75);
+	REQUIRE(ring.Allocate(50, 1) == INVALID_OFFSET);
+	ring.ReleaseOldestBatch();
+	REQUIRE(ring.Allocate(50, 1) == 0);
+	REQUIRE(ring.Allocate(1, 1) == INVALID_OFFSET);
+
+	ring.ReleaseOldestBatch();
+	ring.ReleaseOldestBatch();
+	REQUIRE(ring.GetPendingBatchCount() == 0);
+	// memory allocated since the last batch is not released
+	REQUIRE(ring.Allocate(50, 1) == 50);
+	REQUIRE(ring.Allocate(1, 1) == INVALID_OFFSET);
+
+	REQUIRE(ring.EndBatch());
+	ring.ReleaseOldestBatch();
+	REQUIRE(ring.GetUsedSize() == 0);
+}
+
+TEST_CASE("Ring allocator without pending batches", "[Allocator]") {
+	RingAllocator ring(100);
+	REQUIRE(ring.Allocate(70, 1) == 0);
+	REQUIRE(ring.EndBatch());
+	ring.ReleaseOldestBatch();
+	REQUIRE(ring.GetPendingBatchCount() == 0);
+	REQUIRE(ring.GetUsedSize() == 0);
+
+	// everything is released, so wrapping allocation larger than the skipped range does not wait for any batch
+	REQUIRE(ring.Allocate(80, 1) == 0);
+	REQUIRE(ring.GetUsedSize() == 80);
+	REQUIRE(ring.EndBatch());
+	ring.ReleaseOldestBatch();
+
+	// allocation of the whole ring always succeeds once nothing is pending
+	REQUIRE(ring.Allocate(100, 1) == 0);
+	REQUIRE(ring.EndBatch());
+	ring.ReleaseOldestBatch();
+	REQUIRE(ring.Allocate(100, 64) == 0);
+}
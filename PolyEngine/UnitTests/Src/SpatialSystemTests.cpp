@@ -0,0 +1,78 @@
+#include <catch.hpp>
+
+#define _WINDLL
+#define _GAME //fake being a game for the dllexport macros
+#include <MeshResource.hpp>
+#include <CookedMesh.hpp>
+#include <SpatialSystem.hpp>
+#include <SpatialWorldComponent.hpp>
+#include <TransformComponent.hpp>
+#include <FileIO.hpp>
+
+#include <cstdio>
+
+using namespace Poly;
+
+namespace
+{
+	// cooked mesh without vertices, only bounding volumes of a cube at the origin are stored
+	void WriteBoundsOnlyMesh(const String& path, float halfSize)
+	{
+		using namespace CookedMesh;
+		SubMeshHeader subMesh;
+		memset(&subMesh, 0, sizeof(subMesh));
+		subMesh.VertexStride = 3 * sizeof(float);
+		subMesh.VertexDataOffset = sizeof(FileHeader) + sizeof(SubMeshHeader);
+		subMesh.IndexDataOffset = subMesh.VertexDataOffset;
+		subMesh.DiffuseTexturePathOffset = subMesh.VertexDataOffset;
+		subMesh.BoxMin[0] = subMesh.BoxMin[1] = subMesh.BoxMin[2] = -halfSize;
+		subMesh.BoxSize[0] = subMesh.BoxSize[1] = subMesh.BoxSize[2] = 2.0f * halfSize;
+		subMesh.SphereRadius = std::sqrt(3.0f) * halfSize;
+
+		const FileHeader header = { MAGIC, VERSION, 1, 0 };
+		u8 file[sizeof(FileHeader) + sizeof(SubMeshHeader)];
+		memcpy(file, &header, sizeof(header));
+		memcpy(file + sizeof(header), &subMesh, sizeof(subMesh));
+		SaveBinaryFile(path, file, sizeof(file));
+	}
+}
+
+TEST_CASE("Spatial proxy is refit when the mesh changes", "[SpatialSystem]")
+{
+	WriteBoundsOnlyMesh("spatial_small.mesh", 0.5f);
+	WriteBoundsOnlyMesh("spatial_large.mesh", 4.0f);
+	{
+		MeshResource smallMesh("spatial_small.mesh");
+		MeshResource largeMesh("spatial_large.mesh");
+		SpatialWorldComponent spatial;
+		TransformComponent transform;
+		transform.SetLocalTranslation(Vector(10.0f, 0.0f, 0.0f));
+		const UniqueID entityID = UniqueID::Generate();
+
+		Dynarray<UniqueID> entities;
+		const AABox nearBox(Vector(9.9f, -0.1f, -0.1f), Vector(0.2f, 0.2f, 0.2f));
+		const AABox farBox(Vector(13.0f, -0.1f, -0.1f), Vector(0.2f, 0.2f, 0.2f));
+
+		SpatialSystem::UpdateEntityProxy(&spatial, entityID, &smallMesh, &transform, 1);
+		spatial.QueryBox(nearBox, entities);
+		CHECK(entities.GetSize() == 1);
+		spatial.QueryBox(farBox, entities);
+		CHECK(entities.GetSize() == 0);
+
+		// transformation stays the same, only the mesh of the entity is replaced
+		SpatialSystem::UpdateEntityProxy(&spatial, entityID, &largeMesh, &transform, 2);
+		spatial.QueryBox(farBox, entities);
+		REQUIRE(entities.GetSize() == 1);
+		CHECK(entities[0] == entityID);
+
+		// moving the entity refits the box as well
+		transform.SetLocalTranslation(Vector(30.0f, 0.0f, 0.0f));
+		SpatialSystem::UpdateEntityProxy(&spatial, entityID, &largeMesh, &transform, 3);
+		spatial.QueryBox(farBox, entities);
+		CHECK(entities.GetSize() == 0);
+		spatial.QueryBox(AABox(Vector(33.0f, -0.1f, -0.1f), Vector(0.2f, 0.2f, 0.2f)), entities);
+		CHECK(entities.GetSize() == 1);
+	}
+	std::remove("spatial_small.mesh");
+	std::remove("spatial_large.mesh");
+}
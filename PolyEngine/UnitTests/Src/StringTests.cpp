@@ -93,4 +93,9 @@ TEST_CASE("String operations", "[String]") {
 
 	String notContainsTest = String("Z[allz'/");
 	REQUIRE(test.Contains(notContainsTest) == false);
-}
\ No newline at end of file
+
+	REQUIRE(String("Textures/a.png").GetHash() == (String("Textures/") + String("a.png")).GetHash());
+	REQUIRE(String("Textures/a.png").GetHash() != String("Textures/b.png").GetHash());
+	REQUIRE(String().GetHash() != String("a").GetHash());
+	REQUIRE(std::hash<String>()(test) == test.GetHash());
+}
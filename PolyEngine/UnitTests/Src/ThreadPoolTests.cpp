@@ -0,0 +1,60 @@
+#include <catch.hpp>
+
+#include <ThreadPool.hpp>
+
+using namespace Poly;
+
+TEST_CASE("Thread pool job execution", "[ThreadPool]")
+{
+	for (size_t workerCount : { 0, 1, 4 })
+	{
+		ThreadPool pool(workerCount);
+		REQUIRE(pool.GetWorkerCount() == workerCount);
+
+		SECTION("All submitted jobs are executed once")
+		{
+			std::atomic<size_t> executed[1000];
+			for (std::atomic<size_t>& e : executed)
+				e = 0;
+
+			JobCounter counter;
+			for (size_t i = 0; i < 1000; ++i)
+				pool.Submit([&executed, i]() { ++executed[i]; }, &counter);
+			pool.Wait(counter);
+
+			REQUIRE(counter.IsDone());
+			for (const std::atomic<size_t>& e : executed)
+				REQUIRE(e == 1);
+		}
+
+		SECTION("Jobs submitted from jobs")
+		{
+			std::atomic<size_t> sum{ 0 };
+			JobCounter outer;
+			for (size_t i = 0; i < 16; ++i)
+			{
+				pool.Submit([&pool, &sum]()
+				{
+					JobCounter inner;
+					for (size_t j = 0; j < 16; ++j)
+						pool.Submit([&sum, j]() { sum += j; }, &inner);
+					pool.Wait(inner);
+				}, &outer);
+			}
+			pool.Wait(outer);
+
+			REQUIRE(sum == 16 * (15 * 16 / 2));
+		}
+	}
+}
+
+TEST_CASE("Thread pool finishes queued jobs on destruction", "[ThreadPool]")
+{
+	std::atomic<size_t> executed{ 0 };
+	{
+		ThreadPool pool(2);
+		for (size_t i = 0; i < 100; ++i)
+			pool.Submit([&executed]() { ++executed; });
+	}
+	REQUIRE(executed == 100);
+}
@@ -1,8 +1,15 @@
 #include <catch.hpp>
 
 #include <TransformComponent.hpp>
+#include <TransformWorldComponent.hpp>
+#include <World.hpp>
+#include <DeferredTaskSystem.hpp>
+#include <ThreadPool.hpp>
 #include <Quaternion.hpp>
 #include <Angle.hpp>
+#include <Logger.hpp>
+
+#include <chrono>
 
 using namespace Poly;
 
@@ -150,3 +157,168 @@ TEST_CASE("Get parent globals before getting children globals", "[TransformCompo
 	tc1.GetGlobalTransformationMatrix();
 	REQUIRE(tc2.GetGlobalTranslation() == v3);
 }
+
+TEST_CASE("Flat hierarchy global transform update", "[TransformComponent]")
+{
+	World world;
+	DeferredTaskSystem::AddWorldComponentImmediate<DeferredTaskWorldComponent>(&world);
+	DeferredTaskSystem::AddWorldComponentImmediate<TransformWorldComponent>(&world);
+
+	// several roots with chains and fans, enough nodes to be split into multiple jobs
+	Dynarray<TransformComponent*> transforms;
+	for (size_t i = 0; i < 5000; ++i)
+	{
+		UniqueID id = DeferredTaskSystem::SpawnEntityImmediate(&world);
+		DeferredTaskSystem::AddComponentImmediate<TransformComponent>(&world, id);
+		TransformComponent* transform = world.GetComponent<TransformComponent>(id);
+		if (i % 500 != 0)
+			transform->SetParent(transforms[i % 3 == 0 ? i - 1 : i - i % 500]);
+		transforms.PushBack(transform);
+	}
+
+	ThreadPool pool(3);
+	for (ThreadPool* usedPool : { (ThreadPool*)nullptr, &pool })
+	{
+		for (size_t i = 0; i < transforms.GetSize(); ++i)
+		{
+			transforms[i]->SetLocalTranslation(Vector(float(i % 7), float(i % 5), usedPool ? 1.0f : -1.0f));
+			transforms[i]->SetLocalRotation(Quaternion(Vector::UNIT_Y, Angle::FromDegrees(float(i % 13))));
+		}
+
+		TransformSystem::UpdateGlobalTransforms(&world, usedPool);
+		REQUIRE(world.GetWorldComponent<TransformWorldComponent>()->GetNodeCount() == transforms.GetSize());
+
+		for (TransformComponent* transform : transforms)
+		{
+			const Matrix expected = transform->GetParent()
+				? transform->GetParent()->GetGlobalTransformationMatrix() * transform->GetLocalTransformationMatrix()
+				: transform->GetLocalTransformationMatrix();
+			REQUIRE(transform->GetGlobalTransformationMatrix() == expected);
+		}
+	}
+}
+
+TEST_CASE("Composed global TRS matches decomposed global matrix", "[TransformComponent]")
+{
+	auto requireTRSMatchesMatrix = [](const TransformComponent& tc)
+	{
+		Vector translation, scale;
+		Quaternion rotation;
+		MatrixSkew skew;
+		Vector perspectivePoint;
+		tc.GetGlobalTransformationMatrix().Decompose(translation, rotation, scale, skew, perspectivePoint);
+		REQUIRE(tc.GetGlobalTranslation() == translation);
+		REQUIRE(tc.GetGlobalScale() == scale);
+		// q and -q represent the same rotation
+		const float sign = rotation.W * tc.GetGlobalRotation().W < 0 ? -1.f : 1.f;
+		REQUIRE(Cmpf(tc.GetGlobalRotation().X, sign * rotation.X));
+		REQUIRE(Cmpf(tc.GetGlobalRotation().Y, sign * rotation.Y));
+		REQUIRE(Cmpf(tc.GetGlobalRotation().Z, sign * rotation.Z));
+		REQUIRE(Cmpf(tc.GetGlobalRotation().W, sign * rotation.W));
+	};
+
+	TransformComponent tc1, tc2, tc3;
+	tc2.SetParent(&tc1);
+	tc3.SetParent(&tc2);
+	tc1.SetLocalTranslation(Vector(1, 2, 3));
+	tc1.SetLocalRotation(Quaternion(Vector::UNIT_Y, 30_deg));
+	tc1.SetLocalScale(2.f);
+	tc2.SetLocalTranslation(Vector(-4, 5, 1));
+	tc2.SetLocalRotation(Quaternion(Vector::UNIT_X, 45_deg));
+	tc2.SetLocalScale(Vector(1, 2, 3));
+	tc3.SetLocalTranslation(Vector(2, 0, -1));
+
+	SECTION("Uniform parent scale")
+	{
+		requireTRSMatchesMatrix(tc1);
+		requireTRSMatchesMatrix(tc2);
+		requireTRSMatchesMatrix(tc3);
+	}
+
+	SECTION("Non-uniform parent scale with unrotated child")
+	{
+		tc3.SetLocalScale(Vector(3, 2, 1));
+		requireTRSMatchesMatrix(tc3);
+	}
+
+	SECTION("Skewed hierarchy falls back to decomposition")
+	{
+		tc3.SetLocalRotation(Quaternion(Vector::UNIT_Z, 60_deg));
+		TransformComponent tc4;
+		tc4.SetParent(&tc3);
+		tc4.SetLocalTranslation(Vector(1, 1, 1));
+		Vector translation, scale;
+		Quaternion rotation;
+		MatrixSkew skew;
+		Vector perspectivePoint;
+		tc3.GetGlobalTransformationMatrix().Decompose(translation, rotation, scale, skew, perspectivePoint);
+		REQUIRE(tc3.GetGlobalTranslation() == translation);
+		REQUIRE(tc3.GetGlobalScale() == scale);
+		REQUIRE(tc4.GetGlobalTransformationMatrix() == tc3.GetGlobalTransformationMatrix() * tc4.GetLocalTransformationMatrix());
+	}
+}
+
+TEST_CASE("Deep hierarchy global transform update benchmark", "[.][Benchmark][TransformComponent]")
+{
+	const size_t nodeCount = 10000;
+	// single chain and many shallow chains, every node is a child of the previous one within its chain
+	for (size_t depth : { nodeCount, size_t(10) })
+	{
+		World world;
+		DeferredTaskSystem::AddWorldComponentImmediate<DeferredTaskWorldComponent>(&world);
+		DeferredTaskSystem::AddWorldComponentImmediate<TransformWorldComponent>(&world);
+
+		Dynarray<TransformComponent*> transforms;
+		for (size_t i = 0; i < nodeCount; ++i)
+		{
+			UniqueID id = DeferredTaskSystem::SpawnEntityImmediate(&world);
+			DeferredTaskSystem::AddComponentImmediate<TransformComponent>(&world, id);
+			TransformComponent* transform = world.GetComponent<TransformComponent>(id);
+			transform->SetLocalTranslation(Vector(1.f, 0.f, 0.f));
+			if (i % depth != 0)
+				transform->SetParent(transforms[i - 1]);
+			transforms.PushBack(transform);
+		}
+
+		// baseline path: every dirty global matrix is multiplied and then decomposed into global TRS
+		Dynarray<Matrix> baselineGlobals;
+		Dynarray<Vector> baselineTranslations, baselineScales;
+		Dynarray<Quaternion> baselineRotations;
+		baselineGlobals.Resize(nodeCount);
+		baselineTranslations.Resize(nodeCount);
+		baselineScales.Resize(nodeCount);
+		baselineRotations.Resize(nodeCount);
+
+		const size_t passes = 50;
+		double cachedMs = 0, baselineMs = 0;
+		for (size_t pass = 0; pass < passes; ++pass)
+		{
+			for (size_t i = 0; i < nodeCount; i += depth)
+				transforms[i]->SetLocalRotation(Quaternion(Vector::UNIT_Y, Angle::FromDegrees(float(pass))));
+
+			// both paths use the same up to date local matrices
+			for (const TransformComponent* transform : transforms)
+				transform->GetLocalTransformationMatrix();
+
+			auto start = std::chrono::high_resolution_clock::now();
+			for (size_t i = 0; i < nodeCount; ++i)
+			{
+				if (i % depth == 0)
+					baselineGlobals[i] = transforms[i]->GetLocalTransformationMatrix();
+				else
+					baselineGlobals[i] = baselineGlobals[i - 1] * transforms[i]->GetLocalTransformationMatrix();
+				baselineGlobals[i].Decompose(baselineTranslations[i], baselineRotations[i], baselineScales[i]);
+			}
+			baselineMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+			start = std::chrono::high_resolution_clock::now();
+			TransformSystem::UpdateGlobalTransforms(&world, nullptr);
+			cachedMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		}
+
+		for (size_t i = 0; i < nodeCount; i += nodeCount / 10)
+			REQUIRE(transforms[i]->GetGlobalTransformationMatrix() == baselineGlobals[i]);
+		gConsole.LogInfo("Global transform update of {} nodes, depth {}: baseline (multiply and Decompose) {} ms, composed TRS {} ms per pass",
+			nodeCount, depth, baselineMs / passes, cachedMs / passes);
+	}
+}
@@ -0,0 +1,61 @@
+#include <catch.hpp>
+
+#include <UniformRegistry.hpp>
+
+using namespace Poly;
+
+TEST_CASE("Uniform registry resolves handles", "[Uniform]")
+{
+	UniformRegistry uniforms;
+	REQUIRE(uniforms.Register("mat4", "uMVPTransform", 0));
+	REQUIRE(uniforms.Register("vec4", "uColor", 3));
+	REQUIRE(uniforms.Register("sampler2D", "uTexture", 7));
+	REQUIRE(uniforms.Register("float", "uTime", 5));
+
+	// first registration wins, shader units declaring the same uniform do not change it
+	CHECK_FALSE(uniforms.Register("vec4", "uTime", 9));
+	REQUIRE(uniforms.Find("uTime") != nullptr);
+	CHECK(uniforms.Find("uTime")->TypeName == "float");
+	CHECK(uniforms.Find("uTime")->Location == 5);
+
+	// handles refer to the same locations as name lookups
+	const UniformHandle<Matrix> mvp = uniforms.GetUniform<Matrix>("uMVPTransform");
+	const UniformHandle<Color> color = uniforms.GetUniform<Color>("uColor");
+	const UniformHandle<Vector> vector = uniforms.GetUniform<Vector>("uColor");
+	const UniformHandle<int> texture = uniforms.GetUniform<int>("uTexture");
+	const UniformHandle<float> time = uniforms.GetUniform<float>("uTime");
+	REQUIRE(mvp.IsValid());
+	CHECK(mvp.Location == uniforms.Find("uMVPTransform")->Location);
+	CHECK(color.Location == 3);
+	CHECK(vector.Location == 3);
+	CHECK(texture.Location == 7);
+	CHECK(time.Location == 5);
+
+	// uniforms that are not registered (f.ex. optimized out) give invalid handles
+	CHECK(uniforms.Find("uMissing") == nullptr);
+	CHECK_FALSE(uniforms.Contains("uMissing"));
+	CHECK_FALSE(uniforms.GetUniform<Matrix>("uMissing").IsValid());
+	CHECK_FALSE(UniformHandle<float>().IsValid());
+	CHECK(uniforms.GetUniformsInfo().size() == 4);
+}
+
+TEST_CASE("Uniform type compatibility", "[Uniform]")
+{
+	CHECK(UniformRegistry::IsTypeCompatible<int>("int"));
+	CHECK(UniformRegistry::IsTypeCompatible<int>("sampler2D"));
+	CHECK(UniformRegistry::IsTypeCompatible<int>("samplerBuffer"));
+	CHECK(UniformRegistry::IsTypeCompatible<int>("usamplerBuffer"));
+	CHECK_FALSE(UniformRegistry::IsTypeCompatible<int>("float"));
+
+	CHECK(UniformRegistry::IsTypeCompatible<float>("float"));
+	CHECK_FALSE(UniformRegistry::IsTypeCompatible<float>("int"));
+	CHECK_FALSE(UniformRegistry::IsTypeCompatible<float>("vec2"));
+
+	CHECK(UniformRegistry::IsTypeCompatible<Vector>("vec4"));
+	CHECK(UniformRegistry::IsTypeCompatible<Color>("vec4"));
+	CHECK_FALSE(UniformRegistry::IsTypeCompatible<Vector>("vec3"));
+	CHECK_FALSE(UniformRegistry::IsTypeCompatible<Color>("mat4"));
+
+	CHECK(UniformRegistry::IsTypeCompatible<Matrix>("mat4"));
+	CHECK_FALSE(UniformRegistry::IsTypeCompatible<Matrix>("vec4"));
+}
@@ -0,0 +1,47 @@
+#include <catch.hpp>
+
+#include <Engine.hpp>
+#include <TransformComponent.hpp>
+#include <SoundEmitterComponent.hpp>
+#include <DebugDrawComponents.hpp>
+#include <ViewportWorldComponent.hpp>
+
+using namespace Poly;
+
+TEST_CASE("Update phase access conflicts", "[Engine]")
+{
+	const UpdatePhaseAccess nothing;
+	const UpdatePhaseAccess exclusive = UpdatePhaseAccess::Exclusive();
+	const UpdatePhaseAccess readSound = UpdatePhaseAccess().Reads<SoundEmitterComponent>();
+	const UpdatePhaseAccess readTransform = UpdatePhaseAccess().Reads<TransformComponent>();
+	const UpdatePhaseAccess writeTransform = UpdatePhaseAccess().Writes<TransformComponent>();
+	const UpdatePhaseAccess readViewport = UpdatePhaseAccess().ReadsWorld<ViewportWorldComponent>();
+	const UpdatePhaseAccess writeLines = UpdatePhaseAccess().WritesWorld<DebugDrawLinesComponent>();
+	const UpdatePhaseAccess readAll = UpdatePhaseAccess().ReadsAll();
+
+	REQUIRE(exclusive.IsExclusiveAccess());
+	REQUIRE(!nothing.IsExclusiveAccess());
+	REQUIRE(exclusive.ConflictsWith(nothing));
+	REQUIRE(nothing.ConflictsWith(exclusive));
+	REQUIRE(!nothing.ConflictsWith(nothing));
+
+	// readers never conflict
+	REQUIRE(!readSound.ConflictsWith(readTransform));
+	REQUIRE(!readTransform.ConflictsWith(readTransform));
+	REQUIRE(!readAll.ConflictsWith(readSound));
+
+	// writers conflict with readers and writers of the same type only
+	REQUIRE(writeTransform.ConflictsWith(readTransform));
+	REQUIRE(readTransform.ConflictsWith(writeTransform));
+	REQUIRE(writeTransform.ConflictsWith(writeTransform));
+	REQUIRE(!writeTransform.ConflictsWith(readSound));
+	REQUIRE(writeTransform.ConflictsWith(readAll));
+
+	// world components are tracked separately from components
+	REQUIRE(!writeLines.ConflictsWith(readViewport));
+	REQUIRE(!writeLines.ConflictsWith(readTransform));
+	REQUIRE(writeLines.ConflictsWith(readAll));
+
+	REQUIRE(UpdatePhaseAccess().RunsOnMainThread().IsMainThreadOnly());
+	REQUIRE(!readAll.IsMainThreadOnly());
+}
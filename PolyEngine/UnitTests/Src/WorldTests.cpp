@@ -0,0 +1,206 @@
+#include <catch.hpp>
+
+#include <World.hpp>
+#include <DeferredTaskSystem.hpp>
+#include <EntityPrototype.hpp>
+#include <TransformComponent.hpp>
+#include <FreeFloatMovementComponent.hpp>
+#include <LightSourceComponent.hpp>
+#include <Logger.hpp>
+
+#include <chrono>
+#include <map>
+
+using namespace Poly;
+
+namespace
+{
+	using IterationResult = std::map<TransformComponent*, FreeFloatMovementComponent*>;
+
+	IterationResult CollectTransforms(World& world)
+	{
+		IterationResult result;
+		for (auto tuple : world.IterateComponents<TransformComponent, FreeFloatMovementComponent>())
+		{
+			TransformComponent* transform = std::get<TransformComponent*>(tuple);
+			REQUIRE(result.find(transform) == result.end());
+			result[transform] = std::get<FreeFloatMovementComponent*>(tuple);
+		}
+		return result;
+	}
+}
+
+TEST_CASE("World archetype storage iteration", "[World]")
+{
+	World world;
+	DeferredTaskSystem::AddWorldComponentImmediate<DeferredTaskWorldComponent>(&world);
+
+	Dynarray<UniqueID> entities;
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		UniqueID id = DeferredTaskSystem::SpawnEntityImmediate(&world);
+		entities.PushBack(id);
+		if (i % 3 != 0)
+			DeferredTaskSystem::AddComponentImmediate<TransformComponent>(&world, id);
+		if (i % 2 == 0)
+			DeferredTaskSystem::AddComponentImmediate<FreeFloatMovementComponent>(&world, id);
+		if (i % 5 == 0)
+			DeferredTaskSystem::AddComponentImmediate<PointLightComponent>(&world, id);
+	}
+
+	const IterationResult poolResult = CollectTransforms(world);
+	REQUIRE(poolResult.size() == 666);
+
+	world.SetArchetypeStorageEnabled(true);
+	REQUIRE(world.IsArchetypeStorageEnabled());
+	REQUIRE(CollectTransforms(world) == poolResult);
+
+	SECTION("Components added and removed in archetype mode")
+	{
+		for (size_t i = 0; i < entities.GetSize(); i += 4)
+		{
+			if (i % 2 == 0)
+				DeferredTaskSystem::DestroyEntityImmediate(&world, entities[i]);
+		}
+		UniqueID id = DeferredTaskSystem::SpawnEntityImmediate(&world);
+		DeferredTaskSystem::AddComponentImmediate<FreeFloatMovementComponent>(&world, id);
+		DeferredTaskSystem::AddComponentImmediate<TransformComponent>(&world, id);
+
+		const IterationResult archetypeResult = CollectTransforms(world);
+		world.SetArchetypeStorageEnabled(false);
+		REQUIRE(!world.IsArchetypeStorageEnabled());
+		REQUIRE(CollectTransforms(world) == archetypeResult);
+		REQUIRE(archetypeResult.at(world.GetComponent<TransformComponent>(id)) == world.GetComponent<FreeFloatMovementComponent>(id));
+	}
+
+	SECTION("Backward iteration")
+	{
+		size_t count = 0;
+		auto proxy = world.IterateComponents<PointLightComponent, TransformComponent>();
+		auto it = proxy.End();
+		while (it != proxy.Begin())
+		{
+			--it;
+			REQUIRE(std::get<PointLightComponent*>(*it) != nullptr);
+			++count;
+		}
+		REQUIRE(count == 200);
+	}
+}
+
+TEST_CASE("World generational entity handles", "[World]")
+{
+	World world;
+	DeferredTaskSystem::AddWorldComponentImmediate<DeferredTaskWorldComponent>(&world);
+
+	UniqueID first = DeferredTaskSystem::SpawnEntityImmediate(&world);
+	UniqueID second = DeferredTaskSystem::SpawnEntityImmediate(&world);
+	REQUIRE(first != second);
+	REQUIRE(world.HasEntity(first));
+	REQUIRE(world.HasEntity(second));
+
+	const EntityHandle handle = EntityHandle::FromID(first);
+	REQUIRE(handle.ToID() == first);
+	REQUIRE(UniqueID::FromValue(first.GetValue()) == first);
+
+	DeferredTaskSystem::AddComponentImmediate<TransformComponent>(&world, first);
+	DeferredTaskSystem::DestroyEntityImmediate(&world, first);
+	REQUIRE(!world.HasEntity(first));
+	REQUIRE(world.HasEntity(second));
+
+	// slot is reused with a new generation, old ID stays invalid
+	UniqueID third = DeferredTaskSystem::SpawnEntityImmediate(&world);
+	const EntityHandle thirdHandle = EntityHandle::FromID(third);
+	REQUIRE(thirdHandle.Index == handle.Index);
+	REQUIRE(thirdHandle.Generation != handle.Generation);
+	REQUIRE(third != first);
+	REQUIRE(!world.HasEntity(first));
+	REQUIRE(world.HasEntity(third));
+	REQUIRE(world.GetComponent<TransformComponent>(third) == nullptr);
+	REQUIRE(!world.HasEntity(UniqueID()));
+}
+
+TEST_CASE("World batched entity spawn and destroy", "[World]")
+{
+	World world;
+	DeferredTaskSystem::AddWorldComponentImmediate<DeferredTaskWorldComponent>(&world);
+
+	EntityPrototype prototype;
+	prototype.AddComponent<TransformComponent>().AddComponent<FreeFloatMovementComponent>(5.0f, 0.5f);
+	REQUIRE(prototype.GetComponentCount() == 2);
+
+	for (bool archetypes : { false, true })
+	{
+		world.SetArchetypeStorageEnabled(archetypes);
+
+		Dynarray<UniqueID> ids = DeferredTaskSystem::SpawnEntitiesBatch(&world, 1000, prototype);
+		REQUIRE(ids.GetSize() == 1000);
+		for (const UniqueID& id : ids)
+		{
+			REQUIRE(world.HasEntity(id));
+			FreeFloatMovementComponent* movement = world.GetComponent<FreeFloatMovementComponent>(id);
+			REQUIRE(movement != nullptr);
+			REQUIRE(movement->GetMovementSpeed() == 5.0f);
+			REQUIRE(movement->GetAngularVelocity() == 0.5f);
+			REQUIRE(movement->CheckFlags(eComponentBaseFlags::NEWLY_CREATED));
+			REQUIRE(world.GetComponent<TransformComponent>(id) != nullptr);
+			REQUIRE(world.GetComponent<PointLightComponent>(id) == nullptr);
+		}
+		REQUIRE(CollectTransforms(world).size() == 1000);
+
+		// children are destroyed with their parents, batch skips them
+		world.GetComponent<TransformComponent>(ids[1])->SetParent(world.GetComponent<TransformComponent>(ids[0]));
+		DeferredTaskSystem::DestroyEntitiesBatch(&world, ids);
+		for (const UniqueID& id : ids)
+			REQUIRE(!world.HasEntity(id));
+		REQUIRE(CollectTransforms(world).empty());
+	}
+}
+
+TEST_CASE("World batched entity spawn benchmark", "[.][Benchmark][World]")
+{
+	const size_t count = MAX_ENTITY_COUNT / 2;
+	for (bool archetypes : { false, true })
+	{
+		{
+			World world;
+			DeferredTaskSystem::AddWorldComponentImmediate<DeferredTaskWorldComponent>(&world);
+			world.SetArchetypeStorageEnabled(archetypes);
+
+			const auto start = std::chrono::high_resolution_clock::now();
+			Dynarray<UniqueID> ids;
+			for (size_t i = 0; i < count; ++i)
+			{
+				UniqueID id = DeferredTaskSystem::SpawnEntityImmediate(&world);
+				DeferredTaskSystem::AddComponentImmediate<TransformComponent>(&world, id);
+				DeferredTaskSystem::AddComponentImmediate<FreeFloatMovementComponent>(&world, id);
+				DeferredTaskSystem::AddComponentImmediate<PointLightComponent>(&world, id);
+				ids.PushBack(id);
+			}
+			const auto spawned = std::chrono::high_resolution_clock::now();
+			for (const UniqueID& id : ids)
+				DeferredTaskSystem::DestroyEntityImmediate(&world, id);
+			const auto destroyed = std::chrono::high_resolution_clock::now();
+
+			gConsole.LogInfo("Spawning {} entities one by one (archetypes: {}): {} ms, destroying: {} ms", count, archetypes,
+				std::chrono::duration<double, std::milli>(spawned - start).count(), std::chrono::duration<double, std::milli>(destroyed - spawned).count());
+		}
+		{
+			World world;
+			DeferredTaskSystem::AddWorldComponentImmediate<DeferredTaskWorldComponent>(&world);
+			world.SetArchetypeStorageEnabled(archetypes);
+
+			EntityPrototype prototype;
+			prototype.AddComponent<TransformComponent>().AddComponent<FreeFloatMovementComponent>().AddComponent<PointLightComponent>();
+
+			const auto start = std::chrono::high_resolution_clock::now();
+			Dynarray<UniqueID> ids = DeferredTaskSystem::SpawnEntitiesBatch(&world, count, prototype);
+			const auto spawned = std::chrono::high_resolution_clock::now();
+			DeferredTaskSystem::DestroyEntitiesBatch(&world, ids);
+			const auto destroyed = std::chrono::high_resolution_clock::now();
+
+			gConsole.LogInfo("Spawning {} entities in batch (archetypes: {}): {} ms, destroying: {} ms", count, archetypes,
+				std::chrono::duration<double, std::milli>(spawned - start).count(), std::chrono::duration<double, std::milli>(destroyed - spawned).count());
+		}
+	}
+}